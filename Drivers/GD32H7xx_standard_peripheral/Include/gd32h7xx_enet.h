@@ -885,6 +885,12 @@ typedef struct {
 
 } enet_descriptors_struct;
 
+/* structure for one buffer segment of a transmit frame */
+typedef struct {
+    uint32_t buffer_addr;                                                           /*!< address of the segment data */
+    uint32_t length;                                                                /*!< length of the segment data */
+} enet_frame_segment_struct;
+
 /* structure of PTP system time */
 typedef struct {
     uint32_t second;                                                                /*!< second of system time */
@@ -1384,6 +1390,36 @@ typedef enum {
 #define ENET_TXBUF_SIZE                  ENET_MAX_FRAME_SIZE                    /*!< ethernet transmit buffer size */
 #endif
 
+#ifndef ENET_RX_ZERO_COPY
+#define ENET_RX_ZERO_COPY                0U                                     /*!< 1: the application attaches its own Rx buffers, no receive buffers are allocated */
+#endif
+
+#ifndef ENET_INSTANCE_NUM
+#define ENET_INSTANCE_NUM                1U                                     /*!< ENET instances with their own DMA descriptors and buffers, 1 or 2 */
+#endif
+
+/* statistics of an ENET instance */
+typedef struct {
+    uint32_t rx_frames;                                                         /*!< frames received by the application */
+    uint32_t rx_dropped;                                                        /*!< received frames dropped */
+    uint32_t tx_frames;                                                         /*!< frames handed to the TxDMA */
+    uint32_t tx_busy;                                                           /*!< transmissions refused because the TxDMA owned the descriptor */
+} enet_handle_stats_struct;
+
+/* DMA context of an ENET instance */
+typedef struct {
+    uint32_t periph;                                                            /*!< ENETx(x=0,1) served by the instance */
+    enet_descriptors_struct *rxdesc_tab;                                        /*!< RxDMA descriptor table */
+    enet_descriptors_struct *txdesc_tab;                                        /*!< TxDMA descriptor table */
+    uint8_t (*rx_buff)[ENET_RXBUF_SIZE];                                        /*!< receive buffers */
+    uint8_t (*tx_buff)[ENET_TXBUF_SIZE];                                        /*!< transmit buffers */
+    enet_descriptors_struct *rxdesc_current;                                    /*!< current RxDMA descriptor */
+    enet_descriptors_struct *txdesc_current;                                    /*!< current TxDMA descriptor */
+    enet_descriptors_struct *ptp_rxdesc_current;                                /*!< current Rx ptp descriptor for normal mode */
+    enet_descriptors_struct *ptp_txdesc_current;                                /*!< current Tx ptp descriptor for normal mode */
+    enet_handle_stats_struct stats;                                             /*!< statistics */
+} enet_handle_struct;
+
 /* #define SELECT_DESCRIPTORS_ENHANCED_MODE */
 
 /* #define USE_DELAY */
@@ -1438,6 +1474,10 @@ typedef enum {
 
 /* function declarations */
 /* main function */
+/* get the handle of the ENET instance which serves the peripheral */
+enet_handle_struct *enet_handle_get(uint32_t enet_periph);
+/* get the statistics on the ENET instance */
+void enet_handle_stats_get(enet_handle_struct *handle, enet_handle_stats_struct *stats);
 /* deinitialize the ENET, and reset structure parameters for ENET initialization */
 void enet_deinit(uint32_t enet_periph);
 /* configure the parameters which are usually less cared for initialization */
@@ -1448,18 +1488,38 @@ ErrStatus enet_init(uint32_t enet_periph, enet_mediamode_enum mediamode, enet_ch
 ErrStatus enet_software_reset(uint32_t enet_periph);
 /* check receive frame valid and return frame size */
 uint32_t enet_rxframe_size_get(uint32_t enet_periph);
+/* check receive frame valid and return frame size on the ENET instance */
+uint32_t enet_handle_rxframe_size_get(enet_handle_struct *handle);
 /* initialize the dma tx/rx descriptors's parameters in chain mode */
 void enet_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum direction);
+/* initialize the dma tx/rx descriptors's parameters in chain mode on the ENET instance */
+void enet_handle_descriptors_chain_init(enet_handle_struct *handle, enet_dmadirection_enum direction);
 /* initialize the dma tx/rx descriptors's parameters in ring mode */
 void enet_descriptors_ring_init(uint32_t enet_periph, enet_dmadirection_enum direction);
+/* initialize the dma tx/rx descriptors's parameters in ring mode on the ENET instance */
+void enet_handle_descriptors_ring_init(enet_handle_struct *handle, enet_dmadirection_enum direction);
 /* handle current received frame data to application buffer */
 ErrStatus enet_frame_receive(uint32_t enet_periph, uint8_t buffer[], uint32_t bufsize);
 /* handle current received frame but without data copy to application buffer */
 #define ENET_NOCOPY_FRAME_RECEIVE(enet_periph)         enet_frame_receive((enet_periph), NULL, 0U)
+/* handle current received frame data to application buffer on the ENET instance */
+ErrStatus enet_handle_frame_receive(enet_handle_struct *handle, uint8_t buffer[], uint32_t bufsize);
+/* handle current received frame but without data copy to application buffer on the ENET instance */
+#define ENET_HANDLE_NOCOPY_FRAME_RECEIVE(handle)       enet_handle_frame_receive((handle), NULL, 0U)
 /* handle application buffer data to transmit it */
 ErrStatus enet_frame_transmit(uint32_t enet_periph, uint8_t buffer[], uint32_t length);
 /* handle current transmit frame but without data copy from application buffer */
 #define ENET_NOCOPY_FRAME_TRANSMIT(enet_periph, len)     enet_frame_transmit((enet_periph), NULL, (len))
+/* handle application buffer data to transmit it on the ENET instance */
+ErrStatus enet_handle_frame_transmit(enet_handle_struct *handle, uint8_t buffer[], uint32_t length);
+/* handle current transmit frame but without data copy from application buffer on the ENET instance */
+#define ENET_HANDLE_NOCOPY_FRAME_TRANSMIT(handle, len)   enet_handle_frame_transmit((handle), NULL, (len))
+/* hand a frame made of several buffer segments to the TxDMA, without data copy */
+ErrStatus enet_frame_segments_transmit(uint32_t enet_periph, enet_frame_segment_struct segment[], uint32_t num,
+                                       enet_descriptors_struct **last_desc);
+/* hand a frame made of several buffer segments to the TxDMA, without data copy on the ENET instance */
+ErrStatus enet_handle_frame_segments_transmit(enet_handle_struct *handle, enet_frame_segment_struct segment[], uint32_t num,
+                                              enet_descriptors_struct **last_desc);
 /* configure the transmit IP frame checksum offload calculation and insertion */
 ErrStatus enet_transmit_checksum_config(enet_descriptors_struct *desc, uint32_t checksum);
 /* ENET Tx and Rx function enable (include MAC and DMA module) */
@@ -1528,6 +1588,8 @@ uint32_t enet_dmaprocess_state_get(uint32_t enet_periph, enet_dmadirection_enum
 void enet_dmaprocess_resume(uint32_t enet_periph, enet_dmadirection_enum direction);
 /* check and recover the Rx process */
 void enet_rxprocess_check_recovery(uint32_t enet_periph);
+/* check and recover the Rx process on the ENET instance */
+void enet_handle_rxprocess_check_recovery(enet_handle_struct *handle);
 /* flush the ENET transmit fifo, and wait until the flush operation completes */
 ErrStatus enet_txfifo_flush(uint32_t enet_periph);
 /* get the transmit/receive address of current descriptor, or current buffer, or descriptor table */
@@ -1550,6 +1612,8 @@ void enet_rx_desc_immediate_receive_complete_interrupt(enet_descriptors_struct *
 void enet_rx_desc_delay_receive_complete_interrupt(uint32_t enet_periph, enet_descriptors_struct *desc, uint32_t delay_time);
 /* drop current receive frame */
 void enet_rxframe_drop(uint32_t enet_periph);
+/* drop current receive frame on the ENET instance */
+void enet_handle_rxframe_drop(enet_handle_struct *handle);
 /* enable DMA feature */
 void enet_dma_feature_enable(uint32_t enet_periph, uint32_t feature);
 /* disable DMA feature */
@@ -1564,16 +1628,28 @@ uint32_t enet_rx_desc_enhanced_status_get(enet_descriptors_struct *desc, uint32_
 void enet_desc_select_enhanced_mode(uint32_t enet_periph);
 /* initialize the dma Tx/Rx descriptors's parameters in enhanced chain mode with ptp function */
 void enet_ptp_enhanced_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum direction);
+/* initialize the dma Tx/Rx descriptors's parameters in enhanced chain mode with ptp function on the ENET instance */
+void enet_handle_ptp_enhanced_descriptors_chain_init(enet_handle_struct *handle, enet_dmadirection_enum direction);
 /* initialize the dma Tx/Rx descriptors's parameters in enhanced ring mode with ptp function */
 void enet_ptp_enhanced_descriptors_ring_init(uint32_t enet_periph, enet_dmadirection_enum direction);
+/* initialize the dma Tx/Rx descriptors's parameters in enhanced ring mode with ptp function on the ENET instance */
+void enet_handle_ptp_enhanced_descriptors_ring_init(enet_handle_struct *handle, enet_dmadirection_enum direction);
 /* receive a packet data with timestamp values to application buffer, when the DMA is in enhanced mode */
 ErrStatus enet_ptpframe_receive_enhanced_mode(uint32_t enet_periph, uint8_t buffer[], uint32_t bufsize, uint32_t timestamp[]);
 /* handle current received frame but without data copy to application buffer in PTP enhanced mode */
 #define ENET_NOCOPY_PTPFRAME_RECEIVE_ENHANCED_MODE(enet_periph, ptr)           enet_ptpframe_receive_enhanced_mode((enet_periph), NULL, 0U, (ptr))
+/* receive a packet data with timestamp values to application buffer, when the DMA is in enhanced mode on the ENET instance */
+ErrStatus enet_handle_ptpframe_receive_enhanced_mode(enet_handle_struct *handle, uint8_t buffer[], uint32_t bufsize, uint32_t timestamp[]);
+/* handle current received frame but without data copy to application buffer in PTP enhanced mode on the ENET instance */
+#define ENET_HANDLE_NOCOPY_PTPFRAME_RECEIVE_ENHANCED_MODE(handle, ptr)         enet_handle_ptpframe_receive_enhanced_mode((handle), NULL, 0U, (ptr))
 /* send data with timestamp values in application buffer as a transmit packet, when the DMA is in enhanced mode */
 ErrStatus enet_ptpframe_transmit_enhanced_mode(uint32_t enet_periph, uint8_t buffer[], uint32_t length, uint32_t timestamp[]);
 /* handle current transmit frame but without data copy from application buffer in PTP enhanced mode */
 #define ENET_NOCOPY_PTPFRAME_TRANSMIT_ENHANCED_MODE(enet_periph, len, ptr)     enet_ptpframe_transmit_enhanced_mode((enet_periph), NULL, (len), (ptr))
+/* send data with timestamp values in application buffer as a transmit packet, when the DMA is in enhanced mode on the ENET instance */
+ErrStatus enet_handle_ptpframe_transmit_enhanced_mode(enet_handle_struct *handle, uint8_t buffer[], uint32_t length, uint32_t timestamp[]);
+/* handle current transmit frame but without data copy from application buffer in PTP enhanced mode on the ENET instance */
+#define ENET_HANDLE_NOCOPY_PTPFRAME_TRANSMIT_ENHANCED_MODE(handle, len, ptr)   enet_handle_ptpframe_transmit_enhanced_mode((handle), NULL, (len), (ptr))
 
 #else
 
@@ -1581,16 +1657,28 @@ ErrStatus enet_ptpframe_transmit_enhanced_mode(uint32_t enet_periph, uint8_t buf
 void enet_desc_select_normal_mode(uint32_t enet_periph);
 /* initialize the dma Tx/Rx descriptors's parameters in normal chain mode with ptp function */
 void enet_ptp_normal_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum direction, enet_descriptors_struct *desc_ptptab);
+/* initialize the dma Tx/Rx descriptors's parameters in normal chain mode with ptp function on the ENET instance */
+void enet_handle_ptp_normal_descriptors_chain_init(enet_handle_struct *handle, enet_dmadirection_enum direction, enet_descriptors_struct *desc_ptptab);
 /* initialize the dma Tx/Rx descriptors's parameters in normal ring mode with ptp function */
 void enet_ptp_normal_descriptors_ring_init(uint32_t enet_periph, enet_dmadirection_enum direction, enet_descriptors_struct *desc_ptptab);
+/* initialize the dma Tx/Rx descriptors's parameters in normal ring mode with ptp function on the ENET instance */
+void enet_handle_ptp_normal_descriptors_ring_init(enet_handle_struct *handle, enet_dmadirection_enum direction, enet_descriptors_struct *desc_ptptab);
 /* receive a packet data with timestamp values to application buffer, when the DMA is in normal mode */
 ErrStatus enet_ptpframe_receive_normal_mode(uint32_t enet_periph, uint8_t buffer[], uint32_t bufsize, uint32_t timestamp[]);
 /* handle current received frame but without data copy to application buffer in PTP normal mode */
 #define ENET_NOCOPY_PTPFRAME_RECEIVE_NORMAL_MODE(enet_periph, ptr)             enet_ptpframe_receive_normal_mode((enet_periph), NULL, 0U, (ptr))
+/* receive a packet data with timestamp values to application buffer, when the DMA is in normal mode on the ENET instance */
+ErrStatus enet_handle_ptpframe_receive_normal_mode(enet_handle_struct *handle, uint8_t buffer[], uint32_t bufsize, uint32_t timestamp[]);
+/* handle current received frame but without data copy to application buffer in PTP normal mode on the ENET instance */
+#define ENET_HANDLE_NOCOPY_PTPFRAME_RECEIVE_NORMAL_MODE(handle, ptr)           enet_handle_ptpframe_receive_normal_mode((handle), NULL, 0U, (ptr))
 /* send data with timestamp values in application buffer as a transmit packet, when the DMA is in normal mode */
 ErrStatus enet_ptpframe_transmit_normal_mode(uint32_t enet_periph, uint8_t buffer[], uint32_t length, uint32_t timestamp[]);
 /* handle current transmit frame but without data copy from application buffer in PTP normal mode */
 #define ENET_NOCOPY_PTPFRAME_TRANSMIT_NORMAL_MODE(enet_periph, len, ptr)       enet_ptpframe_transmit_normal_mode((enet_periph), NULL, (len), (ptr))
+/* send data with timestamp values in application buffer as a transmit packet, when the DMA is in normal mode on the ENET instance */
+ErrStatus enet_handle_ptpframe_transmit_normal_mode(enet_handle_struct *handle, uint8_t buffer[], uint32_t length, uint32_t timestamp[]);
+/* handle current transmit frame but without data copy from application buffer in PTP normal mode on the ENET instance */
+#define ENET_HANDLE_NOCOPY_PTPFRAME_TRANSMIT_NORMAL_MODE(handle, len, ptr)     enet_handle_ptpframe_transmit_normal_mode((handle), NULL, (len), (ptr))
 
 #endif /* SELECT_DESCRIPTORS_ENHANCED_MODE */
 
@@ -39,36 +39,70 @@ OF SUCH DAMAGE.
 #if defined(GD32H7XX)
 
 #if defined   (__CC_ARM)                                    /*!< ARM compiler */
+#if (ENET_RXBUF_NUM > 5U) || (ENET_TXBUF_NUM > 5U)
+#error "the fixed ENET DMA addresses only hold 5 descriptors per ring"
+#endif
 __attribute__((section(".ARM.__at_0x30000000")))  enet_descriptors_struct  rxdesc_tab[ENET_RXBUF_NUM];        /*!< ENET RxDMA descriptor */
 __attribute__((section(".ARM.__at_0x30000160")))  enet_descriptors_struct  txdesc_tab[ENET_TXBUF_NUM];        /*!< ENET TxDMA descriptor */
+#if (0U == ENET_RX_ZERO_COPY)
 __attribute__((section(".ARM.__at_0x30000300")))  uint8_t rx_buff[ENET_RXBUF_NUM][ENET_RXBUF_SIZE];           /*!< ENET receive buffer */
+#endif /* ENET_RX_ZERO_COPY */
 __attribute__((section(".ARM.__at_0x30002100")))  uint8_t tx_buff[ENET_TXBUF_NUM][ENET_TXBUF_SIZE];           /*!< ENET transmit buffer */
 
 #elif defined ( __ICCARM__ )                                /*!< IAR compiler */
+#if (ENET_RXBUF_NUM > 5U) || (ENET_TXBUF_NUM > 5U)
+#error "the fixed ENET DMA addresses only hold 5 descriptors per ring"
+#endif
 #pragma location=0x30000000
 enet_descriptors_struct  rxdesc_tab[ENET_RXBUF_NUM];        /*!< ENET RxDMA descriptor */
 #pragma location=0x30000160
 enet_descriptors_struct  txdesc_tab[ENET_TXBUF_NUM];        /*!< ENET TxDMA descriptor */
+#if (0U == ENET_RX_ZERO_COPY)
 #pragma location=0x30000300
 uint8_t rx_buff[ENET_RXBUF_NUM][ENET_RXBUF_SIZE];           /*!< ENET receive buffer */
+#endif /* ENET_RX_ZERO_COPY */
 #pragma location=0x30002100
 uint8_t tx_buff[ENET_TXBUF_NUM][ENET_TXBUF_SIZE];           /*!< ENET transmit buffer */
 
 #elif defined (__GNUC__)        /* GNU Compiler */
-enet_descriptors_struct  rxdesc_tab[ENET_RXBUF_NUM] __attribute__((section(".ARM.__at_0x30000000")));          /*!< ENET RxDMA descriptor */
-enet_descriptors_struct  txdesc_tab[ENET_TXBUF_NUM] __attribute__((section(".ARM.__at_0x30000160")));          /*!< ENET TxDMA descriptor */
-uint8_t rx_buff[ENET_RXBUF_NUM][ENET_RXBUF_SIZE] __attribute__((section(".ARM.__at_0x30000300")));             /*!< ENET receive buffer */
-uint8_t tx_buff[ENET_TXBUF_NUM][ENET_TXBUF_SIZE] __attribute__((section(".ARM.__at_0x30002100")));             /*!< ENET transmit buffer */
+/* the linker script places the .dma_nocache section in a region which the application maps non-cacheable */
+#define ENET_DMA_ATTRIBUTE               __attribute__((section(".dma_nocache"), aligned(32)))
+enet_descriptors_struct  rxdesc_tab[ENET_RXBUF_NUM] ENET_DMA_ATTRIBUTE;                                         /*!< ENET RxDMA descriptor */
+enet_descriptors_struct  txdesc_tab[ENET_TXBUF_NUM] ENET_DMA_ATTRIBUTE;                                         /*!< ENET TxDMA descriptor */
+#if (0U == ENET_RX_ZERO_COPY)
+uint8_t rx_buff[ENET_RXBUF_NUM][ENET_RXBUF_SIZE] ENET_DMA_ATTRIBUTE;                                            /*!< ENET receive buffer */
+#endif /* ENET_RX_ZERO_COPY */
+uint8_t tx_buff[ENET_TXBUF_NUM][ENET_TXBUF_SIZE] ENET_DMA_ATTRIBUTE;                                            /*!< ENET transmit buffer */
 
 #endif /* __CC_ARM */
 
-/* global transmit and receive descriptors pointers */
-enet_descriptors_struct  *dma_current_txdesc;
-enet_descriptors_struct  *dma_current_rxdesc;
-
-/* structure pointer of ptp descriptor for normal mode */
-enet_descriptors_struct  *dma_current_ptp_txdesc = NULL;
-enet_descriptors_struct  *dma_current_ptp_rxdesc = NULL;
+#if (ENET_INSTANCE_NUM > 1U)
+#ifndef ENET_DMA_ATTRIBUTE
+/* the second instance is placed by the linker, its region must be made DMA accessible by the application */
+#define ENET_DMA_ATTRIBUTE               __attribute__((aligned(4)))
+#endif /* ENET_DMA_ATTRIBUTE */
+enet_descriptors_struct  enet1_rxdesc_tab[ENET_RXBUF_NUM] ENET_DMA_ATTRIBUTE;                                   /*!< ENET1 RxDMA descriptor */
+enet_descriptors_struct  enet1_txdesc_tab[ENET_TXBUF_NUM] ENET_DMA_ATTRIBUTE;                                   /*!< ENET1 TxDMA descriptor */
+#if (0U == ENET_RX_ZERO_COPY)
+uint8_t enet1_rx_buff[ENET_RXBUF_NUM][ENET_RXBUF_SIZE] ENET_DMA_ATTRIBUTE;                                      /*!< ENET1 receive buffer */
+#endif /* ENET_RX_ZERO_COPY */
+uint8_t enet1_tx_buff[ENET_TXBUF_NUM][ENET_TXBUF_SIZE] ENET_DMA_ATTRIBUTE;                                      /*!< ENET1 transmit buffer */
+#endif /* ENET_INSTANCE_NUM */
+
+/* with zero-copy Rx the application attaches the receive buffers to the Rx descriptors */
+#if (0U == ENET_RX_ZERO_COPY)
+#define ENET_RX_BUFF(buff)               (buff)
+#else
+#define ENET_RX_BUFF(buff)               NULL
+#endif /* ENET_RX_ZERO_COPY */
+
+/* DMA descriptor tables, buffers and descriptor pointers of each ENET instance */
+static enet_handle_struct enet_handle_tab[ENET_INSTANCE_NUM] = {
+    {ENET0, rxdesc_tab, txdesc_tab, ENET_RX_BUFF(rx_buff), tx_buff, NULL, NULL, NULL, NULL, {0U, 0U, 0U, 0U}},
+#if (ENET_INSTANCE_NUM > 1U)
+    {ENET1, enet1_rxdesc_tab, enet1_txdesc_tab, ENET_RX_BUFF(enet1_rx_buff), enet1_tx_buff, NULL, NULL, NULL, NULL, {0U, 0U, 0U, 0U}},
+#endif /* ENET_INSTANCE_NUM */
+};
 
 /* init structure parameters for ENET initialization */
 static enet_initpara_struct enet_initpara = {0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U};
@@ -91,11 +125,46 @@ static const uint16_t enet_reg_tab[] = {
 
 /* initialize ENET peripheral with generally concerned parameters, call it by enet_init() */
 static void enet_default_init(uint32_t enet_periph);
+/* get the TxDMA descriptor following the given one */
+static enet_descriptors_struct *enet_txdesc_next_get(uint32_t enet_periph, enet_descriptors_struct *desc);
+/* copy frame data between a DMA buffer and an application buffer */
+static void enet_frame_copy(uint8_t *dest, const uint8_t *src, uint32_t length);
 #ifndef USE_DELAY
 /* insert a delay time */
 static void enet_delay(uint32_t ncount);
 #endif /* USE_DELAY */
 
+/*!
+    \brief      get the handle of the ENET instance which serves the peripheral
+    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[out] none
+    \retval     the ENET instance handle, refer to enet_handle_struct
+                note -- if ENET_INSTANCE_NUM is 1, instance 0 serves the ENET last passed to enet_init()
+*/
+enet_handle_struct *enet_handle_get(uint32_t enet_periph)
+{
+#if (ENET_INSTANCE_NUM > 1U)
+    if(ENET1 == enet_periph) {
+        return &enet_handle_tab[1];
+    }
+#else
+    (void)enet_periph;
+#endif /* ENET_INSTANCE_NUM */
+
+    return &enet_handle_tab[0];
+}
+
+/*!
+    \brief      get the statistics of the ENET instance
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
+    \param[out] stats: the statistics of the instance, refer to enet_handle_stats_struct
+    \retval     none
+*/
+void enet_handle_stats_get(enet_handle_struct *handle, enet_handle_stats_struct *stats)
+{
+    *stats = handle->stats;
+}
+
 /*!
     \brief      deinitialize the ENET, and reset structure parameters for ENET initialization
     \param[in]  enet_periph: ENETx(x=0,1)
@@ -351,6 +420,11 @@ ErrStatus enet_init(uint32_t enet_periph, enet_mediamode_enum mediamode, enet_ch
     uint16_t phy_value = 0U;
     ErrStatus phy_state = ERROR, enet_state = ERROR;
 
+#if (ENET_INSTANCE_NUM < 2U)
+    /* the single instance serves whichever ENET is initialized */
+    enet_handle_tab[0].periph = enet_periph;
+#endif /* ENET_INSTANCE_NUM */
+
     /* PHY interface configuration, configure SMI clock and reset PHY chip */
     if(ERROR == enet_phy_config(enet_periph)) {
         _ENET_DELAY_(PHY_RESETDELAY);
@@ -659,17 +733,18 @@ ErrStatus enet_software_reset(uint32_t enet_periph)
 
 /*!
     \brief      check receive frame valid and return frame size
-    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
     \param[out] none
     \retval     size of received frame: 0x0 - 0x3FFF
 */
-uint32_t enet_rxframe_size_get(uint32_t enet_periph)
+uint32_t enet_handle_rxframe_size_get(enet_handle_struct *handle)
 {
     uint32_t size = 0U;
     uint32_t status;
+    uint32_t enet_periph = handle->periph;
 
     /* get rdes0 information of current RxDMA descriptor */
-    status = dma_current_rxdesc->status;
+    status = handle->rxdesc_current->status;
 
     /* if the desciptor is owned by DMA */
     if((uint32_t)RESET != (status & ENET_RDES0_DAV)) {
@@ -681,16 +756,16 @@ uint32_t enet_rxframe_size_get(uint32_t enet_periph)
             (((uint32_t)RESET) == (status & ENET_RDES0_LDES)) ||
             (((uint32_t)RESET) == (status & ENET_RDES0_FDES))) {
         /* drop current receive frame */
-        enet_rxframe_drop(enet_periph);
+        enet_handle_rxframe_drop(handle);
 
         return 1U;
     }
 #ifdef SELECT_DESCRIPTORS_ENHANCED_MODE
     /* if is an ethernet-type frame, and IP frame payload error occurred */
-    if(((uint32_t)RESET) != (dma_current_rxdesc->status & ENET_RDES0_FRMT) &&
-            ((uint32_t)RESET) != (dma_current_rxdesc->extended_status & ENET_RDES4_IPPLDERR)) {
+    if(((uint32_t)RESET) != (handle->rxdesc_current->status & ENET_RDES0_FRMT) &&
+            ((uint32_t)RESET) != (handle->rxdesc_current->extended_status & ENET_RDES4_IPPLDERR)) {
         /* drop current receive frame */
-        enet_rxframe_drop(enet_periph);
+        enet_handle_rxframe_drop(handle);
 
         return 1U;
     }
@@ -699,7 +774,7 @@ uint32_t enet_rxframe_size_get(uint32_t enet_periph)
     if((((uint32_t)RESET) != (status & ENET_RDES0_FRMT)) &&
             (((uint32_t)RESET) != (status & ENET_RDES0_PCERR))) {
         /* drop current receive frame */
-        enet_rxframe_drop(enet_periph);
+        enet_handle_rxframe_drop(handle);
 
         return 1U;
     }
@@ -720,7 +795,7 @@ uint32_t enet_rxframe_size_get(uint32_t enet_periph)
         }
     } else {
         enet_unknow_err++;
-        enet_rxframe_drop(enet_periph);
+        enet_handle_rxframe_drop(handle);
 
         return 1U;
     }
@@ -730,8 +805,19 @@ uint32_t enet_rxframe_size_get(uint32_t enet_periph)
 }
 
 /*!
-    \brief      initialize the DMA Tx/Rx descriptors's parameters in chain mode
+    \brief      check receive frame valid and return frame size
     \param[in]  enet_periph: ENETx(x=0,1)
+    \param[out] none
+    \retval     size of received frame: 0x0 - 0x3FFF
+*/
+uint32_t enet_rxframe_size_get(uint32_t enet_periph)
+{
+    return enet_handle_rxframe_size_get(enet_handle_get(enet_periph));
+}
+
+/*!
+    \brief      initialize the DMA Tx/Rx descriptors's parameters in chain mode
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
     \param[in]  direction: the descriptors which users want to init, refer to enet_dmadirection_enum,
                 only one parameter can be selected which is shown as below
       \arg        ENET_DMA_TX: DMA Tx descriptors
@@ -739,18 +825,19 @@ uint32_t enet_rxframe_size_get(uint32_t enet_periph)
     \param[out] none
     \retval     none
 */
-void enet_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum direction)
+void enet_handle_descriptors_chain_init(enet_handle_struct *handle, enet_dmadirection_enum direction)
 {
     uint32_t num = 0U, count = 0U, maxsize = 0U;
     uint32_t desc_status = 0U, desc_bufsize = 0U;
     enet_descriptors_struct *desc, *desc_tab;
     uint8_t *buf;
+    uint32_t enet_periph = handle->periph;
 
     /* if want to initialize DMA Tx descriptors */
     if(ENET_DMA_TX == direction) {
         /* save a copy of the DMA Tx descriptors */
-        desc_tab = txdesc_tab;
-        buf = &tx_buff[0][0];
+        desc_tab = handle->txdesc_tab;
+        buf = &handle->tx_buff[0][0];
         count = ENET_TXBUF_NUM;
         maxsize = ENET_TXBUF_SIZE;
 
@@ -759,12 +846,12 @@ void enet_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum di
 
         /* configure DMA Tx descriptor table address register */
         ENET_DMA_TDTADDR(enet_periph) = (uint32_t)desc_tab;
-        dma_current_txdesc = desc_tab;
+        handle->txdesc_current = desc_tab;
     } else {
         /* if want to initialize DMA Rx descriptors */
         /* save a copy of the DMA Rx descriptors */
-        desc_tab = rxdesc_tab;
-        buf = &rx_buff[0][0];
+        desc_tab = handle->rxdesc_tab;
+        buf = (NULL != handle->rx_buff) ? &handle->rx_buff[0][0] : NULL;
         count = ENET_RXBUF_NUM;
         maxsize = ENET_RXBUF_SIZE;
 
@@ -775,10 +862,10 @@ void enet_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum di
 
         /* configure DMA Rx descriptor table address register */
         ENET_DMA_RDTADDR(enet_periph) = (uint32_t)desc_tab;
-        dma_current_rxdesc = desc_tab;
+        handle->rxdesc_current = desc_tab;
     }
-    dma_current_ptp_rxdesc = NULL;
-    dma_current_ptp_txdesc = NULL;
+    handle->ptp_rxdesc_current = NULL;
+    handle->ptp_txdesc_current = NULL;
 
     /* configure each descriptor */
     for(num = 0U; num < count; num++) {
@@ -788,7 +875,7 @@ void enet_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum di
         /* configure descriptors */
         desc->status = desc_status;
         desc->control_buffer_size = desc_bufsize;
-        desc->buffer1_addr = (uint32_t)(&buf[num * maxsize]);
+        desc->buffer1_addr = (NULL != buf) ? (uint32_t)(&buf[num * maxsize]) : 0U;
 
         /* if is not the last descriptor */
         if(num < (count - 1U)) {
@@ -803,7 +890,7 @@ void enet_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum di
 }
 
 /*!
-    \brief      initialize the DMA Tx/Rx descriptors's parameters in ring mode
+    \brief      initialize the DMA Tx/Rx descriptors's parameters in chain mode
     \param[in]  enet_periph: ENETx(x=0,1)
     \param[in]  direction: the descriptors which users want to init, refer to enet_dmadirection_enum,
                 only one parameter can be selected which is shown as below
@@ -812,13 +899,29 @@ void enet_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum di
     \param[out] none
     \retval     none
 */
-void enet_descriptors_ring_init(uint32_t enet_periph, enet_dmadirection_enum direction)
+void enet_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum direction)
+{
+    enet_handle_descriptors_chain_init(enet_handle_get(enet_periph), direction);
+}
+
+/*!
+    \brief      initialize the DMA Tx/Rx descriptors's parameters in ring mode
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
+    \param[in]  direction: the descriptors which users want to init, refer to enet_dmadirection_enum,
+                only one parameter can be selected which is shown as below
+      \arg        ENET_DMA_TX: DMA Tx descriptors
+      \arg        ENET_DMA_RX: DMA Rx descriptors
+    \param[out] none
+    \retval     none
+*/
+void enet_handle_descriptors_ring_init(enet_handle_struct *handle, enet_dmadirection_enum direction)
 {
     uint32_t num = 0U, count = 0U, maxsize = 0U;
     uint32_t desc_status = 0U, desc_bufsize = 0U;
     enet_descriptors_struct *desc;
     enet_descriptors_struct *desc_tab;
     uint8_t *buf;
+    uint32_t enet_periph = handle->periph;
 
     /* configure descriptor skip length */
     ENET_DMA_BCTL(enet_periph) &= ~ENET_DMA_BCTL_DPSL;
@@ -827,19 +930,19 @@ void enet_descriptors_ring_init(uint32_t enet_periph, enet_dmadirection_enum dir
     /* if want to initialize DMA Tx descriptors */
     if(ENET_DMA_TX == direction) {
         /* save a copy of the DMA Tx descriptors */
-        desc_tab = txdesc_tab;
-        buf = &tx_buff[0][0];
+        desc_tab = handle->txdesc_tab;
+        buf = &handle->tx_buff[0][0];
         count = ENET_TXBUF_NUM;
         maxsize = ENET_TXBUF_SIZE;
 
         /* configure DMA Tx descriptor table address register */
         ENET_DMA_TDTADDR(enet_periph) = (uint32_t)desc_tab;
-        dma_current_txdesc = desc_tab;
+        handle->txdesc_current = desc_tab;
     } else {
         /* if want to initialize DMA Rx descriptors */
         /* save a copy of the DMA Rx descriptors */
-        desc_tab = rxdesc_tab;
-        buf = &rx_buff[0][0];
+        desc_tab = handle->rxdesc_tab;
+        buf = (NULL != handle->rx_buff) ? &handle->rx_buff[0][0] : NULL;
         count = ENET_RXBUF_NUM;
         maxsize = ENET_RXBUF_SIZE;
 
@@ -850,10 +953,10 @@ void enet_descriptors_ring_init(uint32_t enet_periph, enet_dmadirection_enum dir
 
         /* configure DMA Rx descriptor table address register */
         ENET_DMA_RDTADDR(enet_periph) = (uint32_t)desc_tab;
-        dma_current_rxdesc = desc_tab;
+        handle->rxdesc_current = desc_tab;
     }
-    dma_current_ptp_rxdesc = NULL;
-    dma_current_ptp_txdesc = NULL;
+    handle->ptp_rxdesc_current = NULL;
+    handle->ptp_txdesc_current = NULL;
 
     /* configure each descriptor */
     for(num = 0U; num < count; num++) {
@@ -863,7 +966,7 @@ void enet_descriptors_ring_init(uint32_t enet_periph, enet_dmadirection_enum dir
         /* configure descriptors */
         desc->status = desc_status;
         desc->control_buffer_size = desc_bufsize;
-        desc->buffer1_addr = (uint32_t)(&buf[num * maxsize]);
+        desc->buffer1_addr = (NULL != buf) ? (uint32_t)(&buf[num * maxsize]) : 0U;
 
         /* when it is the last descriptor */
         if(num == (count - 1U)) {
@@ -879,34 +982,50 @@ void enet_descriptors_ring_init(uint32_t enet_periph, enet_dmadirection_enum dir
 }
 
 /*!
-    \brief      handle current received frame data to application buffer
+    \brief      initialize the DMA Tx/Rx descriptors's parameters in ring mode
     \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  direction: the descriptors which users want to init, refer to enet_dmadirection_enum,
+                only one parameter can be selected which is shown as below
+      \arg        ENET_DMA_TX: DMA Tx descriptors
+      \arg        ENET_DMA_RX: DMA Rx descriptors
+    \param[out] none
+    \retval     none
+*/
+void enet_descriptors_ring_init(uint32_t enet_periph, enet_dmadirection_enum direction)
+{
+    enet_handle_descriptors_ring_init(enet_handle_get(enet_periph), direction);
+}
+
+/*!
+    \brief      handle current received frame data to application buffer
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
     \param[in]  bufsize: the size of buffer which is the parameter in function
     \param[out] buffer: pointer to the received frame data
                 note -- if the input is NULL, user should copy data in application by himself
     \retval     ErrStatus: SUCCESS or ERROR
 */
-ErrStatus enet_frame_receive(uint32_t enet_periph, uint8_t buffer[], uint32_t bufsize)
+ErrStatus enet_handle_frame_receive(enet_handle_struct *handle, uint8_t buffer[], uint32_t bufsize)
 {
-    uint32_t offset = 0U, size = 0U;
+    uint32_t size = 0U;
+    uint32_t enet_periph = handle->periph;
 
     /* the descriptor is busy due to own by the DMA */
-    if((uint32_t)RESET != (dma_current_rxdesc->status & ENET_RDES0_DAV)) {
+    if((uint32_t)RESET != (handle->rxdesc_current->status & ENET_RDES0_DAV)) {
         return ERROR;
     }
 
     /* if buffer pointer is null, indicates that users has copied data in application */
     if(NULL != buffer) {
         /* if no error occurs, and the frame uses only one descriptor */
-        if((((uint32_t)RESET) == (dma_current_rxdesc->status & ENET_RDES0_ERRS)) &&
-                (((uint32_t)RESET) != (dma_current_rxdesc->status & ENET_RDES0_LDES)) &&
-                (((uint32_t)RESET) != (dma_current_rxdesc->status & ENET_RDES0_FDES))) {
+        if((((uint32_t)RESET) == (handle->rxdesc_current->status & ENET_RDES0_ERRS)) &&
+                (((uint32_t)RESET) != (handle->rxdesc_current->status & ENET_RDES0_LDES)) &&
+                (((uint32_t)RESET) != (handle->rxdesc_current->status & ENET_RDES0_FDES))) {
             /* get the frame length except CRC */
-            size = GET_RDES0_FRML(dma_current_rxdesc->status);
+            size = GET_RDES0_FRML(handle->rxdesc_current->status);
             size = size - 4U;
 
             /* if is a type frame, and CRC is not included in forwarding frame */
-            if((RESET != (ENET_MAC_CFG(enet_periph) & ENET_MAC_CFG_TFCD)) && (RESET != (dma_current_rxdesc->status & ENET_RDES0_FRMT))) {
+            if((RESET != (ENET_MAC_CFG(enet_periph) & ENET_MAC_CFG_TFCD)) && (RESET != (handle->rxdesc_current->status & ENET_RDES0_FRMT))) {
                 size = size + 4U;
             }
 
@@ -916,9 +1035,7 @@ ErrStatus enet_frame_receive(uint32_t enet_periph, uint8_t buffer[], uint32_t bu
             }
 
             /* copy data from Rx buffer to application buffer */
-            for(offset = 0U; offset < size; offset++) {
-                (*(buffer + offset)) = (*(__IO uint8_t *)(uint32_t)((dma_current_rxdesc->buffer1_addr) + offset));
-            }
+            enet_frame_copy(buffer, (const uint8_t *)(handle->rxdesc_current->buffer1_addr), size);
 
         } else {
             /* return ERROR */
@@ -926,7 +1043,7 @@ ErrStatus enet_frame_receive(uint32_t enet_periph, uint8_t buffer[], uint32_t bu
         }
     }
     /* enable reception, descriptor is owned by DMA */
-    dma_current_rxdesc->status = ENET_RDES0_DAV;
+    handle->rxdesc_current->status = ENET_RDES0_DAV;
 
     /* check Rx buffer unavailable flag status */
     if((uint32_t)RESET != (ENET_DMA_STAT(enet_periph) & ENET_DMA_STAT_RBU)) {
@@ -938,39 +1055,55 @@ ErrStatus enet_frame_receive(uint32_t enet_periph, uint8_t buffer[], uint32_t bu
 
     /* update the current RxDMA descriptor pointer to the next decriptor in RxDMA decriptor table */
     /* chained mode */
-    if((uint32_t)RESET != (dma_current_rxdesc->control_buffer_size & ENET_RDES1_RCHM)) {
-        dma_current_rxdesc = (enet_descriptors_struct *)(dma_current_rxdesc->buffer2_next_desc_addr);
+    if((uint32_t)RESET != (handle->rxdesc_current->control_buffer_size & ENET_RDES1_RCHM)) {
+        handle->rxdesc_current = (enet_descriptors_struct *)(handle->rxdesc_current->buffer2_next_desc_addr);
     } else {
         /* ring mode */
-        if((uint32_t)RESET != (dma_current_rxdesc->control_buffer_size & ENET_RDES1_RERM)) {
+        if((uint32_t)RESET != (handle->rxdesc_current->control_buffer_size & ENET_RDES1_RERM)) {
             /* if is the last descriptor in table, the next descriptor is the table header */
-            dma_current_rxdesc = (enet_descriptors_struct *)(ENET_DMA_RDTADDR(enet_periph));
+            handle->rxdesc_current = (enet_descriptors_struct *)(ENET_DMA_RDTADDR(enet_periph));
         } else {
             /* the next descriptor is the current address, add the descriptor size, and descriptor skip length */
-            dma_current_rxdesc = (enet_descriptors_struct *)(uint32_t)((uint32_t)dma_current_rxdesc + ETH_DMARXDESC_SIZE + (GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(
+            handle->rxdesc_current = (enet_descriptors_struct *)(uint32_t)((uint32_t)handle->rxdesc_current + ETH_DMARXDESC_SIZE + (GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(
                                      enet_periph))));
         }
     }
 
+    handle->stats.rx_frames++;
+
     return SUCCESS;
 }
 
 /*!
-    \brief      handle application buffer data to transmit it
+    \brief      handle current received frame data to application buffer
     \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  bufsize: the size of buffer which is the parameter in function
+    \param[out] buffer: pointer to the received frame data
+                note -- if the input is NULL, user should copy data in application by himself
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+ErrStatus enet_frame_receive(uint32_t enet_periph, uint8_t buffer[], uint32_t bufsize)
+{
+    return enet_handle_frame_receive(enet_handle_get(enet_periph), buffer, bufsize);
+}
+
+/*!
+    \brief      handle application buffer data to transmit it
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
     \param[in]  buffer: pointer to the frame data to be transmitted,
                 note -- if the input is NULL, user should handle the data in application by himself
     \param[in]  length: the length of frame data to be transmitted
     \param[out] none
     \retval     ErrStatus: SUCCESS or ERROR
 */
-ErrStatus enet_frame_transmit(uint32_t enet_periph, uint8_t buffer[], uint32_t length)
+ErrStatus enet_handle_frame_transmit(enet_handle_struct *handle, uint8_t buffer[], uint32_t length)
 {
-    uint32_t offset = 0U;
     uint32_t dma_tbu_flag, dma_tu_flag;
+    uint32_t enet_periph = handle->periph;
 
     /* the descriptor is busy due to own by the DMA */
-    if((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_DAV)) {
+    if((uint32_t)RESET != (handle->txdesc_current->status & ENET_TDES0_DAV)) {
+        handle->stats.tx_busy++;
         return ERROR;
     }
 
@@ -982,17 +1115,15 @@ ErrStatus enet_frame_transmit(uint32_t enet_periph, uint8_t buffer[], uint32_t l
     /* if buffer pointer is null, indicates that users has handled data in application */
     if(NULL != buffer) {
         /* copy frame data from application buffer to Tx buffer */
-        for(offset = 0U; offset < length; offset++) {
-            (*(__IO uint8_t *)(uint32_t)((dma_current_txdesc->buffer1_addr) + offset)) = (*(buffer + offset));
-        }
+        enet_frame_copy((uint8_t *)(handle->txdesc_current->buffer1_addr), buffer, length);
     }
 
     /* set the frame length */
-    dma_current_txdesc->control_buffer_size = length;
+    handle->txdesc_current->control_buffer_size = length;
     /* set the segment of frame, frame is transmitted in one descriptor */
-    dma_current_txdesc->status |= ENET_TDES0_LSG | ENET_TDES0_FSG;
+    handle->txdesc_current->status |= ENET_TDES0_LSG | ENET_TDES0_FSG;
     /* enable the DMA transmission */
-    dma_current_txdesc->status |= ENET_TDES0_DAV;
+    handle->txdesc_current->status |= ENET_TDES0_DAV;
 
     /* check Tx buffer unavailable flag status */
     dma_tbu_flag = (ENET_DMA_STAT(enet_periph) & ENET_DMA_STAT_TBU);
@@ -1007,23 +1138,176 @@ ErrStatus enet_frame_transmit(uint32_t enet_periph, uint8_t buffer[], uint32_t l
 
     /* update the current TxDMA descriptor pointer to the next decriptor in TxDMA decriptor table*/
     /* chained mode */
-    if((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_TCHM)) {
-        dma_current_txdesc = (enet_descriptors_struct *)(dma_current_txdesc->buffer2_next_desc_addr);
+    if((uint32_t)RESET != (handle->txdesc_current->status & ENET_TDES0_TCHM)) {
+        handle->txdesc_current = (enet_descriptors_struct *)(handle->txdesc_current->buffer2_next_desc_addr);
     } else {
         /* ring mode */
-        if((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_TERM)) {
+        if((uint32_t)RESET != (handle->txdesc_current->status & ENET_TDES0_TERM)) {
             /* if is the last descriptor in table, the next descriptor is the table header */
-            dma_current_txdesc = (enet_descriptors_struct *)(ENET_DMA_TDTADDR(enet_periph));
+            handle->txdesc_current = (enet_descriptors_struct *)(ENET_DMA_TDTADDR(enet_periph));
         } else {
             /* the next descriptor is the current address, add the descriptor size, and descriptor skip length */
-            dma_current_txdesc = (enet_descriptors_struct *)(uint32_t)((uint32_t)dma_current_txdesc + ETH_DMATXDESC_SIZE + (GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(
+            handle->txdesc_current = (enet_descriptors_struct *)(uint32_t)((uint32_t)handle->txdesc_current + ETH_DMATXDESC_SIZE + (GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(
                                      enet_periph))));
         }
     }
 
+    handle->stats.tx_frames++;
+
+    return SUCCESS;
+}
+
+/*!
+    \brief      handle application buffer data to transmit it
+    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  buffer: pointer to the frame data to be transmitted,
+                note -- if the input is NULL, user should handle the data in application by himself
+    \param[in]  length: the length of frame data to be transmitted
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+ErrStatus enet_frame_transmit(uint32_t enet_periph, uint8_t buffer[], uint32_t length)
+{
+    return enet_handle_frame_transmit(enet_handle_get(enet_periph), buffer, length);
+}
+
+/*!
+    \brief      hand a frame made of several buffer segments to the TxDMA, without data copy
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
+    \param[in]  segment: the buffer segments of the frame in transmit order, refer to enet_frame_segment_struct
+                note -- the buffers must stay valid and unmodified until the DMA releases the descriptors,
+                        and the data must already be visible to the DMA (D-Cache cleaned or non-cacheable)
+    \param[in]  num: the number of buffer segments, no more than the TxDMA descriptors in chain mode
+                     or twice the TxDMA descriptors in ring mode
+    \param[out] last_desc: the last descriptor used by the frame, the DMA has finished with the
+                           frame once its ENET_TDES0_DAV bit is cleared, NULL if not needed
+    \retval     ErrStatus: SUCCESS or ERROR
+                note -- ERROR is returned at once without waiting if the descriptors are still owned by the DMA,
+                        the buffer address of the used descriptors are overwritten, so the tx_buff based
+                        enet_frame_transmit() should not be used on the same descriptor table afterwards
+*/
+ErrStatus enet_handle_frame_segments_transmit(enet_handle_struct *handle, enet_frame_segment_struct segment[], uint32_t num,
+                                              enet_descriptors_struct **last_desc)
+{
+    enet_descriptors_struct *first, *desc;
+    uint32_t desc_num, length = 0U;
+    uint32_t i, index;
+    uint32_t dma_tbu_flag, dma_tu_flag;
+    uint32_t enet_periph = handle->periph;
+
+    if((NULL == segment) || (0U == num)) {
+        return ERROR;
+    }
+
+    /* only frame length no more than ENET_MAX_FRAME_SIZE is allowed */
+    for(i = 0U; i < num; i++) {
+        if((0U == segment[i].length) || (segment[i].length > ENET_TDES1_TB1S)) {
+            return ERROR;
+        }
+        length += segment[i].length;
+    }
+    if(length > ENET_MAX_FRAME_SIZE) {
+        return ERROR;
+    }
+
+    /* chained mode carries one segment per descriptor, ring mode carries buffer1 and buffer2 */
+    if((uint32_t)RESET != (handle->txdesc_current->status & ENET_TDES0_TCHM)) {
+        desc_num = num;
+    } else {
+        desc_num = (num + 1U) >> 1U;
+    }
+
+    /* all the descriptors of the frame must be released by the DMA */
+    desc = handle->txdesc_current;
+    for(i = 0U; i < desc_num; i++) {
+        if((uint32_t)RESET != (desc->status & ENET_TDES0_DAV)) {
+            handle->stats.tx_busy++;
+            return ERROR;
+        }
+        desc = enet_txdesc_next_get(enet_periph, desc);
+        /* the frame wraps onto its own first descriptor */
+        if((desc == handle->txdesc_current) && ((i + 1U) < desc_num)) {
+            return ERROR;
+        }
+    }
+
+    /* fill the descriptors, the first descriptor is handed to the DMA at last */
+    first = handle->txdesc_current;
+    desc = first;
+    index = 0U;
+    for(i = 0U; i < desc_num; i++) {
+        desc->status &= ~(ENET_TDES0_FSG | ENET_TDES0_LSG | ENET_TDES0_INTC);
+        desc->buffer1_addr = segment[index].buffer_addr;
+        desc->control_buffer_size = TDES1_TB1S(segment[index].length);
+        index++;
+
+        /* ring mode, buffer2 carries the next segment */
+        if(((uint32_t)RESET == (desc->status & ENET_TDES0_TCHM)) && (index < num)) {
+            desc->buffer2_next_desc_addr = segment[index].buffer_addr;
+            desc->control_buffer_size |= TDES1_TB2S(segment[index].length);
+            index++;
+        }
+
+        if(desc == first) {
+            desc->status |= ENET_TDES0_FSG;
+        }
+        if(index == num) {
+            desc->status |= ENET_TDES0_LSG | ENET_TDES0_INTC;
+            if(NULL != last_desc) {
+                *last_desc = desc;
+            }
+        }
+        if(desc != first) {
+            desc->status |= ENET_TDES0_DAV;
+        }
+        desc = enet_txdesc_next_get(enet_periph, desc);
+    }
+
+    /* make sure the following descriptors are written before the DMA sees the first one */
+    __DMB();
+    first->status |= ENET_TDES0_DAV;
+    __DSB();
+
+    /* check Tx buffer unavailable flag status */
+    dma_tbu_flag = (ENET_DMA_STAT(enet_periph) & ENET_DMA_STAT_TBU);
+    dma_tu_flag = (ENET_DMA_STAT(enet_periph) & ENET_DMA_STAT_TU);
+
+    if((RESET != dma_tbu_flag) || (RESET != dma_tu_flag)) {
+        /* clear TBU and TU flag */
+        ENET_DMA_STAT(enet_periph) = (dma_tbu_flag | dma_tu_flag);
+        /* resume DMA transmission by writing to the TPEN register*/
+        ENET_DMA_TPEN(enet_periph) = 0U;
+    }
+
+    /* update the current TxDMA descriptor pointer to the descriptor after the frame */
+    handle->txdesc_current = desc;
+
+    handle->stats.tx_frames++;
+
     return SUCCESS;
 }
 
+/*!
+    \brief      hand a frame made of several buffer segments to the TxDMA, without data copy
+    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  segment: the buffer segments of the frame in transmit order, refer to enet_frame_segment_struct
+                note -- the buffers must stay valid and unmodified until the DMA releases the descriptors,
+                        and the data must already be visible to the DMA (D-Cache cleaned or non-cacheable)
+    \param[in]  num: the number of buffer segments, no more than the TxDMA descriptors in chain mode
+                     or twice the TxDMA descriptors in ring mode
+    \param[out] last_desc: the last descriptor used by the frame, the DMA has finished with the
+                           frame once its ENET_TDES0_DAV bit is cleared, NULL if not needed
+    \retval     ErrStatus: SUCCESS or ERROR
+                note -- ERROR is returned at once without waiting if the descriptors are still owned by the DMA,
+                        the buffer address of the used descriptors are overwritten, so the tx_buff based
+                        enet_frame_transmit() should not be used on the same descriptor table afterwards
+*/
+ErrStatus enet_frame_segments_transmit(uint32_t enet_periph, enet_frame_segment_struct segment[], uint32_t num,
+                                       enet_descriptors_struct **last_desc)
+{
+    return enet_handle_frame_segments_transmit(enet_handle_get(enet_periph), segment, num, last_desc);
+}
+
 /*!
     \brief      configure the transmit IP frame checksum offload calculation and insertion
     \param[in]  desc: the descriptor pointer which users want to configure
@@ -1737,26 +2021,38 @@ void enet_dmaprocess_resume(uint32_t enet_periph, enet_dmadirection_enum directi
 
 /*!
     \brief      check and recover the Rx process
-    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
     \param[out] none
     \retval     none
 */
-void enet_rxprocess_check_recovery(uint32_t enet_periph)
+void enet_handle_rxprocess_check_recovery(enet_handle_struct *handle)
 {
     uint32_t status;
+    uint32_t enet_periph = handle->periph;
 
     /* get DAV information of current RxDMA descriptor */
-    status = dma_current_rxdesc->status;
+    status = handle->rxdesc_current->status;
     status &= ENET_RDES0_DAV;
 
     /* if current descriptor is owned by DMA, but the descriptor address mismatches with
     receive descriptor address pointer updated by RxDMA controller */
-    if((ENET_DMA_CRDADDR(enet_periph) != ((uint32_t)dma_current_rxdesc)) &&
+    if((ENET_DMA_CRDADDR(enet_periph) != ((uint32_t)handle->rxdesc_current)) &&
             (ENET_RDES0_DAV == status)) {
-        dma_current_rxdesc = (enet_descriptors_struct *)ENET_DMA_CRDADDR(enet_periph);
+        handle->rxdesc_current = (enet_descriptors_struct *)ENET_DMA_CRDADDR(enet_periph);
     }
 }
 
+/*!
+    \brief      check and recover the Rx process
+    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[out] none
+    \retval     none
+*/
+void enet_rxprocess_check_recovery(uint32_t enet_periph)
+{
+    enet_handle_rxprocess_check_recovery(enet_handle_get(enet_periph));
+}
+
 /*!
     \brief      flush the ENET transmit FIFO, and wait until the flush operation completes
     \param[in]  enet_periph: ENETx(x=0,1)
@@ -2018,50 +2314,66 @@ void enet_rx_desc_delay_receive_complete_interrupt(uint32_t enet_periph, enet_de
 
 /*!
     \brief      drop current receive frame
-    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
     \param[out] none
     \retval     none
 */
-void enet_rxframe_drop(uint32_t enet_periph)
+void enet_handle_rxframe_drop(enet_handle_struct *handle)
 {
+    uint32_t enet_periph = handle->periph;
+
+    /* the frame is dropped */
+    handle->stats.rx_dropped++;
+
     /* enable reception, descriptor is owned by DMA */
-    dma_current_rxdesc->status = ENET_RDES0_DAV;
+    handle->rxdesc_current->status = ENET_RDES0_DAV;
 
     /* chained mode */
-    if((uint32_t)RESET != (dma_current_rxdesc->control_buffer_size & ENET_RDES1_RCHM)) {
-        if(NULL != dma_current_ptp_rxdesc) {
-            dma_current_rxdesc = (enet_descriptors_struct *)(dma_current_ptp_rxdesc->buffer2_next_desc_addr);
+    if((uint32_t)RESET != (handle->rxdesc_current->control_buffer_size & ENET_RDES1_RCHM)) {
+        if(NULL != handle->ptp_rxdesc_current) {
+            handle->rxdesc_current = (enet_descriptors_struct *)(handle->ptp_rxdesc_current->buffer2_next_desc_addr);
             /* if it is the last ptp descriptor */
-            if(0U != dma_current_ptp_rxdesc->status) {
+            if(0U != handle->ptp_rxdesc_current->status) {
                 /* pointer back to the first ptp descriptor address in the desc_ptptab list address */
-                dma_current_ptp_rxdesc = (enet_descriptors_struct *)(dma_current_ptp_rxdesc->status);
+                handle->ptp_rxdesc_current = (enet_descriptors_struct *)(handle->ptp_rxdesc_current->status);
             } else {
                 /* ponter to the next ptp descriptor */
-                dma_current_ptp_rxdesc++;
+                handle->ptp_rxdesc_current++;
             }
         } else {
-            dma_current_rxdesc = (enet_descriptors_struct *)(dma_current_rxdesc->buffer2_next_desc_addr);
+            handle->rxdesc_current = (enet_descriptors_struct *)(handle->rxdesc_current->buffer2_next_desc_addr);
         }
 
     } else {
         /* ring mode */
-        if((uint32_t)RESET != (dma_current_rxdesc->control_buffer_size & ENET_RDES1_RERM)) {
+        if((uint32_t)RESET != (handle->rxdesc_current->control_buffer_size & ENET_RDES1_RERM)) {
             /* if is the last descriptor in table, the next descriptor is the table header */
-            dma_current_rxdesc = (enet_descriptors_struct *)(ENET_DMA_RDTADDR(enet_periph));
-            if(NULL != dma_current_ptp_rxdesc) {
-                dma_current_ptp_rxdesc = (enet_descriptors_struct *)(dma_current_ptp_rxdesc->status);
+            handle->rxdesc_current = (enet_descriptors_struct *)(ENET_DMA_RDTADDR(enet_periph));
+            if(NULL != handle->ptp_rxdesc_current) {
+                handle->ptp_rxdesc_current = (enet_descriptors_struct *)(handle->ptp_rxdesc_current->status);
             }
         } else {
             /* the next descriptor is the current address, add the descriptor size, and descriptor skip length */
-            dma_current_rxdesc = (enet_descriptors_struct *)(uint32_t)((uint32_t)dma_current_rxdesc + ETH_DMARXDESC_SIZE + GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(
+            handle->rxdesc_current = (enet_descriptors_struct *)(uint32_t)((uint32_t)handle->rxdesc_current + ETH_DMARXDESC_SIZE + GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(
                                      enet_periph)));
-            if(NULL != dma_current_ptp_rxdesc) {
-                dma_current_ptp_rxdesc++;
+            if(NULL != handle->ptp_rxdesc_current) {
+                handle->ptp_rxdesc_current++;
             }
         }
     }
 }
 
+/*!
+    \brief      drop current receive frame
+    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[out] none
+    \retval     none
+*/
+void enet_rxframe_drop(uint32_t enet_periph)
+{
+    enet_handle_rxframe_drop(enet_handle_get(enet_periph));
+}
+
 /*!
     \brief      enable DMA feature
     \param[in]  enet_periph: ENETx(x=0,1)
@@ -2145,7 +2457,7 @@ void enet_desc_select_enhanced_mode(uint32_t enet_periph)
 
 /*!
     \brief      initialize the DMA Tx/Rx descriptors's parameters in enhanced chain mode with ptp function
-    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
     \param[in]  direction: the descriptors which users want to init, refer to enet_dmadirection_enum,
                 only one parameter can be selected which is shown as below
       \arg        ENET_DMA_TX: DMA Tx descriptors
@@ -2153,18 +2465,19 @@ void enet_desc_select_enhanced_mode(uint32_t enet_periph)
     \param[out] none
     \retval     none
 */
-void enet_ptp_enhanced_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum direction)
+void enet_handle_ptp_enhanced_descriptors_chain_init(enet_handle_struct *handle, enet_dmadirection_enum direction)
 {
     uint32_t num = 0U, count = 0U, maxsize = 0U;
     uint32_t desc_status = 0U, desc_bufsize = 0U;
     enet_descriptors_struct *desc, *desc_tab;
     uint8_t *buf;
+    uint32_t enet_periph = handle->periph;
 
     /* if want to initialize DMA Tx descriptors */
     if(ENET_DMA_TX == direction) {
         /* save a copy of the DMA Tx descriptors */
-        desc_tab = txdesc_tab;
-        buf = &tx_buff[0][0];
+        desc_tab = handle->txdesc_tab;
+        buf = &handle->tx_buff[0][0];
         count = ENET_TXBUF_NUM;
         maxsize = ENET_TXBUF_SIZE;
 
@@ -2173,12 +2486,12 @@ void enet_ptp_enhanced_descriptors_chain_init(uint32_t enet_periph, enet_dmadire
 
         /* configure DMA Tx descriptor table address register */
         ENET_DMA_TDTADDR(enet_periph) = (uint32_t)desc_tab;
-        dma_current_txdesc = desc_tab;
+        handle->txdesc_current = desc_tab;
     } else {
         /* if want to initialize DMA Rx descriptors */
         /* save a copy of the DMA Rx descriptors */
-        desc_tab = rxdesc_tab;
-        buf = &rx_buff[0][0];
+        desc_tab = handle->rxdesc_tab;
+        buf = (NULL != handle->rx_buff) ? &handle->rx_buff[0][0] : NULL;
         count = ENET_RXBUF_NUM;
         maxsize = ENET_RXBUF_SIZE;
 
@@ -2189,7 +2502,7 @@ void enet_ptp_enhanced_descriptors_chain_init(uint32_t enet_periph, enet_dmadire
 
         /* configure DMA Rx descriptor table address register */
         ENET_DMA_RDTADDR(enet_periph) = (uint32_t)desc_tab;
-        dma_current_rxdesc = desc_tab;
+        handle->rxdesc_current = desc_tab;
     }
 
     /* configuration each descriptor */
@@ -2200,7 +2513,7 @@ void enet_ptp_enhanced_descriptors_chain_init(uint32_t enet_periph, enet_dmadire
         /* configure descriptors */
         desc->status = desc_status;
         desc->control_buffer_size = desc_bufsize;
-        desc->buffer1_addr = (uint32_t)(&buf[num * maxsize]);
+        desc->buffer1_addr = (NULL != buf) ? (uint32_t)(&buf[num * maxsize]) : 0U;
 
         /* if is not the last descriptor */
         if(num < (count - 1U)) {
@@ -2215,7 +2528,7 @@ void enet_ptp_enhanced_descriptors_chain_init(uint32_t enet_periph, enet_dmadire
 }
 
 /*!
-    \brief      initialize the DMA Tx/Rx descriptors's parameters in enhanced ring mode with ptp function
+    \brief      initialize the DMA Tx/Rx descriptors's parameters in enhanced chain mode with ptp function
     \param[in]  enet_periph: ENETx(x=0,1)
     \param[in]  direction: the descriptors which users want to init, refer to enet_dmadirection_enum,
                 only one parameter can be selected which is shown as below
@@ -2224,13 +2537,29 @@ void enet_ptp_enhanced_descriptors_chain_init(uint32_t enet_periph, enet_dmadire
     \param[out] none
     \retval     none
 */
-void enet_ptp_enhanced_descriptors_ring_init(uint32_t enet_periph, enet_dmadirection_enum direction)
+void enet_ptp_enhanced_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum direction)
+{
+    enet_handle_ptp_enhanced_descriptors_chain_init(enet_handle_get(enet_periph), direction);
+}
+
+/*!
+    \brief      initialize the DMA Tx/Rx descriptors's parameters in enhanced ring mode with ptp function
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
+    \param[in]  direction: the descriptors which users want to init, refer to enet_dmadirection_enum,
+                only one parameter can be selected which is shown as below
+      \arg        ENET_DMA_TX: DMA Tx descriptors
+      \arg        ENET_DMA_RX: DMA Rx descriptors
+    \param[out] none
+    \retval     none
+*/
+void enet_handle_ptp_enhanced_descriptors_ring_init(enet_handle_struct *handle, enet_dmadirection_enum direction)
 {
     uint32_t num = 0U, count = 0U, maxsize = 0U;
     uint32_t desc_status = 0U, desc_bufsize = 0U;
     enet_descriptors_struct *desc;
     enet_descriptors_struct *desc_tab;
     uint8_t *buf;
+    uint32_t enet_periph = handle->periph;
 
     /* configure descriptor skip length */
     ENET_DMA_BCTL(enet_periph) &= ~ENET_DMA_BCTL_DPSL;
@@ -2239,8 +2568,8 @@ void enet_ptp_enhanced_descriptors_ring_init(uint32_t enet_periph, enet_dmadirec
     /* if want to initialize DMA Tx descriptors */
     if(ENET_DMA_TX == direction) {
         /* save a copy of the DMA Tx descriptors */
-        desc_tab = txdesc_tab;
-        buf = &tx_buff[0][0];
+        desc_tab = handle->txdesc_tab;
+        buf = &handle->tx_buff[0][0];
         count = ENET_TXBUF_NUM;
         maxsize = ENET_TXBUF_SIZE;
 
@@ -2249,12 +2578,12 @@ void enet_ptp_enhanced_descriptors_ring_init(uint32_t enet_periph, enet_dmadirec
 
         /* configure DMA Tx descriptor table address register */
         ENET_DMA_TDTADDR(enet_periph) = (uint32_t)desc_tab;
-        dma_current_txdesc = desc_tab;
+        handle->txdesc_current = desc_tab;
     } else {
         /* if want to initialize DMA Rx descriptors */
         /* save a copy of the DMA Rx descriptors */
-        desc_tab = rxdesc_tab;
-        buf = &rx_buff[0][0];
+        desc_tab = handle->rxdesc_tab;
+        buf = (NULL != handle->rx_buff) ? &handle->rx_buff[0][0] : NULL;
         count = ENET_RXBUF_NUM;
         maxsize = ENET_RXBUF_SIZE;
 
@@ -2265,7 +2594,7 @@ void enet_ptp_enhanced_descriptors_ring_init(uint32_t enet_periph, enet_dmadirec
 
         /* configure DMA Rx descriptor table address register */
         ENET_DMA_RDTADDR(enet_periph) = (uint32_t)desc_tab;
-        dma_current_rxdesc = desc_tab;
+        handle->rxdesc_current = desc_tab;
     }
 
     /* configure each descriptor */
@@ -2276,7 +2605,7 @@ void enet_ptp_enhanced_descriptors_ring_init(uint32_t enet_periph, enet_dmadirec
         /* configure descriptors */
         desc->status = desc_status;
         desc->control_buffer_size = desc_bufsize;
-        desc->buffer1_addr = (uint32_t)(&buf[num * maxsize]);
+        desc->buffer1_addr = (NULL != buf) ? (uint32_t)(&buf[num * maxsize]) : 0U;
 
         /* when it is the last descriptor */
         if(num == (count - 1U)) {
@@ -2292,8 +2621,23 @@ void enet_ptp_enhanced_descriptors_ring_init(uint32_t enet_periph, enet_dmadirec
 }
 
 /*!
-    \brief      receive a packet data with timestamp values to application buffer, when the DMA is in enhanced mode
+    \brief      initialize the DMA Tx/Rx descriptors's parameters in enhanced ring mode with ptp function
     \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  direction: the descriptors which users want to init, refer to enet_dmadirection_enum,
+                only one parameter can be selected which is shown as below
+      \arg        ENET_DMA_TX: DMA Tx descriptors
+      \arg        ENET_DMA_RX: DMA Rx descriptors
+    \param[out] none
+    \retval     none
+*/
+void enet_ptp_enhanced_descriptors_ring_init(uint32_t enet_periph, enet_dmadirection_enum direction)
+{
+    enet_handle_ptp_enhanced_descriptors_ring_init(enet_handle_get(enet_periph), direction);
+}
+
+/*!
+    \brief      receive a packet data with timestamp values to application buffer, when the DMA is in enhanced mode
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
     \param[in]  bufsize: the size of buffer which is the parameter in function
     \param[out] buffer: pointer to the application buffer
                 note -- if the input is NULL, user should copy data in application by himself
@@ -2301,28 +2645,29 @@ void enet_ptp_enhanced_descriptors_ring_init(uint32_t enet_periph, enet_dmadirec
                 note -- if the input is NULL, timestamp is ignored
     \retval     ErrStatus: SUCCESS or ERROR
 */
-ErrStatus enet_ptpframe_receive_enhanced_mode(uint32_t enet_periph, uint8_t buffer[], uint32_t bufsize, uint32_t timestamp[])
+ErrStatus enet_handle_ptpframe_receive_enhanced_mode(enet_handle_struct *handle, uint8_t buffer[], uint32_t bufsize, uint32_t timestamp[])
 {
-    uint32_t offset = 0U, size = 0U;
+    uint32_t size = 0U;
     uint32_t timeout = 0U;
     uint32_t rdes0_tsv_flag;
+    uint32_t enet_periph = handle->periph;
 
     /* the descriptor is busy due to own by the DMA */
-    if((uint32_t)RESET != (dma_current_rxdesc->status & ENET_RDES0_DAV)) {
+    if((uint32_t)RESET != (handle->rxdesc_current->status & ENET_RDES0_DAV)) {
         return ERROR;
     }
 
     /* if buffer pointer is null, indicates that users has copied data in application */
     if(NULL != buffer) {
         /* if no error occurs, and the frame uses only one descriptor */
-        if(((uint32_t)RESET == (dma_current_rxdesc->status & ENET_RDES0_ERRS)) &&
-                ((uint32_t)RESET != (dma_current_rxdesc->status & ENET_RDES0_LDES)) &&
-                ((uint32_t)RESET != (dma_current_rxdesc->status & ENET_RDES0_FDES))) {
+        if(((uint32_t)RESET == (handle->rxdesc_current->status & ENET_RDES0_ERRS)) &&
+                ((uint32_t)RESET != (handle->rxdesc_current->status & ENET_RDES0_LDES)) &&
+                ((uint32_t)RESET != (handle->rxdesc_current->status & ENET_RDES0_FDES))) {
             /* get the frame length except CRC */
-            size = GET_RDES0_FRML(dma_current_rxdesc->status) - 4U;
+            size = GET_RDES0_FRML(handle->rxdesc_current->status) - 4U;
 
             /* if is a type frame, and CRC is not included in forwarding frame */
-            if((RESET != (ENET_MAC_CFG(enet_periph) & ENET_MAC_CFG_TFCD)) && (RESET != (dma_current_rxdesc->status & ENET_RDES0_FRMT))) {
+            if((RESET != (ENET_MAC_CFG(enet_periph) & ENET_MAC_CFG_TFCD)) && (RESET != (handle->rxdesc_current->status & ENET_RDES0_FRMT))) {
                 size = size + 4U;
             }
 
@@ -2332,9 +2677,7 @@ ErrStatus enet_ptpframe_receive_enhanced_mode(uint32_t enet_periph, uint8_t buff
             }
 
             /* copy data from Rx buffer to application buffer */
-            for(offset = 0U; offset < size; offset++) {
-                (*(buffer + offset)) = (*(__IO uint8_t *)((dma_current_rxdesc->buffer1_addr) + offset));
-            }
+            enet_frame_copy(buffer, (const uint8_t *)(handle->rxdesc_current->buffer1_addr), size);
         } else {
             return ERROR;
         }
@@ -2345,7 +2688,7 @@ ErrStatus enet_ptpframe_receive_enhanced_mode(uint32_t enet_periph, uint8_t buff
         /* wait for ENET_RDES0_TSV flag to be set, the timestamp value is taken and
         write to the RDES6 and RDES7 */
         do {
-            rdes0_tsv_flag = (dma_current_rxdesc->status & ENET_RDES0_TSV);
+            rdes0_tsv_flag = (handle->rxdesc_current->status & ENET_RDES0_TSV);
             timeout++;
         } while((RESET == rdes0_tsv_flag) && (timeout < ENET_DELAY_TO));
 
@@ -2355,14 +2698,14 @@ ErrStatus enet_ptpframe_receive_enhanced_mode(uint32_t enet_periph, uint8_t buff
         }
 
         /* clear the ENET_RDES0_TSV flag */
-        dma_current_rxdesc->status &= ~ENET_RDES0_TSV;
+        handle->rxdesc_current->status &= ~ENET_RDES0_TSV;
         /* get the timestamp value of the received frame */
-        timestamp[0] = dma_current_rxdesc->timestamp_low;
-        timestamp[1] = dma_current_rxdesc->timestamp_high;
+        timestamp[0] = handle->rxdesc_current->timestamp_low;
+        timestamp[1] = handle->rxdesc_current->timestamp_high;
     }
 
     /* enable reception, descriptor is owned by DMA */
-    dma_current_rxdesc->status = ENET_RDES0_DAV;
+    handle->rxdesc_current->status = ENET_RDES0_DAV;
 
     /* check Rx buffer unavailable flag status */
     if((uint32_t)RESET != (ENET_DMA_STAT(enet_periph) & ENET_DMA_STAT_RBU)) {
@@ -2374,25 +2717,42 @@ ErrStatus enet_ptpframe_receive_enhanced_mode(uint32_t enet_periph, uint8_t buff
 
     /* update the current RxDMA descriptor pointer to the next decriptor in RxDMA decriptor table */
     /* chained mode */
-    if((uint32_t)RESET != (dma_current_rxdesc->control_buffer_size & ENET_RDES1_RCHM)) {
-        dma_current_rxdesc = (enet_descriptors_struct *)(dma_current_rxdesc->buffer2_next_desc_addr);
+    if((uint32_t)RESET != (handle->rxdesc_current->control_buffer_size & ENET_RDES1_RCHM)) {
+        handle->rxdesc_current = (enet_descriptors_struct *)(handle->rxdesc_current->buffer2_next_desc_addr);
     } else {
         /* ring mode */
-        if((uint32_t)RESET != (dma_current_rxdesc->control_buffer_size & ENET_RDES1_RERM)) {
+        if((uint32_t)RESET != (handle->rxdesc_current->control_buffer_size & ENET_RDES1_RERM)) {
             /* if is the last descriptor in table, the next descriptor is the table header */
-            dma_current_rxdesc = (enet_descriptors_struct *)(ENET_DMA_RDTADDR(enet_periph));
+            handle->rxdesc_current = (enet_descriptors_struct *)(ENET_DMA_RDTADDR(enet_periph));
         } else {
             /* the next descriptor is the current address, add the descriptor size, and descriptor skip length */
-            dma_current_rxdesc = (enet_descriptors_struct *)((uint32_t)dma_current_rxdesc + ETH_DMARXDESC_SIZE + GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(enet_periph)));
+            handle->rxdesc_current = (enet_descriptors_struct *)((uint32_t)handle->rxdesc_current + ETH_DMARXDESC_SIZE + GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(enet_periph)));
         }
     }
 
+    handle->stats.rx_frames++;
+
     return SUCCESS;
 }
 
 /*!
-    \brief      send data with timestamp values in application buffer as a transmit packet, when the DMA is in enhanced mode
+    \brief      receive a packet data with timestamp values to application buffer, when the DMA is in enhanced mode
     \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  bufsize: the size of buffer which is the parameter in function
+    \param[out] buffer: pointer to the application buffer
+                note -- if the input is NULL, user should copy data in application by himself
+    \param[out] timestamp: pointer to the table which stores the timestamp high and low
+                note -- if the input is NULL, timestamp is ignored
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+ErrStatus enet_ptpframe_receive_enhanced_mode(uint32_t enet_periph, uint8_t buffer[], uint32_t bufsize, uint32_t timestamp[])
+{
+    return enet_handle_ptpframe_receive_enhanced_mode(enet_handle_get(enet_periph), buffer, bufsize, timestamp);
+}
+
+/*!
+    \brief      send data with timestamp values in application buffer as a transmit packet, when the DMA is in enhanced mode
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
     \param[in]  buffer: pointer on the application buffer
                 note -- if the input is NULL, user should copy data in application by himself
     \param[in]  length: the length of frame data to be transmitted
@@ -2401,15 +2761,16 @@ ErrStatus enet_ptpframe_receive_enhanced_mode(uint32_t enet_periph, uint8_t buff
     \param[out] none
     \retval     ErrStatus: SUCCESS or ERROR
 */
-ErrStatus enet_ptpframe_transmit_enhanced_mode(uint32_t enet_periph, uint8_t buffer[], uint32_t length, uint32_t timestamp[])
+ErrStatus enet_handle_ptpframe_transmit_enhanced_mode(enet_handle_struct *handle, uint8_t buffer[], uint32_t length, uint32_t timestamp[])
 {
-    uint32_t offset = 0U;
     uint32_t dma_tbu_flag, dma_tu_flag;
     uint32_t tdes0_ttmss_flag;
     uint32_t timeout = 0U;
+    uint32_t enet_periph = handle->periph;
 
     /* the descriptor is busy due to own by the DMA */
-    if((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_DAV)) {
+    if((uint32_t)RESET != (handle->txdesc_current->status & ENET_TDES0_DAV)) {
+        handle->stats.tx_busy++;
         return ERROR;
     }
 
@@ -2421,16 +2782,14 @@ ErrStatus enet_ptpframe_transmit_enhanced_mode(uint32_t enet_periph, uint8_t buf
     /* if buffer pointer is null, indicates that users has handled data in application */
     if(NULL != buffer) {
         /* copy frame data from application buffer to Tx buffer */
-        for(offset = 0U; offset < length; offset++) {
-            (*(__IO uint8_t *)((dma_current_txdesc->buffer1_addr) + offset)) = (*(buffer + offset));
-        }
+        enet_frame_copy((uint8_t *)(handle->txdesc_current->buffer1_addr), buffer, length);
     }
     /* set the frame length */
-    dma_current_txdesc->control_buffer_size = length;
+    handle->txdesc_current->control_buffer_size = length;
     /* set the segment of frame, frame is transmitted in one descriptor */
-    dma_current_txdesc->status |= ENET_TDES0_LSG | ENET_TDES0_FSG;
+    handle->txdesc_current->status |= ENET_TDES0_LSG | ENET_TDES0_FSG;
     /* enable the DMA transmission */
-    dma_current_txdesc->status |= ENET_TDES0_DAV;
+    handle->txdesc_current->status |= ENET_TDES0_DAV;
 
     /* check Tx buffer unavailable flag status */
     dma_tbu_flag = (ENET_DMA_STAT(enet_periph) & ENET_DMA_STAT_TBU);
@@ -2447,7 +2806,7 @@ ErrStatus enet_ptpframe_transmit_enhanced_mode(uint32_t enet_periph, uint8_t buf
     if(NULL != timestamp) {
         /* wait for ENET_TDES0_TTMSS flag to be set, a timestamp was captured */
         do {
-            tdes0_ttmss_flag = (dma_current_txdesc->status & ENET_TDES0_TTMSS);
+            tdes0_ttmss_flag = (handle->txdesc_current->status & ENET_TDES0_TTMSS);
             timeout++;
         } while((RESET == tdes0_ttmss_flag) && (timeout < ENET_DELAY_TO));
 
@@ -2457,30 +2816,48 @@ ErrStatus enet_ptpframe_transmit_enhanced_mode(uint32_t enet_periph, uint8_t buf
         }
 
         /* clear the ENET_TDES0_TTMSS flag */
-        dma_current_txdesc->status &= ~ENET_TDES0_TTMSS;
+        handle->txdesc_current->status &= ~ENET_TDES0_TTMSS;
         /* get the timestamp value of the transmit frame */
-        timestamp[0] = dma_current_txdesc->timestamp_low;
-        timestamp[1] = dma_current_txdesc->timestamp_high;
+        timestamp[0] = handle->txdesc_current->timestamp_low;
+        timestamp[1] = handle->txdesc_current->timestamp_high;
     }
 
     /* update the current TxDMA descriptor pointer to the next decriptor in TxDMA decriptor table*/
     /* chained mode */
-    if((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_TCHM)) {
-        dma_current_txdesc = (enet_descriptors_struct *)(dma_current_txdesc->buffer2_next_desc_addr);
+    if((uint32_t)RESET != (handle->txdesc_current->status & ENET_TDES0_TCHM)) {
+        handle->txdesc_current = (enet_descriptors_struct *)(handle->txdesc_current->buffer2_next_desc_addr);
     } else {
         /* ring mode */
-        if((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_TERM)) {
+        if((uint32_t)RESET != (handle->txdesc_current->status & ENET_TDES0_TERM)) {
             /* if is the last descriptor in table, the next descriptor is the table header */
-            dma_current_txdesc = (enet_descriptors_struct *)(ENET_DMA_TDTADDR(enet_periph));
+            handle->txdesc_current = (enet_descriptors_struct *)(ENET_DMA_TDTADDR(enet_periph));
         } else {
             /* the next descriptor is the current address, add the descriptor size, and descriptor skip length */
-            dma_current_txdesc = (enet_descriptors_struct *)((uint32_t)dma_current_txdesc + ETH_DMATXDESC_SIZE + GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(enet_periph)));
+            handle->txdesc_current = (enet_descriptors_struct *)((uint32_t)handle->txdesc_current + ETH_DMATXDESC_SIZE + GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(enet_periph)));
         }
     }
 
+    handle->stats.tx_frames++;
+
     return SUCCESS;
 }
 
+/*!
+    \brief      send data with timestamp values in application buffer as a transmit packet, when the DMA is in enhanced mode
+    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  buffer: pointer on the application buffer
+                note -- if the input is NULL, user should copy data in application by himself
+    \param[in]  length: the length of frame data to be transmitted
+    \param[out] timestamp: pointer to the table which stores the timestamp high and low
+                note -- if the input is NULL, timestamp is ignored
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+ErrStatus enet_ptpframe_transmit_enhanced_mode(uint32_t enet_periph, uint8_t buffer[], uint32_t length, uint32_t timestamp[])
+{
+    return enet_handle_ptpframe_transmit_enhanced_mode(enet_handle_get(enet_periph), buffer, length, timestamp);
+}
+
 #else
 
 /*!
@@ -2496,7 +2873,7 @@ void enet_desc_select_normal_mode(uint32_t enet_periph)
 
 /*!
     \brief      initialize the DMA Tx/Rx descriptors's parameters in normal chain mode with PTP function
-    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
     \param[in]  direction: the descriptors which users want to init, refer to enet_dmadirection_enum,
                 only one parameter can be selected which is shown as below
       \arg        ENET_DMA_TX: DMA Tx descriptors
@@ -2505,18 +2882,19 @@ void enet_desc_select_normal_mode(uint32_t enet_periph)
     \param[out] none
     \retval     none
 */
-void enet_ptp_normal_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum direction, enet_descriptors_struct *desc_ptptab)
+void enet_handle_ptp_normal_descriptors_chain_init(enet_handle_struct *handle, enet_dmadirection_enum direction, enet_descriptors_struct *desc_ptptab)
 {
     uint32_t num = 0U, count = 0U, maxsize = 0U;
     uint32_t desc_status = 0U, desc_bufsize = 0U;
     enet_descriptors_struct *desc, *desc_tab;
     uint8_t *buf;
+    uint32_t enet_periph = handle->periph;
 
     /* if want to initialize DMA Tx descriptors */
     if(ENET_DMA_TX == direction) {
         /* save a copy of the DMA Tx descriptors */
-        desc_tab = txdesc_tab;
-        buf = &tx_buff[0][0];
+        desc_tab = handle->txdesc_tab;
+        buf = &handle->tx_buff[0][0];
         count = ENET_TXBUF_NUM;
         maxsize = ENET_TXBUF_SIZE;
 
@@ -2525,13 +2903,13 @@ void enet_ptp_normal_descriptors_chain_init(uint32_t enet_periph, enet_dmadirect
 
         /* configure DMA Tx descriptor table address register */
         ENET_DMA_TDTADDR(enet_periph) = (uint32_t)desc_tab;
-        dma_current_txdesc = desc_tab;
-        dma_current_ptp_txdesc = desc_ptptab;
+        handle->txdesc_current = desc_tab;
+        handle->ptp_txdesc_current = desc_ptptab;
     } else {
         /* if want to initialize DMA Rx descriptors */
         /* save a copy of the DMA Rx descriptors */
-        desc_tab = rxdesc_tab;
-        buf = &rx_buff[0][0];
+        desc_tab = handle->rxdesc_tab;
+        buf = (NULL != handle->rx_buff) ? &handle->rx_buff[0][0] : NULL;
         count = ENET_RXBUF_NUM;
         maxsize = ENET_RXBUF_SIZE;
 
@@ -2542,8 +2920,8 @@ void enet_ptp_normal_descriptors_chain_init(uint32_t enet_periph, enet_dmadirect
 
         /* configure DMA Rx descriptor table address register */
         ENET_DMA_RDTADDR(enet_periph) = (uint32_t)desc_tab;
-        dma_current_rxdesc = desc_tab;
-        dma_current_ptp_rxdesc = desc_ptptab;
+        handle->rxdesc_current = desc_tab;
+        handle->ptp_rxdesc_current = desc_ptptab;
     }
 
     /* configure each descriptor */
@@ -2554,7 +2932,7 @@ void enet_ptp_normal_descriptors_chain_init(uint32_t enet_periph, enet_dmadirect
         /* configure descriptors */
         desc->status = desc_status;
         desc->control_buffer_size = desc_bufsize;
-        desc->buffer1_addr = (uint32_t)(&buf[num * maxsize]);
+        desc->buffer1_addr = (NULL != buf) ? (uint32_t)(&buf[num * maxsize]) : 0U;
 
         /* if is not the last descriptor */
         if(num < (count - 1U)) {
@@ -2575,7 +2953,7 @@ void enet_ptp_normal_descriptors_chain_init(uint32_t enet_periph, enet_dmadirect
 }
 
 /*!
-    \brief      initialize the DMA Tx/Rx descriptors's parameters in normal ring mode with PTP function
+    \brief      initialize the DMA Tx/Rx descriptors's parameters in normal chain mode with PTP function
     \param[in]  enet_periph: ENETx(x=0,1)
     \param[in]  direction: the descriptors which users want to init, refer to enet_dmadirection_enum,
                 only one parameter can be selected which is shown as below
@@ -2585,12 +2963,29 @@ void enet_ptp_normal_descriptors_chain_init(uint32_t enet_periph, enet_dmadirect
     \param[out] none
     \retval     none
 */
-void enet_ptp_normal_descriptors_ring_init(uint32_t enet_periph, enet_dmadirection_enum direction, enet_descriptors_struct *desc_ptptab)
+void enet_ptp_normal_descriptors_chain_init(uint32_t enet_periph, enet_dmadirection_enum direction, enet_descriptors_struct *desc_ptptab)
+{
+    enet_handle_ptp_normal_descriptors_chain_init(enet_handle_get(enet_periph), direction, desc_ptptab);
+}
+
+/*!
+    \brief      initialize the DMA Tx/Rx descriptors's parameters in normal ring mode with PTP function
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
+    \param[in]  direction: the descriptors which users want to init, refer to enet_dmadirection_enum,
+                only one parameter can be selected which is shown as below
+      \arg        ENET_DMA_TX: DMA Tx descriptors
+      \arg        ENET_DMA_RX: DMA Rx descriptors
+    \param[in]  desc_ptptab: pointer to the first descriptor address of PTP Rx descriptor table
+    \param[out] none
+    \retval     none
+*/
+void enet_handle_ptp_normal_descriptors_ring_init(enet_handle_struct *handle, enet_dmadirection_enum direction, enet_descriptors_struct *desc_ptptab)
 {
     uint32_t num = 0U, count = 0U, maxsize = 0U;
     uint32_t desc_status = 0U, desc_bufsize = 0U;
     enet_descriptors_struct *desc, *desc_tab;
     uint8_t *buf;
+    uint32_t enet_periph = handle->periph;
 
     /* configure descriptor skip length */
     ENET_DMA_BCTL(enet_periph) &= ~ENET_DMA_BCTL_DPSL;
@@ -2599,8 +2994,8 @@ void enet_ptp_normal_descriptors_ring_init(uint32_t enet_periph, enet_dmadirecti
     /* if want to initialize DMA Tx descriptors */
     if(ENET_DMA_TX == direction) {
         /* save a copy of the DMA Tx descriptors */
-        desc_tab = txdesc_tab;
-        buf = &tx_buff[0][0];
+        desc_tab = handle->txdesc_tab;
+        buf = &handle->tx_buff[0][0];
         count = ENET_TXBUF_NUM;
         maxsize = ENET_TXBUF_SIZE;
 
@@ -2609,13 +3004,13 @@ void enet_ptp_normal_descriptors_ring_init(uint32_t enet_periph, enet_dmadirecti
 
         /* configure DMA Tx descriptor table address register */
         ENET_DMA_TDTADDR(enet_periph) = (uint32_t)desc_tab;
-        dma_current_txdesc = desc_tab;
-        dma_current_ptp_txdesc = desc_ptptab;
+        handle->txdesc_current = desc_tab;
+        handle->ptp_txdesc_current = desc_ptptab;
     } else {
         /* if want to initialize DMA Rx descriptors */
         /* save a copy of the DMA Rx descriptors */
-        desc_tab = rxdesc_tab;
-        buf = &rx_buff[0][0];
+        desc_tab = handle->rxdesc_tab;
+        buf = (NULL != handle->rx_buff) ? &handle->rx_buff[0][0] : NULL;
         count = ENET_RXBUF_NUM;
         maxsize = ENET_RXBUF_SIZE;
 
@@ -2626,8 +3021,8 @@ void enet_ptp_normal_descriptors_ring_init(uint32_t enet_periph, enet_dmadirecti
 
         /* configure DMA Rx descriptor table address register */
         ENET_DMA_RDTADDR(enet_periph) = (uint32_t)desc_tab;
-        dma_current_rxdesc = desc_tab;
-        dma_current_ptp_rxdesc = desc_ptptab;
+        handle->rxdesc_current = desc_tab;
+        handle->ptp_rxdesc_current = desc_ptptab;
     }
 
     /* configure each descriptor */
@@ -2638,7 +3033,7 @@ void enet_ptp_normal_descriptors_ring_init(uint32_t enet_periph, enet_dmadirecti
         /* configure descriptors */
         desc->status = desc_status;
         desc->control_buffer_size = desc_bufsize;
-        desc->buffer1_addr = (uint32_t)(&buf[num * maxsize]);
+        desc->buffer1_addr = (NULL != buf) ? (uint32_t)(&buf[num * maxsize]) : 0U;
 
         /* when it is the last descriptor */
         if(num == (count - 1U)) {
@@ -2660,34 +3055,51 @@ void enet_ptp_normal_descriptors_ring_init(uint32_t enet_periph, enet_dmadirecti
 }
 
 /*!
-    \brief      receive a packet data with timestamp values to application buffer, when the DMA is in normal mode
+    \brief      initialize the DMA Tx/Rx descriptors's parameters in normal ring mode with PTP function
     \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  direction: the descriptors which users want to init, refer to enet_dmadirection_enum,
+                only one parameter can be selected which is shown as below
+      \arg        ENET_DMA_TX: DMA Tx descriptors
+      \arg        ENET_DMA_RX: DMA Rx descriptors
+    \param[in]  desc_ptptab: pointer to the first descriptor address of PTP Rx descriptor table
+    \param[out] none
+    \retval     none
+*/
+void enet_ptp_normal_descriptors_ring_init(uint32_t enet_periph, enet_dmadirection_enum direction, enet_descriptors_struct *desc_ptptab)
+{
+    enet_handle_ptp_normal_descriptors_ring_init(enet_handle_get(enet_periph), direction, desc_ptptab);
+}
+
+/*!
+    \brief      receive a packet data with timestamp values to application buffer, when the DMA is in normal mode
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
     \param[in]  bufsize: the size of buffer which is the parameter in function
     \param[out] timestamp: pointer to the table which stores the timestamp high and low
     \param[out] buffer: pointer to the application buffer
                 note -- if the input is NULL, user should copy data in application by himself
     \retval     ErrStatus: SUCCESS or ERROR
 */
-ErrStatus enet_ptpframe_receive_normal_mode(uint32_t enet_periph, uint8_t buffer[], uint32_t bufsize, uint32_t timestamp[])
+ErrStatus enet_handle_ptpframe_receive_normal_mode(enet_handle_struct *handle, uint8_t buffer[], uint32_t bufsize, uint32_t timestamp[])
 {
-    uint32_t offset = 0U, size = 0U;
+    uint32_t size = 0U;
+    uint32_t enet_periph = handle->periph;
 
     /* the descriptor is busy due to own by the DMA */
-    if((uint32_t)RESET != (dma_current_rxdesc->status & ENET_RDES0_DAV)) {
+    if((uint32_t)RESET != (handle->rxdesc_current->status & ENET_RDES0_DAV)) {
         return ERROR;
     }
 
     /* if buffer pointer is null, indicates that users has copied data in application */
     if(NULL != buffer) {
         /* if no error occurs, and the frame uses only one descriptor */
-        if(((uint32_t)RESET == (dma_current_rxdesc->status & ENET_RDES0_ERRS)) &&
-                ((uint32_t)RESET != (dma_current_rxdesc->status & ENET_RDES0_LDES)) &&
-                ((uint32_t)RESET != (dma_current_rxdesc->status & ENET_RDES0_FDES))) {
+        if(((uint32_t)RESET == (handle->rxdesc_current->status & ENET_RDES0_ERRS)) &&
+                ((uint32_t)RESET != (handle->rxdesc_current->status & ENET_RDES0_LDES)) &&
+                ((uint32_t)RESET != (handle->rxdesc_current->status & ENET_RDES0_FDES))) {
 
             /* get the frame length except CRC */
-            size = GET_RDES0_FRML(dma_current_rxdesc->status) - 4U;
+            size = GET_RDES0_FRML(handle->rxdesc_current->status) - 4U;
             /* if is a type frame, and CRC is not included in forwarding frame */
-            if((RESET != (ENET_MAC_CFG(enet_periph) & ENET_MAC_CFG_TFCD)) && (RESET != (dma_current_rxdesc->status & ENET_RDES0_FRMT))) {
+            if((RESET != (ENET_MAC_CFG(enet_periph) & ENET_MAC_CFG_TFCD)) && (RESET != (handle->rxdesc_current->status & ENET_RDES0_FRMT))) {
                 size = size + 4U;
             }
 
@@ -2697,23 +3109,21 @@ ErrStatus enet_ptpframe_receive_normal_mode(uint32_t enet_periph, uint8_t buffer
             }
 
             /* copy data from Rx buffer to application buffer */
-            for(offset = 0U; offset < size; offset++) {
-                (*(buffer + offset)) = (*(__IO uint8_t *)(uint32_t)((dma_current_ptp_rxdesc->buffer1_addr) + offset));
-            }
+            enet_frame_copy(buffer, (const uint8_t *)(handle->ptp_rxdesc_current->buffer1_addr), size);
 
         } else {
             return ERROR;
         }
     }
     /* copy timestamp value from Rx descriptor to application array */
-    timestamp[0] = dma_current_rxdesc->buffer1_addr;
-    timestamp[1] = dma_current_rxdesc->buffer2_next_desc_addr;
+    timestamp[0] = handle->rxdesc_current->buffer1_addr;
+    timestamp[1] = handle->rxdesc_current->buffer2_next_desc_addr;
 
-    dma_current_rxdesc->buffer1_addr = dma_current_ptp_rxdesc ->buffer1_addr ;
-    dma_current_rxdesc->buffer2_next_desc_addr = dma_current_ptp_rxdesc ->buffer2_next_desc_addr;
+    handle->rxdesc_current->buffer1_addr = handle->ptp_rxdesc_current ->buffer1_addr ;
+    handle->rxdesc_current->buffer2_next_desc_addr = handle->ptp_rxdesc_current ->buffer2_next_desc_addr;
 
     /* enable reception, descriptor is owned by DMA */
-    dma_current_rxdesc->status = ENET_RDES0_DAV;
+    handle->rxdesc_current->status = ENET_RDES0_DAV;
 
     /* check Rx buffer unavailable flag status */
     if((uint32_t)RESET != (ENET_DMA_STAT(enet_periph) & ENET_DMA_STAT_RBU)) {
@@ -2725,38 +3135,54 @@ ErrStatus enet_ptpframe_receive_normal_mode(uint32_t enet_periph, uint8_t buffer
 
     /* update the current RxDMA descriptor pointer to the next decriptor in RxDMA decriptor table */
     /* chained mode */
-    if((uint32_t)RESET != (dma_current_rxdesc->control_buffer_size & ENET_RDES1_RCHM)) {
-        dma_current_rxdesc = (enet_descriptors_struct *)(dma_current_ptp_rxdesc->buffer2_next_desc_addr);
+    if((uint32_t)RESET != (handle->rxdesc_current->control_buffer_size & ENET_RDES1_RCHM)) {
+        handle->rxdesc_current = (enet_descriptors_struct *)(handle->ptp_rxdesc_current->buffer2_next_desc_addr);
         /* if it is the last ptp descriptor */
-        if(0U != dma_current_ptp_rxdesc->status) {
+        if(0U != handle->ptp_rxdesc_current->status) {
             /* pointer back to the first ptp descriptor address in the desc_ptptab list address */
-            dma_current_ptp_rxdesc = (enet_descriptors_struct *)(dma_current_ptp_rxdesc->status);
+            handle->ptp_rxdesc_current = (enet_descriptors_struct *)(handle->ptp_rxdesc_current->status);
         } else {
             /* ponter to the next ptp descriptor */
-            dma_current_ptp_rxdesc++;
+            handle->ptp_rxdesc_current++;
         }
     } else {
         /* ring mode */
-        if((uint32_t)RESET != (dma_current_rxdesc->control_buffer_size & ENET_RDES1_RERM)) {
+        if((uint32_t)RESET != (handle->rxdesc_current->control_buffer_size & ENET_RDES1_RERM)) {
             /* if is the last descriptor in table, the next descriptor is the table header */
-            dma_current_rxdesc = (enet_descriptors_struct *)(ENET_DMA_RDTADDR(enet_periph));
+            handle->rxdesc_current = (enet_descriptors_struct *)(ENET_DMA_RDTADDR(enet_periph));
             /* RDES2 and RDES3 will not be covered by buffer address, so do not need to preserve a new table,
             use the same table with RxDMA descriptor */
-            dma_current_ptp_rxdesc = (enet_descriptors_struct *)(dma_current_ptp_rxdesc->status);
+            handle->ptp_rxdesc_current = (enet_descriptors_struct *)(handle->ptp_rxdesc_current->status);
         } else {
             /* the next descriptor is the current address, add the descriptor size, and descriptor skip length */
-            dma_current_rxdesc = (enet_descriptors_struct *)(uint32_t)((uint32_t)dma_current_rxdesc + ETH_DMARXDESC_SIZE + GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(
+            handle->rxdesc_current = (enet_descriptors_struct *)(uint32_t)((uint32_t)handle->rxdesc_current + ETH_DMARXDESC_SIZE + GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(
                                      enet_periph)));
-            dma_current_ptp_rxdesc ++;
+            handle->ptp_rxdesc_current ++;
         }
     }
 
+    handle->stats.rx_frames++;
+
     return SUCCESS;
 }
 
 /*!
-    \brief      send data with timestamp values in application buffer as a transmit packet, when the DMA is in normal mode
+    \brief      receive a packet data with timestamp values to application buffer, when the DMA is in normal mode
     \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  bufsize: the size of buffer which is the parameter in function
+    \param[out] timestamp: pointer to the table which stores the timestamp high and low
+    \param[out] buffer: pointer to the application buffer
+                note -- if the input is NULL, user should copy data in application by himself
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+ErrStatus enet_ptpframe_receive_normal_mode(uint32_t enet_periph, uint8_t buffer[], uint32_t bufsize, uint32_t timestamp[])
+{
+    return enet_handle_ptpframe_receive_normal_mode(enet_handle_get(enet_periph), buffer, bufsize, timestamp);
+}
+
+/*!
+    \brief      send data with timestamp values in application buffer as a transmit packet, when the DMA is in normal mode
+    \param[in]  handle: the ENET instance handle, refer to enet_handle_struct
     \param[in]  buffer: pointer on the application buffer
                 note -- if the input is NULL, user should copy data in application by himself
     \param[in]  length: the length of frame data to be transmitted
@@ -2764,13 +3190,15 @@ ErrStatus enet_ptpframe_receive_normal_mode(uint32_t enet_periph, uint8_t buffer
                 note -- if the input is NULL, timestamp is ignored
     \retval     ErrStatus: SUCCESS or ERROR
 */
-ErrStatus enet_ptpframe_transmit_normal_mode(uint32_t enet_periph, uint8_t buffer[], uint32_t length, uint32_t timestamp[])
+ErrStatus enet_handle_ptpframe_transmit_normal_mode(enet_handle_struct *handle, uint8_t buffer[], uint32_t length, uint32_t timestamp[])
 {
-    uint32_t offset = 0U, timeout = 0U;
+    uint32_t timeout = 0U;
     uint32_t dma_tbu_flag, dma_tu_flag, tdes0_ttmss_flag;
+    uint32_t enet_periph = handle->periph;
 
     /* the descriptor is busy due to own by the DMA */
-    if((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_DAV)) {
+    if((uint32_t)RESET != (handle->txdesc_current->status & ENET_TDES0_DAV)) {
+        handle->stats.tx_busy++;
         return ERROR;
     }
 
@@ -2782,16 +3210,14 @@ ErrStatus enet_ptpframe_transmit_normal_mode(uint32_t enet_periph, uint8_t buffe
     /* if buffer pointer is null, indicates that users has handled data in application */
     if(NULL != buffer) {
         /* copy frame data from application buffer to Tx buffer */
-        for(offset = 0U; offset < length; offset++) {
-            (*(__IO uint8_t *)(uint32_t)((dma_current_ptp_txdesc->buffer1_addr) + offset)) = (*(buffer + offset));
-        }
+        enet_frame_copy((uint8_t *)(handle->ptp_txdesc_current->buffer1_addr), buffer, length);
     }
     /* set the frame length */
-    dma_current_txdesc->control_buffer_size = (length & (uint32_t)0x00001FFFU);
+    handle->txdesc_current->control_buffer_size = (length & (uint32_t)0x00001FFFU);
     /* set the segment of frame, frame is transmitted in one descriptor */
-    dma_current_txdesc->status |= ENET_TDES0_LSG | ENET_TDES0_FSG;
+    handle->txdesc_current->status |= ENET_TDES0_LSG | ENET_TDES0_FSG;
     /* enable the DMA transmission */
-    dma_current_txdesc->status |= ENET_TDES0_DAV;
+    handle->txdesc_current->status |= ENET_TDES0_DAV;
 
     /* check Tx buffer unavailable flag status */
     dma_tbu_flag = (ENET_DMA_STAT(enet_periph) & ENET_DMA_STAT_TBU);
@@ -2808,7 +3234,7 @@ ErrStatus enet_ptpframe_transmit_normal_mode(uint32_t enet_periph, uint8_t buffe
     if(NULL != timestamp) {
         /* wait for ENET_TDES0_TTMSS flag to be set, a timestamp was captured */
         do {
-            tdes0_ttmss_flag = (dma_current_txdesc->status & ENET_TDES0_TTMSS);
+            tdes0_ttmss_flag = (handle->txdesc_current->status & ENET_TDES0_TTMSS);
             timeout++;
         } while((RESET == tdes0_ttmss_flag) && (timeout < ENET_DELAY_TO));
 
@@ -2818,44 +3244,61 @@ ErrStatus enet_ptpframe_transmit_normal_mode(uint32_t enet_periph, uint8_t buffe
         }
 
         /* clear the ENET_TDES0_TTMSS flag */
-        dma_current_txdesc->status &= ~ENET_TDES0_TTMSS;
+        handle->txdesc_current->status &= ~ENET_TDES0_TTMSS;
         /* get the timestamp value of the transmit frame */
-        timestamp[0] = dma_current_txdesc->buffer1_addr;
-        timestamp[1] = dma_current_txdesc->buffer2_next_desc_addr;
+        timestamp[0] = handle->txdesc_current->buffer1_addr;
+        timestamp[1] = handle->txdesc_current->buffer2_next_desc_addr;
     }
-    dma_current_txdesc->buffer1_addr = dma_current_ptp_txdesc ->buffer1_addr ;
-    dma_current_txdesc->buffer2_next_desc_addr = dma_current_ptp_txdesc ->buffer2_next_desc_addr;
+    handle->txdesc_current->buffer1_addr = handle->ptp_txdesc_current ->buffer1_addr ;
+    handle->txdesc_current->buffer2_next_desc_addr = handle->ptp_txdesc_current ->buffer2_next_desc_addr;
 
     /* update the current TxDMA descriptor pointer to the next decriptor in TxDMA decriptor table */
     /* chained mode */
-    if((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_TCHM)) {
-        dma_current_txdesc = (enet_descriptors_struct *)(dma_current_ptp_txdesc->buffer2_next_desc_addr);
+    if((uint32_t)RESET != (handle->txdesc_current->status & ENET_TDES0_TCHM)) {
+        handle->txdesc_current = (enet_descriptors_struct *)(handle->ptp_txdesc_current->buffer2_next_desc_addr);
         /* if it is the last ptp descriptor */
-        if(0U != dma_current_ptp_txdesc->status) {
+        if(0U != handle->ptp_txdesc_current->status) {
             /* pointer back to the first ptp descriptor address in the desc_ptptab list address */
-            dma_current_ptp_txdesc = (enet_descriptors_struct *)(dma_current_ptp_txdesc->status);
+            handle->ptp_txdesc_current = (enet_descriptors_struct *)(handle->ptp_txdesc_current->status);
         } else {
             /* ponter to the next ptp descriptor */
-            dma_current_ptp_txdesc++;
+            handle->ptp_txdesc_current++;
         }
     } else {
         /* ring mode */
-        if((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_TERM)) {
+        if((uint32_t)RESET != (handle->txdesc_current->status & ENET_TDES0_TERM)) {
             /* if is the last descriptor in table, the next descriptor is the table header */
-            dma_current_txdesc = (enet_descriptors_struct *)(ENET_DMA_TDTADDR(enet_periph));
+            handle->txdesc_current = (enet_descriptors_struct *)(ENET_DMA_TDTADDR(enet_periph));
             /* TDES2 and TDES3 will not be covered by buffer address, so do not need to preserve a new table,
             use the same table with TxDMA descriptor */
-            dma_current_ptp_txdesc = (enet_descriptors_struct *)(dma_current_ptp_txdesc->status);
+            handle->ptp_txdesc_current = (enet_descriptors_struct *)(handle->ptp_txdesc_current->status);
         } else {
             /* the next descriptor is the current address, add the descriptor size, and descriptor skip length */
-            dma_current_txdesc = (enet_descriptors_struct *)(uint32_t)((uint32_t)dma_current_txdesc + ETH_DMATXDESC_SIZE + GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(
+            handle->txdesc_current = (enet_descriptors_struct *)(uint32_t)((uint32_t)handle->txdesc_current + ETH_DMATXDESC_SIZE + GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(
                                      enet_periph)));
-            dma_current_ptp_txdesc ++;
+            handle->ptp_txdesc_current ++;
         }
     }
+    handle->stats.tx_frames++;
+
     return SUCCESS;
 }
 
+/*!
+    \brief      send data with timestamp values in application buffer as a transmit packet, when the DMA is in normal mode
+    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  buffer: pointer on the application buffer
+                note -- if the input is NULL, user should copy data in application by himself
+    \param[in]  length: the length of frame data to be transmitted
+    \param[out] timestamp: pointer to the table which stores the timestamp high and low
+                note -- if the input is NULL, timestamp is ignored
+    \retval     ErrStatus: SUCCESS or ERROR
+*/
+ErrStatus enet_ptpframe_transmit_normal_mode(uint32_t enet_periph, uint8_t buffer[], uint32_t length, uint32_t timestamp[])
+{
+    return enet_handle_ptpframe_transmit_normal_mode(enet_handle_get(enet_periph), buffer, length, timestamp);
+}
+
 #endif /* SELECT_DESCRIPTORS_ENHANCED_MODE */
 
 /*!
@@ -3346,7 +3789,7 @@ void enet_ptp_coarsecorrection_systime_update(uint32_t enet_periph, enet_ptp_sys
     subsecond_val = enet_ptp_nanosecond_2_subsecond(systime_struct->nanosecond);
 
     /* save the carry_cfg value */
-    carry_cfg = ENET_PTP_TSADDEND_TMSA;
+    carry_cfg = ENET_PTP_TSADDEND(enet_periph);
 
     /* update the system time */
     enet_ptp_timestamp_update_config(enet_periph, systime_struct->sign, systime_struct->second, subsecond_val);
@@ -3512,6 +3955,102 @@ static void enet_default_init(uint32_t enet_periph)
     ENET_DMA_BCTL(enet_periph) = reg_value;
 }
 
+/*!
+    \brief      get the TxDMA descriptor following the given one
+    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[in]  desc: the TxDMA descriptor
+    \param[out] none
+    \retval     the next TxDMA descriptor in the descriptor table
+*/
+static enet_descriptors_struct *enet_txdesc_next_get(uint32_t enet_periph, enet_descriptors_struct *desc)
+{
+    /* chained mode */
+    if((uint32_t)RESET != (desc->status & ENET_TDES0_TCHM)) {
+        return (enet_descriptors_struct *)(desc->buffer2_next_desc_addr);
+    }
+
+    /* ring mode */
+    if((uint32_t)RESET != (desc->status & ENET_TDES0_TERM)) {
+        /* if is the last descriptor in table, the next descriptor is the table header */
+        return (enet_descriptors_struct *)(ENET_DMA_TDTADDR(enet_periph));
+    }
+
+    /* the next descriptor is the current address, add the descriptor size, and descriptor skip length */
+    return (enet_descriptors_struct *)(uint32_t)((uint32_t)desc + ETH_DMATXDESC_SIZE + (GET_DMA_BCTL_DPSL(ENET_DMA_BCTL(enet_periph))));
+}
+
+/*!
+    \brief      copy frame data between a DMA buffer and an application buffer
+    \param[in]  dest: destination address
+    \param[in]  src: source address
+    \param[in]  length: the number of bytes to copy
+    \param[out] none
+    \retval     none
+*/
+static void enet_frame_copy(uint8_t *dest, const uint8_t *src, uint32_t length)
+{
+    uint32_t *dest_word;
+    uint32_t word0, word1, word2, word3;
+
+    /* copy the head bytes until the destination is word aligned */
+    while((0U != ((uint32_t)dest & 0x3U)) && (0U != length)) {
+        *dest++ = *src++;
+        length--;
+    }
+
+    dest_word = (uint32_t *)(uint32_t)dest;
+    if(0U == ((uint32_t)src & 0x3U)) {
+        const uint32_t *src_word = (const uint32_t *)(uint32_t)src;
+
+        /* copy 16 bytes per loop, which lets the compiler use LDM/STM */
+        while(length >= 16U) {
+            word0 = src_word[0];
+            word1 = src_word[1];
+            word2 = src_word[2];
+            word3 = src_word[3];
+            dest_word[0] = word0;
+            dest_word[1] = word1;
+            dest_word[2] = word2;
+            dest_word[3] = word3;
+            src_word += 4U;
+            dest_word += 4U;
+            length -= 16U;
+        }
+        while(length >= 4U) {
+            *dest_word++ = *src_word++;
+            length -= 4U;
+        }
+        src = (const uint8_t *)src_word;
+    } else {
+        /* the source is not word aligned, load it with unaligned word accesses */
+        while(length >= 16U) {
+            word0 = __UNALIGNED_UINT32_READ(src);
+            word1 = __UNALIGNED_UINT32_READ(src + 4U);
+            word2 = __UNALIGNED_UINT32_READ(src + 8U);
+            word3 = __UNALIGNED_UINT32_READ(src + 12U);
+            dest_word[0] = word0;
+            dest_word[1] = word1;
+            dest_word[2] = word2;
+            dest_word[3] = word3;
+            src += 16U;
+            dest_word += 4U;
+            length -= 16U;
+        }
+        while(length >= 4U) {
+            *dest_word++ = __UNALIGNED_UINT32_READ(src);
+            src += 4U;
+            length -= 4U;
+        }
+    }
+
+    /* copy the tail bytes */
+    dest = (uint8_t *)dest_word;
+    while(0U != length) {
+        *dest++ = *src++;
+        length--;
+    }
+}
+
 #ifndef USE_DELAY
 /*!
     \brief      insert a delay time
@@ -39,13 +39,19 @@ OF SUCH DAMAGE.
 #include "msc_scsi.h"
 #include "usbd_msc_scsi.h"
 
+/* number of media packet buffers, 2 or more pipelines READ10/WRITE10 media access with the DMA bus transfer */
+#ifndef MSC_MEDIA_BUF_NUM
+    #define MSC_MEDIA_BUF_NUM           1U
+#endif /* MSC_MEDIA_BUF_NUM */
+
 /* MSC BBB state */
 enum msc_bbb_state {
     BBB_IDLE = 0U,          /*!< idle state  */
     BBB_DATA_OUT,           /*!< data OUT state */
     BBB_DATA_IN,            /*!< data IN state */
     BBB_LAST_DATA_IN,       /*!< last data IN state */
-    BBB_SEND_DATA           /*!< send immediate data state */
+    BBB_SEND_DATA,          /*!< send immediate data state */
+    BBB_WAIT_FLUSH          /*!< wait for the medium to commit cached writes */
 };
 
 /* MSC BBB status */
@@ -56,7 +62,7 @@ enum msc_bbb_status {
 };
 
 typedef struct {
-    __ALIGN_BEGIN uint8_t bbb_data[MSC_MEDIA_PACKET_SIZE] __ALIGN_END;          /*!< MSC BBB data buff */
+    __ALIGN_BEGIN uint8_t bbb_data[MSC_MEDIA_PACKET_SIZE * MSC_MEDIA_BUF_NUM] __ALIGN_END; /*!< MSC BBB data buff */
 
     uint8_t max_lun;                                                            /*!< maximum LUN */
 
@@ -78,6 +84,12 @@ typedef struct {
     uint32_t scsi_blk_len;                                                      /*!< SCSI block length */
     uint32_t scsi_disk_pop;                                                     /*!< SCSI disk pop */
 
+    uint32_t scsi_xfer_len;                                                     /*!< SCSI bytes still to be armed on the bus */
+    uint32_t scsi_buf_len[MSC_MEDIA_BUF_NUM];                                   /*!< SCSI data length held by each media buffer */
+    uint8_t scsi_buf_head;                                                      /*!< SCSI oldest media buffer in use */
+    uint8_t scsi_buf_count;                                                     /*!< SCSI media buffers holding data */
+    uint8_t scsi_buf_busy;                                                      /*!< SCSI head buffer is on the bus */
+
     __ALIGN_BEGIN msc_scsi_sense scsi_sense[SENSE_LIST_DEEPTH] __ALIGN_END;     /*!< MSC SCSI sense structural buffer */
 } usbd_msc_handler;
 
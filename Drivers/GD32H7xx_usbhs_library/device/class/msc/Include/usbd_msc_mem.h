@@ -46,6 +46,7 @@ typedef struct {
     int8_t (*mem_read)(uint8_t lun, uint8_t *buf, uint32_t block_addr, uint16_t block_len);
     int8_t (*mem_write)(uint8_t lun, uint8_t *buf, uint32_t block_addr, uint16_t block_len);
     int8_t (*mem_maxlun)(void);
+    int8_t (*mem_flush)(uint8_t lun);                      /*!< commit cached writes, optional, 1 when completed later by scsi_flush_complete() */
 
     uint8_t *mem_toc_data;                                 /*!< memory TOC command data pointer */
     uint8_t *mem_inquiry_data[MEM_LUN_NUM];                /*!< memory inquiry data buff */
@@ -49,5 +49,7 @@ OF SUCH DAMAGE.
 int8_t scsi_process_cmd(usb_core_driver *udev, uint8_t lun, uint8_t *cmd);
 /* load the last error code in the error list */
 void scsi_sense_code(usb_core_driver *udev, uint8_t lun, uint8_t skey, uint8_t asc);
+/* finish a flush the medium has committed, with the USB interrupt masked */
+void scsi_flush_complete(usb_core_driver *udev, int8_t status);
 
 #endif /* USBD_MSC_SCSI_H */
@@ -227,7 +227,8 @@ static void msc_bbb_cbw_decode(usb_core_driver *udev)
             msc_bbb_abort(udev);
         } else if((BBB_DATA_IN != msc->bbb_state) && \
                     (BBB_DATA_OUT != msc->bbb_state) && \
-                      (BBB_LAST_DATA_IN != msc->bbb_state)) { /* burst transfer handled internally */
+                      (BBB_LAST_DATA_IN != msc->bbb_state) && \
+                        (BBB_WAIT_FLUSH != msc->bbb_state)) { /* burst transfer and flush handled internally */
             if(msc->bbb_datalen > 0U) {
                 msc_bbb_data_send(udev, msc->bbb_data, msc->bbb_datalen);
             } else if(0U == msc->bbb_datalen) {
@@ -42,6 +42,11 @@ OF SUCH DAMAGE.
 #define USBD_VID                    0x28E9U
 #define USBD_PID                    0x028FU
 
+#ifdef USB_INTERNAL_DMA_ENABLED
+/* the media packets are received in place, __ALIGN_END must give them whole D-cache lines */
+USB_DMA_BUF_CHECK(usbd_msc_handler, bbb_data);
+#endif /* USB_INTERNAL_DMA_ENABLED */
+
 /* local function prototypes ('static') */
 static uint8_t msc_core_init(usb_dev *udev, uint8_t config_index);
 static uint8_t msc_core_deinit(usb_dev *udev, uint8_t config_index);
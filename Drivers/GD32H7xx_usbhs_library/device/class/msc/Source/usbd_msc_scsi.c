@@ -87,9 +87,13 @@ static int8_t scsi_mode_sense10(usb_core_driver *udev, uint8_t lun, uint8_t *par
 static int8_t scsi_write10(usb_core_driver *udev, uint8_t lun, uint8_t *params);
 static int8_t scsi_read10(usb_core_driver *udev, uint8_t lun, uint8_t *params);
 static int8_t scsi_verify10(usb_core_driver *udev, uint8_t lun, uint8_t *params);
+static int8_t scsi_synchronize_cache10(usb_core_driver *udev, uint8_t lun, uint8_t *params);
+static int8_t scsi_media_flush(usb_core_driver *udev, uint8_t lun);
 
 static int8_t scsi_process_read(usb_core_driver *udev, uint8_t lun);
 static int8_t scsi_process_write(usb_core_driver *udev, uint8_t lun);
+static int8_t scsi_media_read(usb_core_driver *udev, uint8_t lun);
+static void scsi_media_recev(usb_core_driver *udev);
 
 static inline int8_t scsi_check_address_range(usb_core_driver *udev, uint8_t lun, uint32_t blk_offset, uint16_t blk_nbr);
 static inline int8_t scsi_format_cmd(usb_core_driver *udev, uint8_t lun);
@@ -143,6 +147,9 @@ int8_t scsi_process_cmd(usb_core_driver *udev, uint8_t lun, uint8_t *params)
     case SCSI_VERIFY10:
         return scsi_verify10(udev, lun, params);
 
+    case SCSI_SYNCHRONIZE_CACHE10:
+        return scsi_synchronize_cache10(udev, lun, params);
+
     case SCSI_FORMAT_UNIT:
         return scsi_format_cmd(udev, lun);
 
@@ -451,6 +458,11 @@ static inline int8_t scsi_start_stop_unit(usb_core_driver *udev, uint8_t lun, ui
     msc->bbb_datalen = 0U;
     msc->scsi_disk_pop = 1U;
 
+    /* commit cached writes before the medium is ejected */
+    if(0x02U == (params[4] & 0x03U)) {
+        return scsi_media_flush(udev, lun);
+    }
+
     return 0;
 }
 
@@ -517,6 +529,10 @@ static int8_t scsi_read10(usb_core_driver *udev, uint8_t lun, uint8_t *params)
 
             return -1;
         }
+
+        msc->scsi_buf_head = 0U;
+        msc->scsi_buf_count = 0U;
+        msc->scsi_buf_busy = 0U;
     }
 
     msc->bbb_datalen = MSC_MEDIA_PACKET_SIZE;
@@ -581,10 +597,12 @@ static int8_t scsi_write10(usb_core_driver *udev, uint8_t lun, uint8_t *params)
         /* prepare endpoint to receive first data packet */
         msc->bbb_state = BBB_DATA_OUT;
 
-        usbd_ep_recev(udev, \
-                      MSC_OUT_EP, \
-                      msc->bbb_data, \
-                      USB_MIN(msc->scsi_blk_len, MSC_MEDIA_PACKET_SIZE));
+        msc->scsi_xfer_len = msc->scsi_blk_len;
+        msc->scsi_buf_head = 0U;
+        msc->scsi_buf_count = 0U;
+        msc->scsi_buf_busy = 0U;
+
+        scsi_media_recev(udev);
     } else { /* write process ongoing */
         return scsi_process_write(udev, lun);
     }
@@ -619,6 +637,80 @@ static int8_t scsi_verify10(usb_core_driver *udev, uint8_t lun, uint8_t *params)
     return 0;
 }
 
+/*!
+    \brief      process synchronize cache10 command
+    \param[in]  udev: pointer to USB device instance
+    \param[in]  lun: logical unit number
+    \param[in]  params: command parameters
+    \param[out] none
+    \retval     status
+*/
+static int8_t scsi_synchronize_cache10(usb_core_driver *udev, uint8_t lun, uint8_t *params)
+{
+    usbd_msc_handler *msc = (usbd_msc_handler *)udev->dev.class_data[USBD_MSC_INTERFACE];
+
+    msc->bbb_datalen = 0U;
+
+    return scsi_media_flush(udev, lun);
+}
+
+/*!
+    \brief      ask the medium to commit its cached writes
+    \param[in]  udev: pointer to USB device instance
+    \param[in]  lun: logical unit number
+    \param[out] none
+    \retval     status
+*/
+static int8_t scsi_media_flush(usb_core_driver *udev, uint8_t lun)
+{
+    usbd_msc_handler *msc = (usbd_msc_handler *)udev->dev.class_data[USBD_MSC_INTERFACE];
+    int8_t status;
+
+    if(NULL == usbd_mem_fops->mem_flush) {
+        return 0;
+    }
+
+    status = usbd_mem_fops->mem_flush(lun);
+
+    if(status < 0) {
+        scsi_sense_code(udev, lun, HARDWARE_ERROR, WRITE_FAULT);
+
+        return -1;
+    } else if(status > 0) {
+        /* hold the CSW until scsi_flush_complete() reports the commit */
+        msc->bbb_state = BBB_WAIT_FLUSH;
+    } else {
+
+    }
+
+    return 0;
+}
+
+/*!
+    \brief      send the CSW of a flush once the medium has committed the cached writes
+    \param[in]  udev: pointer to USB device instance
+    \param[in]  status: commit status, negative on failure
+    \param[out] none
+    \retval     none
+*/
+void scsi_flush_complete(usb_core_driver *udev, int8_t status)
+{
+    usbd_msc_handler *msc = (usbd_msc_handler *)udev->dev.class_data[USBD_MSC_INTERFACE];
+
+    /* the command may have been dropped by a reset in the meantime */
+    if((NULL == msc) || (BBB_WAIT_FLUSH != msc->bbb_state)) {
+        return;
+    }
+
+    if(status < 0) {
+        scsi_sense_code(udev, msc->bbb_cbw.bCBWLUN, HARDWARE_ERROR, WRITE_FAULT);
+
+        msc_bbb_csw_send(udev, CSW_CMD_FAILED);
+    } else {
+        msc_bbb_csw_send(udev, CSW_CMD_PASSED);
+    }
+}
+
 /*!
     \brief      check address range
     \param[in]  udev: pointer to USB device instance
@@ -652,29 +744,45 @@ static int8_t scsi_process_read(usb_core_driver *udev, uint8_t lun)
 {
     usbd_msc_handler *msc = (usbd_msc_handler *)udev->dev.class_data[USBD_MSC_INTERFACE];
 
-    uint32_t len = USB_MIN(msc->scsi_blk_len, MSC_MEDIA_PACKET_SIZE);
+    uint32_t len;
 
-    if(usbd_mem_fops->mem_read(lun, \
-                               msc->bbb_data, \
-                               msc->scsi_blk_addr, \
-                               (uint16_t)(len / msc->scsi_blk_size[lun])) < 0) {
-        scsi_sense_code(udev, lun, HARDWARE_ERROR, UNRECOVERED_READ_ERROR);
+    /* the head buffer has been sent, release it */
+    if(0U != msc->scsi_buf_busy) {
+        msc->scsi_buf_busy = 0U;
+        msc->scsi_buf_head = (uint8_t)((msc->scsi_buf_head + 1U) % MSC_MEDIA_BUF_NUM);
+        msc->scsi_buf_count--;
+    }
 
-        return -1;
+    /* no data read ahead, fetch the next packet now */
+    if(0U == msc->scsi_buf_count) {
+        if(scsi_media_read(udev, lun) < 0) {
+            scsi_sense_code(udev, lun, HARDWARE_ERROR, UNRECOVERED_READ_ERROR);
+
+            return -1;
+        }
     }
 
-    usbd_ep_send(udev, MSC_IN_EP, msc->bbb_data, len);
+    len = msc->scsi_buf_len[msc->scsi_buf_head];
 
-    msc->scsi_blk_addr += len;
-    msc->scsi_blk_len -= len;
+    usbd_ep_send(udev, MSC_IN_EP, &msc->bbb_data[msc->scsi_buf_head * MSC_MEDIA_PACKET_SIZE], len);
+
+    msc->scsi_buf_busy = 1U;
 
     /* case 6 : Hi = Di */
     msc->bbb_csw.dCSWDataResidue -= len;
 
-    if(0U == msc->scsi_blk_len) {
+    if((0U == msc->scsi_blk_len) && (1U == msc->scsi_buf_count)) {
         msc->bbb_state = BBB_LAST_DATA_IN;
     }
 
+    /* read ahead into the free buffers while the head one is on the bus,
+       a failed read ahead is retried and reported when its data is due */
+    while((msc->scsi_buf_count < MSC_MEDIA_BUF_NUM) && (msc->scsi_blk_len > 0U)) {
+        if(scsi_media_read(udev, lun) < 0) {
+            break;
+        }
+    }
+
     return 0;
 }
 
@@ -689,36 +797,103 @@ static int8_t scsi_process_write(usb_core_driver *udev, uint8_t lun)
 {
     usbd_msc_handler *msc = (usbd_msc_handler *)udev->dev.class_data[USBD_MSC_INTERFACE];
 
-    uint32_t len = USB_MIN(msc->scsi_blk_len, MSC_MEDIA_PACKET_SIZE);
+    uint32_t len;
 
-    if(usbd_mem_fops->mem_write(lun, \
-                                msc->bbb_data, \
-                                msc->scsi_blk_addr, \
-                                (uint16_t)(len / msc->scsi_blk_size[lun])) < 0) {
-        scsi_sense_code(udev, lun, HARDWARE_ERROR, WRITE_FAULT);
+    /* the armed buffer has been filled by the host */
+    msc->scsi_buf_busy = 0U;
+    msc->scsi_buf_count++;
 
-        return -1;
-    }
+    /* receive the next packet while the filled buffers are written behind */
+    scsi_media_recev(udev);
 
-    msc->scsi_blk_addr += len;
-    msc->scsi_blk_len -= len;
+    while(msc->scsi_buf_count > 0U) {
+        len = msc->scsi_buf_len[msc->scsi_buf_head];
 
-    /* case 12 : Ho = Do */
-    msc->bbb_csw.dCSWDataResidue -= len;
+        if(usbd_mem_fops->mem_write(lun, \
+                                    &msc->bbb_data[msc->scsi_buf_head * MSC_MEDIA_PACKET_SIZE], \
+                                    msc->scsi_blk_addr, \
+                                    (uint16_t)(len / msc->scsi_blk_size[lun])) < 0) {
+            scsi_sense_code(udev, lun, HARDWARE_ERROR, WRITE_FAULT);
+
+            return -1;
+        }
+
+        msc->scsi_blk_addr += len;
+        msc->scsi_blk_len -= len;
+
+        /* case 12 : Ho = Do */
+        msc->bbb_csw.dCSWDataResidue -= len;
+
+        msc->scsi_buf_head = (uint8_t)((msc->scsi_buf_head + 1U) % MSC_MEDIA_BUF_NUM);
+        msc->scsi_buf_count--;
+
+        scsi_media_recev(udev);
+    }
 
     if(0U == msc->scsi_blk_len) {
         msc_bbb_csw_send(udev, CSW_CMD_PASSED);
-    } else {
-        /* prepare endpoint to receive next packet */
-        usbd_ep_recev(udev, \
-                      MSC_OUT_EP, \
-                      msc->bbb_data, \
-                      USB_MIN(msc->scsi_blk_len, MSC_MEDIA_PACKET_SIZE));
     }
 
     return 0;
 }
 
+/*!
+    \brief      read the next media packet into the first free buffer
+    \param[in]  udev: pointer to USB device instance
+    \param[in]  lun: logical unit number
+    \param[out] none
+    \retval     status
+*/
+static int8_t scsi_media_read(usb_core_driver *udev, uint8_t lun)
+{
+    usbd_msc_handler *msc = (usbd_msc_handler *)udev->dev.class_data[USBD_MSC_INTERFACE];
+
+    uint8_t index = (uint8_t)((msc->scsi_buf_head + msc->scsi_buf_count) % MSC_MEDIA_BUF_NUM);
+    uint32_t len = USB_MIN(msc->scsi_blk_len, MSC_MEDIA_PACKET_SIZE);
+
+    if(usbd_mem_fops->mem_read(lun, \
+                               &msc->bbb_data[index * MSC_MEDIA_PACKET_SIZE], \
+                               msc->scsi_blk_addr, \
+                               (uint16_t)(len / msc->scsi_blk_size[lun])) < 0) {
+        return -1;
+    }
+
+    msc->scsi_buf_len[index] = len;
+    msc->scsi_buf_count++;
+
+    msc->scsi_blk_addr += len;
+    msc->scsi_blk_len -= len;
+
+    return 0;
+}
+
+/*!
+    \brief      prepare endpoint to receive the next packet into the first free buffer
+    \param[in]  udev: pointer to USB device instance
+    \param[out] none
+    \retval     none
+*/
+static void scsi_media_recev(usb_core_driver *udev)
+{
+    usbd_msc_handler *msc = (usbd_msc_handler *)udev->dev.class_data[USBD_MSC_INTERFACE];
+
+    uint8_t index;
+    uint32_t len;
+
+    if((0U == msc->scsi_buf_busy) && \
+        (msc->scsi_xfer_len > 0U) && \
+         (msc->scsi_buf_count < MSC_MEDIA_BUF_NUM)) {
+        index = (uint8_t)((msc->scsi_buf_head + msc->scsi_buf_count) % MSC_MEDIA_BUF_NUM);
+        len = USB_MIN(msc->scsi_xfer_len, MSC_MEDIA_PACKET_SIZE);
+
+        msc->scsi_buf_len[index] = len;
+        msc->scsi_xfer_len -= len;
+        msc->scsi_buf_busy = 1U;
+
+        usbd_ep_recev(udev, MSC_OUT_EP, &msc->bbb_data[index * MSC_MEDIA_PACKET_SIZE], len);
+    }
+}
+
 /*!
     \brief      process format unit command
     \param[in]  udev: pointer to USB device instance
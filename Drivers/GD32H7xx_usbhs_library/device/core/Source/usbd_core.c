@@ -159,7 +159,7 @@ uint32_t usbd_ep_clear(usb_core_driver *udev, uint8_t ep_addr)
     \param[in]  pbuf: user buffer address pointer
     \param[in]  len: buffer length
     \param[out] none
-    \retval     none
+    \retval     status
 */
 uint32_t usbd_ep_recev(usb_core_driver *udev, uint8_t ep_addr, uint8_t *pbuf, uint32_t len)
 {
@@ -175,9 +175,7 @@ uint32_t usbd_ep_recev(usb_core_driver *udev, uint8_t ep_addr, uint8_t *pbuf, ui
     }
 
     /* start the transfer */
-    (void)usb_transc_outxfer(udev, transc);
-
-    return 0U;
+    return (uint32_t)usb_transc_outxfer(udev, transc);
 }
 
 /*!
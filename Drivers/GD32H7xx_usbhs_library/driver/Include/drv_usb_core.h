@@ -37,10 +37,27 @@ OF SUCH DAMAGE.
 
 #include "drv_usb_regs.h"
 #include "usb_ch9_std.h"
+#include <stddef.h>
 
 #define USB_FS_EP0_MAX_LEN                  64U                         /*!< maximum packet size of endpoint 0 */
 #define HC_MAX_PACKET_COUNT                 140U                        /*!< maximum packet count */
 
+#ifdef USB_INTERNAL_DMA_ENABLED
+    #define USB_DCACHE_LINE_SIZE            32U                         /*!< D-cache line size */
+
+    /* receive buffers that share cache lines with other data are received here first, multiple of 32,
+       at least one high-speed packet so that every single packet transfer can be bounced */
+    #ifndef USB_DMA_BOUNCE_SIZE
+        #define USB_DMA_BOUNCE_SIZE         512U                        /*!< bounce buffer size */
+    #endif /* USB_DMA_BOUNCE_SIZE */
+
+    /* compile-time check that a receive buffer larger than the bounce buffer can be invalidated in place */
+    #define USB_DMA_BUF_CHECK(type, member) \
+        typedef char usb_dma_buf_check_##member[((0U == (offsetof(type, member) % USB_DCACHE_LINE_SIZE)) && \
+                                                 (0U == (sizeof(((type *)0)->member) % USB_DCACHE_LINE_SIZE)) && \
+                                                 (0U == (__alignof__(type) % USB_DCACHE_LINE_SIZE))) ? 1 : -1]
+#endif /* USB_INTERNAL_DMA_ENABLED */
+
 #define EP_ID(x)                            ((uint8_t)((x) & 0x7FU))    /*!< endpoint number */
 #define EP_DIR(x)                           ((uint8_t)((x) >> 7))       /*!< endpoint direction */
 
@@ -198,6 +215,11 @@ typedef struct _usb_perp_dev {
     void               *class_data[4];                                  /*!< class data pointer */
     void               *user_data;                                      /*!< user data pointer */
     void               *pdata;                                          /*!< reserved data pointer */
+
+#ifdef USB_INTERNAL_DMA_ENABLED
+    __ALIGNED(32) uint8_t setup_bounce[USB_DCACHE_LINE_SIZE];           /*!< SETUP packets received by DMA */
+    __ALIGNED(32) uint8_t out_bounce[USBHS_MAX_EP_COUNT][USB_DMA_BOUNCE_SIZE]; /*!< OUT endpoint bounce buffers */
+#endif /* USB_INTERNAL_DMA_ENABLED */
 } usb_perp_dev;
 
 #endif /* USE_DEVICE_MODE */
@@ -235,6 +257,8 @@ typedef struct _usb_pipe {
     uint8_t              in_used;                                       /*!< pipe used */
     uint8_t              dev_addr;                                      /*!< USB device address */
     uint32_t             dev_speed;                                     /*!< USB device speed */
+    uint8_t              hub_addr;                                      /*!< address of the hub the device is attached to, 0 on the root port */
+    uint8_t              hub_port;                                      /*!< number of the hub port the device is attached to */
 
     struct {
         uint8_t          num;                                           /*!< endpoint numbers */
@@ -250,6 +274,7 @@ typedef struct _usb_pipe {
     uint8_t             *xfer_buf;                                      /*!< USB transfer buffer */
     uint32_t             xfer_len;                                      /*!< USB transfer length */
     uint32_t             xfer_count;                                    /*!< USB transfer count */
+    uint32_t             dma_addr;                                      /*!< DMA address */
 
     uint8_t              data_toggle_in;                                /*!< toggle DATA IN */
     uint8_t              data_toggle_out;                               /*!< toggle DATA OUT */
@@ -266,6 +291,10 @@ typedef struct _usb_host_drv {
 
     usb_pipe             pipe[USBHS_MAX_TX_FIFOS];                      /*!< USB host pipe handles */
     void                *data;                                          /*!< user data pointer */
+
+#ifdef USB_INTERNAL_DMA_ENABLED
+    __ALIGNED(32) uint8_t pipe_bounce[USBHS_MAX_TX_FIFOS][USB_DMA_BOUNCE_SIZE]; /*!< IN pipe bounce buffers */
+#endif /* USB_INTERNAL_DMA_ENABLED */
 } usb_host_drv;
 
 #endif /* USE_HOST_MODE */
@@ -345,6 +374,89 @@ __STATIC_INLINE void usb_globalint_disable(usb_core_regs *usb_regs)
     usb_regs->gr->GAHBCS &= ~GAHBCS_GINTEN;
 }
 
+#ifdef USB_INTERNAL_DMA_ENABLED
+
+/*!
+    \brief      check whether the D-cache is enabled
+    \param[in]  none
+    \param[out] none
+    \retval     1 if the D-cache is enabled, 0 otherwise
+*/
+__STATIC_INLINE uint8_t usb_dcache_enabled(void)
+{
+    return (0U != (SCB->CCR & SCB_CCR_DC_Msk)) ? 1U : 0U;
+}
+
+/*!
+    \brief      write a transmit buffer back to memory before the DMA reads it
+    \param[in]  buf: transmit buffer
+    \param[in]  len: transmit length
+    \param[out] none
+    \retval     none
+*/
+__STATIC_INLINE void usb_dma_tx_prepare(uint8_t *buf, uint32_t len)
+{
+    if((0U != len) && (1U == usb_dcache_enabled())) {
+        SCB_CleanDCache_by_Addr(buf, (int32_t)len);
+    }
+}
+
+/*!
+    \brief      prepare a receive buffer for the DMA
+    \param[in]  buf: receive buffer
+    \param[in]  len: length of the receive buffer
+    \param[in]  dma_len: maximum length the DMA may write, a whole number of packets
+    \param[in]  bounce: bounce buffer of USB_DMA_BOUNCE_SIZE bytes, 32-byte aligned
+    \param[out] none
+    \retval     address to be programmed in the DMA address register, 0 if the buffer can not be used
+*/
+__STATIC_INLINE uint32_t usb_dma_rx_prepare(uint8_t *buf, uint32_t len, uint32_t dma_len, uint8_t *bounce)
+{
+    if((0U != dma_len) && (1U == usb_dcache_enabled())) {
+        /* a buffer sharing a cache line with other data, or shorter than the DMA write, can not be
+           invalidated safely, receive it in the bounce buffer and refuse it when it does not fit */
+        if((0U != (((uint32_t)buf | len) & (USB_DCACHE_LINE_SIZE - 1U))) || (dma_len > len)) {
+            if(dma_len > USB_DMA_BOUNCE_SIZE) {
+                return 0U;
+            }
+
+            buf = bounce;
+        }
+
+        /* no dirty line may be evicted over the received data */
+        SCB_CleanInvalidateDCache_by_Addr(buf, (int32_t)dma_len);
+    }
+
+    return (uint32_t)buf;
+}
+
+/*!
+    \brief      make the received data visible to the CPU
+    \param[in]  buf: receive buffer
+    \param[in]  len: received length
+    \param[in]  dma_addr: address returned by usb_dma_rx_prepare()
+    \param[out] none
+    \retval     none
+*/
+__STATIC_INLINE void usb_dma_rx_complete(uint8_t *buf, uint32_t len, uint32_t dma_addr)
+{
+    uint8_t *src = (uint8_t *)dma_addr;
+
+    if(0U != len) {
+        if(1U == usb_dcache_enabled()) {
+            SCB_InvalidateDCache_by_Addr(src, (int32_t)len);
+        }
+
+        if(src != buf) {
+            while(len--) {
+                *buf++ = *src++;
+            }
+        }
+    }
+}
+
+#endif /* USB_INTERNAL_DMA_ENABLED */
+
 /* function declarations */
 /* configures USB parameters */
 void usb_para_init(usb_core_driver *core, uint32_t usb_periph, uint32_t usb_speed);
@@ -485,6 +485,9 @@ typedef struct _usb_regs
 #define PIPE_CTL_EPMPL(x)         (((uint32_t)(x) <<  0U) & HCHCTL_MPL)      /*!< maximum packet length */
 #define PIPE_CTL_LSD(x)           (((uint32_t)(x) << 17U) & HCHCTL_LSD)      /*!< low-Speed device */
 
+#define PIPE_SPLT_HADDR(x)        (((uint32_t)(x) << 7U) & HCHSTCTL_HADDR)   /*!< hub address */
+#define PIPE_SPLT_PADDR(x)        (((uint32_t)(x) << 0U) & HCHSTCTL_PADDR)   /*!< hub port address */
+
 #define PIPE_XFER_PCNT(x)         (((uint32_t)(x) << 19U) & HCHLEN_PCNT)     /*!< packet count */
 #define PIPE_XFER_DPID(x)         (((uint32_t)(x) << 29U) & HCHLEN_DPID)     /*!< data PID */
 
@@ -38,6 +38,18 @@ OF SUCH DAMAGE.
 #include "drv_usb_core.h"
 #include "drv_usb_dev.h"
 
+#ifdef USBD_ISR_CYCLE_STATS
+/* usbd_isr() execution time, in core clock cycles */
+typedef struct {
+    uint32_t count;                                 /*!< number of calls */
+    uint32_t last;                                  /*!< cycles of the last call */
+    uint32_t max;                                   /*!< cycles of the longest call */
+    uint64_t total;                                 /*!< cycles of all calls */
+} usbd_isr_stats;
+
+extern usbd_isr_stats usbd_isr_cycles;
+#endif /* USBD_ISR_CYCLE_STATS */
+
 /* function declarations */
 #ifdef USB_DEDICATED_EP1_ENABLED
 /* USB dedicated OUT endpoint 1 interrupt service routine handler */
@@ -269,14 +269,62 @@ usb_status usb_txfifo_write(usb_core_regs *usb_regs, \
                             uint8_t fifo_num, \
                             uint16_t byte_count)
 {
-    uint32_t word_count = (byte_count + 3U) / 4U;
+    uint32_t word_count = (uint32_t)byte_count >> 2;
+    uint32_t tail = (uint32_t)byte_count & 3U;
+    uint32_t data;
 
     __IO uint32_t *fifo = usb_regs->DFIFO[fifo_num];
 
-    while(word_count-- > 0U) {
-        *fifo = *((__IO uint32_t *)src_buf);
+    if(0U == ((uint32_t)src_buf & 3U)) {
+        const uint32_t *src = (const uint32_t *)src_buf;
 
-        src_buf += 4U;
+        /* word aligned source, four words per iteration */
+        while(word_count >= 4U) {
+            *fifo = src[0];
+            *fifo = src[1];
+            *fifo = src[2];
+            *fifo = src[3];
+
+            src += 4U;
+            word_count -= 4U;
+        }
+
+        while(word_count-- > 0U) {
+            *fifo = *src++;
+        }
+
+        src_buf = (uint8_t *)src;
+    } else {
+        while(word_count >= 4U) {
+            *fifo = __UNALIGNED_UINT32_READ(src_buf);
+            *fifo = __UNALIGNED_UINT32_READ(src_buf + 4U);
+            *fifo = __UNALIGNED_UINT32_READ(src_buf + 8U);
+            *fifo = __UNALIGNED_UINT32_READ(src_buf + 12U);
+
+            src_buf += 16U;
+            word_count -= 4U;
+        }
+
+        while(word_count-- > 0U) {
+            *fifo = __UNALIGNED_UINT32_READ(src_buf);
+
+            src_buf += 4U;
+        }
+    }
+
+    /* the last partial word, without reading beyond the buffer */
+    if(0U != tail) {
+        data = src_buf[0];
+
+        if(tail > 1U) {
+            data |= (uint32_t)src_buf[1] << 8;
+        }
+
+        if(tail > 2U) {
+            data |= (uint32_t)src_buf[2] << 16;
+        }
+
+        *fifo = data;
     }
 
     return USB_OK;
@@ -292,13 +340,64 @@ usb_status usb_txfifo_write(usb_core_regs *usb_regs, \
 */
 void *usb_rxfifo_read(usb_core_regs *usb_regs, uint8_t *dest_buf, uint16_t byte_count)
 {
-    __IO uint32_t word_count = (byte_count + 3U) / 4U;
+    uint32_t word_count = (uint32_t)byte_count >> 2;
+    uint32_t tail = (uint32_t)byte_count & 3U;
+    uint32_t data;
+
     __IO uint32_t *fifo = usb_regs->DFIFO[0];
 
-    while(word_count-- > 0U) {
-        *(__IO uint32_t *)dest_buf = *fifo;
+    if(0U == ((uint32_t)dest_buf & 3U)) {
+        uint32_t *dest = (uint32_t *)dest_buf;
+
+        /* word aligned destination, four words per iteration */
+        while(word_count >= 4U) {
+            dest[0] = *fifo;
+            dest[1] = *fifo;
+            dest[2] = *fifo;
+            dest[3] = *fifo;
+
+            dest += 4U;
+            word_count -= 4U;
+        }
+
+        while(word_count-- > 0U) {
+            *dest++ = *fifo;
+        }
+
+        dest_buf = (uint8_t *)dest;
+    } else {
+        while(word_count >= 4U) {
+            __UNALIGNED_UINT32_WRITE(dest_buf, *fifo);
+            __UNALIGNED_UINT32_WRITE(dest_buf + 4U, *fifo);
+            __UNALIGNED_UINT32_WRITE(dest_buf + 8U, *fifo);
+            __UNALIGNED_UINT32_WRITE(dest_buf + 12U, *fifo);
+
+            dest_buf += 16U;
+            word_count -= 4U;
+        }
+
+        while(word_count-- > 0U) {
+            __UNALIGNED_UINT32_WRITE(dest_buf, *fifo);
+
+            dest_buf += 4U;
+        }
+    }
+
+    /* the last partial word, without writing beyond the buffer */
+    if(0U != tail) {
+        data = *fifo;
+
+        dest_buf[0] = (uint8_t)data;
+
+        if(tail > 1U) {
+            dest_buf[1] = (uint8_t)(data >> 8);
+        }
+
+        if(tail > 2U) {
+            dest_buf[2] = (uint8_t)(data >> 16);
+        }
 
-        dest_buf += 4U;
+        dest_buf += tail;
     }
 
     return ((void *)dest_buf);
@@ -363,6 +363,10 @@ usb_status usb_transc_inxfer(usb_core_driver *udev, usb_transc *transc)
     }
 
     if((uint8_t)USB_USE_DMA == udev->bp.transfer_mode) {
+#ifdef USB_INTERNAL_DMA_ENABLED
+        usb_dma_tx_prepare(transc->xfer_buf, transc->xfer_len);
+#endif /* USB_INTERNAL_DMA_ENABLED */
+
         udev->regs.er_in[ep_num]->DIEPDMAADDR = transc->dma_addr;
     }
 
@@ -424,6 +428,16 @@ usb_status usb_transc_outxfer(usb_core_driver *udev, usb_transc *transc)
     udev->regs.er_out[ep_num]->DOEPLEN = eplen;
 
     if((uint8_t)USB_USE_DMA == udev->bp.transfer_mode) {
+#ifdef USB_INTERNAL_DMA_ENABLED
+        transc->dma_addr = usb_dma_rx_prepare(transc->xfer_buf, transc->xfer_len, eplen & DEPLEN_TLEN, \
+                                              udev->dev.out_bounce[ep_num]);
+
+        /* the endpoint is left disabled rather than corrupting the data around the buffer */
+        if(0U == transc->dma_addr) {
+            return USB_FAIL;
+        }
+#endif /* USB_INTERNAL_DMA_ENABLED */
+
         udev->regs.er_out[ep_num]->DOEPDMAADDR = transc->dma_addr;
     }
 
@@ -539,7 +553,16 @@ void usb_ctlep_startout(usb_core_driver *udev)
     udev->regs.er_out[0]->DOEPLEN = DOEP0_TLEN(8U * 3U) | DOEP0_PCNT(1U) | DOEP0_STPCNT(3U);
 
     if((uint8_t)USB_USE_DMA == udev->bp.transfer_mode) {
+#ifdef USB_INTERNAL_DMA_ENABLED
+        /* the request sits among data the CPU keeps writing, receive it in its own cache line */
+        if(1U == usb_dcache_enabled()) {
+            SCB_InvalidateDCache_by_Addr(udev->dev.setup_bounce, (int32_t)USB_DCACHE_LINE_SIZE);
+        }
+
+        udev->regs.er_out[0]->DOEPDMAADDR = (uint32_t)udev->dev.setup_bounce;
+#else
         udev->regs.er_out[0]->DOEPDMAADDR = (uint32_t)&udev->dev.control.req;
+#endif /* USB_INTERNAL_DMA_ENABLED */
 
         /* endpoint enable */
         udev->regs.er_out[0]->DOEPCTL |= DEPCTL_EPACT | DEPCTL_EPEN;
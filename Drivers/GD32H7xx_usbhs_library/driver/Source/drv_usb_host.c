@@ -231,6 +231,15 @@ usb_status usb_pipe_init(usb_core_driver *udev, uint8_t pipe_num)
         break;
     }
 
+    /* full and low speed devices behind a high speed hub are reached through split transactions */
+    if((0U != pp->hub_addr) && (PORT_SPEED_HIGH != pp->dev_speed) && (PORT_SPEED_HIGH == usb_curspeed_get(udev))) {
+        pp_inten |= HCHINTEN_ACKIE | HCHINTEN_NYETIE | HCHINTEN_NAKIE;
+
+        udev->regs.pr[pipe_num]->HCHSTCTL = HCHSTCTL_SPLEN | PIPE_SPLT_HADDR(pp->hub_addr) | PIPE_SPLT_PADDR(pp->hub_port);
+    } else {
+        udev->regs.pr[pipe_num]->HCHSTCTL = 0U;
+    }
+
     udev->regs.pr[pipe_num]->HCHINTEN = pp_inten;
 
     /* enable the top level host channel interrupt */
@@ -274,6 +283,10 @@ usb_status usb_pipe_xfer(usb_core_driver *udev, uint8_t pipe_num)
 
     uint16_t max_packet_len = pp->ep.mps;
 
+#ifdef USB_INTERNAL_DMA_ENABLED
+    uint32_t buf_len = pp->xfer_len;
+#endif /* USB_INTERNAL_DMA_ENABLED */
+
     /* compute the expected number of packets associated to the transfer */
     if(pp->xfer_len > 0U) {
         packet_count = (uint16_t)((pp->xfer_len + max_packet_len - 1U) / max_packet_len);
@@ -294,7 +307,22 @@ usb_status usb_pipe_xfer(usb_core_driver *udev, uint8_t pipe_num)
     udev->regs.pr[pipe_num]->HCHLEN = pp->xfer_len | pp->DPID | PIPE_XFER_PCNT(packet_count);
 
     if(USB_USE_DMA == udev->bp.transfer_mode) {
-        udev->regs.pr[pipe_num]->HCHDMAADDR = (unsigned int)pp->xfer_buf;
+        pp->dma_addr = (uint32_t)pp->xfer_buf;
+
+#ifdef USB_INTERNAL_DMA_ENABLED
+        if(pp->ep.dir) {
+            pp->dma_addr = usb_dma_rx_prepare(pp->xfer_buf, buf_len, pp->xfer_len, udev->host.pipe_bounce[pipe_num]);
+
+            /* the pipe is left disabled rather than corrupting the data around the buffer */
+            if(0U == pp->dma_addr) {
+                return USB_FAIL;
+            }
+        } else {
+            usb_dma_tx_prepare(pp->xfer_buf, pp->xfer_len);
+        }
+#endif /* USB_INTERNAL_DMA_ENABLED */
+
+        udev->regs.pr[pipe_num]->HCHDMAADDR = pp->dma_addr;
     }
 
     pp_ctl = udev->regs.pr[pipe_num]->HCHCTL;
@@ -58,6 +58,12 @@ static uint32_t usbd_int_lpm(usb_core_driver *udev, usb_lpm_type active_type);
 #endif /* LPM_ENABLED */
 
 static uint32_t usbd_emptytxfifo_write(usb_core_driver *udev, uint32_t ep_num);
+static uint32_t usbd_outxfer_count(usb_transc *transc, uint32_t eplen);
+static void usbd_isr_process(usb_core_driver *udev);
+
+#ifdef USBD_ISR_CYCLE_STATS
+usbd_isr_stats usbd_isr_cycles = {0U, 0U, 0U, 0U};
+#endif /* USBD_ISR_CYCLE_STATS */
 
 /*!
     \brief      USB device-mode interrupts global service routine handler
@@ -66,6 +72,43 @@ static uint32_t usbd_emptytxfifo_write(usb_core_driver *udev, uint32_t ep_num);
     \retval     none
 */
 void usbd_isr(usb_core_driver *udev)
+{
+#ifdef USBD_ISR_CYCLE_STATS
+    uint32_t cycles;
+
+    /* start the cycle counter on first use */
+    if(0U == (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+        DWT->LAR = 0xC5ACCE55U;
+        DWT->CYCCNT = 0U;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    cycles = DWT->CYCCNT;
+
+    usbd_isr_process(udev);
+
+    cycles = DWT->CYCCNT - cycles;
+
+    usbd_isr_cycles.count++;
+    usbd_isr_cycles.last = cycles;
+    usbd_isr_cycles.total += cycles;
+
+    if(cycles > usbd_isr_cycles.max) {
+        usbd_isr_cycles.max = cycles;
+    }
+#else
+    usbd_isr_process(udev);
+#endif /* USBD_ISR_CYCLE_STATS */
+}
+
+/*!
+    \brief      dispatch the pending device-mode interrupts
+    \param[in]  udev: pointer to USB device instance
+    \param[out] none
+    \retval     none
+*/
+static void usbd_isr_process(usb_core_driver *udev)
 {
     if(HOST_MODE != (udev->regs.gr->GINTF & GINTF_COPM)) {
         uint32_t intr = udev->regs.gr->GINTF;
@@ -202,8 +245,14 @@ static uint32_t usbd_int_epout(usb_core_driver *udev)
                 if((uint8_t)USB_USE_DMA == udev->bp.transfer_mode) {
                     __IO uint32_t eplen = udev->regs.er_out[ep_num]->DOEPLEN;
 
-                    udev->dev.transc_out[ep_num].xfer_count = udev->dev.transc_out[ep_num].max_len - \
-                                                                (eplen & DEPLEN_TLEN);
+                    udev->dev.transc_out[ep_num].xfer_count = usbd_outxfer_count(&udev->dev.transc_out[ep_num], eplen);
+
+#ifdef USB_INTERNAL_DMA_ENABLED
+                    /* only the received bytes, at most the length the buffer was armed with */
+                    usb_dma_rx_complete(udev->dev.transc_out[ep_num].xfer_buf, \
+                                        USB_MIN(udev->dev.transc_out[ep_num].xfer_count, udev->dev.transc_out[ep_num].xfer_len), \
+                                        udev->dev.transc_out[ep_num].dma_addr);
+#endif /* USB_INTERNAL_DMA_ENABLED */
                 }
 
                 /* inform upper layer: data ready */
@@ -218,6 +267,14 @@ static uint32_t usbd_int_epout(usb_core_driver *udev)
 
             /* SETUP phase finished interrupt (control endpoints) */
             if(oepintr & DOEPINTF_STPF) {
+#ifdef USB_INTERNAL_DMA_ENABLED
+                if((uint8_t)USB_USE_DMA == udev->bp.transfer_mode) {
+                    usb_dma_rx_complete((uint8_t *)&udev->dev.control.req, \
+                                        sizeof(usb_req), \
+                                        (uint32_t)udev->dev.setup_bounce);
+                }
+#endif /* USB_INTERNAL_DMA_ENABLED */
+
                 /* inform the upper layer that a SETUP packet is available */
                 (void)usbd_setup_transc(udev);
 
@@ -540,9 +597,14 @@ uint32_t usbd_int_dedicated_ep1out(usb_core_driver *udev)
         if(USB_USE_DMA == udev->bp.transfer_mode) {
             oeplen = udev->regs.er_out[1]->DOEPLEN;
 
-            /* ToDo : handle more than one single MPS size packet */
-            udev->dev.transc_out[1].xfer_count = udev->dev.transc_out[1].max_len - \
-                                    (oeplen & DEPLEN_TLEN);
+            udev->dev.transc_out[1].xfer_count = usbd_outxfer_count(&udev->dev.transc_out[1], oeplen);
+
+#ifdef USB_INTERNAL_DMA_ENABLED
+            /* only the received bytes, at most the length the buffer was armed with */
+            usb_dma_rx_complete(udev->dev.transc_out[1].xfer_buf, \
+                                USB_MIN(udev->dev.transc_out[1].xfer_count, udev->dev.transc_out[1].xfer_len), \
+                                udev->dev.transc_out[1].dma_addr);
+#endif /* USB_INTERNAL_DMA_ENABLED */
         }
 
         /* RX COMPLETE */
@@ -644,6 +706,25 @@ static uint32_t usbd_int_lpm(usb_core_driver *udev, usb_lpm_type active_type)
 
 #endif /* LPM_ENABLED */
 
+/*!
+    \brief      get the number of bytes a DMA OUT transfer has received
+    \param[in]  transc: the USB OUT transaction
+    \param[in]  eplen: DOEPLEN value at transfer complete
+    \param[out] none
+    \retval     received byte count
+*/
+static uint32_t usbd_outxfer_count(usb_transc *transc, uint32_t eplen)
+{
+    /* the transfer was armed with whole packets, see usb_transc_outxfer() */
+    uint32_t xfer_size = transc->max_len;
+
+    if((0U != transc->xfer_len) && (0U != transc->ep_addr.num)) {
+        xfer_size = ((transc->xfer_len + transc->max_len - 1U) / transc->max_len) * transc->max_len;
+    }
+
+    return xfer_size - (eplen & DEPLEN_TLEN);
+}
+
 /*!
     \brief      check FIFO for the next packet to be loaded
     \param[in]  udev: pointer to USB device instance
@@ -655,32 +736,38 @@ static uint32_t usbd_emptytxfifo_write(usb_core_driver *udev, uint32_t ep_num)
 {
     uint32_t len;
     uint32_t word_count;
+    uint32_t space;
 
     usb_transc *transc = &udev->dev.transc_in[ep_num];
 
-    len = transc->xfer_len - transc->xfer_count;
-
-    /* get the data length to write */
-    if(len > transc->max_len) {
-        len = transc->max_len;
-    }
+    /* free FIFO space in words, tracked locally while packets are loaded */
+    space = udev->regs.er_in[ep_num]->DIEPTFSTAT & DIEPTFSTAT_IEPTFS;
 
-    word_count = (len + 3U) / 4U;
-
-    while(((udev->regs.er_in[ep_num]->DIEPTFSTAT & DIEPTFSTAT_IEPTFS) >= word_count) && \
-            (transc->xfer_count < transc->xfer_len)) {
+    /* load as many packets as the FIFO can hold */
+    while(transc->xfer_count < transc->xfer_len) {
         len = transc->xfer_len - transc->xfer_count;
 
+        /* get the data length to write */
         if(len > transc->max_len) {
             len = transc->max_len;
         }
 
-        /* write FIFO in word(4bytes) */
         word_count = (len + 3U) / 4U;
 
+        if(space < word_count) {
+            /* the core may have sent packets meanwhile */
+            space = udev->regs.er_in[ep_num]->DIEPTFSTAT & DIEPTFSTAT_IEPTFS;
+
+            if(space < word_count) {
+                break;
+            }
+        }
+
         /* write the FIFO */
         (void)usb_txfifo_write(&udev->regs, transc->xfer_buf, (uint8_t)ep_num, (uint16_t)len);
 
+        space -= word_count;
+
         transc->xfer_buf += len;
         transc->xfer_count += len;
 
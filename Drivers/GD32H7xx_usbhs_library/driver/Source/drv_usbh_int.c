@@ -49,6 +49,7 @@ static uint32_t usbh_int_port(usb_core_driver *udev);
 static uint32_t usbh_int_pipe(usb_core_driver *udev);
 static uint32_t usbh_int_pipe_in(usb_core_driver *udev, uint32_t pp_num);
 static uint32_t usbh_int_pipe_out(usb_core_driver *udev, uint32_t pp_num);
+static uint32_t usbh_int_pipe_split(usb_core_driver *udev, uint32_t pp_num, uint32_t intr_pp);
 static uint32_t usbh_int_rxfifonoempty(usb_core_driver *udev);
 static uint32_t usbh_int_txfifoempty(usb_core_driver *udev, usb_pipe_mode pp_mode);
 
@@ -257,6 +258,10 @@ static uint32_t usbh_int_pipe_in(usb_core_driver *udev, uint32_t pp_num)
 
     uint8_t ep_type = (uint8_t)((pp_reg->HCHCTL & HCHCTL_EPTYPE) >> 18);
 
+    if(0U != usbh_int_pipe_split(udev, pp_num, intr_pp)) {
+        return 1U;
+    }
+
     if(intr_pp & HCHINTF_ACK) {
         pp_reg->HCHINTF = HCHINTF_ACK;
     } else if(intr_pp & HCHINTF_STALL) {
@@ -279,6 +284,10 @@ static uint32_t usbh_int_pipe_in(usb_core_driver *udev, uint32_t pp_num)
     } else if(intr_pp & HCHINTF_TF) {
         if((uint8_t)USB_USE_DMA == udev->bp.transfer_mode) {
             udev->host.backup_xfercount[pp_num] = pp->xfer_len - (pp_reg->HCHLEN & HCHLEN_TLEN);
+
+#ifdef USB_INTERNAL_DMA_ENABLED
+            usb_dma_rx_complete(pp->xfer_buf, udev->host.backup_xfercount[pp_num], pp->dma_addr);
+#endif /* USB_INTERNAL_DMA_ENABLED */
         }
 
         pp->pp_status = PIPE_XF;
@@ -387,6 +396,10 @@ static uint32_t usbh_int_pipe_out(usb_core_driver *udev, uint32_t pp_num)
     uint32_t intr_pp = pp_reg->HCHINTF;
     intr_pp &= pp_reg->HCHINTEN;
 
+    if(0U != usbh_int_pipe_split(udev, pp_num, intr_pp)) {
+        return 1U;
+    }
+
     if(intr_pp & HCHINTF_ACK) {
         if(1U == udev->host.pipe[pp_num].do_ping) {
             udev->host.pipe[pp_num].do_ping = 0U;
@@ -488,6 +501,49 @@ static uint32_t usbh_int_pipe_out(usb_core_driver *udev, uint32_t pp_num)
     return 1U;
 }
 
+/*!
+    \brief      handle the split transaction handshakes of a host channel
+    \param[in]  udev: pointer to USB device instance
+    \param[in]  pp_num: host channel number which is in (0..7)
+    \param[in]  intr_pp: pending and enabled channel interrupts
+    \param[out] none
+    \retval     1 if the interrupt has been handled here, 0 if it is left to the IN/OUT handler
+*/
+static uint32_t usbh_int_pipe_split(usb_core_driver *udev, uint32_t pp_num, uint32_t intr_pp)
+{
+    usb_pr *pp_reg = udev->regs.pr[pp_num];
+
+    if(0U == (pp_reg->HCHSTCTL & HCHSTCTL_SPLEN)) {
+        return 0U;
+    }
+
+    if(0U == (pp_reg->HCHSTCTL & HCHSTCTL_CSPLT)) {
+        if(intr_pp & HCHINTF_ACK) {
+            /* the hub accepted the start split, collect the result with complete splits */
+            pp_reg->HCHINTF = HCHINTF_ACK;
+            pp_reg->HCHSTCTL |= HCHSTCTL_CSPLT;
+            pp_reg->HCHCTL = (pp_reg->HCHCTL | HCHCTL_CEN) & ~HCHCTL_CDIS;
+
+            return 1U;
+        }
+    } else {
+        if(intr_pp & HCHINTF_NYET) {
+            /* the full/low speed transaction is still running behind the hub */
+            pp_reg->HCHINTF = HCHINTF_NYET;
+            pp_reg->HCHCTL = (pp_reg->HCHCTL | HCHCTL_CEN) & ~HCHCTL_CDIS;
+
+            return 1U;
+        }
+
+        if(intr_pp & (HCHINTF_TF | HCHINTF_NAK | HCHINTF_STALL | HCHINTF_USBER | HCHINTF_DTER)) {
+            /* the transaction is over, the next one starts with a start split again */
+            pp_reg->HCHSTCTL &= ~HCHSTCTL_CSPLT;
+        }
+    }
+
+    return 0U;
+}
+
 /*!
     \brief      handle the RX FIFO non-empty interrupt
     \param[in]  udev: pointer to USB device instance
@@ -132,7 +132,7 @@ void cdc_stop_reception(usbh_host *uhost)
 
     cdc->rx_enabled = 0U;
 
-    usb_pipe_halt(uhost->data, cdc->data_itf.pipe_in);
+    usbh_pipe_halt(uhost->data, cdc->data_itf.pipe_in);
     usbh_pipe_free(uhost->data, cdc->data_itf.pipe_in);
 }
 
@@ -368,7 +368,7 @@ static void cdc_interface_deinit(usbh_host *uhost)
 
     /* reset the channel as free */
     if(cdc->cmd_itf.pipe_notify) {
-        usb_pipe_halt(uhost->data, cdc->cmd_itf.pipe_notify);
+        usbh_pipe_halt(uhost->data, cdc->cmd_itf.pipe_notify);
         usbh_pipe_free(uhost->data, cdc->cmd_itf.pipe_notify);
 
         cdc->cmd_itf.pipe_notify = 0U;
@@ -376,7 +376,7 @@ static void cdc_interface_deinit(usbh_host *uhost)
 
     /* reset the channel as free */
     if(cdc->data_itf.pipe_out) {
-        usb_pipe_halt(uhost->data, cdc->data_itf.pipe_out);
+        usbh_pipe_halt(uhost->data, cdc->data_itf.pipe_out);
         usbh_pipe_free(uhost->data, cdc->data_itf.pipe_out);
 
         cdc->data_itf.pipe_out = 0U;
@@ -384,7 +384,7 @@ static void cdc_interface_deinit(usbh_host *uhost)
 
     /* reset the channel as free */
     if(cdc->data_itf.pipe_in) {
-        usb_pipe_halt(uhost->data, cdc->data_itf.pipe_in);
+        usbh_pipe_halt(uhost->data, cdc->data_itf.pipe_in);
         usbh_pipe_free(uhost->data, cdc->data_itf.pipe_in);
 
         cdc->data_itf.pipe_in = 0U;
@@ -583,8 +583,8 @@ static void cdc_process_reception(usbh_host *uhost)
             /* check the last state of the device is URB_DONE */
             if(URB_DONE == urb_status_rx) {
                 /* move the pointer as well as data length */
-                cdc->rx_param.data_length += udev->host.pipe[cdc->data_itf.pipe_in].xfer_count;
-                cdc->rx_param.pfill_buff += udev->host.pipe[cdc->data_itf.pipe_in].xfer_count;
+                cdc->rx_param.data_length += usbh_pipe_get(udev, cdc->data_itf.pipe_in)->xfer_count;
+                cdc->rx_param.pfill_buff += usbh_pipe_get(udev, cdc->data_itf.pipe_in)->xfer_count;
 
                 /* Process the received data */
                 cdc_receive_data(uhost, &cdc->rx_param);
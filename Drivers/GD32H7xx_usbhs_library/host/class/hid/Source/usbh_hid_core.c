@@ -143,7 +143,7 @@ void usbh_hid_itf_deinit(usbh_host *uhost)
     usbh_hid_handler *hid = (usbh_hid_handler *)uhost->active_class->class_data;
 
     if(0x00U != hid->pipe_in) {
-        usb_pipe_halt(uhost->data, hid->pipe_in);
+        usbh_pipe_halt(uhost->data, hid->pipe_in);
 
         usbh_pipe_free(uhost->data, hid->pipe_in);
 
@@ -152,7 +152,7 @@ void usbh_hid_itf_deinit(usbh_host *uhost)
     }
 
     if(0x00U != hid->pipe_out) {
-        usb_pipe_halt(uhost->data, hid->pipe_out);
+        usbh_pipe_halt(uhost->data, hid->pipe_out);
 
         usbh_pipe_free(uhost->data, hid->pipe_out);
 
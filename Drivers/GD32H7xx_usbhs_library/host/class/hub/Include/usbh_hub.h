@@ -0,0 +1,113 @@
+/*!
+    \file    usbh_hub.h
+    \brief   header file for the usbh_hub.c
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef USBH_HUB_H
+#define USBH_HUB_H
+
+#include "usbh_enum.h"
+#include "usbh_transc.h"
+
+/* downstream ports served, further ports of a larger hub are left unpowered */
+#ifndef USBH_HUB_PORT_NUM
+#define USBH_HUB_PORT_NUM                               4U
+#endif /* USBH_HUB_PORT_NUM */
+
+#if (USBH_HUB_PORT_NUM > 15U)
+#error "invalid USB host hub configuration"
+#endif
+
+#define USB_DESCTYPE_HUB                                0x29U     /*!< hub descriptor type */
+#define USB_HUB_DESC_SIZE                               7U        /*!< hub descriptor size without the port bitmaps */
+
+/* hub class feature selectors */
+#define HUB_FEAT_PORT_RESET                             4U        /*!< port reset */
+#define HUB_FEAT_PORT_POWER                             8U        /*!< port power */
+#define HUB_FEAT_C_PORT_CONNECTION                      16U       /*!< port connection change */
+#define HUB_FEAT_C_PORT_ENABLE                          17U       /*!< port enable change */
+#define HUB_FEAT_C_PORT_SUSPEND                         18U       /*!< port suspend change */
+#define HUB_FEAT_C_PORT_OVER_CURRENT                    19U       /*!< port over-current change */
+#define HUB_FEAT_C_PORT_RESET                           20U       /*!< port reset change */
+
+/* wPortStatus bits */
+#define HUB_PORT_STAT_CONNECTION                        0x0001U   /*!< device present */
+#define HUB_PORT_STAT_ENABLE                            0x0002U   /*!< port enabled */
+#define HUB_PORT_STAT_RESET                             0x0010U   /*!< reset signalling in progress */
+#define HUB_PORT_STAT_LOW_SPEED                         0x0200U   /*!< low speed device attached */
+#define HUB_PORT_STAT_HIGH_SPEED                        0x0400U   /*!< high speed device attached */
+
+/* states of the hub class request machine */
+typedef enum {
+    HUB_REQ_GET_DESC = 0U,                                        /*!< get hub descriptor */
+    HUB_REQ_PORT_POWER,                                           /*!< power the downstream ports */
+    HUB_REQ_POWER_WAIT,                                           /*!< wait for the port power to be good */
+    HUB_REQ_IDLE                                                  /*!< all requests performed */
+} hub_ctlstate;
+
+/* states of the hub port machine */
+typedef enum {
+    HUB_IDLE = 0U,                                                /*!< look for a port with a pending change */
+    HUB_POLL,                                                     /*!< wait for the status change bitmap */
+    HUB_PORT_STATUS_GET,                                          /*!< read the port status */
+    HUB_PORT_CHANGE_CLEAR,                                        /*!< acknowledge the port changes */
+    HUB_PORT_UPDATE,                                              /*!< attach, reset or detach the port device */
+    HUB_PORT_RESET                                                /*!< reset the port */
+} hub_state;
+
+/* structure for hub process */
+typedef struct _hub_process {
+    uint8_t              pipe_in;                                 /*!< status change pipe */
+    uint8_t              ep_in;                                   /*!< status change endpoint */
+    uint16_t             ep_size;                                 /*!< status change endpoint size */
+    uint16_t             poll;                                    /*!< status change polling interval, in SOF periods */
+    uint32_t             timer;                                   /*!< SOF count of the last poll */
+    uint8_t              port_num;                                /*!< downstream ports served */
+    uint8_t              pwr_delay;                               /*!< power-on to power-good time, in 2 ms units */
+    uint8_t              port;                                    /*!< port being processed */
+    uint8_t              feature;                                 /*!< port change feature being cleared */
+    uint16_t             port_status;                             /*!< wPortStatus of the port being processed */
+    uint16_t             port_change;                             /*!< wPortChange of the port being processed */
+    uint32_t             change_map;                              /*!< ports with a pending change */
+    uint8_t              status_buf[8];                           /*!< status change bitmap */
+    hub_state            state;                                   /*!< hub port state */
+    hub_ctlstate         ctl_state;                               /*!< hub class request state */
+    usbh_host            dev[USBH_HUB_PORT_NUM];                  /*!< devices attached to the downstream ports */
+} usbh_hub_handler;
+
+extern usbh_class usbh_hub;
+
+/* function declarations */
+/* find the host running a class, on the root port or behind the hub */
+usbh_host *usbh_hub_device_find(usbh_host *uhost, uint8_t class_code);
+
+#endif /* USBH_HUB_H */
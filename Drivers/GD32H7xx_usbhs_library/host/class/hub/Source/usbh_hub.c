@@ -0,0 +1,625 @@
+/*!
+    \file    usbh_hub.c
+    \brief   USB host hub class driver
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "drv_usb_hw.h"
+#include "usbh_pipe.h"
+#include "usbh_hub.h"
+
+#include <string.h>
+
+/* local function prototypes ('static') */
+static usbh_status usbh_hub_itf_init(usbh_host *uhost);
+static void usbh_hub_itf_deinit(usbh_host *uhost);
+static usbh_status usbh_hub_class_req(usbh_host *uhost);
+static usbh_status usbh_hub_handle(usbh_host *uhost);
+static usbh_status usbh_hub_sof(usbh_host *uhost);
+static usbh_status usbh_hub_desc_get(usbh_host *uhost, uint8_t len);
+static usbh_status usbh_hub_port_feature(usbh_host *uhost, uint8_t request, uint8_t feature, uint8_t port);
+static usbh_status usbh_hub_port_status_get(usbh_host *uhost, uint8_t port);
+static uint8_t usbh_hub_change_feature(uint16_t port_change);
+static void usbh_hub_port_update(usbh_host *uhost);
+static uint8_t usbh_hub_dev_addressing(usbh_hub_handler *hub);
+static void usbh_hub_dev_attach(usbh_host *uhost, uint8_t port, uint16_t port_status);
+static void usbh_hub_dev_detach(usbh_hub_handler *hub, uint8_t port);
+
+usbh_class usbh_hub = {
+    HUB_CLASS,
+    usbh_hub_itf_init,
+    usbh_hub_itf_deinit,
+    usbh_hub_class_req,
+    usbh_hub_handle,
+    usbh_hub_sof,
+    NULL
+};
+
+/*!
+    \brief      find the host running a class, on the root port or behind the hub
+    \param[in]  uhost: pointer to USB host of the root port
+    \param[in]  class_code: USB class code
+    \param[out] none
+    \retval     pointer to the USB host of the device, NULL if there is none
+*/
+usbh_host *usbh_hub_device_find(usbh_host *uhost, uint8_t class_code)
+{
+    usbh_hub_handler *hub = NULL;
+    usbh_host *dev = NULL;
+    uint8_t i = 0U;
+
+    if((NULL == uhost->active_class) || (HOST_CLASS_HANDLER != uhost->cur_state)) {
+        return NULL;
+    }
+
+    if(class_code == uhost->active_class->class_code) {
+        return uhost;
+    }
+
+    if(HUB_CLASS == uhost->active_class->class_code) {
+        hub = (usbh_hub_handler *)uhost->active_class->class_data;
+
+        for(i = 0U; i < hub->port_num; i++) {
+            dev = &hub->dev[i];
+
+            if((1U == dev->dev_connected) && (HOST_CLASS_HANDLER == dev->cur_state) && \
+                 (NULL != dev->active_class) && (class_code == dev->active_class->class_code)) {
+                return dev;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/*!
+    \brief      initialize the hub class
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status usbh_hub_itf_init(usbh_host *uhost)
+{
+    uint8_t interface = 0U;
+    usb_desc_ep *ep_desc = NULL;
+
+    static usbh_hub_handler hub_handler;
+
+    interface = usbh_interface_find(&uhost->dev_prop, HUB_CLASS, 0xFFU, 0xFFU);
+
+    if(0xFFU == interface) {
+        uhost->usr_cb->dev_not_supported();
+
+        return USBH_FAIL;
+    }
+
+    usbh_interface_select(&uhost->dev_prop, interface);
+
+    memset((void *)&hub_handler, 0U, sizeof(usbh_hub_handler));
+
+    ep_desc = &uhost->dev_prop.cfg_desc_set.itf_desc_set[uhost->dev_prop.cur_itf][0].ep_desc[0];
+
+    hub_handler.ep_in = ep_desc->bEndpointAddress;
+    hub_handler.ep_size = USB_MIN(ep_desc->wMaxPacketSize, sizeof(hub_handler.status_buf));
+
+    hub_handler.poll = (0U != ep_desc->bInterval) ? ep_desc->bInterval : 1U;
+
+    /* bInterval counts microframes as a power of two on a high speed hub */
+    if(PORT_SPEED_HIGH == uhost->dev_prop.speed) {
+        hub_handler.poll = (uint16_t)(1U << (USB_MIN(hub_handler.poll, 16U) - 1U));
+    }
+
+    hub_handler.pipe_in = usbh_pipe_allocate(uhost->data, hub_handler.ep_in);
+
+    /* open pipe for the status change endpoint */
+    usbh_pipe_create(uhost->data, \
+                     &uhost->dev_prop, \
+                     hub_handler.pipe_in, \
+                     USB_EPTYPE_INTR, \
+                     hub_handler.ep_size);
+
+    usbh_pipe_toggle_set(uhost->data, hub_handler.pipe_in, 0U);
+
+    hub_handler.state = HUB_IDLE;
+    hub_handler.ctl_state = HUB_REQ_GET_DESC;
+
+    uhost->active_class->class_data = (void *)&hub_handler;
+
+    return USBH_OK;
+}
+
+/*!
+    \brief      deinitialize the hub class, detaching every device behind the hub
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     none
+*/
+static void usbh_hub_itf_deinit(usbh_host *uhost)
+{
+    uint8_t port = 0U;
+    usbh_hub_handler *hub = (usbh_hub_handler *)uhost->active_class->class_data;
+
+    if(NULL == hub) {
+        return;
+    }
+
+    for(port = 1U; port <= hub->port_num; port++) {
+        usbh_hub_dev_detach(hub, port);
+    }
+
+    if(0x00U != hub->pipe_in) {
+        usbh_pipe_halt(uhost->data, hub->pipe_in);
+
+        usbh_pipe_free(uhost->data, hub->pipe_in);
+
+        /* reset the pipe as free */
+        hub->pipe_in = 0U;
+    }
+}
+
+/*!
+    \brief      handle hub class requests, powering the downstream ports
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status usbh_hub_class_req(usbh_host *uhost)
+{
+    usbh_status status = USBH_BUSY;
+    usbh_status req_status = USBH_BUSY;
+
+    usbh_hub_handler *hub = (usbh_hub_handler *)uhost->active_class->class_data;
+
+    switch(hub->ctl_state) {
+    case HUB_REQ_GET_DESC:
+        req_status = usbh_hub_desc_get(uhost, USB_HUB_DESC_SIZE);
+
+        if(USBH_OK == req_status) {
+            hub->port_num = USB_MIN(uhost->dev_prop.data[2], USBH_HUB_PORT_NUM);
+            hub->pwr_delay = uhost->dev_prop.data[5];
+            hub->port = 1U;
+
+            hub->ctl_state = (0U != hub->port_num) ? HUB_REQ_PORT_POWER : HUB_REQ_POWER_WAIT;
+        }
+        break;
+
+    case HUB_REQ_PORT_POWER:
+        req_status = usbh_hub_port_feature(uhost, USB_SET_FEATURE, HUB_FEAT_PORT_POWER, hub->port);
+
+        if(USBH_OK == req_status) {
+            if(++hub->port > hub->port_num) {
+                hub->ctl_state = HUB_REQ_POWER_WAIT;
+            }
+        }
+        break;
+
+    case HUB_REQ_POWER_WAIT:
+        usb_mdelay(2U * hub->pwr_delay);
+
+        /* look at every port once, devices present at power-on may not report a change */
+        hub->change_map = ((1U << (hub->port_num + 1U)) - 1U) & ~1U;
+        hub->port = 1U;
+        hub->state = HUB_IDLE;
+        hub->ctl_state = HUB_REQ_IDLE;
+
+        /* all requests performed */
+        status = USBH_OK;
+        break;
+
+    case HUB_REQ_IDLE:
+    default:
+        status = USBH_OK;
+        break;
+    }
+
+    if(USBH_FAIL == req_status) {
+        status = USBH_UNRECOVERED_ERROR;
+    }
+
+    return status;
+}
+
+/*!
+    \brief      manage the hub ports and run the devices behind them
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status usbh_hub_handle(usbh_host *uhost)
+{
+    usbh_status status = USBH_OK;
+    usbh_status req_status = USBH_BUSY;
+    usb_urb_state urb_status = URB_IDLE;
+    usb_core_driver *udev = (usb_core_driver *)uhost->data;
+    usbh_hub_handler *hub = (usbh_hub_handler *)uhost->active_class->class_data;
+    usbh_host *dev = NULL;
+    uint8_t i = 0U;
+
+    switch(hub->state) {
+    case HUB_IDLE:
+        while((hub->port <= hub->port_num) && (0U == (hub->change_map & (1U << hub->port)))) {
+            hub->port++;
+        }
+
+        if(hub->port <= hub->port_num) {
+            hub->change_map &= ~(1U << hub->port);
+            hub->state = HUB_PORT_STATUS_GET;
+        } else if((uhost->control.timer - hub->timer) >= hub->poll) {
+            /* ask the hub which ports have changed */
+            usbh_data_recev(udev, hub->status_buf, hub->pipe_in, hub->ep_size);
+
+            hub->timer = uhost->control.timer;
+            hub->state = HUB_POLL;
+        } else {
+            /* no operation */
+        }
+        break;
+
+    case HUB_POLL:
+        urb_status = usbh_urbstate_get(udev, hub->pipe_in);
+
+        if(URB_DONE == urb_status) {
+            hub->change_map |= (uint32_t)hub->status_buf[0] | ((uint32_t)hub->status_buf[1] << 8);
+            hub->port = 1U;
+            hub->state = HUB_IDLE;
+        } else if(URB_STALL == urb_status) {
+            /* issue clear feature on the status change endpoint */
+            if(USBH_OK == usbh_clrfeature(uhost, hub->ep_in, hub->pipe_in)) {
+                hub->state = HUB_IDLE;
+            }
+        } else if((uhost->control.timer - hub->timer) >= hub->poll) {
+            /* nothing reported in this interval, retry ports still waiting for the default address */
+            hub->port = 1U;
+            hub->state = HUB_IDLE;
+        } else {
+            /* no operation */
+        }
+        break;
+
+    case HUB_PORT_STATUS_GET:
+        req_status = usbh_hub_port_status_get(uhost, hub->port);
+
+        if(USBH_OK == req_status) {
+            hub->port_status = (uint16_t)(uhost->dev_prop.data[0] | ((uint16_t)uhost->dev_prop.data[1] << 8));
+            hub->port_change = (uint16_t)(uhost->dev_prop.data[2] | ((uint16_t)uhost->dev_prop.data[3] << 8));
+            hub->feature = usbh_hub_change_feature(hub->port_change);
+
+            hub->state = (0U != hub->feature) ? HUB_PORT_CHANGE_CLEAR : HUB_PORT_UPDATE;
+        }
+        break;
+
+    case HUB_PORT_CHANGE_CLEAR:
+        req_status = usbh_hub_port_feature(uhost, USB_CLEAR_FEATURE, hub->feature, hub->port);
+
+        if(USBH_OK == req_status) {
+            hub->port_change &= (uint16_t)~(1U << (hub->feature - HUB_FEAT_C_PORT_CONNECTION));
+            hub->feature = usbh_hub_change_feature(hub->port_change);
+
+            if(0U == hub->feature) {
+                hub->state = HUB_PORT_UPDATE;
+            }
+        }
+        break;
+
+    case HUB_PORT_UPDATE:
+        usbh_hub_port_update(uhost);
+        break;
+
+    case HUB_PORT_RESET:
+        req_status = usbh_hub_port_feature(uhost, USB_SET_FEATURE, HUB_FEAT_PORT_RESET, hub->port);
+
+        if(USBH_OK == req_status) {
+            /* reset signalling lasts 10 to 20 ms */
+            usb_mdelay(20U);
+
+            hub->state = HUB_PORT_STATUS_GET;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if(USBH_FAIL == req_status) {
+        status = USBH_UNRECOVERED_ERROR;
+    }
+
+    /* run the device state machines, their transfers share the host channels through the pipe scheduler */
+    for(i = 0U; i < hub->port_num; i++) {
+        dev = &hub->dev[i];
+
+        if((1U == dev->dev_connected) || (HOST_DEFAULT != dev->cur_state)) {
+            usbh_core_task(dev);
+        }
+    }
+
+    return status;
+}
+
+/*!
+    \brief      advance the timers of the devices behind the hub
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status usbh_hub_sof(usbh_host *uhost)
+{
+    usbh_hub_handler *hub = (usbh_hub_handler *)uhost->active_class->class_data;
+    usbh_host *dev = NULL;
+    uint8_t i = 0U;
+
+    if(NULL == hub) {
+        return USBH_OK;
+    }
+
+    for(i = 0U; i < hub->port_num; i++) {
+        dev = &hub->dev[i];
+
+        dev->control.timer++;
+
+        if(((HOST_CLASS_ENUM == dev->cur_state) || (HOST_CLASS_HANDLER == dev->cur_state)) && \
+             (NULL != dev->active_class) && (NULL != dev->active_class->class_sof)) {
+            dev->active_class->class_sof(dev);
+        }
+    }
+
+    return USBH_OK;
+}
+
+/*!
+    \brief      get the hub descriptor
+    \param[in]  uhost: pointer to USB host
+    \param[in]  len: length of the descriptor
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status usbh_hub_desc_get(usbh_host *uhost, uint8_t len)
+{
+    usbh_status status = USBH_BUSY;
+
+    if(CTL_IDLE == uhost->control.ctl_state) {
+        uhost->control.setup.req = (usb_req) {
+            .bmRequestType = USB_TRX_IN | USB_RECPTYPE_DEV | USB_REQTYPE_CLASS,
+            .bRequest      = USB_GET_DESCRIPTOR,
+            .wValue        = USBH_DESC(USB_DESCTYPE_HUB),
+            .wIndex        = 0U,
+            .wLength       = len
+        };
+
+        usbh_ctlstate_config(uhost, uhost->dev_prop.data, len);
+    }
+
+    status = usbh_ctl_handler(uhost);
+
+    return status;
+}
+
+/*!
+    \brief      set or clear a hub port feature
+    \param[in]  uhost: pointer to USB host
+    \param[in]  request: USB_SET_FEATURE or USB_CLEAR_FEATURE
+    \param[in]  feature: port feature selector
+    \param[in]  port: port number
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status usbh_hub_port_feature(usbh_host *uhost, uint8_t request, uint8_t feature, uint8_t port)
+{
+    usbh_status status = USBH_BUSY;
+
+    if(CTL_IDLE == uhost->control.ctl_state) {
+        uhost->control.setup.req = (usb_req) {
+            .bmRequestType = USB_TRX_OUT | USB_RECPTYPE_OTHER | USB_REQTYPE_CLASS,
+            .bRequest      = request,
+            .wValue        = feature,
+            .wIndex        = port,
+            .wLength       = 0U
+        };
+
+        usbh_ctlstate_config(uhost, NULL, 0U);
+    }
+
+    status = usbh_ctl_handler(uhost);
+
+    return status;
+}
+
+/*!
+    \brief      get the status and change bits of a hub port
+    \param[in]  uhost: pointer to USB host
+    \param[in]  port: port number
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status usbh_hub_port_status_get(usbh_host *uhost, uint8_t port)
+{
+    usbh_status status = USBH_BUSY;
+
+    if(CTL_IDLE == uhost->control.ctl_state) {
+        uhost->control.setup.req = (usb_req) {
+            .bmRequestType = USB_TRX_IN | USB_RECPTYPE_OTHER | USB_REQTYPE_CLASS,
+            .bRequest      = USB_GET_STATUS,
+            .wValue        = 0U,
+            .wIndex        = port,
+            .wLength       = 4U
+        };
+
+        usbh_ctlstate_config(uhost, uhost->dev_prop.data, 4U);
+    }
+
+    status = usbh_ctl_handler(uhost);
+
+    return status;
+}
+
+/*!
+    \brief      get the feature acknowledging the lowest pending port change
+    \param[in]  port_change: wPortChange of the port
+    \param[out] none
+    \retval     C_PORT_* feature selector, 0 if nothing has changed
+*/
+static uint8_t usbh_hub_change_feature(uint16_t port_change)
+{
+    uint8_t i = 0U;
+
+    for(i = 0U; i <= (HUB_FEAT_C_PORT_RESET - HUB_FEAT_C_PORT_CONNECTION); i++) {
+        if(port_change & (1U << i)) {
+            return (uint8_t)(HUB_FEAT_C_PORT_CONNECTION + i);
+        }
+    }
+
+    return 0U;
+}
+
+/*!
+    \brief      attach, reset or detach the device of the port being processed
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     none
+*/
+static void usbh_hub_port_update(usbh_host *uhost)
+{
+    usbh_hub_handler *hub = (usbh_hub_handler *)uhost->active_class->class_data;
+    usbh_host *dev = &hub->dev[hub->port - 1U];
+
+    hub->state = HUB_IDLE;
+
+    if(0U == (hub->port_status & HUB_PORT_STAT_CONNECTION)) {
+        usbh_hub_dev_detach(hub, hub->port);
+    } else if(hub->port_status & HUB_PORT_STAT_RESET) {
+        /* reset still in progress, look again */
+        usb_mdelay(5U);
+
+        hub->state = HUB_PORT_STATUS_GET;
+    } else if(0U == dev->dev_connected) {
+        if(hub->port_status & HUB_PORT_STAT_ENABLE) {
+            usbh_hub_dev_attach(uhost, hub->port, hub->port_status);
+        } else if(0U == usbh_hub_dev_addressing(hub)) {
+            /* let the connection settle before the reset */
+            usb_mdelay(100U);
+
+            hub->state = HUB_PORT_RESET;
+        } else {
+            /* only one device may answer at the default address, come back later */
+            hub->change_map |= (1U << hub->port);
+        }
+    } else {
+        /* no operation */
+    }
+
+    if(HUB_IDLE == hub->state) {
+        hub->port++;
+    }
+}
+
+/*!
+    \brief      check whether a device behind the hub is still at the default address
+    \param[in]  hub: pointer to hub handler
+    \param[out] none
+    \retval     1 if a device is being addressed, 0 otherwise
+*/
+static uint8_t usbh_hub_dev_addressing(usbh_hub_handler *hub)
+{
+    uint8_t i = 0U;
+
+    for(i = 0U; i < hub->port_num; i++) {
+        if((1U == hub->dev[i].dev_connected) && (USBH_DEV_ADDR_DEFAULT == hub->dev[i].dev_prop.addr)) {
+            return 1U;
+        }
+    }
+
+    return 0U;
+}
+
+/*!
+    \brief      set up the host of a device that has been enabled on a hub port
+    \param[in]  uhost: pointer to USB host of the hub
+    \param[in]  port: port number
+    \param[in]  port_status: wPortStatus of the port
+    \param[out] none
+    \retval     none
+*/
+static void usbh_hub_dev_attach(usbh_host *uhost, uint8_t port, uint16_t port_status)
+{
+    usbh_hub_handler *hub = (usbh_hub_handler *)uhost->active_class->class_data;
+    usbh_host *dev = &hub->dev[port - 1U];
+    uint8_t i = 0U;
+
+    memset((void *)dev, 0U, sizeof(usbh_host));
+
+    dev->data = uhost->data;
+    dev->usr_cb = uhost->usr_cb;
+    dev->parent = uhost;
+    dev->control.pipe_in_num = 0xFFU;
+    dev->control.pipe_out_num = 0xFFU;
+
+    usbh_deinit(dev);
+
+    if(port_status & HUB_PORT_STAT_LOW_SPEED) {
+        dev->dev_prop.speed = PORT_SPEED_LOW;
+    } else if(port_status & HUB_PORT_STAT_HIGH_SPEED) {
+        dev->dev_prop.speed = PORT_SPEED_HIGH;
+    } else {
+        dev->dev_prop.speed = PORT_SPEED_FULL;
+    }
+
+    /* full and low speed devices are reached through the transaction translator of the hub */
+    dev->dev_prop.hub_addr = uhost->dev_prop.addr;
+    dev->dev_prop.hub_port = port;
+
+    /* every class of the root port except the hub itself, one tier of hubs is supported */
+    for(i = 0U; i < uhost->class_num; i++) {
+        if(HUB_CLASS != uhost->uclass[i]->class_code) {
+            (void)usbh_class_register(dev, uhost->uclass[i]);
+        }
+    }
+
+    dev->dev_connected = 1U;
+}
+
+/*!
+    \brief      detach the device of a hub port
+    \param[in]  hub: pointer to hub handler
+    \param[in]  port: port number
+    \param[out] none
+    \retval     none
+*/
+static void usbh_hub_dev_detach(usbh_hub_handler *hub, uint8_t port)
+{
+    usbh_host *dev = &hub->dev[port - 1U];
+
+    if(1U == dev->dev_connected) {
+        dev->dev_connected = 0U;
+
+        /* let the device state machine run its detach path */
+        usbh_core_task(dev);
+    }
+}
@@ -0,0 +1,92 @@
+/*!
+    \file    usbh_msc_cache.h
+    \brief   header file for the usbh_msc_cache.c
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef USBH_MSC_CACHE_H
+#define USBH_MSC_CACHE_H
+
+#include "usbh_msc_core.h"
+
+#define USBH_MSC_CACHE_SECTOR_SIZE              512U
+
+/* sectors per cache line, one line is loaded or written back with a single command */
+#ifndef USBH_MSC_CACHE_LINE_SECTORS
+#define USBH_MSC_CACHE_LINE_SECTORS             8U
+#endif /* USBH_MSC_CACHE_LINE_SECTORS */
+
+/* number of cache lines */
+#ifndef USBH_MSC_CACHE_LINE_NUM
+#define USBH_MSC_CACHE_LINE_NUM                 8U
+#endif /* USBH_MSC_CACHE_LINE_NUM */
+
+/* lines loaded by one READ10 when a sequential read misses */
+#ifndef USBH_MSC_CACHE_READAHEAD
+#define USBH_MSC_CACHE_READAHEAD                4U
+#endif /* USBH_MSC_CACHE_READAHEAD */
+
+#if (USBH_MSC_CACHE_LINE_SECTORS > 32U) || (USBH_MSC_CACHE_READAHEAD > USBH_MSC_CACHE_LINE_NUM)
+#error "invalid USB host MSC cache configuration"
+#endif
+
+/* blocking sector transfer used by the cache to reach the device */
+typedef usbh_status (*usbh_msc_cache_io)(msc_io_dir dir, uint8_t *pbuf, uint32_t sector, uint32_t count);
+
+/* cache statistics */
+typedef struct {
+    uint32_t        read_sectors;                       /*!< sectors read through the cache */
+    uint32_t        read_hits;                          /*!< sectors read without accessing the device */
+    uint32_t        write_sectors;                      /*!< sectors written through the cache */
+    uint32_t        dev_reads;                          /*!< READ10 commands sent to the device */
+    uint32_t        dev_writes;                         /*!< WRITE10 commands sent to the device */
+    uint64_t        read_cycles;                        /*!< CPU cycles spent in usbh_msc_cache_read() */
+    uint64_t        write_cycles;                       /*!< CPU cycles spent in usbh_msc_cache_write() and flushes */
+    uint32_t        hit_rate;                           /*!< read hit rate in 0.1% units */
+    uint32_t        read_kbps;                          /*!< effective read throughput in KB/s */
+    uint32_t        write_kbps;                         /*!< effective write throughput in KB/s */
+} usbh_msc_cache_stats;
+
+/* function declarations */
+/* initialize the cache, dropping any cached data */
+void usbh_msc_cache_init(usbh_msc_cache_io io, uint32_t sector_num);
+/* read sectors through the cache */
+usbh_status usbh_msc_cache_read(uint8_t *pbuf, uint32_t sector, uint32_t count);
+/* write sectors through the cache */
+usbh_status usbh_msc_cache_write(const uint8_t *pbuf, uint32_t sector, uint32_t count);
+/* write all dirty sectors back to the device */
+usbh_status usbh_msc_cache_flush(void);
+/* get the cache statistics */
+void usbh_msc_cache_stats_get(usbh_msc_cache_stats *stats);
+/* reset the cache statistics */
+void usbh_msc_cache_stats_reset(void);
+
+#endif /* USBH_MSC_CACHE_H */
@@ -70,6 +70,27 @@ typedef enum {
     MSC_REQ_ERROR                                       /*!< MSC error request state */
 } msc_req_state;
 
+/* MSC asynchronous I/O directions */
+typedef enum {
+    MSC_IO_READ = 0U,                                   /*!< read sectors from the device */
+    MSC_IO_WRITE                                        /*!< write sectors to the device */
+} msc_io_dir;
+
+typedef struct _msc_io_req msc_io_req;
+
+/* MSC asynchronous I/O request, owned by the library from submission until completion */
+struct _msc_io_req {
+    uint8_t                 lun;                        /*!< logic unit number */
+    msc_io_dir              dir;                        /*!< transfer direction */
+    uint32_t                address;                    /*!< first sector */
+    uint8_t                *pbuf;                       /*!< data buffer */
+    uint32_t                length;                     /*!< number of sectors */
+    void                  (*complete)(void *context, usbh_status status); /*!< completion callback, may be NULL */
+    void                   *context;                    /*!< user data for the callback */
+    __IO usbh_status        status;                     /*!< USBH_BUSY until completed */
+    msc_io_req             *next;                       /*!< next queued request */
+};
+
 /* structure for LUN */
 typedef struct {
     msc_state               state;                      /*!< MSC LUN state */
@@ -99,6 +120,10 @@ typedef struct _msc_process {
     bbb_handle      bbb;                                /*!< MSC BBB correlation parameter handle */
     msc_lun         unit[MSC_MAX_SUPPORTED_LUN];        /*!< MSC LUN unit buff */
     uint32_t        timer;                              /*!< MSC read/write timer */
+    msc_io_req     *io_head;                            /*!< MSC first queued asynchronous request */
+    msc_io_req     *io_tail;                            /*!< MSC last queued asynchronous request */
+    msc_io_req     *io_active;                          /*!< MSC asynchronous request on the bus */
+    uint32_t        io_timer;                           /*!< MSC asynchronous request start time */
 } usbh_msc_handler;
 
 extern usbh_class usbh_msc;
@@ -118,5 +143,7 @@ usbh_status usbh_msc_write(usbh_host *uhost, \
                            uint32_t address, \
                            uint8_t *pbuf, \
                            uint32_t length);
+/* queue an asynchronous MSC read or write request */
+usbh_status usbh_msc_submit(usbh_host *uhost, msc_io_req *req);
 
 #endif  /* USBH_MSC_CORE_H */
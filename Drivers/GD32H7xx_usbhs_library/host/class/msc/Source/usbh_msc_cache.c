@@ -0,0 +1,596 @@
+/*!
+    \file    usbh_msc_cache.c
+    \brief   USB MSC host sector cache between FatFs and the device
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "usbh_msc_cache.h"
+#include <string.h>
+
+#define CACHE_LINE_NONE                 0xFFFFFFFFU
+#define CACHE_LINE_SIZE                 (USBH_MSC_CACHE_LINE_SECTORS * USBH_MSC_CACHE_SECTOR_SIZE)
+
+/* state of one cache line */
+typedef struct {
+    uint32_t        line;                               /*!< cached line number, CACHE_LINE_NONE when empty */
+    uint32_t        valid;                              /*!< sectors holding device data */
+    uint32_t        dirty;                              /*!< sectors not yet written to the device */
+    uint32_t        stamp;                              /*!< request count at the last access */
+    uint8_t         hot;                                /*!< line was accessed again by a non-sequential request */
+} cache_tag;
+
+/* line buffers are contiguous so that read-ahead can load several lines with one READ10,
+   and 32-byte aligned because they are DMA targets */
+static uint8_t cache_data[USBH_MSC_CACHE_LINE_NUM][CACHE_LINE_SIZE] __ALIGNED(32);
+static cache_tag cache_tags[USBH_MSC_CACHE_LINE_NUM];
+
+static usbh_msc_cache_io cache_io = NULL;
+static uint32_t cache_sector_num = 0U;
+static uint32_t cache_clock = 0U;
+static uint32_t cache_next_sector = CACHE_LINE_NONE;
+static usbh_msc_cache_stats cache_stats;
+
+/* local function prototypes ('static') */
+static uint32_t cache_cycles(void);
+static uint32_t cache_mask(uint32_t first, uint32_t num);
+static int32_t cache_lookup(uint32_t line);
+static void cache_touch(uint32_t slot, uint8_t sequential);
+static usbh_status cache_device_xfer(msc_io_dir dir, uint8_t *pbuf, uint32_t sector, uint32_t count);
+static usbh_status cache_line_flush(uint32_t slot);
+static usbh_status cache_range_flush(uint32_t sector, uint32_t count);
+static int32_t cache_window_get(uint32_t num);
+static int32_t cache_fill(uint32_t line, uint32_t num);
+
+/*!
+    \brief      initialize the cache, dropping any cached data
+    \param[in]  io: blocking sector transfer function
+    \param[in]  sector_num: number of sectors on the device, 0 if unknown
+    \param[out] none
+    \retval     none
+*/
+void usbh_msc_cache_init(usbh_msc_cache_io io, uint32_t sector_num)
+{
+    uint32_t i;
+
+    for(i = 0U; i < USBH_MSC_CACHE_LINE_NUM; i++) {
+        cache_tags[i].line = CACHE_LINE_NONE;
+        cache_tags[i].valid = 0U;
+        cache_tags[i].dirty = 0U;
+        cache_tags[i].stamp = 0U;
+        cache_tags[i].hot = 0U;
+    }
+
+    cache_io = io;
+    cache_sector_num = sector_num;
+    cache_next_sector = CACHE_LINE_NONE;
+
+    /* the cycle counter is used for the throughput statistics */
+    if(0U == (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+        DWT->LAR = 0xC5ACCE55U;
+        DWT->CYCCNT = 0U;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+}
+
+/*!
+    \brief      read sectors through the cache
+    \param[in]  pbuf: pointer to the data buffer
+    \param[in]  sector: start sector number
+    \param[in]  count: sector count
+    \param[out] none
+    \retval     operation status
+*/
+usbh_status usbh_msc_cache_read(uint8_t *pbuf, uint32_t sector, uint32_t count)
+{
+    usbh_status status = USBH_OK;
+    uint32_t start = cache_cycles();
+    uint32_t line, offset, num, mask;
+    uint8_t sequential = (uint8_t)(sector == cache_next_sector);
+    int32_t slot;
+
+    cache_clock++;
+    cache_stats.read_sectors += count;
+    cache_next_sector = sector + count;
+
+    if(count >= USBH_MSC_CACHE_LINE_SECTORS) {
+        /* large requests are already coalesced by FatFs, only newer cached data has to reach the device first */
+        status = cache_range_flush(sector, count);
+
+        if(USBH_OK == status) {
+            status = cache_device_xfer(MSC_IO_READ, pbuf, sector, count);
+        }
+    } else {
+        while((USBH_OK == status) && (0U != count)) {
+            line = sector / USBH_MSC_CACHE_LINE_SECTORS;
+            offset = sector % USBH_MSC_CACHE_LINE_SECTORS;
+            num = USBH_MSC_CACHE_LINE_SECTORS - offset;
+
+            if(num > count) {
+                num = count;
+            }
+
+            mask = cache_mask(offset, num);
+            slot = cache_lookup(line);
+
+            if((slot >= 0) && (mask == (cache_tags[slot].valid & mask))) {
+                cache_stats.read_hits += num;
+            } else {
+                if(slot >= 0) {
+                    /* partially written line, reload it as a whole */
+                    status = cache_line_flush((uint32_t)slot);
+
+                    if(USBH_OK != status) {
+                        break;
+                    }
+
+                    cache_tags[slot].line = CACHE_LINE_NONE;
+                }
+
+                slot = cache_fill(line, sequential ? USBH_MSC_CACHE_READAHEAD : 1U);
+
+                if((slot < 0) || (mask != (cache_tags[slot].valid & mask))) {
+                    status = USBH_FAIL;
+                    break;
+                }
+            }
+
+            memcpy(pbuf, &cache_data[slot][offset * USBH_MSC_CACHE_SECTOR_SIZE], num * USBH_MSC_CACHE_SECTOR_SIZE);
+            cache_touch((uint32_t)slot, sequential);
+
+            pbuf += num * USBH_MSC_CACHE_SECTOR_SIZE;
+            sector += num;
+            count -= num;
+        }
+    }
+
+    cache_stats.read_cycles += cache_cycles() - start;
+
+    return status;
+}
+
+/*!
+    \brief      write sectors through the cache
+    \param[in]  pbuf: pointer to the data buffer
+    \param[in]  sector: start sector number
+    \param[in]  count: sector count
+    \param[out] none
+    \retval     operation status
+*/
+usbh_status usbh_msc_cache_write(const uint8_t *pbuf, uint32_t sector, uint32_t count)
+{
+    usbh_status status = USBH_OK;
+    uint32_t start = cache_cycles();
+    uint32_t line, offset, num, mask, i, first, last;
+    int32_t slot;
+
+    cache_clock++;
+    cache_stats.write_sectors += count;
+
+    if(count >= USBH_MSC_CACHE_LINE_SECTORS) {
+        /* write large requests through and keep the overlapping cached sectors up to date */
+        status = cache_device_xfer(MSC_IO_WRITE, (uint8_t *)pbuf, sector, count);
+
+        for(i = 0U; (USBH_OK == status) && (i < USBH_MSC_CACHE_LINE_NUM); i++) {
+            if(CACHE_LINE_NONE == cache_tags[i].line) {
+                continue;
+            }
+
+            first = cache_tags[i].line * USBH_MSC_CACHE_LINE_SECTORS;
+            last = first + USBH_MSC_CACHE_LINE_SECTORS;
+
+            if((last <= sector) || (first >= sector + count)) {
+                continue;
+            }
+
+            if(first < sector) {
+                first = sector;
+            }
+
+            if(last > sector + count) {
+                last = sector + count;
+            }
+
+            offset = first % USBH_MSC_CACHE_LINE_SECTORS;
+            mask = cache_mask(offset, last - first);
+
+            memcpy(&cache_data[i][offset * USBH_MSC_CACHE_SECTOR_SIZE], \
+                   pbuf + (first - sector) * USBH_MSC_CACHE_SECTOR_SIZE, \
+                   (last - first) * USBH_MSC_CACHE_SECTOR_SIZE);
+
+            cache_tags[i].valid |= mask;
+            cache_tags[i].dirty &= ~mask;
+        }
+    } else {
+        while((USBH_OK == status) && (0U != count)) {
+            line = sector / USBH_MSC_CACHE_LINE_SECTORS;
+            offset = sector % USBH_MSC_CACHE_LINE_SECTORS;
+            num = USBH_MSC_CACHE_LINE_SECTORS - offset;
+
+            if(num > count) {
+                num = count;
+            }
+
+            mask = cache_mask(offset, num);
+            slot = cache_lookup(line);
+
+            if(slot < 0) {
+                /* allocate without reading, the line is filled on a later read miss if needed */
+                slot = cache_window_get(1U);
+
+                if(slot < 0) {
+                    status = USBH_FAIL;
+                    break;
+                }
+
+                cache_tags[slot].line = line;
+                cache_tags[slot].valid = 0U;
+                cache_tags[slot].dirty = 0U;
+                cache_tags[slot].hot = 0U;
+                cache_tags[slot].stamp = cache_clock;
+            }
+
+            memcpy(&cache_data[slot][offset * USBH_MSC_CACHE_SECTOR_SIZE], pbuf, num * USBH_MSC_CACHE_SECTOR_SIZE);
+            cache_tags[slot].valid |= mask;
+            cache_tags[slot].dirty |= mask;
+            cache_touch((uint32_t)slot, 0U);
+
+            pbuf += num * USBH_MSC_CACHE_SECTOR_SIZE;
+            sector += num;
+            count -= num;
+        }
+    }
+
+    cache_stats.write_cycles += cache_cycles() - start;
+
+    return status;
+}
+
+/*!
+    \brief      write all dirty sectors back to the device
+    \param[in]  none
+    \param[out] none
+    \retval     operation status
+*/
+usbh_status usbh_msc_cache_flush(void)
+{
+    uint32_t start = cache_cycles();
+    usbh_status status = cache_range_flush(0U, CACHE_LINE_NONE);
+
+    cache_stats.write_cycles += cache_cycles() - start;
+
+    return status;
+}
+
+/*!
+    \brief      get the cache statistics
+    \param[in]  none
+    \param[out] stats: cache statistics, including the derived hit rate and throughput
+    \retval     none
+*/
+void usbh_msc_cache_stats_get(usbh_msc_cache_stats *stats)
+{
+    *stats = cache_stats;
+
+    if(0U != stats->read_sectors) {
+        stats->hit_rate = (uint32_t)(((uint64_t)stats->read_hits * 1000U) / stats->read_sectors);
+    }
+
+    if(0U != stats->read_cycles) {
+        stats->read_kbps = (uint32_t)(((uint64_t)stats->read_sectors * USBH_MSC_CACHE_SECTOR_SIZE / 1024U) * \
+                                      SystemCoreClock / stats->read_cycles);
+    }
+
+    if(0U != stats->write_cycles) {
+        stats->write_kbps = (uint32_t)(((uint64_t)stats->write_sectors * USBH_MSC_CACHE_SECTOR_SIZE / 1024U) * \
+                                       SystemCoreClock / stats->write_cycles);
+    }
+}
+
+/*!
+    \brief      reset the cache statistics
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void usbh_msc_cache_stats_reset(void)
+{
+    memset(&cache_stats, 0U, sizeof(cache_stats));
+}
+
+/*!
+    \brief      get the current CPU cycle count
+    \param[in]  none
+    \param[out] none
+    \retval     cycle count
+*/
+static uint32_t cache_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/*!
+    \brief      build the bit mask of a sector range inside a line
+    \param[in]  first: first sector in the line
+    \param[in]  num: number of sectors, at least 1
+    \param[out] none
+    \retval     sector mask
+*/
+static uint32_t cache_mask(uint32_t first, uint32_t num)
+{
+    return (0xFFFFFFFFU >> (32U - num)) << first;
+}
+
+/*!
+    \brief      find the slot holding a line
+    \param[in]  line: line number
+    \param[out] none
+    \retval     slot index, -1 if the line is not cached
+*/
+static int32_t cache_lookup(uint32_t line)
+{
+    uint32_t i;
+
+    for(i = 0U; i < USBH_MSC_CACHE_LINE_NUM; i++) {
+        if(line == cache_tags[i].line) {
+            return (int32_t)i;
+        }
+    }
+
+    return -1;
+}
+
+/*!
+    \brief      record an access to a slot
+    \param[in]  slot: slot index
+    \param[in]  sequential: access belongs to a sequential stream
+    \param[out] none
+    \retval     none
+*/
+static void cache_touch(uint32_t slot, uint8_t sequential)
+{
+    /* FAT and directory sectors are revisited between data accesses, streamed data is not */
+    if((0U == sequential) && (cache_clock != cache_tags[slot].stamp)) {
+        cache_tags[slot].hot = 1U;
+    }
+
+    cache_tags[slot].stamp = cache_clock;
+}
+
+/*!
+    \brief      transfer sectors to or from the device
+    \param[in]  dir: transfer direction
+    \param[in]  pbuf: pointer to the data buffer
+    \param[in]  sector: start sector number
+    \param[in]  count: sector count
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status cache_device_xfer(msc_io_dir dir, uint8_t *pbuf, uint32_t sector, uint32_t count)
+{
+    if(NULL == cache_io) {
+        return USBH_FAIL;
+    }
+
+    if(MSC_IO_READ == dir) {
+        cache_stats.dev_reads++;
+    } else {
+        cache_stats.dev_writes++;
+    }
+
+    return cache_io(dir, pbuf, sector, count);
+}
+
+/*!
+    \brief      write the dirty sectors of a line back, one command per contiguous run
+    \param[in]  slot: slot index
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status cache_line_flush(uint32_t slot)
+{
+    usbh_status status;
+    uint32_t first, last;
+    cache_tag *tag = &cache_tags[slot];
+
+    while(0U != tag->dirty) {
+        first = __CLZ(__RBIT(tag->dirty));
+        last = first + 1U;
+
+        while((last < USBH_MSC_CACHE_LINE_SECTORS) && (tag->dirty & (1U << last))) {
+            last++;
+        }
+
+        status = cache_device_xfer(MSC_IO_WRITE, \
+                                   &cache_data[slot][first * USBH_MSC_CACHE_SECTOR_SIZE], \
+                                   tag->line * USBH_MSC_CACHE_LINE_SECTORS + first, \
+                                   last - first);
+
+        if(USBH_OK != status) {
+            return status;
+        }
+
+        tag->dirty &= ~cache_mask(first, last - first);
+    }
+
+    return USBH_OK;
+}
+
+/*!
+    \brief      write back the dirty lines overlapping a sector range in ascending order
+    \param[in]  sector: start sector number
+    \param[in]  count: sector count, CACHE_LINE_NONE for the whole device
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status cache_range_flush(uint32_t sector, uint32_t count)
+{
+    usbh_status status;
+    uint32_t i, slot;
+    uint32_t first = sector / USBH_MSC_CACHE_LINE_SECTORS;
+    uint32_t last = CACHE_LINE_NONE;
+
+    if(CACHE_LINE_NONE != count) {
+        last = (sector + count - 1U) / USBH_MSC_CACHE_LINE_SECTORS;
+    }
+
+    while(1) {
+        slot = USBH_MSC_CACHE_LINE_NUM;
+
+        for(i = 0U; i < USBH_MSC_CACHE_LINE_NUM; i++) {
+            if((0U != cache_tags[i].dirty) && (cache_tags[i].line >= first) && (cache_tags[i].line <= last)) {
+                if((USBH_MSC_CACHE_LINE_NUM == slot) || (cache_tags[i].line < cache_tags[slot].line)) {
+                    slot = i;
+                }
+            }
+        }
+
+        if(USBH_MSC_CACHE_LINE_NUM == slot) {
+            return USBH_OK;
+        }
+
+        status = cache_line_flush(slot);
+
+        if(USBH_OK != status) {
+            return status;
+        }
+    }
+}
+
+/*!
+    \brief      free a run of adjacent slots, preferring streamed data over hot lines and then the least recently used
+    \param[in]  num: number of adjacent slots
+    \param[out] none
+    \retval     first slot index, -1 if a dirty line could not be written back
+*/
+static int32_t cache_window_get(uint32_t num)
+{
+    uint32_t start, i, age, keep, window_keep;
+    uint32_t best = 0U, best_keep = 0xFFFFFFFFU;
+
+    for(start = 0U; start + num <= USBH_MSC_CACHE_LINE_NUM; start++) {
+        window_keep = 0U;
+
+        for(i = start; i < start + num; i++) {
+            keep = 0U;
+
+            if(CACHE_LINE_NONE != cache_tags[i].line) {
+                age = cache_clock - cache_tags[i].stamp;
+
+                keep = (age < 0x7FFFFFFFU) ? (0x7FFFFFFFU - age) : 0U;
+
+                if(0U != cache_tags[i].hot) {
+                    keep |= 0x80000000U;
+                }
+            }
+
+            if(keep > window_keep) {
+                window_keep = keep;
+            }
+        }
+
+        if(window_keep < best_keep) {
+            best_keep = window_keep;
+            best = start;
+        }
+    }
+
+    for(i = best; i < best + num; i++) {
+        if(USBH_OK != cache_line_flush(i)) {
+            return -1;
+        }
+
+        cache_tags[i].line = CACHE_LINE_NONE;
+        cache_tags[i].valid = 0U;
+    }
+
+    return (int32_t)best;
+}
+
+/*!
+    \brief      load a line and up to num - 1 following lines with one READ10
+    \param[in]  line: first line number, not cached
+    \param[in]  num: number of lines to load
+    \param[out] none
+    \retval     slot index of the first line, -1 on error
+*/
+static int32_t cache_fill(uint32_t line, uint32_t num)
+{
+    uint32_t i, first, count, remain;
+    int32_t slot;
+
+    first = line * USBH_MSC_CACHE_LINE_SECTORS;
+
+    if((0U != cache_sector_num) && (first >= cache_sector_num)) {
+        return -1;
+    }
+
+    /* stop the read-ahead at the end of the device and at lines already cached */
+    for(i = 1U; i < num; i++) {
+        if(((0U != cache_sector_num) && (first + i * USBH_MSC_CACHE_LINE_SECTORS >= cache_sector_num)) || \
+             (cache_lookup(line + i) >= 0)) {
+            break;
+        }
+    }
+
+    num = i;
+    count = num * USBH_MSC_CACHE_LINE_SECTORS;
+
+    if((0U != cache_sector_num) && (first + count > cache_sector_num)) {
+        count = cache_sector_num - first;
+    }
+
+    slot = cache_window_get(num);
+
+    if(slot < 0) {
+        return -1;
+    }
+
+    if(USBH_OK != cache_device_xfer(MSC_IO_READ, cache_data[slot], first, count)) {
+        return -1;
+    }
+
+    for(i = 0U; i < num; i++) {
+        remain = count - i * USBH_MSC_CACHE_LINE_SECTORS;
+
+        if(remain > USBH_MSC_CACHE_LINE_SECTORS) {
+            remain = USBH_MSC_CACHE_LINE_SECTORS;
+        }
+
+        cache_tags[slot + i].line = line + i;
+        cache_tags[slot + i].valid = cache_mask(0U, remain);
+        cache_tags[slot + i].dirty = 0U;
+        cache_tags[slot + i].hot = 0U;
+        cache_tags[slot + i].stamp = cache_clock;
+    }
+
+    return slot;
+}
@@ -45,6 +45,8 @@ static usbh_status usbh_msc_req(usbh_host *uhost);
 static usbh_status usbh_msc_handle(usbh_host *uhost);
 static usbh_status usbh_msc_maxlun_get(usbh_host *uhost, uint8_t *maxlun);
 static usbh_status usbh_msc_rdwr_process(usbh_host *uhost, uint8_t lun);
+static void usbh_msc_io_process(usbh_host *uhost);
+static void usbh_msc_io_abort(usbh_msc_handler *msc);
 
 usbh_class usbh_msc = {
     USB_CLASS_MSC,
@@ -167,6 +169,54 @@ usbh_status usbh_msc_write(usbh_host *uhost, \
     return USBH_OK;
 }
 
+/*!
+    \brief      queue an asynchronous MSC read or write request
+    \param[in]  uhost: pointer to USB host
+    \param[in]  req: request to be queued, its status stays USBH_BUSY until the completion
+                      callback has been called from usbh_core_task()
+    \param[out] none
+    \retval     operation status
+*/
+usbh_status usbh_msc_submit(usbh_host *uhost, msc_io_req *req)
+{
+    uint32_t primask;
+    usb_core_driver *udev = (usb_core_driver *)uhost->data;
+    usbh_msc_handler *msc = NULL;
+
+    if((0U == udev->host.connect_status) || \
+         (HOST_CLASS_HANDLER != uhost->cur_state) || \
+            (NULL == uhost->active_class) || \
+                (NULL == uhost->active_class->class_data) || \
+                    (0U == req->length)) {
+        return USBH_FAIL;
+    }
+
+    msc = (usbh_msc_handler *)uhost->active_class->class_data;
+
+    if(req->lun >= msc->max_lun) {
+        return USBH_FAIL;
+    }
+
+    req->status = USBH_BUSY;
+    req->next = NULL;
+
+    /* requests may be submitted from other tasks than usbh_core_task() */
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if(NULL == msc->io_tail) {
+        msc->io_head = req;
+    } else {
+        msc->io_tail->next = req;
+    }
+
+    msc->io_tail = req;
+
+    __set_PRIMASK(primask);
+
+    return USBH_OK;
+}
+
 /*!
     \brief      de-initialize interface by freeing host channels allocated to interface
     \param[in]  uhost: pointer to USB host
@@ -177,15 +227,17 @@ static void usbh_msc_itf_deinit(usbh_host *uhost)
 {
     usbh_msc_handler *msc = (usbh_msc_handler *)uhost->active_class->class_data;
 
+    usbh_msc_io_abort(msc);
+
     if(msc->pipe_out) {
-        usb_pipe_halt(uhost->data, msc->pipe_out);
+        usbh_pipe_halt(uhost->data, msc->pipe_out);
         usbh_pipe_free(uhost->data, msc->pipe_out);
 
         msc->pipe_out = 0U;
     }
 
     if(msc->pipe_in) {
-        usb_pipe_halt(uhost->data, msc->pipe_in);
+        usbh_pipe_halt(uhost->data, msc->pipe_in);
         usbh_pipe_free(uhost->data, msc->pipe_in);
 
         msc->pipe_in = 0U;
@@ -439,6 +491,8 @@ static usbh_status usbh_msc_handle(usbh_host *uhost)
         break;
 
     case MSC_IDLE:
+        usbh_msc_io_process(uhost);
+
         uhost->usr_cb->dev_user_app();
         status = USBH_OK;
         break;
@@ -550,3 +604,128 @@ static usbh_status usbh_msc_rdwr_process(usbh_host *uhost, uint8_t lun)
 
     return error;
 }
+
+/*!
+    \brief      start the next queued asynchronous request or advance the active one
+    \param[in]  uhost: pointer to USB host
+    \param[out] none
+    \retval     none
+*/
+static void usbh_msc_io_process(usbh_host *uhost)
+{
+    uint32_t primask;
+    usbh_status status;
+    msc_io_req *req;
+    void (*complete)(void *context, usbh_status status);
+    void *context;
+    usbh_msc_handler *msc = (usbh_msc_handler *)uhost->active_class->class_data;
+
+    if(NULL == msc->io_active) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+
+        req = msc->io_head;
+
+        if((NULL != req) && (MSC_IDLE == msc->unit[req->lun].state)) {
+            msc->io_head = req->next;
+
+            if(NULL == msc->io_head) {
+                msc->io_tail = NULL;
+            }
+        } else {
+            req = NULL;
+        }
+
+        __set_PRIMASK(primask);
+
+        if(NULL == req) {
+            return;
+        }
+
+        msc->io_active = req;
+        msc->io_timer = uhost->control.timer;
+        msc->rw_lun = req->lun;
+
+        if(MSC_IO_READ == req->dir) {
+            msc->unit[req->lun].state = MSC_READ;
+
+            usbh_msc_read10(uhost, req->lun, req->pbuf, req->address, req->length);
+        } else {
+            msc->unit[req->lun].state = MSC_WRITE;
+
+            usbh_msc_write10(uhost, req->lun, req->pbuf, req->address, req->length);
+        }
+    }
+
+    req = msc->io_active;
+
+    status = usbh_msc_rdwr_process(uhost, req->lun);
+
+    if(USBH_BUSY == status) {
+        if((uhost->control.timer - msc->io_timer) <= (1000U * req->length)) {
+            return;
+        }
+
+        msc->unit[req->lun].state = MSC_IDLE;
+
+        status = USBH_FAIL;
+    }
+
+    msc->io_active = NULL;
+
+    /* the request may be gone as soon as its status is set, e.g. from the waiter's stack */
+    complete = req->complete;
+    context = req->context;
+
+    req->status = status;
+
+    if(NULL != complete) {
+        complete(context, status);
+    }
+}
+
+/*!
+    \brief      fail the active and all queued asynchronous requests
+    \param[in]  msc: pointer to MSC handler
+    \param[out] none
+    \retval     none
+*/
+static void usbh_msc_io_abort(usbh_msc_handler *msc)
+{
+    uint32_t primask;
+    msc_io_req *req;
+    void (*complete)(void *context, usbh_status status);
+    void *context;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if(NULL != msc->io_active) {
+        msc->io_active->next = msc->io_head;
+        msc->io_head = msc->io_active;
+        msc->io_active = NULL;
+    }
+
+    req = msc->io_head;
+
+    msc->io_head = NULL;
+    msc->io_tail = NULL;
+
+    __set_PRIMASK(primask);
+
+    while(NULL != req) {
+        msc_io_req *next = req->next;
+
+        /* the request may be gone as soon as its status is set */
+        complete = req->complete;
+        context = req->context;
+
+        req->status = USBH_FAIL;
+
+        if(NULL != complete) {
+            complete(context, USBH_FAIL);
+        }
+
+        req = next;
+    }
+}
@@ -35,45 +35,217 @@ OF SUCH DAMAGE.
 #include "diskio.h"
 #include "usbh_msc_core.h"
 
-static volatile DSTATUS state = STA_NOINIT; /* disk status */
+#ifdef USBH_MSC_CACHE_ENABLED
+#include "usbh_msc_cache.h"
+#endif /* USBH_MSC_CACHE_ENABLED */
+
+#ifdef USBH_MSC_DISKIO_RTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#endif /* USBH_MSC_DISKIO_RTOS */
+
+#ifdef USBH_HUB_ENABLED
+#include "usbh_hub.h"
+#endif /* USBH_HUB_ENABLED */
+
+/* physical drive n is LUN n, the cache serves a single disk */
+#ifdef USBH_MSC_CACHE_ENABLED
+#define DISK_DRIVE_NUM              1U
+#else
+#define DISK_DRIVE_NUM              MSC_MAX_SUPPORTED_LUN
+#endif /* USBH_MSC_CACHE_ENABLED */
+
+static volatile DSTATUS state[DISK_DRIVE_NUM];     /* disk status, STA_NOINIT while the drive is not initialized */
+static volatile uint8_t disk_ready = 0U;            /* bit n is set once drive n has been initialized */
 
 extern usbh_host usb_host_msc;
 
+/*!
+    \brief      get the host running the MSC class
+    \param[in]  none
+    \param[out] none
+    \retval     pointer to the host, NULL when no MSC device is ready behind the hub
+*/
+static usbh_host *disk_host(void)
+{
+#ifdef USBH_HUB_ENABLED
+    /* the Udisk may sit on the root port or on a hub port */
+    return usbh_hub_device_find(&usb_host_msc, USB_CLASS_MSC);
+#else
+    return &usb_host_msc;
+#endif /* USBH_HUB_ENABLED */
+}
+
+#ifdef USBH_MSC_DISKIO_RTOS
+/*!
+    \brief      wake the task waiting in disk_rdwr()
+    \param[in]  context: handle of the waiting task
+    \param[in]  status: request status
+    \param[out] none
+    \retval     none
+*/
+static void disk_io_complete(void *context, usbh_status status)
+{
+    (void)status;
+
+    (void)xTaskNotifyGive((TaskHandle_t)context);
+}
+
+/*!
+    \brief      queue a sector transfer and block the calling task until it completes
+    \param[in]  lun: logical unit number
+    \param[in]  dir: transfer direction
+    \param[in]  pbuf: pointer to the data buffer
+    \param[in]  sector: start sector number (LBA)
+    \param[in]  count: sector count
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status disk_rdwr(uint8_t lun, msc_io_dir dir, uint8_t *pbuf, uint32_t sector, uint32_t count)
+{
+    msc_io_req req;
+    usbh_host *uhost = disk_host();
+
+    if(NULL == uhost) {
+        return USBH_FAIL;
+    }
+
+    req.lun = lun;
+    req.dir = dir;
+    req.address = sector;
+    req.pbuf = pbuf;
+    req.length = count;
+    req.complete = disk_io_complete;
+    req.context = (void *)xTaskGetCurrentTaskHandle();
+
+    if(USBH_OK != usbh_msc_submit(uhost, &req)) {
+        return USBH_FAIL;
+    }
+
+    /* the library completes every request, failing it on timeout or disconnection,
+       a notification left over from elsewhere only costs another pass */
+    while(USBH_BUSY == req.status) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    return req.status;
+}
+#else
+/*!
+    \brief      transfer sectors, polling the host state machine until done
+    \param[in]  lun: logical unit number
+    \param[in]  dir: transfer direction
+    \param[in]  pbuf: pointer to the data buffer
+    \param[in]  sector: start sector number (LBA)
+    \param[in]  count: sector count
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status disk_rdwr(uint8_t lun, msc_io_dir dir, uint8_t *pbuf, uint32_t sector, uint32_t count)
+{
+    usbh_status status = USBH_FAIL;
+    usb_core_driver *udev = (usb_core_driver *)usb_host_msc.data;
+    usbh_host *uhost = disk_host();
+
+    if((NULL != uhost) && (udev->host.connect_status)) {
+        do {
+            if(MSC_IO_READ == dir) {
+                status = usbh_msc_read(uhost, lun, sector, pbuf, count);
+            } else {
+                status = usbh_msc_write(uhost, lun, sector, pbuf, count);
+            }
+
+            if(!udev->host.connect_status) {
+                return USBH_FAIL;
+            }
+        } while(USBH_BUSY == status);
+    }
+
+    return status;
+}
+#endif /* USBH_MSC_DISKIO_RTOS */
+
+#ifdef USBH_MSC_CACHE_ENABLED
+/*!
+    \brief      transfer sectors of the cached disk
+    \param[in]  dir: transfer direction
+    \param[in]  pbuf: pointer to the data buffer
+    \param[in]  sector: start sector number (LBA)
+    \param[in]  count: sector count
+    \param[out] none
+    \retval     operation status
+*/
+static usbh_status disk_cache_io(msc_io_dir dir, uint8_t *pbuf, uint32_t sector, uint32_t count)
+{
+    return disk_rdwr(0U, dir, pbuf, sector, count);
+}
+#endif /* USBH_MSC_CACHE_ENABLED */
+
 /*!
     \brief      initialize the disk drive
-    \param[in]  drv: physical drive number (0)
+    \param[in]  drv: physical drive number, the LUN
     \param[out] none
     \retval     operation status
 */
 DSTATUS disk_initialize(BYTE drv)
 {
     usb_core_driver *udev = (usb_core_driver *)usb_host_msc.data;
+#ifdef USBH_MSC_CACHE_ENABLED
+    usbh_host *uhost = disk_host();
+    msc_lun info;
+#endif /* USBH_MSC_CACHE_ENABLED */
+
+    if(drv >= DISK_DRIVE_NUM) {
+        return STA_NOINIT;
+    }
 
     if(udev->host.connect_status) {
-        state &= ~STA_NOINIT;
+#ifdef USBH_MSC_CACHE_ENABLED
+        /* a (re)mounted disk may be a different one, drop what was cached */
+        if((NULL == uhost) || (USBH_OK != usbh_msc_lun_info_get(uhost, drv, &info))) {
+            return disk_status(drv);
+        }
+
+        usbh_msc_cache_init(disk_cache_io, info.capacity.block_nbr);
+#endif /* USBH_MSC_CACHE_ENABLED */
+
+        disk_ready |= (uint8_t)(1U << drv);
     }
 
-    return state;
+    return disk_status(drv);
 }
 
 /*!
     \brief      get disk status
-    \param[in]  drv: physical drive number (0)
+    \param[in]  drv: physical drive number, the LUN
     \param[out] none
     \retval     operation status
 */
 DSTATUS disk_status(BYTE drv)
 {
-    if(drv) {
-        return STA_NOINIT; /* supports only single drive */
+    if(drv >= DISK_DRIVE_NUM) {
+        return STA_NOINIT;
     }
 
-    return state;
+#ifdef USBH_MSC_CACHE_ENABLED
+    /* force FatFs to call disk_initialize() again, the cached sectors belong to the removed disk */
+    if(0U == ((usb_core_driver *)usb_host_msc.data)->host.connect_status) {
+        disk_ready &= (uint8_t)~(1U << drv);
+    }
+#endif /* USBH_MSC_CACHE_ENABLED */
+
+    if(0U == (disk_ready & (1U << drv))) {
+        state[drv] |= STA_NOINIT;
+    } else {
+        state[drv] &= (DSTATUS)~STA_NOINIT;
+    }
+
+    return state[drv];
 }
 
 /*!
     \brief      read sectors
-    \param[in]  drv: physical drive number (0)
+    \param[in]  drv: physical drive number, the LUN
     \param[in]  buff: pointer to the data buffer to store read data
     \param[in]  sector: start sector number (LBA)
     \param[in]  count: sector count (1..255)
@@ -82,26 +254,21 @@ DSTATUS disk_status(BYTE drv)
 */
 DRESULT disk_read(BYTE drv, BYTE *buff, DWORD sector, UINT count)
 {
-    BYTE status = USBH_OK;
-    usb_core_driver *udev = (usb_core_driver *)usb_host_msc.data;
+    usbh_status status;
 
-    if(drv || (!count)) {
+    if((drv >= DISK_DRIVE_NUM) || (!count)) {
         return RES_PARERR;
     }
 
-    if(state & STA_NOINIT) {
+    if(disk_status(drv) & STA_NOINIT) {
         return RES_NOTRDY;
     }
 
-    if(udev->host.connect_status) {
-        do {
-            status = usbh_msc_read(&usb_host_msc, drv, sector, buff, count);
-
-            if(!udev->host.connect_status) {
-                return RES_ERROR;
-            }
-        } while(USBH_BUSY == status);
-    }
+#ifdef USBH_MSC_CACHE_ENABLED
+    status = usbh_msc_cache_read(buff, sector, count);
+#else
+    status = disk_rdwr(drv, MSC_IO_READ, buff, sector, count);
+#endif /* USBH_MSC_CACHE_ENABLED */
 
     if(USBH_OK == status) {
         return RES_OK;
@@ -114,7 +281,7 @@ DRESULT disk_read(BYTE drv, BYTE *buff, DWORD sector, UINT count)
 
 /*!
     \brief      write sectors
-    \param[in]  drv: physical drive number (0)
+    \param[in]  drv: physical drive number, the LUN
     \param[in]  buff: pointer to the data buffer to store read data
     \param[in]  sector: start sector number (LBA)
     \param[in]  count: sector count (1..255)
@@ -123,30 +290,25 @@ DRESULT disk_read(BYTE drv, BYTE *buff, DWORD sector, UINT count)
 */
 DRESULT disk_write(BYTE drv, const BYTE *buff, DWORD sector, UINT count)
 {
-    BYTE status = USBH_OK;
-    usb_core_driver *udev = (usb_core_driver *)usb_host_msc.data;
+    usbh_status status;
 
-    if((!count) || drv) {
+    if((!count) || (drv >= DISK_DRIVE_NUM)) {
         return RES_PARERR;
     }
 
-    if(state & STA_NOINIT) {
+    if(disk_status(drv) & STA_NOINIT) {
         return RES_NOTRDY;
     }
 
-    if(state & STA_PROTECT) {
+    if(state[drv] & STA_PROTECT) {
         return RES_WRPRT;
     }
 
-    if(udev->host.connect_status) {
-        do {
-            status = usbh_msc_write(&usb_host_msc, drv, sector, (BYTE *)buff, count);
-
-            if(!udev->host.connect_status) {
-                return RES_ERROR;
-            }
-        } while(USBH_BUSY == status);
-    }
+#ifdef USBH_MSC_CACHE_ENABLED
+    status = usbh_msc_cache_write(buff, sector, count);
+#else
+    status = disk_rdwr(drv, MSC_IO_WRITE, (BYTE *)buff, sector, count);
+#endif /* USBH_MSC_CACHE_ENABLED */
 
     if(USBH_OK == status) {
         return RES_OK;
@@ -159,7 +321,7 @@ DRESULT disk_write(BYTE drv, const BYTE *buff, DWORD sector, UINT count)
 
 /*!
     \brief      I/O control function
-    \param[in]  drv: physical drive number (0)
+    \param[in]  drv: physical drive number, the LUN
     \param[in]  ctrl: control code
     \param[in]  buff: pointer to the data buffer to store read data
     \param[out] none
@@ -168,27 +330,34 @@ DRESULT disk_write(BYTE drv, const BYTE *buff, DWORD sector, UINT count)
 DRESULT disk_ioctl(BYTE drv, BYTE ctrl, void *buff)
 {
     DRESULT res = RES_OK;
+    usbh_host *uhost = disk_host();
     msc_lun info;
 
-    if(drv) {
+    if(drv >= DISK_DRIVE_NUM) {
         return RES_PARERR;
     }
 
     res = RES_ERROR;
 
-    if(state & STA_NOINIT) {
+    if((NULL == uhost) || (disk_status(drv) & STA_NOINIT)) {
         return RES_NOTRDY;
     }
 
     switch(ctrl) {
     /* make sure that no pending write process */
     case CTRL_SYNC:
+#ifdef USBH_MSC_CACHE_ENABLED
+        if(USBH_OK == usbh_msc_cache_flush()) {
+            res = RES_OK;
+        }
+#else
         res = RES_OK;
+#endif /* USBH_MSC_CACHE_ENABLED */
         break;
 
     /* get number of sectors on the disk (dword) */
     case GET_SECTOR_COUNT:
-        if(USBH_OK == usbh_msc_lun_info_get(&usb_host_msc, drv, &info)) {
+        if(USBH_OK == usbh_msc_lun_info_get(uhost, drv, &info)) {
             *(DWORD *)buff = (DWORD)info.capacity.block_nbr;
             res = RES_OK;
         }
@@ -196,7 +365,7 @@ DRESULT disk_ioctl(BYTE drv, BYTE ctrl, void *buff)
 
     /* get r/w sector size (word) */
     case GET_SECTOR_SIZE:
-        if(USBH_OK == usbh_msc_lun_info_get(&usb_host_msc, drv, &info)) {
+        if(USBH_OK == usbh_msc_lun_info_get(uhost, drv, &info)) {
             *(WORD *)buff = (DWORD)info.capacity.block_size;
             res = RES_OK;
         }
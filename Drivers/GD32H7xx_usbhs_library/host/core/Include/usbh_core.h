@@ -38,8 +38,13 @@ OF SUCH DAMAGE.
 #include "usbh_conf.h"
 #include "drv_usb_host.h"
 
+#ifdef USBH_SCHED_ENABLED
+#include "usbh_sched.h"
+#endif /* USBH_SCHED_ENABLED */
+
 #define MSC_CLASS                                       0x08U                  /*!< USB MSC class */
 #define HID_CLASS                                       0x03U                  /*!< USB HID class */
+#define HUB_CLASS                                       0x09U                  /*!< USB hub class */
 #define MSC_PROTOCOL                                    0x50U                  /*!< USB MSC protocol */
 #define CBI_PROTOCOL                                    0x01U                  /*!< USB CBI protocol */
 
@@ -154,6 +159,8 @@ typedef struct {
     uint8_t                   addr;                                                  /*!< USB device address */
 
     uint32_t                  speed;                                                 /*!< USB device speed */
+    uint8_t                   hub_addr;                                              /*!< address of the hub the device is attached to, 0 on the root port */
+    uint8_t                   hub_port;                                              /*!< number of the hub port the device is attached to */
 
     usb_desc_dev              dev_desc;                                              /*!< USB device descriptor  */
     usb_desc_cfg_set          cfg_desc_set;                                          /*!< USB interface descriptor set */
@@ -220,6 +227,9 @@ typedef struct _usbh_host {
 
     void                                *data;                              /*!< used for... */
 
+    struct _usbh_host                   *parent;                            /*!< host of the hub the device is attached to, NULL on the root port */
+    __IO uint8_t                        dev_connected;                      /*!< device present on the hub port */
+
 #if USB_LOW_POWER
     uint8_t                             suspend_flag;                       /*!< host suspend flag */
     uint8_t                             dev_supp_remote_wkup;               /*!< record device remote wakeup function */
@@ -236,7 +246,11 @@ typedef struct _usbh_host {
 */
 static inline usb_urb_state usbh_urbstate_get(usb_core_driver *udev, uint8_t pp_num)
 {
+#ifdef USBH_SCHED_ENABLED
+    return usbh_sched_urbstate_get(udev, pp_num);
+#else
     return udev->host.pipe[pp_num].urb_state;
+#endif /* USBH_SCHED_ENABLED */
 }
 
 /*!
@@ -248,7 +262,13 @@ static inline usb_urb_state usbh_urbstate_get(usb_core_driver *udev, uint8_t pp_
 */
 static inline uint32_t usbh_xfercount_get(usb_core_driver *udev, uint8_t pp_num)
 {
+#ifdef USBH_SCHED_ENABLED
+    (void)udev;
+
+    return usbh_sched_xfercount_get(pp_num);
+#else
     return udev->host.backup_xfercount[pp_num];
+#endif /* USBH_SCHED_ENABLED */
 }
 
 /* function declarations */
@@ -38,7 +38,11 @@ OF SUCH DAMAGE.
 #include "usbh_core.h"
 
 /* host pipe maximum */
+#ifdef USBH_SCHED_ENABLED
+#define HP_MAX                  USBH_SCHED_PIPE_NUM
+#else
 #define HP_MAX                  16U
+#endif /* USBH_SCHED_ENABLED */
 
 /* host pipe status */
 #define HP_OK                   0x0000U           /*!< host pipe status */
@@ -46,6 +50,25 @@ OF SUCH DAMAGE.
 #define HP_ERROR                0xFFFFU           /*!< host pipe error status */
 #define HP_USED_MASK            0x7FFFU           /*!< host pipe used mask */
 
+/*!
+    \brief      get the transfer state of a pipe
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  pp_num: pipe number
+    \param[out] none
+    \retval     pointer to the pipe state
+*/
+__STATIC_INLINE usb_pipe *usbh_pipe_get(usb_core_driver *udev, uint8_t pp_num)
+{
+#ifdef USBH_SCHED_ENABLED
+    (void)udev;
+
+    /* with the scheduler a pipe is logical and holds a host channel only while it transfers */
+    return usbh_sched_pipe_get(pp_num);
+#else
+    return &udev->host.pipe[pp_num];
+#endif /* USBH_SCHED_ENABLED */
+}
+
 /*!
     \brief      set toggle for a pipe
     \param[in]  udev: pointer to USB core instance
@@ -56,10 +79,12 @@ OF SUCH DAMAGE.
 */
 __STATIC_INLINE void usbh_pipe_toggle_set(usb_core_driver *udev, uint8_t pp_num, uint8_t toggle)
 {
-    if(udev->host.pipe[pp_num].ep.dir) {
-        udev->host.pipe[pp_num].data_toggle_in = toggle;
+    usb_pipe *pp = usbh_pipe_get(udev, pp_num);
+
+    if(pp->ep.dir) {
+        pp->data_toggle_in = toggle;
     } else {
-        udev->host.pipe[pp_num].data_toggle_out = toggle;
+        pp->data_toggle_out = toggle;
     }
 }
 
@@ -72,10 +97,12 @@ __STATIC_INLINE void usbh_pipe_toggle_set(usb_core_driver *udev, uint8_t pp_num,
 */
 __STATIC_INLINE uint8_t usbh_pipe_toggle_get(usb_core_driver *udev, uint8_t pp_num)
 {
-    if(udev->host.pipe[pp_num].ep.dir) {
-        return udev->host.pipe[pp_num].data_toggle_in;
+    usb_pipe *pp = usbh_pipe_get(udev, pp_num);
+
+    if(pp->ep.dir) {
+        return pp->data_toggle_in;
     } else {
-        return udev->host.pipe[pp_num].data_toggle_out;
+        return pp->data_toggle_out;
     }
 }
 
@@ -96,6 +123,8 @@ uint8_t usbh_pipe_update(usb_core_driver *udev, \
 uint8_t usbh_pipe_allocate(usb_core_driver *udev, uint8_t ep_addr);
 /* free a pipe */
 uint8_t usbh_pipe_free(usb_core_driver *udev, uint8_t pp_num);
+/* stop the transfer running on a pipe */
+uint8_t usbh_pipe_halt(usb_core_driver *udev, uint8_t pp_num);
 /* delete all USB host pipe */
 uint8_t usbh_pipe_delete(usb_core_driver *udev);
 
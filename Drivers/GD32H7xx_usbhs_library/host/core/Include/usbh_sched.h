@@ -0,0 +1,88 @@
+/*!
+    \file    usbh_sched.h
+    \brief   USB host channel scheduler header file
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef USBH_SCHED_H
+#define USBH_SCHED_H
+
+#include "usbh_conf.h"
+#include "drv_usb_host.h"
+
+/* logical pipes shared by all devices on the bus, each one takes a host channel only while it transfers */
+#ifndef USBH_SCHED_PIPE_NUM
+#define USBH_SCHED_PIPE_NUM                     32U
+#endif /* USBH_SCHED_PIPE_NUM */
+
+/* host channels control and bulk transfers leave free for interrupt and isochronous ones */
+#ifndef USBH_SCHED_PERIODIC_RESERVE
+#define USBH_SCHED_PERIODIC_RESERVE             1U
+#endif /* USBH_SCHED_PERIODIC_RESERVE */
+
+/* SOF periods a control/bulk IN transfer may hold a channel without receiving data while others wait */
+#ifndef USBH_SCHED_BULK_SLICE
+#define USBH_SCHED_BULK_SLICE                   2U
+#endif /* USBH_SCHED_BULK_SLICE */
+
+#if (USBH_SCHED_PIPE_NUM > 0xF0U) || (USBH_SCHED_PERIODIC_RESERVE >= USBHS_MAX_CHANNEL_COUNT) || (0U == USBH_SCHED_BULK_SLICE)
+#error "invalid USB host scheduler configuration"
+#endif
+
+/* scheduler statistics */
+typedef struct {
+    uint32_t        grants;                             /*!< transfers started on a host channel */
+    uint32_t        preempts;                           /*!< idle control/bulk IN transfers taken off their channel */
+    uint32_t        periodic_wait_max;                  /*!< longest wait of an interrupt/isochronous transfer for a channel, in SOF periods */
+    uint32_t        bulk_wait_max;                      /*!< longest wait of a control/bulk transfer for a channel, in SOF periods */
+} usbh_sched_stats;
+
+/* function declarations */
+/* initialize the scheduler for the host core */
+void usbh_sched_init(usb_core_driver *udev);
+/* get the transfer state of a logical pipe */
+usb_pipe *usbh_sched_pipe_get(uint8_t pp_num);
+/* queue the transfer prepared in a logical pipe */
+usb_status usbh_sched_submit(usb_core_driver *udev, uint8_t pp_num);
+/* stop the transfer of a logical pipe */
+void usbh_sched_cancel(usb_core_driver *udev, uint8_t pp_num);
+/* get the URB state of a logical pipe */
+usb_urb_state usbh_sched_urbstate_get(usb_core_driver *udev, uint8_t pp_num);
+/* get the transfer data count of a logical pipe */
+uint32_t usbh_sched_xfercount_get(uint8_t pp_num);
+/* collect finished transfers and hand out free host channels, called on every SOF */
+void usbh_sched_sof(usb_core_driver *udev);
+/* get the scheduler statistics */
+void usbh_sched_stats_get(usbh_sched_stats *stats);
+/* reset the scheduler statistics */
+void usbh_sched_stats_reset(void);
+
+#endif /* USBH_SCHED_H */
@@ -91,6 +91,10 @@ void usbh_init(usbh_host *uhost, usb_core_driver *udev, usbh_user_cb *user_cb)
 
     usb_basic_init(&udev->bp, &udev->regs);
 
+#ifdef USBH_SCHED_ENABLED
+    usbh_sched_init(udev);
+#endif /* USBH_SCHED_ENABLED */
+
 #ifndef DUAL_ROLE_MODE_ENABLED
     usb_globalint_disable(&udev->regs);
 
@@ -162,6 +166,10 @@ usbh_status usbh_deinit(usbh_host *uhost)
     usbh_pipe_free(udev, uhost->control.pipe_in_num);
     usbh_pipe_free(udev, uhost->control.pipe_out_num);
 
+    /* the pipes may be handed to another device on the same hub */
+    uhost->control.pipe_in_num = 0xFFU;
+    uhost->control.pipe_out_num = 0xFFU;
+
     return USBH_OK;
 }
 
@@ -175,9 +183,16 @@ void usbh_core_task(usbh_host *uhost)
 {
     volatile usbh_status status = USBH_FAIL;
     usb_core_driver *udev = (usb_core_driver *)uhost->data;
+    uint8_t port_ready = 0U;
+
+    /* check for host port events, the port of a device behind a hub is watched by the hub class */
+    if(NULL == uhost->parent) {
+        port_ready = (uint8_t)((0U != udev->host.connect_status) && (0U != udev->host.port_enabled));
+    } else {
+        port_ready = uhost->dev_connected;
+    }
 
-    /* check for host port events */
-    if(((0U == udev->host.connect_status) || (0U == udev->host.port_enabled)) && (HOST_DEFAULT != uhost->cur_state)) {
+    if((0U == port_ready) && (HOST_DEFAULT != uhost->cur_state)) {
         if(HOST_DEV_DETACHED != uhost->cur_state) {
             uhost->cur_state = HOST_DEV_DETACHED;
         }
@@ -185,7 +200,14 @@ void usbh_core_task(usbh_host *uhost)
 
     switch (uhost->cur_state) {
     case HOST_DEFAULT:
-        if(udev->host.connect_status) {
+        if(NULL != uhost->parent) {
+            /* the hub has already reset its port and reported the device speed */
+            if(uhost->dev_connected) {
+                uhost->cur_state = HOST_DEV_CONNECT;
+
+                uhost->usr_cb->dev_speed_detected(uhost->dev_prop.speed);
+            }
+        } else if(udev->host.connect_status) {
             uhost->cur_state = HOST_DETECT_DEV_SPEED;
 
             usb_mdelay(100U);
@@ -364,7 +386,10 @@ void usbh_core_task(usbh_host *uhost)
         /* deinitialize host for new enumeration */
         usbh_deinit(uhost);
         uhost->usr_cb->dev_deinit();
-        uhost->active_class->class_deinit(uhost);
+
+        if(NULL != uhost->active_class) {
+            uhost->active_class->class_deinit(uhost);
+        }
         break;
 
     case HOST_DEV_DETACHED:
@@ -374,8 +399,16 @@ void usbh_core_task(usbh_host *uhost)
         /* re-initialize host for new enumeration */
         usbh_deinit(uhost);
         uhost->usr_cb->dev_deinit();
-        uhost->active_class->class_deinit(uhost);
-        usbh_pipe_delete(udev);
+
+        if(NULL != uhost->active_class) {
+            uhost->active_class->class_deinit(uhost);
+        }
+
+        /* devices behind a hub only give back their own pipes */
+        if(NULL == uhost->parent) {
+            usbh_pipe_delete(udev);
+        }
+
         uhost->cur_state = HOST_DEFAULT;
         break;
 
@@ -475,6 +508,10 @@ static uint8_t usb_ev_sof(usbh_host *uhost)
     /* update timer variable */
     uhost->control.timer++;
 
+#ifdef USBH_SCHED_ENABLED
+    usbh_sched_sof((usb_core_driver *)uhost->data);
+#endif /* USBH_SCHED_ENABLED */
+
     /* this callback could be used to implement a scheduler process */
     if(NULL != uhost->active_class) {
         if(NULL != uhost->active_class->class_sof) {
@@ -497,6 +534,9 @@ static usbh_status usbh_enum_task(usbh_host *uhost)
     usbh_status status = USBH_BUSY;
     usb_core_driver *udev = (usb_core_driver *)uhost->data;
 
+    /* devices behind a hub are told apart by the hub port they are attached to */
+    uint8_t dev_addr = (NULL == uhost->parent) ? USBH_DEV_ADDR : (uint8_t)(USBH_DEV_ADDR + uhost->dev_prop.hub_port);
+
 #ifdef USB_MTP
     static uint8_t interface = 0U, index_itf_str = 0U;
 #endif /* USB_MTP */
@@ -539,10 +579,10 @@ static usbh_status usbh_enum_task(usbh_host *uhost)
 
     case ENUM_SET_ADDR:
         /* set address */
-        if(USBH_OK == usbh_setaddress(uhost, USBH_DEV_ADDR)) {
+        if(USBH_OK == usbh_setaddress(uhost, dev_addr)) {
             usb_mdelay(2U);
 
-            uhost->dev_prop.addr = USBH_DEV_ADDR;
+            uhost->dev_prop.addr = dev_addr;
 
             /* user callback for device address assigned */
             uhost->usr_cb->dev_address_set();
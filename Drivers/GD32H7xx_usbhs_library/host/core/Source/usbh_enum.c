@@ -360,7 +360,7 @@ usbh_status usbh_clrfeature(usbh_host *uhost, uint8_t ep_addr, uint8_t pp_num)
             .wLength       = 0U
         };
 
-        if(EP_ID(ep_addr) == udev->host.pipe[pp_num].ep.num) {
+        if(EP_ID(ep_addr) == usbh_pipe_get(udev, pp_num)->ep.num) {
             usbh_pipe_toggle_set(udev, pp_num, 0U);
         } else {
             return USBH_FAIL;
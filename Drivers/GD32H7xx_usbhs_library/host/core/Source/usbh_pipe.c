@@ -53,10 +53,12 @@ uint8_t usbh_pipe_create(usb_core_driver *udev, \
                          uint8_t  ep_type, \
                          uint16_t ep_mpl)
 {
-    usb_pipe *pp = &udev->host.pipe[pp_num];
+    usb_pipe *pp = usbh_pipe_get(udev, pp_num);
 
     pp->dev_addr = dev->addr;
     pp->dev_speed = dev->speed;
+    pp->hub_addr = dev->hub_addr;
+    pp->hub_port = dev->hub_port;
     pp->ep.type = ep_type;
     pp->ep.mps = ep_mpl;
 
@@ -64,7 +66,10 @@ uint8_t usbh_pipe_create(usb_core_driver *udev, \
         pp->supp_ping = (uint8_t)(pp->dev_speed == PORT_SPEED_HIGH);
     }
 
+#ifndef USBH_SCHED_ENABLED
+    /* with the scheduler the host channel is set up when a transfer is granted one */
     usb_pipe_init(udev, pp_num);
+#endif /* USBH_SCHED_ENABLED */
 
     return HP_OK;
 }
@@ -85,7 +90,7 @@ uint8_t usbh_pipe_update(usb_core_driver *udev, \
                          uint32_t dev_speed, \
                          uint16_t ep_mpl)
 {
-    usb_pipe *pp = &udev->host.pipe[pp_num];
+    usb_pipe *pp = usbh_pipe_get(udev, pp_num);
 
     if((pp->dev_addr != dev_addr) && (dev_addr)) {
         pp->dev_addr = dev_addr;
@@ -103,7 +108,10 @@ uint8_t usbh_pipe_update(usb_core_driver *udev, \
         pp->ep.mps = ep_mpl;
     }
 
+#ifndef USBH_SCHED_ENABLED
+    /* with the scheduler the host channel is set up when a transfer is granted one */
     usb_pipe_init(udev, pp_num);
+#endif /* USBH_SCHED_ENABLED */
 
     return HP_OK;
 }
@@ -120,9 +128,11 @@ uint8_t usbh_pipe_allocate(usb_core_driver *udev, uint8_t ep_addr)
     uint16_t pp_num = usbh_freepipe_get(udev);
 
     if(HP_ERROR != pp_num) {
-        udev->host.pipe[pp_num].in_used = 1U;
-        udev->host.pipe[pp_num].ep.dir = EP_DIR(ep_addr);
-        udev->host.pipe[pp_num].ep.num = EP_ID(ep_addr);
+        usb_pipe *pp = usbh_pipe_get(udev, (uint8_t)pp_num);
+
+        pp->in_used = 1U;
+        pp->ep.dir = EP_DIR(ep_addr);
+        pp->ep.num = EP_ID(ep_addr);
     }
 
     return (uint8_t)pp_num;
@@ -138,12 +148,34 @@ uint8_t usbh_pipe_allocate(usb_core_driver *udev, uint8_t ep_addr)
 uint8_t usbh_pipe_free(usb_core_driver *udev, uint8_t pp_num)
 {
     if(pp_num < HP_MAX) {
-        udev->host.pipe[pp_num].in_used = 0U;
+#ifdef USBH_SCHED_ENABLED
+        usbh_sched_cancel(udev, pp_num);
+#endif /* USBH_SCHED_ENABLED */
+
+        usbh_pipe_get(udev, pp_num)->in_used = 0U;
     }
 
     return USBH_OK;
 }
 
+/*!
+    \brief      stop the transfer running on a pipe
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  pp_num: pipe number
+    \param[out] none
+    \retval     operation status
+*/
+uint8_t usbh_pipe_halt(usb_core_driver *udev, uint8_t pp_num)
+{
+#ifdef USBH_SCHED_ENABLED
+    usbh_sched_cancel(udev, pp_num);
+#else
+    (void)usb_pipe_halt(udev, pp_num);
+#endif /* USBH_SCHED_ENABLED */
+
+    return HP_OK;
+}
+
 /*!
     \brief      delete all USB host pipe
     \param[in]  udev: pointer to USB core instance
@@ -155,7 +187,11 @@ uint8_t usbh_pipe_delete(usb_core_driver *udev)
     uint8_t pp_num = 0U;
 
     for(pp_num = 2U; pp_num < HP_MAX; pp_num++) {
-        udev->host.pipe[pp_num] = (usb_pipe){0};
+#ifdef USBH_SCHED_ENABLED
+        usbh_sched_cancel(udev, pp_num);
+#endif /* USBH_SCHED_ENABLED */
+
+        *usbh_pipe_get(udev, pp_num) = (usb_pipe){0};
     }
 
     return USBH_OK;
@@ -172,7 +208,7 @@ static uint16_t usbh_freepipe_get(usb_core_driver *udev)
     uint8_t pp_num = 0U;
 
     for(pp_num = 0U; pp_num < HP_MAX; pp_num++) {
-        if(0U == udev->host.pipe[pp_num].in_used) {
+        if(0U == usbh_pipe_get(udev, pp_num)->in_used) {
             return (uint16_t)pp_num;
         }
     }
@@ -0,0 +1,535 @@
+/*!
+    \file    usbh_sched.c
+    \brief   USB host channel scheduler
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "usbh_pipe.h"
+#include "usbh_sched.h"
+
+#include <string.h>
+
+#define SCHED_CH_FREE                           0xFFU               /* host channel not in use */
+#define SCHED_CH_DRAIN                          0xFEU               /* host channel stopping a cancelled transfer */
+
+/* logical pipe */
+typedef struct {
+    usb_pipe            pipe;                                       /*!< transfer state, loaded into the host channel while granted */
+    uint32_t            xfercount;                                  /*!< data count of the last transfer */
+    uint32_t            base;                                       /*!< data received before the transfer was preempted */
+    uint32_t            progress;                                   /*!< data received at the last check */
+    uint32_t            submit_frame;                               /*!< SOF count when the transfer was queued */
+    uint32_t            active_frame;                               /*!< SOF count when the transfer last moved data */
+    uint8_t             ch;                                         /*!< granted host channel */
+    uint8_t             pending;                                    /*!< transfer waits for a host channel */
+    uint8_t             preempt;                                    /*!< host channel is being taken back */
+} usbh_sched_pipe;
+
+/* scheduler state */
+typedef struct {
+    usbh_sched_pipe     pipe[USBH_SCHED_PIPE_NUM];                  /*!< logical pipes */
+    uint8_t             owner[USBHS_MAX_TX_FIFOS];                  /*!< logical pipe each host channel is granted to */
+    uint8_t             ch_num;                                     /*!< number of host channels */
+    uint8_t             next_periodic;                              /*!< round-robin start among interrupt/isochronous pipes */
+    uint8_t             next_bulk;                                  /*!< round-robin start among control/bulk pipes */
+    uint32_t            frame;                                      /*!< SOF count */
+    usbh_sched_stats    stats;                                      /*!< statistics */
+} usbh_sched;
+
+static usbh_sched sched;
+
+/* local function prototypes ('static') */
+static uint8_t usbh_sched_periodic(usbh_sched_pipe *sp);
+static uint32_t usbh_sched_received(usb_core_driver *udev, uint8_t ch);
+static void usbh_sched_grant(usb_core_driver *udev, uint8_t pp_num, uint8_t ch);
+static void usbh_sched_harvest(usb_core_driver *udev, uint8_t ch);
+static void usbh_sched_detach(usb_core_driver *udev, usbh_sched_pipe *sp);
+static void usbh_sched_dispatch(usb_core_driver *udev);
+static void usbh_sched_preempt(usb_core_driver *udev);
+
+/*!
+    \brief      initialize the scheduler for the host core
+    \param[in]  udev: pointer to USB core instance
+    \param[out] none
+    \retval     none
+*/
+void usbh_sched_init(usb_core_driver *udev)
+{
+    uint8_t i = 0U;
+
+    memset((void *)&sched, 0U, sizeof(usbh_sched));
+
+    sched.ch_num = (uint8_t)USB_MIN(udev->bp.num_pipe, USBHS_MAX_TX_FIFOS);
+
+    for(i = 0U; i < USBH_SCHED_PIPE_NUM; i++) {
+        sched.pipe[i].ch = SCHED_CH_FREE;
+    }
+
+    for(i = 0U; i < USBHS_MAX_TX_FIFOS; i++) {
+        sched.owner[i] = SCHED_CH_FREE;
+    }
+}
+
+/*!
+    \brief      get the transfer state of a logical pipe
+    \param[in]  pp_num: logical pipe number
+    \param[out] none
+    \retval     pointer to the pipe state
+*/
+usb_pipe *usbh_sched_pipe_get(uint8_t pp_num)
+{
+    return &sched.pipe[pp_num].pipe;
+}
+
+/*!
+    \brief      queue the transfer prepared in a logical pipe
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  pp_num: logical pipe number
+    \param[out] none
+    \retval     operation status
+*/
+usb_status usbh_sched_submit(usb_core_driver *udev, uint8_t pp_num)
+{
+    uint32_t primask;
+    usbh_sched_pipe *sp = &sched.pipe[pp_num];
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    usbh_sched_detach(udev, sp);
+
+    sp->base = 0U;
+    sp->pending = 1U;
+    sp->submit_frame = sched.frame;
+
+    /* start at once when a channel is free, otherwise on a later SOF */
+    usbh_sched_dispatch(udev);
+
+    __set_PRIMASK(primask);
+
+    return USB_OK;
+}
+
+/*!
+    \brief      stop the transfer of a logical pipe
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  pp_num: logical pipe number
+    \param[out] none
+    \retval     none
+*/
+void usbh_sched_cancel(usb_core_driver *udev, uint8_t pp_num)
+{
+    uint32_t primask;
+
+    if(pp_num < USBH_SCHED_PIPE_NUM) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+
+        usbh_sched_detach(udev, &sched.pipe[pp_num]);
+
+        sched.pipe[pp_num].pending = 0U;
+
+        __set_PRIMASK(primask);
+    }
+}
+
+/*!
+    \brief      get the URB state of a logical pipe
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  pp_num: logical pipe number
+    \param[out] none
+    \retval     URB state
+*/
+usb_urb_state usbh_sched_urbstate_get(usb_core_driver *udev, uint8_t pp_num)
+{
+    uint32_t primask;
+    usbh_sched_pipe *sp = &sched.pipe[pp_num];
+
+    /* collect a finished transfer without waiting for the next SOF */
+    if(sp->ch < sched.ch_num) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+
+        if(sp->ch < sched.ch_num) {
+            usbh_sched_harvest(udev, sp->ch);
+
+            if(SCHED_CH_FREE == sp->ch) {
+                usbh_sched_dispatch(udev);
+            }
+        }
+
+        __set_PRIMASK(primask);
+    }
+
+    return sp->pipe.urb_state;
+}
+
+/*!
+    \brief      get the transfer data count of a logical pipe
+    \param[in]  pp_num: logical pipe number
+    \param[out] none
+    \retval     transfer data count
+*/
+uint32_t usbh_sched_xfercount_get(uint8_t pp_num)
+{
+    return sched.pipe[pp_num].xfercount;
+}
+
+/*!
+    \brief      collect finished transfers and hand out free host channels, called on every SOF
+    \param[in]  udev: pointer to USB core instance
+    \param[out] none
+    \retval     none
+*/
+void usbh_sched_sof(usb_core_driver *udev)
+{
+    uint8_t ch = 0U;
+
+    sched.frame++;
+
+    for(ch = 0U; ch < sched.ch_num; ch++) {
+        usbh_sched_harvest(udev, ch);
+    }
+
+    usbh_sched_dispatch(udev);
+
+    usbh_sched_preempt(udev);
+}
+
+/*!
+    \brief      get the scheduler statistics
+    \param[in]  none
+    \param[out] stats: scheduler statistics
+    \retval     none
+*/
+void usbh_sched_stats_get(usbh_sched_stats *stats)
+{
+    *stats = sched.stats;
+}
+
+/*!
+    \brief      reset the scheduler statistics
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void usbh_sched_stats_reset(void)
+{
+    memset((void *)&sched.stats, 0U, sizeof(usbh_sched_stats));
+}
+
+/*!
+    \brief      check whether a logical pipe carries interrupt or isochronous transfers
+    \param[in]  sp: logical pipe
+    \param[out] none
+    \retval     1 for a periodic pipe, 0 otherwise
+*/
+static uint8_t usbh_sched_periodic(usbh_sched_pipe *sp)
+{
+    return (uint8_t)((USB_EPTYPE_INTR == sp->pipe.ep.type) || (USB_EPTYPE_ISOC == sp->pipe.ep.type));
+}
+
+/*!
+    \brief      get the data received by the transfer running on an IN host channel
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  ch: host channel number
+    \param[out] none
+    \retval     received data count
+*/
+static uint32_t usbh_sched_received(usb_core_driver *udev, uint8_t ch)
+{
+    usb_pipe *pp = &udev->host.pipe[ch];
+
+    if(USB_USE_DMA == udev->bp.transfer_mode) {
+        return pp->xfer_len - (udev->regs.pr[ch]->HCHLEN & HCHLEN_TLEN);
+    }
+
+    return pp->xfer_count;
+}
+
+/*!
+    \brief      start the transfer of a logical pipe on a host channel
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  pp_num: logical pipe number
+    \param[in]  ch: free host channel number
+    \param[out] none
+    \retval     none
+*/
+static void usbh_sched_grant(usb_core_driver *udev, uint8_t pp_num, uint8_t ch)
+{
+    usbh_sched_pipe *sp = &sched.pipe[pp_num];
+    uint32_t wait = sched.frame - sp->submit_frame;
+    usb_status status = USB_OK;
+
+    if(usbh_sched_periodic(sp)) {
+        if(wait > sched.stats.periodic_wait_max) {
+            sched.stats.periodic_wait_max = wait;
+        }
+    } else {
+        if(wait > sched.stats.bulk_wait_max) {
+            sched.stats.bulk_wait_max = wait;
+        }
+    }
+
+    sched.stats.grants++;
+    sched.owner[ch] = pp_num;
+
+    sp->ch = ch;
+    sp->pending = 0U;
+    sp->progress = 0U;
+    sp->active_frame = sched.frame;
+
+    udev->host.pipe[ch] = sp->pipe;
+    udev->host.backup_xfercount[ch] = 0U;
+
+    (void)usb_pipe_init(udev, ch);
+
+    if(1U == sp->pipe.do_ping) {
+        status = usb_pipe_ping(udev, ch);
+    } else {
+        status = usb_pipe_xfer(udev, ch);
+    }
+
+    /* the channel never started, so complete the logical pipe with an error and hand the channel back */
+    if(USB_OK != status) {
+        sp->pipe.urb_state = URB_ERROR;
+        sp->xfercount = sp->base;
+        sp->ch = SCHED_CH_FREE;
+
+        sched.owner[ch] = SCHED_CH_FREE;
+    }
+}
+
+/*!
+    \brief      release a host channel whose transfer has stopped
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  ch: host channel number
+    \param[out] none
+    \retval     none
+*/
+static void usbh_sched_harvest(usb_core_driver *udev, uint8_t ch)
+{
+    usb_pr *pp_reg = udev->regs.pr[ch];
+    usb_pipe *pp = &udev->host.pipe[ch];
+    usbh_sched_pipe *sp = NULL;
+    uint8_t pp_num = sched.owner[ch];
+    uint32_t received = 0U;
+
+    if(SCHED_CH_FREE == pp_num) {
+        return;
+    }
+
+    /* the channel is done once it has stopped and its interrupts have been serviced */
+    if((pp_reg->HCHCTL & HCHCTL_CEN) || (pp_reg->HCHINTF & pp_reg->HCHINTEN)) {
+        return;
+    }
+
+    /* in FIFO mode an IN channel pauses between packets until the RX FIFO has been read */
+    if((URB_IDLE == pp->urb_state) && (USB_USE_FIFO == udev->bp.transfer_mode) && (udev->regs.gr->GINTF & GINTF_RXFNEIF)) {
+        return;
+    }
+
+    if(SCHED_CH_DRAIN != pp_num) {
+        sp = &sched.pipe[pp_num];
+
+        if((1U == sp->preempt) && (URB_IDLE == pp->urb_state)) {
+            received = usbh_sched_received(udev, ch);
+
+            /* keep what arrived before the channel stopped and queue a request for the rest */
+            if(received > 0U) {
+#ifdef USB_INTERNAL_DMA_ENABLED
+                if(USB_USE_DMA == udev->bp.transfer_mode) {
+                    usb_dma_rx_complete(pp->xfer_buf, received, pp->dma_addr);
+                }
+#endif /* USB_INTERNAL_DMA_ENABLED */
+
+                sp->pipe.xfer_buf += received;
+                sp->pipe.xfer_len = pp->xfer_len - received;
+                sp->pipe.DPID = pp_reg->HCHLEN & HCHLEN_DPID;
+                sp->base += received;
+            }
+
+            sp->pending = 1U;
+            sp->submit_frame = sched.frame;
+        } else {
+            sp->pipe = *pp;
+            sp->pipe.xfer_count += sp->base;
+            sp->xfercount = udev->host.backup_xfercount[ch] + sp->base;
+        }
+
+        sp->preempt = 0U;
+        sp->ch = SCHED_CH_FREE;
+    }
+
+    sched.owner[ch] = SCHED_CH_FREE;
+}
+
+/*!
+    \brief      take a logical pipe off its host channel, dropping the running transfer
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  sp: logical pipe
+    \param[out] none
+    \retval     none
+*/
+static void usbh_sched_detach(usb_core_driver *udev, usbh_sched_pipe *sp)
+{
+    uint8_t ch = sp->ch;
+
+    if(ch < sched.ch_num) {
+        /* only the halt is left to be serviced */
+        udev->regs.pr[ch]->HCHINTEN = HCHINTEN_CHIE;
+
+        if(udev->regs.pr[ch]->HCHCTL & HCHCTL_CEN) {
+            (void)usb_pipe_halt(udev, ch);
+        }
+
+        sched.owner[ch] = SCHED_CH_DRAIN;
+        sp->ch = SCHED_CH_FREE;
+    }
+
+    sp->preempt = 0U;
+}
+
+/*!
+    \brief      hand out free host channels, interrupt and isochronous transfers first
+    \param[in]  udev: pointer to USB core instance
+    \param[out] none
+    \retval     none
+*/
+static void usbh_sched_dispatch(usb_core_driver *udev)
+{
+    uint8_t i = 0U, ch = 0U, free_num = 0U, start = 0U;
+    uint8_t pp_num = 0U;
+
+    for(i = 0U; i < sched.ch_num; i++) {
+        if(SCHED_CH_FREE == sched.owner[i]) {
+            free_num++;
+        }
+    }
+
+    /* periodic transfers may use every free channel */
+    start = sched.next_periodic;
+
+    for(i = 0U; (i < USBH_SCHED_PIPE_NUM) && (free_num > 0U); i++) {
+        pp_num = (uint8_t)((start + i) % USBH_SCHED_PIPE_NUM);
+
+        if((1U == sched.pipe[pp_num].pending) && usbh_sched_periodic(&sched.pipe[pp_num])) {
+            while(SCHED_CH_FREE != sched.owner[ch]) {
+                ch++;
+            }
+
+            usbh_sched_grant(udev, pp_num, ch);
+
+            free_num--;
+            sched.next_periodic = (uint8_t)((pp_num + 1U) % USBH_SCHED_PIPE_NUM);
+        }
+    }
+
+    /* control and bulk transfers share the rest round-robin */
+    start = sched.next_bulk;
+
+    for(i = 0U; (i < USBH_SCHED_PIPE_NUM) && (free_num > USBH_SCHED_PERIODIC_RESERVE); i++) {
+        pp_num = (uint8_t)((start + i) % USBH_SCHED_PIPE_NUM);
+
+        if((1U == sched.pipe[pp_num].pending) && (0U == usbh_sched_periodic(&sched.pipe[pp_num]))) {
+            while(SCHED_CH_FREE != sched.owner[ch]) {
+                ch++;
+            }
+
+            usbh_sched_grant(udev, pp_num, ch);
+
+            free_num--;
+            sched.next_bulk = (uint8_t)((pp_num + 1U) % USBH_SCHED_PIPE_NUM);
+        }
+    }
+}
+
+/*!
+    \brief      take channels back from control/bulk IN transfers that stopped moving data while others wait
+    \param[in]  udev: pointer to USB core instance
+    \param[out] none
+    \retval     none
+*/
+static void usbh_sched_preempt(usb_core_driver *udev)
+{
+    uint8_t i = 0U, waiting = 0U;
+    uint8_t pp_num = 0U;
+    uint32_t received = 0U;
+    usbh_sched_pipe *sp = NULL;
+    usb_pr *pp_reg = NULL;
+
+    for(i = 0U; i < USBH_SCHED_PIPE_NUM; i++) {
+        waiting += sched.pipe[i].pending;
+    }
+
+    for(i = 0U; i < sched.ch_num; i++) {
+        pp_num = sched.owner[i];
+        pp_reg = udev->regs.pr[i];
+
+        if(SCHED_CH_FREE == pp_num) {
+            continue;
+        }
+
+        if((SCHED_CH_DRAIN == pp_num) || (1U == sched.pipe[pp_num].preempt)) {
+            /* the RX FIFO handler re-activates the channel after a packet, repeat a lost halt request */
+            if(HCHCTL_CEN == (pp_reg->HCHCTL & (HCHCTL_CEN | HCHCTL_CDIS))) {
+                (void)usb_pipe_halt(udev, i);
+            }
+
+            continue;
+        }
+
+        sp = &sched.pipe[pp_num];
+
+        if(usbh_sched_periodic(sp) || (0U == sp->pipe.ep.dir) || (0U == (pp_reg->HCHCTL & HCHCTL_CEN))) {
+            continue;
+        }
+
+        received = usbh_sched_received(udev, i);
+
+        if(received != sp->progress) {
+            sp->progress = received;
+            sp->active_frame = sched.frame;
+        } else if((waiting > 0U) && ((sched.frame - sp->active_frame) >= USBH_SCHED_BULK_SLICE)) {
+            /* the device keeps NAKing, the NAK handler must not re-activate the channel */
+            sp->preempt = 1U;
+
+            pp_reg->HCHINTEN = (pp_reg->HCHINTEN & ~HCHINTEN_NAKIE) | HCHINTEN_CHIE;
+
+            (void)usb_pipe_halt(udev, i);
+
+            sched.stats.preempts++;
+            waiting--;
+        } else {
+            /* no operation */
+        }
+    }
+}
@@ -44,6 +44,7 @@ static void usbh_data_in_transc(usbh_host *uhost);
 static void usbh_data_out_transc(usbh_host *uhost);
 static void usbh_status_in_transc(usbh_host *uhost);
 static void usbh_status_out_transc(usbh_host *uhost);
+static usb_pipe *usbh_request_pipe(usb_core_driver *udev, uint8_t pp_num);
 static uint32_t usbh_request_submit(usb_core_driver *udev, uint8_t pp_num);
 
 /*!
@@ -56,7 +57,7 @@ static uint32_t usbh_request_submit(usb_core_driver *udev, uint8_t pp_num);
 */
 usbh_status usbh_ctlsetup_send(usb_core_driver *udev, uint8_t *buf, uint8_t pp_num)
 {
-    usb_pipe *pp = &udev->host.pipe[pp_num];
+    usb_pipe *pp = usbh_request_pipe(udev, pp_num);
 
     pp->DPID = PIPE_DPID_SETUP;
     pp->xfer_buf = buf;
@@ -76,7 +77,7 @@ usbh_status usbh_ctlsetup_send(usb_core_driver *udev, uint8_t *buf, uint8_t pp_n
 */
 usbh_status usbh_data_send(usb_core_driver *udev, uint8_t *buf, uint8_t pp_num, uint16_t len)
 {
-    usb_pipe *pp = &udev->host.pipe[pp_num];
+    usb_pipe *pp = usbh_request_pipe(udev, pp_num);
 
     pp->xfer_buf = buf;
     pp->xfer_len = len;
@@ -124,7 +125,7 @@ usbh_status usbh_data_send(usb_core_driver *udev, uint8_t *buf, uint8_t pp_num,
 */
 usbh_status usbh_data_recev(usb_core_driver *udev, uint8_t *buf, uint8_t pp_num, uint16_t len)
 {
-    usb_pipe *pp = &udev->host.pipe[pp_num];
+    usb_pipe *pp = usbh_request_pipe(udev, pp_num);
 
     pp->xfer_buf = buf;
     pp->xfer_len = len;
@@ -350,6 +351,23 @@ static void usbh_status_out_transc(usbh_host *uhost)
     }
 }
 
+/*!
+    \brief      get a pipe ready to be loaded with a new request
+    \param[in]  udev: pointer to USB core instance
+    \param[in]  pp_num: pipe number
+    \param[out] none
+    \retval     pointer to the pipe state
+*/
+static usb_pipe *usbh_request_pipe(usb_core_driver *udev, uint8_t pp_num)
+{
+#ifdef USBH_SCHED_ENABLED
+    /* a request still holding a host channel would write its result back over the new one */
+    usbh_sched_cancel(udev, pp_num);
+#endif /* USBH_SCHED_ENABLED */
+
+    return usbh_pipe_get(udev, pp_num);
+}
+
 /*!
     \brief      prepare a pipe and start a transfer
     \param[in]  udev: pointer to USB core instance
@@ -359,14 +377,20 @@ static void usbh_status_out_transc(usbh_host *uhost)
 */
 static uint32_t usbh_request_submit(usb_core_driver *udev, uint8_t pp_num)
 {
-    udev->host.pipe[pp_num].urb_state = URB_IDLE;
-    udev->host.pipe[pp_num].xfer_count = 0U;
+    usb_pipe *pp = usbh_pipe_get(udev, pp_num);
+
+    pp->urb_state = URB_IDLE;
+    pp->xfer_count = 0U;
 
-    if(1U == udev->host.pipe[pp_num].do_ping) {
+#ifdef USBH_SCHED_ENABLED
+    return (uint32_t)usbh_sched_submit(udev, pp_num);
+#else
+    if(1U == pp->do_ping) {
         (void)usb_pipe_ping(udev, (uint8_t)pp_num);
         return USB_OK;
     }
 
     return (uint32_t)usb_pipe_xfer(udev, pp_num);
+#endif /* USBH_SCHED_ENABLED */
 }
 
@@ -66,6 +66,8 @@ OF SUCH DAMAGE.
 #define SCSI_VERIFY12                               0xAFU        /*!< MSC SCSI verify12 */
 #define SCSI_VERIFY16                               0x8FU        /*!< MSC SCSI verify16 */
 
+#define SCSI_SYNCHRONIZE_CACHE10                    0x35U        /*!< MSC SCSI synchronize cache10 */
+
 #define SCSI_SEND_DIAGNOSTIC                        0x1DU        /*!< MSC SCSI send diagnostic */
 #define SCSI_READ_FORMAT_CAPACITIES                 0x23U        /*!< MSC SCSI read format capacities */
 
@@ -69,6 +69,7 @@ enum _usb_recp_type {
     USB_RECPTYPE_DEV  = 0x0U,                    /*!< USB device request type */
     USB_RECPTYPE_ITF  = 0x1U,                    /*!< USB interface request type */
     USB_RECPTYPE_EP   = 0x2U,                    /*!< USB endpoint request type */
+    USB_RECPTYPE_OTHER = 0x3U,                   /*!< USB other recipient request type */
     USB_RECPTYPE_MASK = 0x3U                     /*!< USB request type mask */
 };
 
@@ -54,6 +54,12 @@ OF SUCH DAMAGE.
 #endif
 
 #define MSC_MEDIA_PACKET_SIZE           8192U
+/* a second media buffer only overlaps media access and the bus when the core DMA moves the packets */
+#ifdef USB_INTERNAL_DMA_ENABLED
+    #define MSC_MEDIA_BUF_NUM           2U
+#else
+    #define MSC_MEDIA_BUF_NUM           1U
+#endif /* USB_INTERNAL_DMA_ENABLED */
 
 #define MEM_LUN_NUM                     1
 
@@ -33,11 +33,33 @@ OF SUCH DAMAGE.
 */
 
 #include "flash_msd.h"
+#include <string.h>
 
 /* pages 0 and 1 base and end addresses */
 #define FLASH_BASE_ADDR         0x8010000U
 #define PAGE_SIZE               0x1000U
 
+#define FLASH_CACHE_FREE        0xFFFFFFFFU
+
+/* write-back page cache */
+typedef struct {
+    uint32_t page;                                          /*!< cached page index, FLASH_CACHE_FREE when unused */
+    uint32_t stamp;                                         /*!< last access stamp for LRU eviction */
+    uint8_t dirty;                                          /*!< page differs from flash */
+} flash_cache_slot;
+
+static flash_cache_slot cache_slot[FLASH_CACHE_PAGE_NUM];
+static uint32_t cache_data[FLASH_CACHE_PAGE_NUM][PAGE_SIZE / 4U];
+static uint32_t cache_stamp = 0U;
+static volatile uint32_t cache_idle_ms = 0U;
+static volatile uint8_t cache_dirty = 0U;
+static volatile uint8_t cache_flush_pending = 0U;
+
+static int32_t flash_cache_find(uint32_t page);
+static void flash_cache_usb_mask(uint8_t mask);
+static uint32_t flash_page_commit(uint32_t slot);
+static uint32_t flash_cache_commit(void);
+
 /*!
     \brief      initialize the internal flash
     \param[in]  none
@@ -46,8 +68,20 @@ OF SUCH DAMAGE.
   */
 uint32_t flash_init()
 {
+    static uint8_t cache_ready = 0U;
+    uint32_t i;
+
     fmc_unlock();
 
+    if(0U == cache_ready) {
+        for(i = 0U; i < FLASH_CACHE_PAGE_NUM; i++) {
+            cache_slot[i].page = FLASH_CACHE_FREE;
+            cache_slot[i].dirty = 0U;
+        }
+
+        cache_ready = 1U;
+    }
+
     return 0U;
 }
 
@@ -62,14 +96,34 @@ uint32_t flash_init()
 */
 uint32_t flash_multi_blocks_read(uint8_t *buf, uint32_t read_addr, uint16_t block_size, uint32_t block_num)
 {
-    uint32_t i;
-    uint8_t *src = (uint8_t *)(read_addr + FLASH_BASE_ADDR);
+    uint32_t page = read_addr / PAGE_SIZE;
+    uint32_t run;
+    int32_t slot;
+
+    while(block_num > 0U) {
+        slot = flash_cache_find(page);
+
+        if(slot >= 0) {
+            /* serve pages not yet committed from the cache */
+            cache_slot[slot].stamp = ++cache_stamp;
+
+            memcpy(buf, cache_data[slot], PAGE_SIZE);
 
-    /* Data transfer */
-    while(block_num--) {
-        for(i = 0U; i < block_size; i++) {
-            *buf++ = *src++;
+            run = 1U;
+        } else {
+            /* copy the whole run of uncached pages straight from flash */
+            run = 1U;
+
+            while((run < block_num) && (flash_cache_find(page + run) < 0)) {
+                run++;
+            }
+
+            memcpy(buf, (const uint8_t *)(page * PAGE_SIZE + FLASH_BASE_ADDR), run * PAGE_SIZE);
         }
+
+        buf += run * PAGE_SIZE;
+        page += run;
+        block_num -= run;
     }
 
     return 0U;
@@ -86,22 +140,224 @@ uint32_t flash_multi_blocks_read(uint8_t *buf, uint32_t read_addr, uint16_t bloc
 */
 uint32_t flash_multi_blocks_write(uint8_t *buf, uint32_t write_addr, uint16_t block_size, uint32_t block_num)
 {
-    uint32_t i, page;
-    uint32_t start_page = (write_addr / PAGE_SIZE) * PAGE_SIZE + FLASH_BASE_ADDR;
-    uint32_t *ptrs = (uint32_t *)buf;
+    uint32_t i, victim;
+    uint32_t page = write_addr / PAGE_SIZE;
+    int32_t slot;
+
+    for(; block_num > 0U; block_num--) {
+        slot = flash_cache_find(page);
+
+        if(slot < 0) {
+            /* take a free slot, or evict the least recently used page */
+            victim = 0U;
+
+            for(i = 0U; i < FLASH_CACHE_PAGE_NUM; i++) {
+                if(FLASH_CACHE_FREE == cache_slot[i].page) {
+                    victim = i;
+                    break;
+                }
+
+                if((cache_stamp - cache_slot[i].stamp) > (cache_stamp - cache_slot[victim].stamp)) {
+                    victim = i;
+                }
+            }
+
+            if(0U != flash_page_commit(victim)) {
+                return 1U;
+            }
+
+            slot = (int32_t)victim;
+            cache_slot[slot].page = page;
+        }
+
+        /* a block is a whole page, so no read is needed before the update */
+        memcpy(cache_data[slot], buf, PAGE_SIZE);
+
+        cache_slot[slot].stamp = ++cache_stamp;
+        cache_slot[slot].dirty = 1U;
+
+        buf += PAGE_SIZE;
+        page++;
+    }
+
+    cache_dirty = 1U;
+    cache_idle_ms = 0U;
+
+    return 0U;
+}
+
+/*!
+    \brief      request a write back of all dirty cached pages
+    \param[in]  none
+    \param[out] none
+    \retval     1 when the commit is pending, 0 when nothing is cached
+*/
+uint32_t flash_cache_flush(void)
+{
+    if(0U == cache_dirty) {
+        return 0U;
+    }
+
+    /* called from the USB interrupt, the commit itself runs in flash_cache_idle() */
+    cache_flush_pending = 1U;
+
+    return 1U;
+}
+
+/*!
+    \brief      flush the cache once no write has arrived for FLASH_CACHE_IDLE_MS,
+                or when a flush has been requested, called from the main loop
+    \param[in]  elapsed_ms: time passed since the previous call
+    \param[out] none
+    \retval     none
+*/
+void flash_cache_idle(uint32_t elapsed_ms)
+{
+    uint32_t status = 0U;
+    uint8_t flush;
+
+    /* keep the USB interrupt out of the cache while the pages are programmed */
+    flash_cache_usb_mask(1U);
+
+    flush = cache_flush_pending;
+    cache_flush_pending = 0U;
+
+    if(0U != cache_dirty) {
+        cache_idle_ms += elapsed_ms;
+
+        if((0U != flush) || (cache_idle_ms >= FLASH_CACHE_IDLE_MS)) {
+            status = flash_cache_commit();
+        }
+    }
+
+    /* the host gets the status of its flush only now that the pages are programmed */
+    if(0U != flush) {
+        flash_cache_flushed(status);
+    }
+
+    flash_cache_usb_mask(0U);
+}
+
+/*!
+    \brief      look up a page in the cache
+    \param[in]  page: page index
+    \param[out] none
+    \retval     slot index, or -1 when the page is not cached
+*/
+static int32_t flash_cache_find(uint32_t page)
+{
+    uint32_t i;
 
-    page = block_num;
+    for(i = 0U; i < FLASH_CACHE_PAGE_NUM; i++) {
+        if(page == cache_slot[i].page) {
+            return (int32_t)i;
+        }
+    }
 
-    for(; page > 0U; page--) {
-        fmc_sector_erase(start_page);
+    return -1;
+}
 
-        i = 0U;
+/*!
+    \brief      commit the dirty pages in ascending address order
+    \param[in]  none
+    \param[out] none
+    \retval     status
+*/
+static uint32_t flash_cache_commit(void)
+{
+    uint32_t i, next;
+
+    do {
+        next = FLASH_CACHE_PAGE_NUM;
 
-        do {
-            fmc_word_program(start_page, *ptrs++);
-            start_page += 4U;
-        } while(++i < 1024U);
+        for(i = 0U; i < FLASH_CACHE_PAGE_NUM; i++) {
+            if((0U != cache_slot[i].dirty) && \
+                ((FLASH_CACHE_PAGE_NUM == next) || (cache_slot[i].page < cache_slot[next].page))) {
+                next = i;
+            }
+        }
+
+        if(FLASH_CACHE_PAGE_NUM != next) {
+            if(0U != flash_page_commit(next)) {
+                return 1U;
+            }
+        }
+    } while(FLASH_CACHE_PAGE_NUM != next);
+
+    cache_dirty = 0U;
+
+    return 0U;
+}
+
+/*!
+    \brief      write one cached page back to flash, erasing only when needed
+    \param[in]  slot: cache slot index
+    \param[out] none
+    \retval     status
+*/
+static uint32_t flash_page_commit(uint32_t slot)
+{
+    uint32_t i;
+    uint32_t addr = cache_slot[slot].page * PAGE_SIZE + FLASH_BASE_ADDR;
+    uint32_t *src = cache_data[slot];
+    const uint32_t *dst = (const uint32_t *)addr;
+
+    if(0U == cache_slot[slot].dirty) {
+        return 0U;
+    }
+
+    /* the page already holds this data, typical for rewritten FAT sectors */
+    if(0 != memcmp(dst, src, PAGE_SIZE)) {
+        /* erase only when the page is not blank already */
+        for(i = 0U; i < (PAGE_SIZE / 4U); i++) {
+            if(0xFFFFFFFFU != dst[i]) {
+                if(FMC_READY != fmc_sector_erase(addr)) {
+                    return 1U;
+                }
+
+                break;
+            }
+        }
+
+        for(i = 0U; i < (PAGE_SIZE / 4U); i++) {
+            if(FMC_READY != fmc_word_program(addr + (i << 2), src[i])) {
+                return 1U;
+            }
+        }
+
+        /* drop stale lines so the read path sees the new content */
+        SCB_InvalidateDCache_by_Addr((uint32_t *)addr, (int32_t)PAGE_SIZE);
     }
 
+    cache_slot[slot].dirty = 0U;
+
     return 0U;
 }
+
+/*!
+    \brief      mask or unmask the USB interrupts that access the cache
+    \param[in]  mask: 1 to mask, 0 to unmask
+    \param[out] none
+    \retval     none
+*/
+static void flash_cache_usb_mask(uint8_t mask)
+{
+#ifdef USE_USBHS0
+    if(0U != mask) {
+        NVIC_DisableIRQ(USBHS0_IRQn);
+    } else {
+        NVIC_EnableIRQ(USBHS0_IRQn);
+    }
+#endif /* USE_USBHS0 */
+
+#ifdef USE_USBHS1
+    if(0U != mask) {
+        NVIC_DisableIRQ(USBHS1_IRQn);
+    } else {
+        NVIC_EnableIRQ(USBHS1_IRQn);
+    }
+#endif /* USE_USBHS1 */
+
+    __DSB();
+    __ISB();
+}
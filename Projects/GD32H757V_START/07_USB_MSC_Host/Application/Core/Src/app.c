@@ -50,13 +50,8 @@ void cache_enable(void)
     /* enable i-cache */
     SCB_EnableICache();
 
-    /* enable d-cache */
-    /** note:
-      * if the USB DMA is enabled, the d-cache should be disabled!
-      */
-#ifndef USB_INTERNAL_DMA_ENABLED
+    /* enable d-cache, the USB driver keeps the DMA buffers coherent */
     SCB_EnableDCache();
-#endif /* USB_INTERNAL_DMA_ENABLED */
 }
 
 /*!
@@ -41,6 +41,9 @@ OF SUCH DAMAGE.
 #define ISFLASH_BLOCK_SIZE         4096U
 #define ISFLASH_BLOCK_NUM          64U
 
+#define FLASH_CACHE_PAGE_NUM       4U                   /* pages held by the write-back cache */
+#define FLASH_CACHE_IDLE_MS        500U                 /* flush after this long without writes */
+
 /* function declarations */
 /* initialize the flash */
 uint32_t flash_init(void);
@@ -48,5 +51,11 @@ uint32_t flash_init(void);
 uint32_t flash_multi_blocks_read(uint8_t* pBuf, uint32_t read_addr, uint16_t block_size, uint32_t block_num);
 /* write data to multiple blocks of flash */
 uint32_t flash_multi_blocks_write(uint8_t* pBuf, uint32_t write_addr, uint16_t block_size, uint32_t block_num);
+/* request a write back of all dirty cached pages, 1 when the commit is pending */
+uint32_t flash_cache_flush(void);
+/* flush the cache once requested or once the writes have gone idle, from the main loop */
+void flash_cache_idle(uint32_t elapsed_ms);
+/* report the commit of a requested flush, called with the USB interrupt masked */
+void flash_cache_flushed(uint32_t status);
 
 #endif /* FLASH_MSD_H */
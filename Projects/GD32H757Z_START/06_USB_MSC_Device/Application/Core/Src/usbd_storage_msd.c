@@ -34,6 +34,9 @@ OF SUCH DAMAGE.
 
 #include "flash_msd.h"
 #include "usbd_msc_mem.h"
+#include "usbd_msc_scsi.h"
+
+extern usb_core_driver msc_udisk;
 
 /* USB mass storage standard inquiry data */
 
@@ -59,6 +62,7 @@ static int8_t storage_wrp(uint8_t lun);
 static int8_t storage_maxlun_get(void);
 static int8_t storage_read(uint8_t lun, uint8_t *buf, uint32_t blk_addr, uint16_t blk_len);
 static int8_t storage_write(uint8_t lun, uint8_t *buf, uint32_t blk_addr, uint16_t blk_len);
+static int8_t storage_flush(uint8_t lun);
 
 usbd_mem_cb usbd_internal_storage_fops = {
     .mem_init      = storage_init,
@@ -67,6 +71,7 @@ usbd_mem_cb usbd_internal_storage_fops = {
     .mem_read      = storage_read,
     .mem_write     = storage_write,
     .mem_maxlun    = storage_maxlun_get,
+    .mem_flush     = storage_flush,
 
     .mem_inquiry_data = {(uint8_t *)storage_inquirydata},
     .mem_block_size   = {ISFLASH_BLOCK_SIZE},
@@ -146,6 +151,32 @@ static int8_t storage_write(uint8_t lun, uint8_t *buf, uint32_t blk_addr, uint16
     return (0);
 }
 
+/*!
+    \brief      schedule the cached writes for commit to the medium
+    \param[in]  lun: logical unit number
+    \param[out] none
+    \retval     1 when the commit completes later through flash_cache_flushed(), 0 otherwise
+*/
+static int8_t storage_flush(uint8_t lun)
+{
+    if(0U != flash_cache_flush()) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/*!
+    \brief      complete the pending flush command once the cache is committed
+    \param[in]  status: commit status, 0 on success
+    \param[out] none
+    \retval     none
+*/
+void flash_cache_flushed(uint32_t status)
+{
+    scsi_flush_complete(&msc_udisk, (0U == status) ? 0 : -1);
+}
+
 /*!
     \brief      get number of supported logical unit
     \param[in]  none
@@ -0,0 +1,54 @@
+/*!
+    \file    lwiperf_app.h
+    \brief   the header file of lwiperf_app
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef LWIPERF_APP_H
+#define LWIPERF_APP_H
+
+#include <stdint.h>
+
+/* iperf 2 peer for the TCP client and the UDP blaster: IP_S_ADDR0.IP_S_ADDR1.IP_S_ADDR2.IP_S_ADDR3 */
+#define LWIPERF_APP_UDP_PORT        5001U           /* port of the "iperf -s -u" on the peer */
+#define LWIPERF_APP_UDP_LEN         1470U           /* UDP payload per datagram */
+#define LWIPERF_APP_UDP_MBPS        0U              /* UDP rate in Mbit/s, 0 to send as fast as buffers allow */
+#define LWIPERF_APP_UDP_SECONDS     10U             /* duration of the UDP run */
+#define LWIPERF_APP_UDP_BURST       16U             /* datagrams sent per timer call at most */
+#define LWIPERF_APP_TICK_MS         1U              /* timer period when the lwIP timeouts drive the timer */
+
+/* function declarations */
+/* start the iperf TCP server, the TCP client and the UDP blaster */
+void lwiperf_app_init(void);
+/* send the UDP datagrams due and report the UDP run once a second */
+void lwiperf_app_timer(uint32_t localtime);
+
+#endif /* LWIPERF_APP_H */
@@ -46,21 +46,41 @@ OF SUCH DAMAGE.
 #define NO_SYS                  0                        /* NO_SYS==1: provides VERY minimal functionality. 
                                                             Otherwise, use lwIP facilities */
 
+/* high-throughput profile */
+#ifndef LWIP_HIGH_THROUGHPUT
+#define LWIP_HIGH_THROUGHPUT    0                        /* LWIP_HIGH_THROUGHPUT==1: large scaled TCP windows, with the lwIP heap
+                                                            and pools in the EXMC SDRAM, set by ENET_HIGH_THROUGHPUT in cmake */
+#endif
+
+#if LWIP_HIGH_THROUGHPUT
+/* every lwIP heap and pool goes to the .sdram section, main() initializes the SDRAM before lwIP.
+   A file reaching lwip/arch.h before this file has the default already, replace it */
+#undef LWIP_DECLARE_MEMORY_ALIGNED
+#define LWIP_DECLARE_MEMORY_ALIGNED(variable_name, size) \
+        u8_t variable_name[LWIP_MEM_ALIGN_BUFFER(size)] __attribute__((section(".sdram"), aligned(32)))
+#endif /* LWIP_HIGH_THROUGHPUT */
+
 /*  memory options  */
 #define MEM_ALIGNMENT           4                        /* should be set to the alignment of the CPU for which lwIP
                                                             is compiled. 4 byte alignment -> define MEM_ALIGNMENT 
                                                             to 4, 2 byte alignment -> define MEM_ALIGNMENT to 2 */
 
+#if LWIP_HIGH_THROUGHPUT
+#define MEM_SIZE                (256*1024)               /* the heap holds the copied Tx data, TCP_SND_BUF for each
+                                                            of a few fast connections */
+#else
 #define MEM_SIZE                (15*1024)                /* the size of the heap memory, if the application will 
                                                             send a lot of data that needs to be copied, this should
                                                             be set high */
+#endif /* LWIP_HIGH_THROUGHPUT */
 
-/* Relocate the LwIP RAM heap pointer */
-#define LWIP_RAM_HEAP_POINTER    (0x30004000)
-
+#if LWIP_HIGH_THROUGHPUT
+#define MEMP_NUM_PBUF           TCP_SND_QUEUELEN         /* a whole send queue of data sent without copy */
+#else
 #define MEMP_NUM_PBUF           100                       /* the number of memp struct pbufs. If the application
                                                             sends a lot of data out of ROM (or other static memory),
                                                             this should be set high */
+#endif /* LWIP_HIGH_THROUGHPUT */
 
 #define MEMP_NUM_UDP_PCB        6                        /* the number of UDP protocol control blocks, one
                                                             per active UDP "connection" */
@@ -69,33 +89,83 @@ OF SUCH DAMAGE.
 
 #define MEMP_NUM_TCP_PCB_LISTEN 5                        /* the number of listening TCP connections */
 
+#if LWIP_HIGH_THROUGHPUT
+#define MEMP_NUM_TCP_SEG        (TCP_SND_QUEUELEN + TCP_OOSEQ_MAX_PBUFS)  /* the send queue and the out of order queue */
+#else
 #define MEMP_NUM_TCP_SEG        20                       /* the number of simultaneously queued TCP segments */
+#endif /* LWIP_HIGH_THROUGHPUT */
 
 #define MEMP_NUM_SYS_TIMEOUT    10                       /* the number of simulateously active timeouts */
 
 #define MEMP_NUM_NETBUF         8                        /* the number of struct netbufs */
 
 /* Pbuf options */
+#if LWIP_HIGH_THROUGHPUT
+#define PBUF_POOL_SIZE          96                       /* the number of buffers in the pbuf pool, more than TCP_WND */
+#define PBUF_POOL_BUFSIZE       1514                     /* one pbuf holds a full-sized frame */
+#else
 #define PBUF_POOL_SIZE          40                       /* the number of buffers in the pbuf pool */
 #define PBUF_POOL_BUFSIZE       1514                     /* the size of each pbuf in the pbuf pool */
+#endif /* LWIP_HIGH_THROUGHPUT */
 #define IP_REASS_MAX_PBUFS      20                       /* total maximum amount of pbufs waiting to be reassembled */
+#define LWIP_SUPPORT_CUSTOM_PBUF 1                       /* allow pbufs referencing memory owned by the ethernet driver */
+
+/* ethernetif options */
+#define ETHERNETIF_RX_ZERO_COPY      ENET_RX_ZERO_COPY   /* pass the ENET Rx DMA buffers to the stack as custom pbufs
+                                                            instead of copying every frame into the pbuf pool, set by
+                                                            the ENET_RX_ZERO_COPY CMake option so the driver agrees */
+#if LWIP_HIGH_THROUGHPUT
+#define ETHERNETIF_RX_SPARE_BUF_NUM  (TCP_WND / TCP_MSS)  /* the received frames stay in the Rx buffers, one spare per
+                                                            segment of the window keeps the descriptors armed */
+#else
+#define ETHERNETIF_RX_SPARE_BUF_NUM  8                   /* the number of spare Rx buffers used to re-arm descriptors
+                                                            while the stack still holds received frames */
+#endif /* LWIP_HIGH_THROUGHPUT */
+#define ETHERNETIF_TX_SCATTER_GATHER 1                   /* chain the pbufs of a Tx frame across ENET descriptors
+                                                            instead of copying them into the Tx buffer */
+#define ETHERNETIF_TX_PRIORITY_QUEUE 1                   /* queue the Tx frames by priority, ARP and DSCP CS4 or above first */
+#define ETHERNETIF_TX_QUEUE_DEPTH    16                  /* the number of frames each Tx priority queue holds */
+#define ETHERNETIF_RX_BUDGET         16                  /* the maximum number of frames passed to the stack per poll round */
+#define ETHERNETIF_RX_BUDGET_BACKOFF 1                   /* the ticks the input task sleeps when a round used the whole budget */
+#define ETHERNETIF_RX_COALESCE_DELAY 0                   /* the Rx interrupt watchdog count (256 ENET clock cycles each),
+                                                            0: raise the Rx interrupt for every frame */
 
 /* TCP options */
 #define LWIP_TCP                1
 #define TCP_TTL                 255
 
+#if LWIP_HIGH_THROUGHPUT
+#define TCP_QUEUE_OOSEQ         1                        /* keep the segments received after a loss, lwIP has no SACK
+                                                            so the sender only resends the missing ones */
+#define TCP_OOSEQ_MAX_PBUFS     (TCP_WND / TCP_MSS / 2)  /* leave half the window to in order data */
+#else
 #define TCP_QUEUE_OOSEQ         0                        /* controls if TCP should queue segments that arrive out of
                                                             order, Define to 0 if your device is low on memory. */
+#endif /* LWIP_HIGH_THROUGHPUT */
 
 #define TCP_MSS                 (1500 - 40)              /* TCP Maximum segment size, 
                                                             TCP_MSS = (Ethernet MTU - IP header size - TCP header size) */
 
+#if LWIP_HIGH_THROUGHPUT
+#define LWIP_WND_SCALE          1                        /* TCP window scaling, the windows exceed 64 KB */
+#define TCP_RCV_SCALE           1                        /* the receive window is announced in units of 2 bytes */
+
+#define TCP_SND_BUF             (64*TCP_MSS)             /* TCP sender buffer space (bytes) */
+
+#define TCP_SND_QUEUELEN        ((4* TCP_SND_BUF)/TCP_MSS)   /* TCP sender buffer space (pbufs) */
+
+#define TCP_WND                 (64*TCP_MSS)             /* TCP receive window */
+
+#define TCP_TMR_INTERVAL        100                      /* a finer TCP timer shortens the delayed ACKs and lets the
+                                                            retransmission timeout recover losses fast recovery misses */
+#else
 #define TCP_SND_BUF             (2*TCP_MSS)              /* TCP sender buffer space (bytes) */
 
 #define TCP_SND_QUEUELEN        ((4* TCP_SND_BUF)/TCP_MSS)   /* TCP sender buffer space (pbufs), this must be at least
                                                             as much as (2 * TCP_SND_BUF/TCP_MSS) for things to work */
 
 #define TCP_WND                 (2*TCP_MSS)              /* TCP receive window */
+#endif /* LWIP_HIGH_THROUGHPUT */
 
 
 /* ICMP options */
@@ -113,7 +183,18 @@ OF SUCH DAMAGE.
 
 
 /* statistics options */
-#define LWIP_STATS              0
+#define LWIP_STATS              1                        /* heap and pool usage, reported by net_stats.c */
+#define LINK_STATS              0                        /* no per-packet protocol counters, the driver counts its drops */
+#define ETHARP_STATS            0
+#define IP_STATS                0
+#define IPFRAG_STATS            0
+#define ICMP_STATS              0
+#define UDP_STATS               0
+#define TCP_STATS               0
+#if LWIP_IPERF
+/* the iperf reports print the TCP fast retransmits */
+#define MIB2_STATS              1
+#endif /* LWIP_IPERF */
 #define LWIP_PROVIDE_ERRNO      1
 
 /* checksum options */
@@ -179,10 +260,14 @@ OF SUCH DAMAGE.
 
 #define TCPIP_THREAD_NAME              "TCP/IP"
 #define TCPIP_THREAD_STACKSIZE          1000
-#define TCPIP_MBOX_SIZE                 5
+#define TCPIP_MBOX_SIZE                 32       /* room for a burst of received frames, a slot costs 8 bytes */
 #define DEFAULT_THREAD_STACKSIZE        500
 #define TCPIP_THREAD_PRIO               (configMAX_PRIORITIES - 2)
-#define LWIP_COMPAT_MUTEX               1
+#define LWIP_COMPAT_MUTEX               0        /* the core lock is a FreeRTOS mutex with priority inheritance */
+#define LWIP_TCPIP_CORE_LOCKING         1        /* netconn and socket calls take the core lock instead of
+                                                    posting to the tcpip thread and waiting for it */
+#define LWIP_FREERTOS_MBOX_RING         1        /* the mboxes are lock-free rings woken by task notifications,
+                                                    see sys_arch.c */
 #define DEFAULT_TCP_RECVMBOX_SIZE       8
 #define DEFAULT_UDP_RECVMBOX_SIZE       8
 #define DEFAULT_ACCEPTMBOX_SIZE         8
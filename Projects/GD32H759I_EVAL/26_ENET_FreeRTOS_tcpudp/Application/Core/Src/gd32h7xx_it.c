@@ -38,8 +38,9 @@ OF SUCH DAMAGE.
 #include "semphr.h"
 #include "queue.h"
 #include "lwip/sys.h"
+#include "ethernetif.h"
 
-extern xSemaphoreHandle g_rx_semaphore;
+extern xSemaphoreHandle g_tx_semaphore;
 
 /*!
     \brief      this function handles NMI exception
@@ -151,12 +152,22 @@ void ENET0_IRQHandler(void)
 
     /* frame received */
     if(SET == enet_interrupt_flag_get(ENET0, ENET_DMA_INT_FLAG_RS)){ 
-        /* give the semaphore to wakeup LwIP task */
-        xSemaphoreGiveFromISR(g_rx_semaphore, &xHigherPriorityTaskWoken);
+        /* mask the Rx interrupt and wakeup LwIP task */
+        ethernetif_rx_isr(&xHigherPriorityTaskWoken);
     }
 
     /* clear the enet DMA Rx interrupt pending bits */
     enet_interrupt_flag_clear(ENET0, ENET_DMA_INT_FLAG_RS_CLR);
+
+    /* frame transmitted */
+    if(SET == enet_interrupt_flag_get(ENET0, ENET_DMA_INT_FLAG_TS)){
+        /* give the semaphore to wakeup the task waiting for Tx descriptors */
+        if(NULL != g_tx_semaphore){
+            xSemaphoreGiveFromISR(g_tx_semaphore, &xHigherPriorityTaskWoken);
+        }
+        enet_interrupt_flag_clear(ENET0, ENET_DMA_INT_FLAG_TS_CLR);
+    }
+
     enet_interrupt_flag_clear(ENET0, ENET_DMA_INT_FLAG_NI_CLR);
 
     /* switch tasks if necessary */
@@ -178,12 +189,22 @@ void ENET1_IRQHandler(void)
 
     /* frame received */
     if(SET == enet_interrupt_flag_get(ENET1, ENET_DMA_INT_FLAG_RS)){ 
-        /* give the semaphore to wakeup LwIP task */
-        xSemaphoreGiveFromISR(g_rx_semaphore, &xHigherPriorityTaskWoken);
+        /* mask the Rx interrupt and wakeup LwIP task */
+        ethernetif_rx_isr(&xHigherPriorityTaskWoken);
     }
 
     /* clear the enet DMA Rx interrupt pending bits */
     enet_interrupt_flag_clear(ENET1, ENET_DMA_INT_FLAG_RS_CLR);
+
+    /* frame transmitted */
+    if(SET == enet_interrupt_flag_get(ENET1, ENET_DMA_INT_FLAG_TS)){
+        /* give the semaphore to wakeup the task waiting for Tx descriptors */
+        if(NULL != g_tx_semaphore){
+            xSemaphoreGiveFromISR(g_tx_semaphore, &xHigherPriorityTaskWoken);
+        }
+        enet_interrupt_flag_clear(ENET1, ENET_DMA_INT_FLAG_TS_CLR);
+    }
+
     enet_interrupt_flag_clear(ENET1, ENET_DMA_INT_FLAG_NI_CLR);
 
     /* switch tasks if necessary */
@@ -36,6 +36,7 @@ OF SUCH DAMAGE.
 #include "lwip/sys.h"
 #include "FreeRTOS.h"
 #include "hello_gigadevice.h"
+#include "net_stats.h"
 #include <string.h>
 #include <stdio.h>
 #include "gd32h7xx.h"
@@ -50,6 +51,25 @@ OF SUCH DAMAGE.
                             \n\r== Telnet SUCCESS==\
                             \n\rHello. What is your name?\r\n"
 #define HELLO              "\n\rGigaDevice PORT Hello "
+#define STATS_COMMAND      "stats"
+
+/* the statistics report, formatted on the "stats" command */
+static char stats_report[NET_STATS_REPORT_SIZE];
+
+/*!
+    \brief      check whether a received line is the "stats" command
+    \param[in]  line: the received line
+    \param[in]  length: length of the line
+    \param[out] none
+    \retval     1 for the "stats" command, 0 otherwise
+*/
+static int hello_gigadevice_stats_command(const char *line, int length)
+{
+    int len = strlen(STATS_COMMAND);
+
+    return (length > len) && (0 == strncmp(line, STATS_COMMAND, len)) &&
+           ((line[len] == '\r') || (line[len] == '\n'));
+}
 
 
 
@@ -79,7 +99,10 @@ static err_t hello_gigadevice_recv(struct netconn *conn, void *data, u16_t len)
         done = ((c[i] == '\r') || (c[i] == '\n'));
     }
 
-    if(done) {
+    if(done && hello_gigadevice_stats_command(c, len)) {
+        /* print the lwIP pool and driver statistics instead of the greeting */
+        netconn_write(conn, stats_report, net_stats_report(stats_report, sizeof(stats_report)), NETCONN_COPY);
+    } else if(done) {
         if(c[len - 2] != '\r' || c[len - 1] != '\n') {
             /* limit the received data length to MAX_NAME_SIZE - 2('\r' and '\n' will be put into the buffer) */
             if((c[len - 1] == '\r' || c[len - 1] == '\n') && (len + 1 <= MAX_NAME_SIZE)) {
@@ -246,7 +269,13 @@ static err_t hello_gigadevice_recv(int fd, void *data, int len)
         }
     }
 
-    if(1 == done) {
+    if((1 == done) && hello_gigadevice_stats_command(name_recv.bytes, name_recv.length)) {
+        /* print the lwIP pool and driver statistics instead of the greeting */
+        send(fd, stats_report, net_stats_report(stats_report, sizeof(stats_report)), 0);
+
+        name_recv.done = 0;
+        name_recv.length = 0;
+    } else if(1 == done) {
         if(c[len - 2] != '\r' || c[len - 1] != '\n') {
             /* limit the received data length to MAX_NAME_SIZE - 2('\r' and '\n' will be put into the buffer) */
             if((c[len - 1] == '\r' || c[len - 1] == '\n') && (len + 1 <= MAX_NAME_SIZE)) {
@@ -0,0 +1,359 @@
+/*!
+    \file    lwiperf_app.c
+    \brief   iperf 2 throughput measurement: lwiperf TCP server and client, UDP blaster
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "lwiperf_app.h"
+#include "main.h"
+#include "lwip/apps/lwiperf.h"
+#include "lwip/udp.h"
+#include "lwip/stats.h"
+#include "lwip/memp.h"
+#include "lwip/timeouts.h"
+#include "lwip/sys.h"
+#if !NO_SYS
+#include "lwip/tcpip.h"
+#endif /* !NO_SYS */
+#include <stdio.h>
+
+#if LWIP_IPERF
+
+#if !LWIP_STATS || !MIB2_STATS || !MEMP_STATS
+#error "the iperf reports need LWIP_STATS with MIB2_STATS and MEMP_STATS"
+#endif
+
+/* size of the iperf 2 UDP header: datagram id and send time */
+#define LWIPERF_APP_UDP_HDR_LEN     12U
+/* iperf 2 ends a UDP run with a few datagrams of negative id */
+#define LWIPERF_APP_UDP_FIN_NUM     10U
+
+/* state of the UDP blaster */
+typedef struct {
+    struct udp_pcb *pcb;
+    ip_addr_t remote;
+    uint32_t start;                             /* time of the run start */
+    uint32_t last_report;                       /* time of the last report */
+    uint32_t last_tick;                         /* time of the last timer call */
+    uint32_t bytes;                             /* bytes sent since the last report */
+    uint32_t datagrams;                         /* datagrams sent since the last report */
+    uint32_t nobuf;                             /* datagrams refused for lack of buffers since the last report */
+    uint32_t credit;                            /* bytes the rate limit allows to send */
+    int32_t id;                                 /* id of the next datagram */
+    uint8_t running;
+} lwiperf_udp_struct;
+
+static lwiperf_udp_struct lwiperf_udp;
+static uint8_t lwiperf_started = 0U;
+static u32_t lwiperf_rexmit = 0U;
+/* payload of the UDP datagrams behind the header, referenced instead of copied */
+static const uint8_t lwiperf_udp_fill[LWIPERF_APP_UDP_LEN - LWIPERF_APP_UDP_HDR_LEN] = {0U};
+
+static const char *const lwiperf_report_names[] = {
+    "server done", "client done", "aborted locally", "aborted on data error",
+    "aborted on Tx error", "aborted by remote"
+};
+
+static void lwiperf_app_udp_start(void);
+#if !NO_SYS
+static void lwiperf_app_tick(void *arg);
+#endif /* !NO_SYS */
+
+/*!
+    \brief      print the TCP fast retransmits and the pbuf pool low-water mark since the last call
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void lwiperf_app_stats_print(void)
+{
+    struct stats_mem *pool = lwip_stats.memp[MEMP_PBUF_POOL];
+    u32_t rexmit = lwip_stats.mib2.tcpretranssegs;
+
+    printf("        %u fast retransmits, pbuf pool low-water %u of %u free\r\n",
+           (unsigned int)(rexmit - lwiperf_rexmit),
+           (unsigned int)(pool->avail - pool->max), (unsigned int)pool->avail);
+    lwiperf_rexmit = rexmit;
+    /* start a new low-water mark */
+    pool->max = pool->used;
+}
+
+/*!
+    \brief      print the rate of a transfer
+    \param[in]  kbitpsec: rate in kbit/s
+    \param[out] none
+    \retval     none
+*/
+static void lwiperf_app_rate_print(uint32_t kbitpsec)
+{
+    printf("%u.%02u Mbit/s", (unsigned int)(kbitpsec / 1000U), (unsigned int)((kbitpsec % 1000U) / 10U));
+}
+
+/*!
+    \brief      report of a finished iperf TCP session
+    \param[in]  arg: 1 for the client session, NULL for the server
+    \param[in]  report_type: how the session ended
+    \param[in]  local_addr, local_port: local end of the session
+    \param[in]  remote_addr, remote_port: remote end of the session
+    \param[in]  bytes_transferred: bytes sent or received
+    \param[in]  ms_duration: duration of the session
+    \param[in]  bandwidth_kbitpsec: rate of the session
+    \param[out] none
+    \retval     none
+*/
+static void lwiperf_app_report(void *arg, enum lwiperf_report_type report_type,
+                               const ip_addr_t *local_addr, u16_t local_port,
+                               const ip_addr_t *remote_addr, u16_t remote_port,
+                               u32_t bytes_transferred, u32_t ms_duration, u32_t bandwidth_kbitpsec)
+{
+    (void)local_addr;
+    (void)local_port;
+
+    printf("iperf TCP %s, %s:%u, %u bytes in %u ms, ", lwiperf_report_names[report_type],
+           ipaddr_ntoa(remote_addr), (unsigned int)remote_port,
+           (unsigned int)bytes_transferred, (unsigned int)ms_duration);
+    lwiperf_app_rate_print(bandwidth_kbitpsec);
+    printf("\r\n");
+    lwiperf_app_stats_print();
+
+    if(NULL != arg) {
+        /* the UDP run follows the TCP client so that they don't share the link */
+        lwiperf_app_udp_start();
+    }
+}
+
+/*!
+    \brief      send one iperf 2 UDP datagram
+    \param[in]  id: datagram id
+    \param[in]  localtime: current time in ms
+    \param[out] none
+    \retval     ERR_OK or the error of the allocation or of udp_sendto()
+*/
+static err_t lwiperf_app_udp_send(int32_t id, uint32_t localtime)
+{
+    struct pbuf *hdr, *fill;
+    u32_t *payload;
+    err_t err;
+
+    hdr = pbuf_alloc(PBUF_TRANSPORT, LWIPERF_APP_UDP_HDR_LEN, PBUF_RAM);
+    if(NULL == hdr) {
+        return ERR_MEM;
+    }
+    fill = pbuf_alloc(PBUF_RAW, sizeof(lwiperf_udp_fill), PBUF_ROM);
+    if(NULL == fill) {
+        pbuf_free(hdr);
+        return ERR_MEM;
+    }
+    fill->payload = (void *)lwiperf_udp_fill;
+    pbuf_cat(hdr, fill);
+
+    payload = (u32_t *)hdr->payload;
+    payload[0] = lwip_htonl((u32_t)id);
+    payload[1] = lwip_htonl(localtime / 1000U);
+    payload[2] = lwip_htonl((localtime % 1000U) * 1000U);
+    err = udp_sendto(lwiperf_udp.pcb, hdr, &lwiperf_udp.remote, LWIPERF_APP_UDP_PORT);
+    pbuf_free(hdr);
+    return err;
+}
+
+/*!
+    \brief      print the UDP rate since the last report
+    \param[in]  localtime: current time in ms
+    \param[out] none
+    \retval     none
+*/
+static void lwiperf_app_udp_report(uint32_t localtime)
+{
+    uint32_t ms = localtime - lwiperf_udp.last_report;
+
+    if(0U == ms) {
+        ms = 1U;
+    }
+    printf("iperf UDP %u s, %u datagrams, %u without buffer, ",
+           (unsigned int)((localtime - lwiperf_udp.start) / 1000U),
+           (unsigned int)lwiperf_udp.datagrams, (unsigned int)lwiperf_udp.nobuf);
+    lwiperf_app_rate_print((uint32_t)(((uint64_t)lwiperf_udp.bytes * 8U) / ms));
+    printf("\r\n");
+    lwiperf_app_stats_print();
+
+    lwiperf_udp.last_report = localtime;
+    lwiperf_udp.bytes = 0U;
+    lwiperf_udp.datagrams = 0U;
+    lwiperf_udp.nobuf = 0U;
+}
+
+/*!
+    \brief      start the UDP run to the peer
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void lwiperf_app_udp_start(void)
+{
+    uint32_t now = sys_now();
+
+    if(NULL == lwiperf_udp.pcb) {
+        lwiperf_udp.pcb = udp_new();
+        if(NULL == lwiperf_udp.pcb) {
+            return;
+        }
+    }
+    IP4_ADDR(ip_2_ip4(&lwiperf_udp.remote), IP_S_ADDR0, IP_S_ADDR1, IP_S_ADDR2, IP_S_ADDR3);
+    lwiperf_udp.start = now;
+    lwiperf_udp.last_report = now;
+    lwiperf_udp.last_tick = now;
+    lwiperf_udp.bytes = 0U;
+    lwiperf_udp.datagrams = 0U;
+    lwiperf_udp.nobuf = 0U;
+    lwiperf_udp.credit = 0U;
+    lwiperf_udp.id = 0;
+    lwiperf_udp.running = 1U;
+#if !NO_SYS
+    sys_timeout(LWIPERF_APP_TICK_MS, lwiperf_app_tick, NULL);
+#endif /* !NO_SYS */
+}
+
+/*!
+    \brief      send the UDP datagrams due and report the UDP run once a second
+    \param[in]  localtime: current time in ms
+    \param[out] none
+    \retval     none
+*/
+void lwiperf_app_timer(uint32_t localtime)
+{
+    uint32_t i;
+
+    if(0U == lwiperf_udp.running) {
+        return;
+    }
+
+    if((localtime - lwiperf_udp.start) >= (LWIPERF_APP_UDP_SECONDS * 1000U)) {
+        /* end of the run, the peer answers the FIN datagrams with its report */
+        for(i = 0U; i < LWIPERF_APP_UDP_FIN_NUM; i++) {
+            lwiperf_app_udp_send(-lwiperf_udp.id, localtime);
+        }
+        lwiperf_app_udp_report(localtime);
+        lwiperf_udp.running = 0U;
+        return;
+    }
+
+#if LWIPERF_APP_UDP_MBPS
+    /* the rate limit grants LWIPERF_APP_UDP_MBPS * 125 bytes per ms, for 20 ms at most */
+    lwiperf_udp.credit += (localtime - lwiperf_udp.last_tick) * (LWIPERF_APP_UDP_MBPS * 125U);
+    if(lwiperf_udp.credit > (LWIPERF_APP_UDP_MBPS * 125U * 20U)) {
+        lwiperf_udp.credit = LWIPERF_APP_UDP_MBPS * 125U * 20U;
+    }
+#endif /* LWIPERF_APP_UDP_MBPS */
+    lwiperf_udp.last_tick = localtime;
+
+    for(i = 0U; i < LWIPERF_APP_UDP_BURST; i++) {
+#if LWIPERF_APP_UDP_MBPS
+        if(lwiperf_udp.credit < LWIPERF_APP_UDP_LEN) {
+            break;
+        }
+        lwiperf_udp.credit -= LWIPERF_APP_UDP_LEN;
+#endif /* LWIPERF_APP_UDP_MBPS */
+        if(ERR_OK != lwiperf_app_udp_send(lwiperf_udp.id, localtime)) {
+            /* out of pbufs or Tx buffers, try again on the next call */
+            lwiperf_udp.nobuf++;
+            break;
+        }
+        lwiperf_udp.id++;
+        lwiperf_udp.datagrams++;
+        lwiperf_udp.bytes += LWIPERF_APP_UDP_LEN;
+    }
+
+    if((localtime - lwiperf_udp.last_report) >= 1000U) {
+        lwiperf_app_udp_report(localtime);
+    }
+}
+
+#if !NO_SYS
+/*!
+    \brief      run lwiperf_app_timer() from the lwIP timeouts while the UDP run lasts
+    \param[in]  arg: not used
+    \param[out] none
+    \retval     none
+*/
+static void lwiperf_app_tick(void *arg)
+{
+    (void)arg;
+    lwiperf_app_timer(sys_now());
+    if(0U != lwiperf_udp.running) {
+        sys_timeout(LWIPERF_APP_TICK_MS, lwiperf_app_tick, NULL);
+    }
+}
+#endif /* !NO_SYS */
+
+/*!
+    \brief      start the iperf sessions, in the lwIP thread
+    \param[in]  arg: not used
+    \param[out] none
+    \retval     none
+*/
+static void lwiperf_app_start(void *arg)
+{
+    ip_addr_t remote;
+
+    (void)arg;
+    lwiperf_rexmit = lwip_stats.mib2.tcpretranssegs;
+
+    /* "iperf -c <board>" on the peer measures the receive path */
+    lwiperf_start_tcp_server_default(lwiperf_app_report, NULL);
+
+    /* the TCP client against "iperf -s" on the peer measures the send path, the UDP run follows it */
+    IP4_ADDR(ip_2_ip4(&remote), IP_S_ADDR0, IP_S_ADDR1, IP_S_ADDR2, IP_S_ADDR3);
+    if(NULL == lwiperf_start_tcp_client_default(&remote, lwiperf_app_report, (void *)1)) {
+        lwiperf_app_udp_start();
+    }
+}
+
+/*!
+    \brief      start the iperf TCP server, the TCP client and the UDP blaster
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void lwiperf_app_init(void)
+{
+    if(0U != lwiperf_started) {
+        return;
+    }
+    lwiperf_started = 1U;
+
+#if NO_SYS
+    lwiperf_app_start(NULL);
+#else
+    tcpip_callback(lwiperf_app_start, NULL);
+#endif /* NO_SYS */
+}
+
+#endif /* LWIP_IPERF */
@@ -41,6 +41,13 @@ OF SUCH DAMAGE.
 #include "hello_gigadevice.h"
 #include "tcp_client.h"
 #include "udp_echo.h"
+#include "net_stats.h"
+#if LWIP_IPERF
+#include "lwiperf_app.h"
+#endif /* LWIP_IPERF */
+#if LWIP_HIGH_THROUGHPUT
+#include "exmc_sdram.h"
+#endif /* LWIP_HIGH_THROUGHPUT */
 
 #define INIT_TASK_PRIO   ( tskIDLE_PRIORITY + 1 )
 #define DHCP_TASK_PRIO   ( tskIDLE_PRIORITY + 4 )
@@ -51,6 +58,15 @@ extern struct netif g_mynetif;
 
 void cache_enable(void);
 void mpu_config(void);
+
+/* non-cacheable region holding the .dma_nocache section, defined by the linker script */
+extern uint8_t __dma_nocache_region_start[];
+extern uint8_t __dma_nocache_region_size[];
+#if LWIP_HIGH_THROUGHPUT
+/* SDRAM region holding the .sdram section, defined by the linker script */
+extern uint8_t __sdram_region_start[];
+extern uint8_t __sdram_region_size[];
+#endif /* LWIP_HIGH_THROUGHPUT */
 void led_task(void *pvParameters);
 void init_task(void *pvParameters);
 
@@ -96,6 +112,11 @@ void init_task(void *pvParameters)
     /* configure ethernet (GPIOs, clocks, MAC, DMA) */
     enet_system_setup();
 
+#if LWIP_HIGH_THROUGHPUT
+    /* the lwIP heap and pools are in the SDRAM */
+    exmc_synchronous_dynamic_ram_init(EXMC_SDRAM_DEVICE0);
+#endif /* LWIP_HIGH_THROUGHPUT */
+
     /* initilaize the LwIP stack */
     lwip_stack_init();
 
@@ -126,6 +147,12 @@ void lwip_netif_status_callback(struct netif *netif)
         tcp_client_init();
         /* initilaize the udp: echo 1025 */
         udp_echo_init();
+        /* initilaize the statistics query: udp 1026 */
+        net_stats_init();
+#if LWIP_IPERF
+        /* initilaize the iperf server 5001, the iperf client and the UDP run */
+        lwiperf_app_init();
+#endif /* LWIP_IPERF */
     }
 }
 
@@ -158,6 +185,25 @@ void cache_enable(void)
     /* Enable D-Cache */
     SCB_EnableDCache();
 }
+/*!
+    \brief      get the MPU region size encoding of a memory size
+    \param[in]  size: memory size in bytes, a power of two from 32 bytes
+    \param[out] none
+    \retval     MPU_REGION_SIZE_32B to MPU_REGION_SIZE_4GB
+*/
+static uint8_t mpu_region_size_get(uint32_t size)
+{
+    uint8_t region_size = MPU_REGION_SIZE_32B;
+    uint32_t region_bytes = 32U;
+
+    while((region_bytes < size) && (region_size < MPU_REGION_SIZE_4GB)) {
+        region_size++;
+        region_bytes <<= 1U;
+    }
+
+    return region_size;
+}
+
 /*!
     \brief      configure the MPU
     \param[in]  none
@@ -172,33 +218,36 @@ void mpu_config(void)
     /* disable the MPU */
     ARM_MPU_SetRegion(0U, 0U);
 
-    /* Configure the DMA descriptors and Rx/Tx buffer*/
-    mpu_init_struct.region_base_address = 0x30000000;
-    mpu_init_struct.region_size = MPU_REGION_SIZE_16KB;
+    /* Configure the DMA descriptors and Rx/Tx buffer as normal non-cacheable memory */
+    mpu_init_struct.region_base_address = (uint32_t)__dma_nocache_region_start;
+    mpu_init_struct.region_size = mpu_region_size_get((uint32_t)__dma_nocache_region_size);
     mpu_init_struct.access_permission = MPU_AP_FULL_ACCESS;
-    mpu_init_struct.access_bufferable = MPU_ACCESS_BUFFERABLE;
+    mpu_init_struct.access_bufferable = MPU_ACCESS_NON_BUFFERABLE;
     mpu_init_struct.access_cacheable = MPU_ACCESS_NON_CACHEABLE;
-    mpu_init_struct.access_shareable = MPU_ACCESS_NON_SHAREABLE;
+    mpu_init_struct.access_shareable = MPU_ACCESS_SHAREABLE;
     mpu_init_struct.region_number = MPU_REGION_NUMBER0;
     mpu_init_struct.subregion_disable = MPU_SUBREGION_ENABLE;
     mpu_init_struct.instruction_exec = MPU_INSTRUCTION_EXEC_PERMIT;
-    mpu_init_struct.tex_type = MPU_TEX_TYPE0;
+    mpu_init_struct.tex_type = MPU_TEX_TYPE1;
     mpu_region_config(&mpu_init_struct);
     mpu_region_enable();
 
-    /* Configure the LwIP RAM heap */
-    mpu_init_struct.region_base_address = 0x30004000;
-    mpu_init_struct.region_size = MPU_REGION_SIZE_16KB;
+#if LWIP_HIGH_THROUGHPUT
+    /* Configure the SDRAM holding the lwIP heap and pools as normal write-through memory,
+       the ENET DMA reads the Tx pbufs there after ethernetif cleaned their cache lines */
+    mpu_init_struct.region_base_address = (uint32_t)__sdram_region_start;
+    mpu_init_struct.region_size = mpu_region_size_get((uint32_t)__sdram_region_size);
     mpu_init_struct.access_permission = MPU_AP_FULL_ACCESS;
     mpu_init_struct.access_bufferable = MPU_ACCESS_NON_BUFFERABLE;
-    mpu_init_struct.access_cacheable = MPU_ACCESS_NON_CACHEABLE;
-    mpu_init_struct.access_shareable = MPU_ACCESS_SHAREABLE;
+    mpu_init_struct.access_cacheable = MPU_ACCESS_CACHEABLE;
+    mpu_init_struct.access_shareable = MPU_ACCESS_NON_SHAREABLE;
     mpu_init_struct.region_number = MPU_REGION_NUMBER1;
     mpu_init_struct.subregion_disable = MPU_SUBREGION_ENABLE;
-    mpu_init_struct.instruction_exec = MPU_INSTRUCTION_EXEC_PERMIT;
-    mpu_init_struct.tex_type = MPU_TEX_TYPE1;
+    mpu_init_struct.instruction_exec = MPU_INSTRUCTION_EXEC_NOT_PERMIT;
+    mpu_init_struct.tex_type = MPU_TEX_TYPE0;
     mpu_region_config(&mpu_init_struct);
     mpu_region_enable();
+#endif /* LWIP_HIGH_THROUGHPUT */
 
     /* enable the MPU */
     ARM_MPU_Enable(MPU_MODE_PRIV_DEFAULT);
@@ -47,6 +47,8 @@ OF SUCH DAMAGE.
 
 #define UDP_TASK_PRIO       ( tskIDLE_PRIORITY + 5)
 #define MAX_BUF_SIZE        50
+/* DSCP CS5 in the IPv4 TOS byte, the echoes skip the Tx queue of bulk TCP traffic */
+#define UDP_ECHO_TOS        0xA0
 
 
 #if ((LWIP_SOCKET == 0) && (LWIP_NETCONN == 1))
@@ -124,6 +126,7 @@ static void udp_task(void *arg)
     /* creat UDP connection */
     conn = netconn_new(NETCONN_UDP);
     netconn_bind(conn, IP_ADDR_ANY, 1025);
+    conn->pcb.udp->tos = UDP_ECHO_TOS;
 
     while(1) {
         recv_err = netconn_recv(conn, &buf);
@@ -162,6 +165,7 @@ static void udp_task(void *arg)
     struct sockaddr_in rmt_addr, bod_addr;
     char buf[100];
     u32_t len;
+    int tos;
     ip_addr_t ipaddr;
 
     IP4_ADDR(&ipaddr, IP_S_ADDR0, IP_S_ADDR1, IP_S_ADDR2, IP_S_ADDR3);
@@ -190,6 +194,9 @@ static void udp_task(void *arg)
             continue;
         }
 
+        tos = UDP_ECHO_TOS;
+        setsockopt(sockfd, IPPROTO_IP, IP_TOS, &tos, sizeof(tos));
+
         len = sizeof(rmt_addr);
         /* reveive packets from rmt_addr, and limit a reception to MAX_BUF_SIZE bytes */
         recvnum = recvfrom(sockfd, buf, MAX_BUF_SIZE, 0, (struct sockaddr *)&rmt_addr, &len);
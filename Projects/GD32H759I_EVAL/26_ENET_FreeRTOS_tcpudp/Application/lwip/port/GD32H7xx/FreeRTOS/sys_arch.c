@@ -86,6 +86,18 @@
 #define LWIP_FREERTOS_SYS_NOW_FROM_FREERTOS           1
 #endif
 
+/** Set this to 1 to implement sys_mbox_*() on a lock-free ring instead of
+ * FreeRTOS queues. Posting reserves a slot with a compare-and-swap and only
+ * calls the kernel to notify the fetching task when it sleeps on the ring.
+ * Each mbox may have any number of posting tasks and ISRs, but one fetching
+ * task at a time, which is how lwIP uses its mboxes. The fetching task is
+ * woken with its direct-to-task notification, which it must not use for
+ * anything else.
+ */
+#ifndef LWIP_FREERTOS_MBOX_RING
+#define LWIP_FREERTOS_MBOX_RING                       0
+#endif
+
 #if !configSUPPORT_DYNAMIC_ALLOCATION
 # error "lwIP FreeRTOS port requires configSUPPORT_DYNAMIC_ALLOCATION"
 #endif
@@ -95,6 +107,9 @@
 #if !INCLUDE_vTaskSuspend
 # error "lwIP FreeRTOS port requires INCLUDE_vTaskSuspend"
 #endif
+#if LWIP_FREERTOS_MBOX_RING && !configUSE_TASK_NOTIFICATIONS
+# error "LWIP_FREERTOS_MBOX_RING requires configUSE_TASK_NOTIFICATIONS"
+#endif
 #if LWIP_FREERTOS_SYS_ARCH_PROTECT_USES_MUTEX || !LWIP_COMPAT_MUTEX
 #if !configUSE_MUTEXES
 # error "lwIP FreeRTOS port requires configUSE_MUTEXES"
@@ -321,6 +336,8 @@ sys_sem_free(sys_sem_t *sem)
   sem->sem = NULL;
 }
 
+#if !LWIP_FREERTOS_MBOX_RING
+
 err_t
 sys_mbox_new(sys_mbox_t *mbox, int size)
 {
@@ -465,6 +482,273 @@ sys_mbox_free(sys_mbox_t *mbox)
   SYS_STATS_DEC(mbox.used);
 }
 
+#else /* !LWIP_FREERTOS_MBOX_RING */
+
+/** One slot of the mbox ring. seq tells whose turn the slot is: it equals the
+ * write index when the slot is free for that write, and the write index + 1
+ * once the message is stored and may be fetched. */
+typedef struct {
+  u32_t seq;
+  void *msg;
+} sys_mbox_slot_t;
+
+/** The mbox ring, the number of slots is a power of two */
+typedef struct {
+  u32_t head;            /* next write index, advanced by the posting tasks with a compare-and-swap */
+  u32_t tail;            /* next read index, advanced by the fetching task only */
+  u32_t mask;            /* number of slots - 1 */
+  TaskHandle_t waiter;   /* fetching task sleeping on the ring, or NULL */
+  sys_mbox_slot_t slots[];
+} sys_mbox_ring_t;
+
+/* store msg in the ring, returns 0 if the ring is full */
+static int
+sys_mbox_ring_push(sys_mbox_ring_t *ring, void *msg)
+{
+  u32_t pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+
+  for (;;) {
+    sys_mbox_slot_t *slot = &ring->slots[pos & ring->mask];
+    s32_t dif = (s32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+
+    if (dif == 0) {
+      /* the slot is free, reserve it; a failed compare-and-swap reloads pos */
+      if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        slot->msg = msg;
+        __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+        return 1;
+      }
+    } else if (dif < 0) {
+      /* the slot still holds the message of the previous round */
+      return 0;
+    } else {
+      /* another writer took the slot meanwhile */
+      pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+/* check whether the next message is ready to be fetched */
+static int
+sys_mbox_ring_ready(sys_mbox_ring_t *ring)
+{
+  return __atomic_load_n(&ring->slots[ring->tail & ring->mask].seq, __ATOMIC_ACQUIRE) == ring->tail + 1;
+}
+
+/* take the next message out of the ring, returns 0 if there is none */
+static int
+sys_mbox_ring_pop(sys_mbox_ring_t *ring, void **msg)
+{
+  u32_t pos = ring->tail;
+  sys_mbox_slot_t *slot = &ring->slots[pos & ring->mask];
+
+  if (!sys_mbox_ring_ready(ring)) {
+    return 0;
+  }
+  *msg = slot->msg;
+  ring->tail = pos + 1;
+  /* free the slot for the write of the next round */
+  __atomic_store_n(&slot->seq, pos + ring->mask + 1, __ATOMIC_RELEASE);
+  return 1;
+}
+
+/* get the fetching task to notify after a push, NULL if it is not sleeping */
+static TaskHandle_t
+sys_mbox_ring_waiter(sys_mbox_ring_t *ring)
+{
+  /* order the push before the read of waiter, paired with the fence in sys_arch_mbox_fetch() */
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  return __atomic_load_n(&ring->waiter, __ATOMIC_RELAXED);
+}
+
+err_t
+sys_mbox_new(sys_mbox_t *mbox, int size)
+{
+  sys_mbox_ring_t *ring;
+  u32_t slots = 1;
+  u32_t i;
+  LWIP_ASSERT("mbox != NULL", mbox != NULL);
+  LWIP_ASSERT("size > 0", size > 0);
+
+  while (slots < (u32_t)size) {
+    slots <<= 1;
+  }
+
+  ring = (sys_mbox_ring_t *)pvPortMalloc(sizeof(sys_mbox_ring_t) + slots * sizeof(sys_mbox_slot_t));
+  if (ring == NULL) {
+    mbox->mbx = NULL;
+    SYS_STATS_INC(mbox.err);
+    return ERR_MEM;
+  }
+  ring->head = 0;
+  ring->tail = 0;
+  ring->mask = slots - 1;
+  ring->waiter = NULL;
+  for (i = 0; i < slots; i++) {
+    ring->slots[i].seq = i;
+    ring->slots[i].msg = NULL;
+  }
+
+  mbox->mbx = ring;
+  SYS_STATS_INC_USED(mbox);
+  return ERR_OK;
+}
+
+void
+sys_mbox_post(sys_mbox_t *mbox, void *msg)
+{
+  sys_mbox_ring_t *ring;
+  TaskHandle_t waiter;
+  LWIP_ASSERT("mbox != NULL", mbox != NULL);
+  LWIP_ASSERT("mbox->mbx != NULL", mbox->mbx != NULL);
+
+  ring = (sys_mbox_ring_t *)mbox->mbx;
+  while (!sys_mbox_ring_push(ring, msg)) {
+    /* the ring is full, give the fetching task a tick to drain it */
+    vTaskDelay(1);
+  }
+
+  waiter = sys_mbox_ring_waiter(ring);
+  if (waiter != NULL) {
+    xTaskNotifyGive(waiter);
+  }
+}
+
+err_t
+sys_mbox_trypost(sys_mbox_t *mbox, void *msg)
+{
+  sys_mbox_ring_t *ring;
+  TaskHandle_t waiter;
+  LWIP_ASSERT("mbox != NULL", mbox != NULL);
+  LWIP_ASSERT("mbox->mbx != NULL", mbox->mbx != NULL);
+
+  ring = (sys_mbox_ring_t *)mbox->mbx;
+  if (!sys_mbox_ring_push(ring, msg)) {
+    SYS_STATS_INC(mbox.err);
+    return ERR_MEM;
+  }
+
+  waiter = sys_mbox_ring_waiter(ring);
+  if (waiter != NULL) {
+    xTaskNotifyGive(waiter);
+  }
+  return ERR_OK;
+}
+
+err_t
+sys_mbox_trypost_fromisr(sys_mbox_t *mbox, void *msg)
+{
+  sys_mbox_ring_t *ring;
+  TaskHandle_t waiter;
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  LWIP_ASSERT("mbox != NULL", mbox != NULL);
+  LWIP_ASSERT("mbox->mbx != NULL", mbox->mbx != NULL);
+
+  ring = (sys_mbox_ring_t *)mbox->mbx;
+  if (!sys_mbox_ring_push(ring, msg)) {
+    SYS_STATS_INC(mbox.err);
+    return ERR_MEM;
+  }
+
+  waiter = sys_mbox_ring_waiter(ring);
+  if (waiter != NULL) {
+    vTaskNotifyGiveFromISR(waiter, &xHigherPriorityTaskWoken);
+    if (xHigherPriorityTaskWoken == pdTRUE) {
+      return ERR_NEED_SCHED;
+    }
+  }
+  return ERR_OK;
+}
+
+u32_t
+sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout_ms)
+{
+  sys_mbox_ring_t *ring;
+  void *msg_dummy;
+  TickType_t start;
+  TickType_t wait_ticks = portMAX_DELAY;
+  LWIP_ASSERT("mbox != NULL", mbox != NULL);
+  LWIP_ASSERT("mbox->mbx != NULL", mbox->mbx != NULL);
+
+  if (!msg) {
+    msg = &msg_dummy;
+  }
+
+  ring = (sys_mbox_ring_t *)mbox->mbx;
+  start = xTaskGetTickCount();
+  while (!sys_mbox_ring_pop(ring, msg)) {
+    if (timeout_ms) {
+      TickType_t timeout_ticks = timeout_ms / portTICK_RATE_MS;
+      TickType_t elapsed = xTaskGetTickCount() - start;
+      if (elapsed >= timeout_ticks) {
+        /* timed out */
+        *msg = NULL;
+        return SYS_ARCH_TIMEOUT;
+      }
+      wait_ticks = timeout_ticks - elapsed;
+    }
+
+    /* announce the sleep, then check again so that a push in between is not missed */
+    __atomic_store_n(&ring->waiter, xTaskGetCurrentTaskHandle(), __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (!sys_mbox_ring_ready(ring)) {
+      ulTaskNotifyTake(pdTRUE, wait_ticks);
+    }
+    __atomic_store_n(&ring->waiter, NULL, __ATOMIC_RELAXED);
+  }
+
+  /* Old versions of lwIP required us to return the time waited.
+     This is not the case any more. Just returning != SYS_ARCH_TIMEOUT
+     here is enough. */
+  return 1;
+}
+
+u32_t
+sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
+{
+  void *msg_dummy;
+  LWIP_ASSERT("mbox != NULL", mbox != NULL);
+  LWIP_ASSERT("mbox->mbx != NULL", mbox->mbx != NULL);
+
+  if (!msg) {
+    msg = &msg_dummy;
+  }
+
+  if (!sys_mbox_ring_pop((sys_mbox_ring_t *)mbox->mbx, msg)) {
+    *msg = NULL;
+    return SYS_MBOX_EMPTY;
+  }
+
+  /* Old versions of lwIP required us to return the time waited.
+     This is not the case any more. Just returning != SYS_ARCH_TIMEOUT
+     here is enough. */
+  return 1;
+}
+
+void
+sys_mbox_free(sys_mbox_t *mbox)
+{
+  LWIP_ASSERT("mbox != NULL", mbox != NULL);
+  LWIP_ASSERT("mbox->mbx != NULL", mbox->mbx != NULL);
+
+#if LWIP_FREERTOS_CHECK_QUEUE_EMPTY_ON_FREE
+  {
+    int msgs_waiting = sys_mbox_ring_ready((sys_mbox_ring_t *)mbox->mbx);
+    LWIP_ASSERT("mbox quence not empty", msgs_waiting == 0);
+
+    if (msgs_waiting != 0) {
+      SYS_STATS_INC(mbox.err);
+    }
+  }
+#endif
+
+  vPortFree(mbox->mbx);
+
+  SYS_STATS_DEC(mbox.used);
+}
+
+#endif /* !LWIP_FREERTOS_MBOX_RING */
+
 sys_thread_t
 sys_thread_new(const char *name, lwip_thread_fn thread, void *arg, int stacksize, int prio)
 {
@@ -0,0 +1,56 @@
+/*!
+    \file    dhcp_cache.h
+    \brief   the header file of dhcp_cache
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef DHCP_CACHE_H
+#define DHCP_CACHE_H
+
+#include <stdint.h>
+#include "lwip/netif.h"
+
+#define DHCP_CACHE_BKP_BASE         8U              /* first RTC backup register holding the cache */
+#define DHCP_CACHE_ARP_ENTRIES      4U              /* ARP entries kept, the gateway first */
+
+/* function declarations */
+/* read the lease of the last boot from the RTC backup registers, return 1 if it is valid */
+uint8_t dhcp_cache_load(ip_addr_t *ipaddr, ip_addr_t *netmask, ip_addr_t *gw);
+/* confirm the cached lease with a DHCP INIT-REBOOT request and prime the ARP table */
+uint8_t dhcp_cache_start(struct netif *netif);
+/* store the bound lease and the ARP table in the RTC backup registers */
+void dhcp_cache_save(struct netif *netif);
+/* give the ARP entries primed from the cache back to the ARP timer */
+void dhcp_cache_release(struct netif *netif);
+/* drop the ARP entries primed from the cache, when the interface leaves the cached lease */
+void dhcp_cache_stop(struct netif *netif);
+
+#endif /* DHCP_CACHE_H */
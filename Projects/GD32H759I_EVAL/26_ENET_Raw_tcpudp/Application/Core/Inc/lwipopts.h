@@ -43,21 +43,41 @@ OF SUCH DAMAGE.
 #define NO_SYS                  1                        /* NO_SYS==1: provides VERY minimal functionality. 
                                                             Otherwise, use lwIP facilities */
 
+/* high-throughput profile */
+#ifndef LWIP_HIGH_THROUGHPUT
+#define LWIP_HIGH_THROUGHPUT    0                        /* LWIP_HIGH_THROUGHPUT==1: large scaled TCP windows, with the lwIP heap
+                                                            and pools in the EXMC SDRAM, set by ENET_HIGH_THROUGHPUT in cmake */
+#endif
+
+#if LWIP_HIGH_THROUGHPUT
+/* every lwIP heap and pool goes to the .sdram section, main() initializes the SDRAM before lwIP.
+   A file reaching lwip/arch.h before this file has the default already, replace it */
+#undef LWIP_DECLARE_MEMORY_ALIGNED
+#define LWIP_DECLARE_MEMORY_ALIGNED(variable_name, size) \
+        u8_t variable_name[LWIP_MEM_ALIGN_BUFFER(size)] __attribute__((section(".sdram"), aligned(32)))
+#endif /* LWIP_HIGH_THROUGHPUT */
+
 /*  memory options  */
 #define MEM_ALIGNMENT           4                        /* should be set to the alignment of the CPU for which lwIP
                                                             is compiled. 4 byte alignment -> define MEM_ALIGNMENT 
                                                             to 4, 2 byte alignment -> define MEM_ALIGNMENT to 2 */
 
+#if LWIP_HIGH_THROUGHPUT
+#define MEM_SIZE                (256*1024)               /* the heap holds the copied Tx data, TCP_SND_BUF for each
+                                                            of a few fast connections */
+#else
 #define MEM_SIZE                (15*1024)                /* the size of the heap memory, if the application will 
                                                             send a lot of data that needs to be copied, this should
                                                             be set high */
+#endif /* LWIP_HIGH_THROUGHPUT */
 
-/* Relocate the LwIP RAM heap pointer */
-#define LWIP_RAM_HEAP_POINTER    (0x30004000)
-
+#if LWIP_HIGH_THROUGHPUT
+#define MEMP_NUM_PBUF           TCP_SND_QUEUELEN         /* a whole send queue of data sent without copy */
+#else
 #define MEMP_NUM_PBUF           10                       /* the number of memp struct pbufs. If the application
                                                             sends a lot of data out of ROM (or other static memory),
                                                             this should be set high */
+#endif /* LWIP_HIGH_THROUGHPUT */
 
 #define MEMP_NUM_UDP_PCB        6                        /* the number of UDP protocol control blocks, one
                                                             per active UDP "connection" */
@@ -66,32 +86,76 @@ OF SUCH DAMAGE.
 
 #define MEMP_NUM_TCP_PCB_LISTEN 6                        /* the number of listening TCP connections */
 
+#if LWIP_HIGH_THROUGHPUT
+#define MEMP_NUM_TCP_SEG        (TCP_SND_QUEUELEN + TCP_OOSEQ_MAX_PBUFS)  /* the send queue and the out of order queue */
+#else
 #define MEMP_NUM_TCP_SEG        12                       /* the number of simultaneously queued TCP segments */
+#endif /* LWIP_HIGH_THROUGHPUT */
 
 #define MEMP_NUM_SYS_TIMEOUT    10                       /* the number of simulateously active timeouts */
 
 #define MEMP_NUM_NETBUF         8                        /* the number of struct netbufs */
 
 /* Pbuf options */
+#if LWIP_HIGH_THROUGHPUT
+#define PBUF_POOL_SIZE          96                       /* the number of buffers in the pbuf pool, more than TCP_WND */
+#define PBUF_POOL_BUFSIZE       1514                     /* one pbuf holds a full-sized frame */
+#else
 #define PBUF_POOL_SIZE          10                       /* the number of buffers in the pbuf pool */
 #define PBUF_POOL_BUFSIZE       1500                     /* the size of each pbuf in the pbuf pool */
+#endif /* LWIP_HIGH_THROUGHPUT */
+
+/* ethernetif options */
+#ifndef LWIP_PTP
+#define LWIP_PTP                0                        /* LWIP_PTP==1: timestamp the frames in the ethernetif port
+                                                            and run the PTP slave of ptp_slave.c, set by ENET_PTP in cmake */
+#endif
+
+#if LWIP_PTP
+#define ETHERNETIF_TX_SCATTER_GATHER 0                   /* the Tx timestamps are taken from the copied Tx buffer */
+#define LWIP_HOOK_FILENAME      "ptp_slave.h"            /* the PTP frames sent over ethernet are taken by the hook below */
+#define LWIP_HOOK_UNKNOWN_ETH_PROTOCOL(p, netif)  ptp_slave_l2_input((p), (netif))
+#else
+#define ETHERNETIF_TX_SCATTER_GATHER 1                   /* chain the pbufs of a Tx frame across ENET descriptors
+                                                            instead of copying them into the Tx buffer */
+#endif /* LWIP_PTP */
 
 /* TCP options */
 #define LWIP_TCP                1
 #define TCP_TTL                 255
 
+#if LWIP_HIGH_THROUGHPUT
+#define TCP_QUEUE_OOSEQ         1                        /* keep the segments received after a loss, lwIP has no SACK
+                                                            so the sender only resends the missing ones */
+#define TCP_OOSEQ_MAX_PBUFS     (TCP_WND / TCP_MSS / 2)  /* leave half the window to in order data */
+#else
 #define TCP_QUEUE_OOSEQ         0                        /* controls if TCP should queue segments that arrive out of
                                                             order, Define to 0 if your device is low on memory. */
+#endif /* LWIP_HIGH_THROUGHPUT */
 
 #define TCP_MSS                 (1500 - 40)              /* TCP Maximum segment size, 
                                                             TCP_MSS = (Ethernet MTU - IP header size - TCP header size) */
 
+#if LWIP_HIGH_THROUGHPUT
+#define LWIP_WND_SCALE          1                        /* TCP window scaling, the windows exceed 64 KB */
+#define TCP_RCV_SCALE           1                        /* the receive window is announced in units of 2 bytes */
+
+#define TCP_SND_BUF             (64*TCP_MSS)             /* TCP sender buffer space (bytes) */
+
+#define TCP_SND_QUEUELEN        ((4* TCP_SND_BUF)/TCP_MSS)   /* TCP sender buffer space (pbufs) */
+
+#define TCP_WND                 (64*TCP_MSS)             /* TCP receive window */
+
+#define TCP_TMR_INTERVAL        100                      /* a finer TCP timer shortens the delayed ACKs and lets the
+                                                            retransmission timeout recover losses fast recovery misses */
+#else
 #define TCP_SND_BUF             (2*TCP_MSS)              /* TCP sender buffer space (bytes) */
 
 #define TCP_SND_QUEUELEN        ((6* TCP_SND_BUF)/TCP_MSS)   /* TCP sender buffer space (pbufs), this must be at least
                                                             as much as (2 * TCP_SND_BUF/TCP_MSS) for things to work */
 
 #define TCP_WND                 (2*TCP_MSS)              /* TCP receive window */
+#endif /* LWIP_HIGH_THROUGHPUT */
                                                    
 
 /* ICMP options */
@@ -102,6 +166,7 @@ OF SUCH DAMAGE.
 #define LWIP_DHCP               1                        /* define to 1 if you want DHCP configuration of interfaces,
                                                             DHCP is not implemented in lwIP 0.5.1, however, so
                                                             turning this on does currently not work. */
+#define ETHARP_SUPPORT_STATIC_ENTRIES   1                /* dhcp_cache.c primes the ARP table of a cached lease */
 
 #define LWIP_NETIF_STATUS_CALLBACK 1
 
@@ -111,7 +176,18 @@ OF SUCH DAMAGE.
 
 
 /* statistics options */
-#define LWIP_STATS              0
+#define LWIP_STATS              1                        /* heap and pool usage, reported by net_stats.c */
+#define LINK_STATS              0                        /* no per-packet protocol counters, the driver counts its drops */
+#define ETHARP_STATS            0
+#define IP_STATS                0
+#define IPFRAG_STATS            0
+#define ICMP_STATS              0
+#define UDP_STATS               0
+#define TCP_STATS               0
+#if LWIP_IPERF
+/* the iperf reports print the TCP fast retransmits */
+#define MIB2_STATS              1
+#endif /* LWIP_IPERF */
 #define LWIP_PROVIDE_ERRNO      1
 
 /* checksum options */
@@ -43,7 +43,7 @@ OF SUCH DAMAGE.
 
 //#define USE_ENET_INTERRUPT
 
-/*The USE_ENET0 and USE_ENET1 macros cannot be opened at the same time*/
+/*The USE_ENET0 and USE_ENET1 macros can be opened at the same time only if ENET_INSTANCE_NUM is defined to 2U for the whole build*/
 #define USE_ENET0
 //#define USE_ENET1
 
@@ -81,6 +81,22 @@ OF SUCH DAMAGE.
 #define BOARD_GW_ADDR2   3
 #define BOARD_GW_ADDR3   1
 
+/* ENET1 address, net mask and gateway when USE_ENET0 and USE_ENET1 are both opened, ENET1 is on its own subnet */
+#define BOARD_ENET1_IP_ADDR0        10
+#define BOARD_ENET1_IP_ADDR1        50
+#define BOARD_ENET1_IP_ADDR2        4
+#define BOARD_ENET1_IP_ADDR3        210
+
+#define BOARD_ENET1_NETMASK_ADDR0   255
+#define BOARD_ENET1_NETMASK_ADDR1   255
+#define BOARD_ENET1_NETMASK_ADDR2   255
+#define BOARD_ENET1_NETMASK_ADDR3   0
+
+#define BOARD_ENET1_GW_ADDR0        10
+#define BOARD_ENET1_GW_ADDR1        50
+#define BOARD_ENET1_GW_ADDR2        4
+#define BOARD_ENET1_GW_ADDR3        1
+
 /* MII and RMII mode selection */
 #define RMII_MODE  // user have to provide the 50 MHz clock by soldering a 50 MHz oscillator
 //#define MII_MODE
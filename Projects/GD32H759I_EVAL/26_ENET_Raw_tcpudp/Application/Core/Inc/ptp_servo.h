@@ -0,0 +1,70 @@
+/*!
+    \file    ptp_servo.h
+    \brief   the header file of ptp_servo
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+#ifndef PTP_SERVO_H
+#define PTP_SERVO_H
+
+#include <stdint.h>
+
+/* state of the servo after a sample */
+typedef enum {
+    PTP_SERVO_UNLOCKED = 0,                                     /*!< the frequency of the clock is being estimated */
+    PTP_SERVO_JUMP,                                             /*!< the offset is too large, the clock has to be stepped */
+    PTP_SERVO_LOCKED                                            /*!< the clock frequency follows the servo output */
+} ptp_servo_state_enum;
+
+/* PI servo which turns clock offsets into frequency adjustments */
+typedef struct {
+    double kp;                                                  /*!< proportional constant, ppb per ns of offset */
+    double ki;                                                  /*!< integral constant, ppb per ns of offset and second */
+    double max_ppb;                                             /*!< largest frequency adjustment, ppb */
+    int64_t step_threshold;                                     /*!< offsets beyond this step the clock, ns */
+    double integral;                                            /*!< integral term, ppb */
+    int64_t first_offset;                                       /*!< offset of the first sample after a reset, ns */
+    uint32_t sample_count;                                      /*!< samples since the last reset */
+    ptp_servo_state_enum state;                                 /*!< state after the last sample */
+} ptp_servo_struct;
+
+/* function declarations */
+/* initialize the servo */
+void ptp_servo_init(ptp_servo_struct *servo, double kp, double ki, double max_ppb, int64_t step_threshold);
+/* forget the integral term and start over */
+void ptp_servo_reset(ptp_servo_struct *servo);
+/* feed a clock offset to the servo and get the frequency adjustment */
+ptp_servo_state_enum ptp_servo_sample(ptp_servo_struct *servo, int64_t offset, double interval, double *freq_ppb);
+/* scale the nominal timestamp addend by a frequency adjustment */
+uint32_t ptp_servo_addend_calc(uint32_t base_addend, double freq_ppb);
+
+#endif /* PTP_SERVO_H */
@@ -0,0 +1,69 @@
+/*!
+    \file    ptp_slave.h
+    \brief   the header file of ptp_slave
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+#ifndef PTP_SLAVE_H
+#define PTP_SLAVE_H
+
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "ptp_servo.h"
+
+/* offset and path delay statistics of the PTP slave */
+typedef struct {
+    uint32_t sync_count;                                        /*!< Sync messages completed with the origin timestamp */
+    uint32_t delay_resp_count;                                  /*!< Delay_Resp messages matching a Delay_Req */
+    uint32_t step_count;                                        /*!< clock steps */
+    uint32_t master_change_count;                               /*!< masters taken or lost */
+    int64_t offset;                                             /*!< last offset from the master, ns */
+    int64_t path_delay;                                         /*!< last mean path delay, ns */
+    int64_t offset_min;                                         /*!< smallest offset since the last step, ns */
+    int64_t offset_max;                                         /*!< largest offset since the last step, ns */
+    uint64_t offset_abs_sum;                                    /*!< sum of the offset magnitudes since the last step, ns */
+    uint32_t offset_samples;                                    /*!< offsets added to offset_abs_sum */
+    double freq_ppb;                                            /*!< frequency adjustment of the clock, ppb */
+    ptp_servo_state_enum servo_state;                           /*!< state of the servo */
+} ptp_slave_stats_struct;
+
+/* function declarations */
+/* initialize the PTP slave on an interface */
+void ptp_slave_init(struct netif *netif, uint32_t enet_periph);
+/* handle the Delay_Req and master timeouts */
+void ptp_slave_timer(uint32_t localtime);
+/* get the offset and path delay statistics */
+void ptp_slave_stats_get(ptp_slave_stats_struct *stats);
+/* take the PTP frames sent over ethernet, called by the LwIP unknown ethernet protocol hook */
+err_t ptp_slave_l2_input(struct pbuf *p, struct netif *netif);
+
+#endif /* PTP_SLAVE_H */
@@ -0,0 +1,343 @@
+/*!
+    \file    dhcp_cache.c
+    \brief   DHCP lease and ARP cache in the RTC backup registers for a fast restart
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "dhcp_cache.h"
+#include "main.h"
+#include "gd32h7xx.h"
+#include "lwip/dhcp.h"
+#include "lwip/prot/dhcp.h"
+#include "lwip/etharp.h"
+#include "lwip/init.h"
+#include <string.h>
+
+#ifdef USE_DHCP
+
+#if !ETHARP_SUPPORT_STATIC_ENTRIES
+#error "the DHCP cache primes the ARP table with static entries, set ETHARP_SUPPORT_STATIC_ENTRIES"
+#endif
+
+#if (LWIP_VERSION_MAJOR != 2) || (LWIP_VERSION_MINOR != 1)
+#error "dhcp_cache_start() relies on the DHCP client states of lwIP 2.1, check it against this lwIP version"
+#endif
+
+/* layout of the cache, in 32-bit backup registers from DHCP_CACHE_BKP_BASE on */
+#define DHCP_CACHE_MAGIC            0x44484331U     /* "DHC1" */
+#define DHCP_CACHE_WORD_MAGIC       0U
+#define DHCP_CACHE_WORD_IP          1U
+#define DHCP_CACHE_WORD_NETMASK     2U
+#define DHCP_CACHE_WORD_GW          3U
+#define DHCP_CACHE_WORD_ARP_NUM     4U
+#define DHCP_CACHE_WORD_ARP         5U              /* IP, MAC bytes 0..3, MAC bytes 4..5 per entry */
+#define DHCP_CACHE_WORD_CHECKSUM    (DHCP_CACHE_WORD_ARP + 3U * DHCP_CACHE_ARP_ENTRIES)
+#define DHCP_CACHE_WORDS            (DHCP_CACHE_WORD_CHECKSUM + 1U)
+
+#if (DHCP_CACHE_BKP_BASE + DHCP_CACHE_WORDS) > 32U
+#error "the DHCP cache does not fit in the 32 RTC backup registers"
+#endif
+
+/* RTC backup register of the cache word index */
+#define DHCP_CACHE_BKP(index)       REG32((RTC) + 0x00000050U + ((DHCP_CACHE_BKP_BASE + (uint32_t)(index)) << 2))
+
+/* the ARP entries of the cache */
+typedef struct {
+    ip4_addr_t ipaddr;
+    struct eth_addr ethaddr;
+} dhcp_cache_arp_struct;
+
+static dhcp_cache_arp_struct dhcp_cache_arp[DHCP_CACHE_ARP_ENTRIES];
+static uint32_t dhcp_cache_arp_num = 0U;
+static uint8_t dhcp_cache_valid = 0U;
+/* the primed ARP entries are static until the lease is confirmed */
+static uint8_t dhcp_cache_arp_primed = 0U;
+
+/*!
+    \brief      enable the access to the RTC backup registers, the RTC clock source is left to the application
+    \param[in]  none
+    \param[out] none
+    \retval     1 if the backup registers can be used, 0 if no RTC clock source is selected
+*/
+static uint8_t dhcp_cache_bkp_enable(void)
+{
+    rcu_periph_clock_enable(RCU_PMU);
+    pmu_backup_write_enable();
+
+    /* the backup registers need the RTC clocked */
+    if(0U == GET_BITS(RCU_BDCTL, 8, 9)) {
+        return 0U;
+    }
+    rcu_periph_clock_enable(RCU_RTC);
+
+    return 1U;
+}
+
+/*!
+    \brief      compute the checksum of the cache words in front of the checksum word
+    \param[in]  none
+    \param[out] none
+    \retval     FNV-1a hash of the words
+*/
+static uint32_t dhcp_cache_checksum(void)
+{
+    uint32_t hash = 0x811C9DC5U;
+    uint32_t word;
+    uint32_t i, j;
+
+    for(i = 0U; i < DHCP_CACHE_WORD_CHECKSUM; i++) {
+        word = DHCP_CACHE_BKP(i);
+        for(j = 0U; j < 4U; j++) {
+            hash ^= (word >> (8U * j)) & 0xFFU;
+            hash *= 0x01000193U;
+        }
+    }
+
+    return hash;
+}
+
+/*!
+    \brief      read the lease of the last boot from the RTC backup registers
+    \param[in]  none
+    \param[out] ipaddr: the cached IP address
+    \param[out] netmask: the cached netmask
+    \param[out] gw: the cached gateway
+    \retval     1 if the cache holds a valid lease, 0 otherwise
+*/
+uint8_t dhcp_cache_load(ip_addr_t *ipaddr, ip_addr_t *netmask, ip_addr_t *gw)
+{
+    uint32_t mac_low, mac_high;
+    uint32_t i;
+
+    dhcp_cache_valid = 0U;
+    if((0U == dhcp_cache_bkp_enable()) ||
+            (DHCP_CACHE_MAGIC != DHCP_CACHE_BKP(DHCP_CACHE_WORD_MAGIC)) ||
+            (dhcp_cache_checksum() != DHCP_CACHE_BKP(DHCP_CACHE_WORD_CHECKSUM)) ||
+            (0U == DHCP_CACHE_BKP(DHCP_CACHE_WORD_IP))) {
+        return 0U;
+    }
+
+    ip4_addr_set_u32(ipaddr, DHCP_CACHE_BKP(DHCP_CACHE_WORD_IP));
+    ip4_addr_set_u32(netmask, DHCP_CACHE_BKP(DHCP_CACHE_WORD_NETMASK));
+    ip4_addr_set_u32(gw, DHCP_CACHE_BKP(DHCP_CACHE_WORD_GW));
+
+    dhcp_cache_arp_num = DHCP_CACHE_BKP(DHCP_CACHE_WORD_ARP_NUM);
+    if(dhcp_cache_arp_num > DHCP_CACHE_ARP_ENTRIES) {
+        dhcp_cache_arp_num = 0U;
+    }
+    for(i = 0U; i < dhcp_cache_arp_num; i++) {
+        ip4_addr_set_u32(&dhcp_cache_arp[i].ipaddr, DHCP_CACHE_BKP(DHCP_CACHE_WORD_ARP + 3U * i));
+        mac_low = DHCP_CACHE_BKP(DHCP_CACHE_WORD_ARP + 3U * i + 1U);
+        mac_high = DHCP_CACHE_BKP(DHCP_CACHE_WORD_ARP + 3U * i + 2U);
+        dhcp_cache_arp[i].ethaddr.addr[0] = (uint8_t)mac_low;
+        dhcp_cache_arp[i].ethaddr.addr[1] = (uint8_t)(mac_low >> 8);
+        dhcp_cache_arp[i].ethaddr.addr[2] = (uint8_t)(mac_low >> 16);
+        dhcp_cache_arp[i].ethaddr.addr[3] = (uint8_t)(mac_low >> 24);
+        dhcp_cache_arp[i].ethaddr.addr[4] = (uint8_t)mac_high;
+        dhcp_cache_arp[i].ethaddr.addr[5] = (uint8_t)(mac_high >> 8);
+    }
+
+    dhcp_cache_valid = 1U;
+    return 1U;
+}
+
+/*!
+    \brief      confirm the cached lease with a DHCP INIT-REBOOT request and prime the ARP table,
+                the interface must be up with the cached address
+    \param[in]  netif: the interface configured by dhcp_cache_load()
+    \param[out] none
+    \retval     1 if DHCP was started on the cached lease, 0 if the normal discovery is needed
+*/
+uint8_t dhcp_cache_start(struct netif *netif)
+{
+    struct dhcp *dhcp;
+    uint8_t link_up;
+    uint32_t i;
+
+    if((0U == dhcp_cache_valid) || ip4_addr_isany_val(*netif_ip4_addr(netif))) {
+        return 0U;
+    }
+
+    /* dhcp_start() sends a DISCOVER on a link which is up, with the link down it waits in INIT */
+    link_up = netif_is_link_up(netif) ? 1U : 0U;
+    if(0U != link_up) {
+        netif_set_link_down(netif);
+    }
+    if(ERR_OK != dhcp_start(netif)) {
+        if(0U != link_up) {
+            netif_set_link_up(netif);
+        }
+        return 0U;
+    }
+
+    /* lwIP 2.1 has no call to start a client in INIT-REBOOT, only dhcp_network_changed() enters it,
+       from a client holding a lease. The client is put in REBOOTING on the cached address by hand,
+       which is safe here: in INIT it has no request pending and its tries and timeouts are zero,
+       exactly what dhcp_set_state() would leave. The link up event then runs lwIP's own
+       dhcp_reboot(), which sends the REQUEST for the address and a gratuitous ARP for it,
+       and a NAK or no answer falls back to the discovery. */
+    dhcp = netif_dhcp_data(netif);
+    if(DHCP_STATE_INIT != dhcp->state) {
+        dhcp_stop(netif);
+        if(0U != link_up) {
+            netif_set_link_up(netif);
+        }
+        return 0U;
+    }
+    ip4_addr_copy(dhcp->offered_ip_addr, *netif_ip4_addr(netif));
+    dhcp->state = DHCP_STATE_REBOOTING;
+    if(0U != link_up) {
+        netif_set_link_up(netif);
+    }
+
+    /* the cached neighbours answer at once, without an ARP round trip */
+    for(i = 0U; i < dhcp_cache_arp_num; i++) {
+        if(ERR_OK == etharp_add_static_entry(&dhcp_cache_arp[i].ipaddr, &dhcp_cache_arp[i].ethaddr)) {
+            dhcp_cache_arp_primed = 1U;
+        }
+    }
+
+    return 1U;
+}
+
+/*!
+    \brief      remove the static ARP entries primed from the cache
+    \param[in]  netif: the interface of the entries
+    \param[in]  refresh: 1 to ask for the neighbours again, which replaces the static entries by dynamic ones
+    \param[out] none
+    \retval     none
+*/
+static void dhcp_cache_arp_unprime(struct netif *netif, uint8_t refresh)
+{
+    uint32_t i;
+
+    dhcp_cache_arp_primed = 0U;
+    for(i = 0U; i < dhcp_cache_arp_num; i++) {
+        if((ERR_OK == etharp_remove_static_entry(&dhcp_cache_arp[i].ipaddr)) && (0U != refresh)) {
+            etharp_request(netif, &dhcp_cache_arp[i].ipaddr);
+        }
+    }
+}
+
+/*!
+    \brief      give the ARP entries primed from the cache back to the ARP timer
+    \param[in]  netif: the interface of the entries
+    \param[out] none
+    \retval     none
+*/
+void dhcp_cache_release(struct netif *netif)
+{
+    if(0U == dhcp_cache_arp_primed) {
+        return;
+    }
+
+    /* a static entry is never refreshed, so it is replaced by a dynamic one */
+    dhcp_cache_arp_unprime(netif, 1U);
+}
+
+/*!
+    \brief      drop the ARP entries primed from the cache, when the interface leaves the cached lease
+    \param[in]  netif: the interface of the entries
+    \param[out] none
+    \retval     none
+*/
+void dhcp_cache_stop(struct netif *netif)
+{
+    /* the neighbours of the cached lease may not be on the new subnet, they are not asked for again */
+    dhcp_cache_arp_unprime(netif, 0U);
+}
+
+/*!
+    \brief      store the bound lease and the ARP table in the RTC backup registers
+    \param[in]  netif: the interface with a bound DHCP lease
+    \param[out] none
+    \retval     none
+*/
+void dhcp_cache_save(struct netif *netif)
+{
+    dhcp_cache_arp_struct entries[DHCP_CACHE_ARP_ENTRIES];
+    ip4_addr_t *ipaddr;
+    struct netif *entry_netif;
+    struct eth_addr *ethaddr;
+    uint32_t num = 0U;
+    uint32_t pass;
+    size_t i;
+
+    if(!dhcp_supplied_address(netif) || (0U == dhcp_cache_bkp_enable())) {
+        return;
+    }
+
+    /* the ARP table holds the primed entries as static ones, so it is read before the release */
+    for(pass = 0U; pass < 2U; pass++) {
+        for(i = 0U; (i < ARP_TABLE_SIZE) && (num < DHCP_CACHE_ARP_ENTRIES); i++) {
+            if((0 == etharp_get_entry(i, &ipaddr, &entry_netif, &ethaddr)) || (entry_netif != netif)) {
+                continue;
+            }
+            /* the gateway goes first */
+            if((0U == pass) != ip4_addr_cmp(ipaddr, netif_ip4_gw(netif))) {
+                continue;
+            }
+            entries[num].ipaddr = *ipaddr;
+            entries[num].ethaddr = *ethaddr;
+            num++;
+        }
+    }
+
+    dhcp_cache_release(netif);
+    memcpy(dhcp_cache_arp, entries, num * sizeof(dhcp_cache_arp_struct));
+    dhcp_cache_arp_num = num;
+
+    DHCP_CACHE_BKP(DHCP_CACHE_WORD_MAGIC) = DHCP_CACHE_MAGIC;
+    DHCP_CACHE_BKP(DHCP_CACHE_WORD_IP) = ip4_addr_get_u32(netif_ip4_addr(netif));
+    DHCP_CACHE_BKP(DHCP_CACHE_WORD_NETMASK) = ip4_addr_get_u32(netif_ip4_netmask(netif));
+    DHCP_CACHE_BKP(DHCP_CACHE_WORD_GW) = ip4_addr_get_u32(netif_ip4_gw(netif));
+    DHCP_CACHE_BKP(DHCP_CACHE_WORD_ARP_NUM) = num;
+    for(i = 0U; i < DHCP_CACHE_ARP_ENTRIES; i++) {
+        if(i < num) {
+            DHCP_CACHE_BKP(DHCP_CACHE_WORD_ARP + 3U * i) = ip4_addr_get_u32(&dhcp_cache_arp[i].ipaddr);
+            DHCP_CACHE_BKP(DHCP_CACHE_WORD_ARP + 3U * i + 1U) = (uint32_t)dhcp_cache_arp[i].ethaddr.addr[0] |
+                    ((uint32_t)dhcp_cache_arp[i].ethaddr.addr[1] << 8) |
+                    ((uint32_t)dhcp_cache_arp[i].ethaddr.addr[2] << 16) |
+                    ((uint32_t)dhcp_cache_arp[i].ethaddr.addr[3] << 24);
+            DHCP_CACHE_BKP(DHCP_CACHE_WORD_ARP + 3U * i + 2U) = (uint32_t)dhcp_cache_arp[i].ethaddr.addr[4] |
+                    ((uint32_t)dhcp_cache_arp[i].ethaddr.addr[5] << 8);
+        } else {
+            DHCP_CACHE_BKP(DHCP_CACHE_WORD_ARP + 3U * i) = 0U;
+            DHCP_CACHE_BKP(DHCP_CACHE_WORD_ARP + 3U * i + 1U) = 0U;
+            DHCP_CACHE_BKP(DHCP_CACHE_WORD_ARP + 3U * i + 2U) = 0U;
+        }
+    }
+    DHCP_CACHE_BKP(DHCP_CACHE_WORD_CHECKSUM) = dhcp_cache_checksum();
+
+    dhcp_cache_valid = 1U;
+}
+
+#endif /* USE_DHCP */
@@ -33,6 +33,7 @@ OF SUCH DAMAGE.
 */
 
 #include "hello_gigadevice.h"
+#include "net_stats.h"
 #include "lwip/tcp.h"
 #include <string.h>
 #include <stdio.h>
@@ -44,6 +45,7 @@ OF SUCH DAMAGE.
                           \n\rHello. What is your name?\r\n"
 #define HELLO            "\n\rGigaDevice Hello "
 #define MAX_NAME_SIZE    32
+#define STATS_COMMAND    "stats"
 
 extern const uint8_t gd32_str[];
 struct name {
@@ -51,10 +53,28 @@ struct name {
     char bytes[MAX_NAME_SIZE];
 };
 
+/* the statistics report, formatted on the "stats" command */
+static char stats_report[NET_STATS_REPORT_SIZE];
+
 static err_t hello_gigadevice_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err);
 static err_t hello_gigadevice_accept(void *arg, struct tcp_pcb *pcb, err_t err);
 static void hello_gigadevice_conn_err(void *arg, err_t err);
 
+/*!
+    \brief      check whether a received line is the "stats" command
+    \param[in]  line: the received line
+    \param[in]  length: length of the line
+    \param[out] none
+    \retval     1 for the "stats" command, 0 otherwise
+*/
+static int hello_gigadevice_stats_command(const char *line, int length)
+{
+    int len = strlen(STATS_COMMAND);
+
+    return (length > len) && (0 == strncmp(line, STATS_COMMAND, len)) &&
+           ((line[len] == '\r') || (line[len] == '\n'));
+}
+
 /*!
     \brief      called when a data is received on the telnet connection
     \param[in]  arg: the user argument
@@ -97,7 +117,11 @@ static err_t hello_gigadevice_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *
             }
         }
 
-        if(done) {
+        if(done && hello_gigadevice_stats_command(name->bytes, name->length)) {
+            /* print the lwIP pool and driver statistics instead of the greeting */
+            tcp_write(pcb, stats_report, net_stats_report(stats_report, sizeof(stats_report)), TCP_WRITE_FLAG_COPY);
+            name->length = 0;
+        } else if(done) {
             if(name->bytes[name->length - 2] != '\r' || name->bytes[name->length - 1] != '\n') {
                 /* limit the received data length to MAX_NAME_SIZE - 2('\r' and '\n' will be put into the buffer) */
                 if((name->bytes[name->length - 1] == '\r' || name->bytes[name->length - 1] == '\n') && (name->length + 1 <= MAX_NAME_SIZE)) {
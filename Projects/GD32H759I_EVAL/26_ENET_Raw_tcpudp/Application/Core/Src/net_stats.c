@@ -0,0 +1,220 @@
+/*!
+    \file    net_stats.c
+    \brief   lwIP pool, heap and ENET driver statistics, read over telnet or UDP
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "net_stats.h"
+#include "main.h"
+#include "ethernetif.h"
+#include "lwip/udp.h"
+#include "lwip/stats.h"
+#include "lwip/memp.h"
+#include "lwip/netif.h"
+#if !NO_SYS
+#include "lwip/tcpip.h"
+#endif /* !NO_SYS */
+#include <stdio.h>
+#include <stdarg.h>
+
+#if !LWIP_STATS || !MEM_STATS || !MEMP_STATS
+#error "the statistics report needs LWIP_STATS with MEM_STATS and MEMP_STATS"
+#endif
+
+/* names of the memp pools, in the order of memp_t */
+static const char *const net_stats_pool_names[MEMP_MAX] = {
+#define LWIP_MEMPOOL(name, num, size, desc) #name,
+#include "lwip/priv/memp_std.h"
+};
+
+static uint8_t net_stats_started = 0U;
+
+/*!
+    \brief      append formatted text to the report, truncating at the end of the buffer
+    \param[in]  buf: report buffer
+    \param[in]  size: size of the buffer
+    \param[in]  len: length already written
+    \param[in]  format: printf format of the text
+    \param[out] none
+    \retval     the new length of the report
+*/
+static uint32_t net_stats_append(char *buf, uint32_t size, uint32_t len, const char *format, ...)
+{
+    va_list args;
+    int ret;
+
+    if(len >= size) {
+        return len;
+    }
+
+    va_start(args, format);
+    ret = vsnprintf(buf + len, size - len, format, args);
+    va_end(args);
+
+    if(ret < 0) {
+        return len;
+    }
+    len += (uint32_t)ret;
+
+    return (len < size) ? len : (size - 1U);
+}
+
+/*!
+    \brief      format the pool, heap and driver counters into buf
+    \param[in]  buf: report buffer
+    \param[in]  size: size of the buffer
+    \param[out] none
+    \retval     the length of the report, without the terminating null
+*/
+uint32_t net_stats_report(char *buf, uint32_t size)
+{
+    ethernetif_stats_struct if_stats;
+    ethernetif_rx_checksum_stats_struct checksum_stats;
+    uint32_t len = 0U;
+    uint32_t i;
+
+    if(0U == size) {
+        return 0U;
+    }
+    buf[0] = '\0';
+
+    /* the counters are read without locking, a value may lag one update behind */
+    len = net_stats_append(buf, size, len, "%-16s %6s %6s %6s %6s\r\n", "pool", "used", "max", "avail", "err");
+    for(i = 0U; i < (uint32_t)MEMP_MAX; i++) {
+        const struct stats_mem *pool = lwip_stats.memp[i];
+
+        len = net_stats_append(buf, size, len, "%-16s %6u %6u %6u %6u\r\n", net_stats_pool_names[i],
+                               (unsigned int)pool->used, (unsigned int)pool->max,
+                               (unsigned int)pool->avail, (unsigned int)pool->err);
+    }
+    len = net_stats_append(buf, size, len, "%-16s %6u %6u %6u %6u\r\n", "HEAP",
+                           (unsigned int)lwip_stats.mem.used, (unsigned int)lwip_stats.mem.max,
+                           (unsigned int)lwip_stats.mem.avail, (unsigned int)lwip_stats.mem.err);
+
+#if NO_SYS
+    if(NULL == netif_default) {
+        return len;
+    }
+    ethernetif_stats_get(netif_default, &if_stats);
+    ethernetif_rx_checksum_stats_get(netif_default, &checksum_stats);
+    len = net_stats_append(buf, size, len, "rx drops: nobuf %u, input %u\r\n",
+                           (unsigned int)if_stats.rx_nobuf, (unsigned int)if_stats.rx_input);
+#else
+    ethernetif_stats_get(&if_stats);
+    ethernetif_rx_checksum_stats_get(&checksum_stats);
+    len = net_stats_append(buf, size, len, "rx drops: nobuf %u, error %u, input %u, dma stalls %u\r\n",
+                           (unsigned int)if_stats.rx_nobuf, (unsigned int)if_stats.rx_error,
+                           (unsigned int)if_stats.rx_input, (unsigned int)if_stats.rx_dma_stalls);
+#endif /* NO_SYS */
+    len = net_stats_append(buf, size, len, "rx checksum drops: ip %u, payload %u, software %u\r\n",
+                           (unsigned int)checksum_stats.ip_header_errors, (unsigned int)checksum_stats.payload_errors,
+                           (unsigned int)checksum_stats.software_errors);
+    len = net_stats_append(buf, size, len, "tx: nobuf %u, desc full %u\r\n",
+                           (unsigned int)if_stats.tx_nobuf, (unsigned int)if_stats.tx_desc_full);
+
+    return len;
+}
+
+/*!
+    \brief      answer a datagram with the statistics report
+    \param[in]  arg: user supplied argument
+    \param[in]  pcb: the udp_pcb which received data
+    \param[in]  p: the packet buffer that was received
+    \param[in]  addr: the remote IP address from which the packet was received
+    \param[in]  port: the remote port from which the packet was received
+    \param[out] none
+    \retval     none
+*/
+static void net_stats_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+    struct pbuf *report;
+    uint32_t len;
+
+    LWIP_UNUSED_ARG(arg);
+    pbuf_free(p);
+
+    /* a PBUF_RAM pbuf is contiguous, so the report is formatted in place */
+    report = pbuf_alloc(PBUF_TRANSPORT, NET_STATS_REPORT_SIZE, PBUF_RAM);
+    if(NULL == report) {
+        return;
+    }
+    len = net_stats_report((char *)report->payload, NET_STATS_REPORT_SIZE);
+    pbuf_realloc(report, (u16_t)len);
+
+    udp_sendto(pcb, report, addr, port);
+    pbuf_free(report);
+}
+
+/*!
+    \brief      bind the UDP statistics query port
+    \param[in]  arg: user supplied argument
+    \param[out] none
+    \retval     none
+*/
+static void net_stats_start(void *arg)
+{
+    struct udp_pcb *pcb;
+
+    LWIP_UNUSED_ARG(arg);
+
+    pcb = udp_new();
+    if(NULL == pcb) {
+        printf("net_stats: can not create udp pcb\r\n");
+        return;
+    }
+    if(ERR_OK != udp_bind(pcb, IP_ADDR_ANY, NET_STATS_UDP_PORT)) {
+        printf("net_stats: can not bind port %u\r\n", (unsigned int)NET_STATS_UDP_PORT);
+        udp_remove(pcb);
+        return;
+    }
+    udp_recv(pcb, net_stats_recv, NULL);
+}
+
+/*!
+    \brief      initialize the UDP statistics query
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void net_stats_init(void)
+{
+    /* the status callback runs again on each address change */
+    if(0U != net_stats_started) {
+        return;
+    }
+    net_stats_started = 1U;
+
+#if NO_SYS
+    net_stats_start(NULL);
+#else
+    tcpip_callback(net_stats_start, NULL);
+#endif /* NO_SYS */
+}
@@ -45,6 +45,12 @@ OF SUCH DAMAGE.
 #include <stdio.h>
 #include "lwip/priv/tcp_priv.h"
 #include "lwip/timeouts.h"
+#ifdef USE_DHCP
+#include "dhcp_cache.h"
+#endif /* USE_DHCP */
+#if LWIP_PTP
+#include "ptp_slave.h"
+#endif /* LWIP_PTP */
 
 #define DHCP_TRIES_MAX_TIMES        3
 
@@ -92,6 +98,8 @@ void lwip_stack_init(void)
     gd_ipaddr.addr = 0;
     gd_netmask.addr = 0;
     gd_gw.addr = 0;
+    /* start with the lease of the last boot, if any, so that the services need not wait for DHCP */
+    dhcp_cache_load(&gd_ipaddr, &gd_netmask, &gd_gw);
 #else
     IP4_ADDR(&gd_ipaddr, BOARD_IP_ADDR0, BOARD_IP_ADDR1, BOARD_IP_ADDR2, BOARD_IP_ADDR3);
     IP4_ADDR(&gd_netmask, BOARD_NETMASK_ADDR0, BOARD_NETMASK_ADDR1, BOARD_NETMASK_ADDR2, BOARD_NETMASK_ADDR3);
@@ -100,7 +108,7 @@ void lwip_stack_init(void)
 #endif /* USE_DHCP */
 #ifdef USE_ENET0
     /* add a new network interface */
-    netif_add(&g_mynetif0, &gd_ipaddr, &gd_netmask, &gd_gw, NULL, &ethernetif_init, &ethernet_input);
+    netif_add(&g_mynetif0, &gd_ipaddr, &gd_netmask, &gd_gw, enet_handle_get(ENET0), &ethernetif_init, &ethernet_input);
 
     /* set a default network interface */
     netif_set_default(&g_mynetif0);
@@ -113,14 +121,30 @@ void lwip_stack_init(void)
 
     /* bring an interface up and set the flag of netif as NETIF_FLAG_UP */
     netif_set_up(&g_mynetif0);
+
+#ifdef USE_DHCP
+    /* confirm the cached lease with an INIT-REBOOT request instead of a discovery */
+    if(dhcp_cache_start(&g_mynetif0)) {
+        dhcp_addr_status = DHCP_ADDR_BEGIN;
+    }
+#endif /* USE_DHCP */
 #endif /* USE_ENET0 */
 
 #ifdef USE_ENET1
+#if defined(USE_ENET0) && !defined(USE_DHCP)
+    /* ENET1 is on its own subnet when both interfaces are used */
+    IP4_ADDR(&gd_ipaddr, BOARD_ENET1_IP_ADDR0, BOARD_ENET1_IP_ADDR1, BOARD_ENET1_IP_ADDR2, BOARD_ENET1_IP_ADDR3);
+    IP4_ADDR(&gd_netmask, BOARD_ENET1_NETMASK_ADDR0, BOARD_ENET1_NETMASK_ADDR1, BOARD_ENET1_NETMASK_ADDR2, BOARD_ENET1_NETMASK_ADDR3);
+    IP4_ADDR(&gd_gw, BOARD_ENET1_GW_ADDR0, BOARD_ENET1_GW_ADDR1, BOARD_ENET1_GW_ADDR2, BOARD_ENET1_GW_ADDR3);
+#endif /* USE_ENET0 && !USE_DHCP */
+
     /* add a new network interface */
-    netif_add(&g_mynetif1, &gd_ipaddr, &gd_netmask, &gd_gw, NULL, &ethernetif_init, &ethernet_input);
+    netif_add(&g_mynetif1, &gd_ipaddr, &gd_netmask, &gd_gw, enet_handle_get(ENET1), &ethernetif_init, &ethernet_input);
 
-    /* set a default network interface */
+#ifndef USE_ENET0
+    /* set a default network interface, ENET0 stays the default when both are used */
     netif_set_default(&g_mynetif1);
+#endif /* USE_ENET0 */
 
     /* set a callback when interface is up/down */
     netif_set_status_callback(&g_mynetif1, lwip_netif_status_callback);
@@ -130,7 +154,19 @@ void lwip_stack_init(void)
 
     /* bring an interface up and set the flag of netif as NETIF_FLAG_UP */
     netif_set_up(&g_mynetif1);
+
+#ifdef USE_DHCP
+    /* confirm the cached lease with an INIT-REBOOT request instead of a discovery */
+    if(dhcp_cache_start(&g_mynetif1)) {
+        dhcp_addr_status = DHCP_ADDR_BEGIN;
+    }
+#endif /* USE_DHCP */
 #endif /* USE_ENET1 */
+
+#if LWIP_PTP
+    /* synchronize the PTP clock of the default interface */
+    ptp_slave_init(netif_default, (&g_mynetif0 == netif_default) ? ENET0 : ENET1);
+#endif /* LWIP_PTP */
 }
 
 /*!
@@ -165,6 +201,11 @@ void lwip_frame_recv1(void)
 */
 void lwip_timeouts_check(__IO uint32_t curtime)
 {
+#if TCP_QUEUE_OOSEQ
+    /* give the out of order segments back to the pbuf pool if it ran dry */
+    PBUF_CHECK_FREE_OOSEQ();
+#endif /* TCP_QUEUE_OOSEQ */
+
 #if LWIP_TCP
     /* called periodically to dispatch TCP timers every 250 ms */
     if(curtime - tcpcurtime >= TCP_TMR_INTERVAL) {
@@ -230,11 +271,13 @@ void lwip_dhcp_address_get(void)
         break;
 
     case DHCP_ADDR_BEGIN:
-        /* got the IP address */
+        /* got the IP address, a cached address is in use before DHCP binds it */
         ip_address.addr = g_mynetif0.ip_addr.addr;
 
-        if(0 != ip_address.addr) {
+        if(dhcp_supplied_address(&g_mynetif0)) {
             dhcp_addr_status = DHCP_ADDR_GOT;
+            /* keep the lease and the neighbours for the next boot */
+            dhcp_cache_save(&g_mynetif0);
 
             printf("\r\nDHCP -- eval board ip address: %d.%d.%d.%d \r\n", ip4_addr1_16(&ip_address), \
                    ip4_addr2_16(&ip_address), ip4_addr3_16(&ip_address), ip4_addr4_16(&ip_address));
@@ -245,6 +288,7 @@ void lwip_dhcp_address_get(void)
                 dhcp_addr_status = DHCP_ADDR_FAIL;
                 /* stop DHCP */
                 dhcp_stop(&g_mynetif0);
+                dhcp_cache_stop(&g_mynetif0);
 
                 /* use static address as IP address */
                 IP4_ADDR(&gd_ipaddr, BOARD_IP_ADDR0, BOARD_IP_ADDR1, BOARD_IP_ADDR2, BOARD_IP_ADDR3);
@@ -268,11 +312,13 @@ void lwip_dhcp_address_get(void)
         break;
 
     case DHCP_ADDR_BEGIN:
-        /* got the IP address */
+        /* got the IP address, a cached address is in use before DHCP binds it */
         ip_address.addr = g_mynetif1.ip_addr.addr;
 
-        if(0 != ip_address.addr) {
+        if(dhcp_supplied_address(&g_mynetif1)) {
             dhcp_addr_status = DHCP_ADDR_GOT;
+            /* keep the lease and the neighbours for the next boot */
+            dhcp_cache_save(&g_mynetif1);
 
             printf("\r\nDHCP -- eval board ip address: %d.%d.%d.%d \r\n", ip4_addr1_16(&ip_address), \
                    ip4_addr2_16(&ip_address), ip4_addr3_16(&ip_address), ip4_addr4_16(&ip_address));
@@ -283,6 +329,7 @@ void lwip_dhcp_address_get(void)
                 dhcp_addr_status = DHCP_ADDR_FAIL;
                 /* stop DHCP */
                 dhcp_stop(&g_mynetif1);
+                dhcp_cache_stop(&g_mynetif1);
 
                 /* use static address as IP address */
                 IP4_ADDR(&gd_ipaddr, BOARD_IP_ADDR0, BOARD_IP_ADDR1, BOARD_IP_ADDR2, BOARD_IP_ADDR3);
@@ -0,0 +1,155 @@
+/*!
+    \file    ptp_servo.c
+    \brief   PI clock servo of the PTP slave
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+#include "ptp_servo.h"
+
+static double ptp_servo_clamp(double value, double limit);
+
+/*!
+    \brief      limit a value to the range from -limit to limit
+    \param[in]  value: the value to limit
+    \param[in]  limit: the largest magnitude allowed
+    \param[out] none
+    \retval     the limited value
+*/
+static double ptp_servo_clamp(double value, double limit)
+{
+    if(value > limit) {
+        return limit;
+    }
+    if(value < -limit) {
+        return -limit;
+    }
+    return value;
+}
+
+/*!
+    \brief      initialize the servo
+    \param[in]  servo: the servo to initialize
+    \param[in]  kp: proportional constant, ppb per ns of offset
+    \param[in]  ki: integral constant, ppb per ns of offset and second
+    \param[in]  max_ppb: largest frequency adjustment, ppb
+    \param[in]  step_threshold: offsets beyond this step the clock, ns
+    \param[out] none
+    \retval     none
+*/
+void ptp_servo_init(ptp_servo_struct *servo, double kp, double ki, double max_ppb, int64_t step_threshold)
+{
+    servo->kp = kp;
+    servo->ki = ki;
+    servo->max_ppb = max_ppb;
+    servo->step_threshold = step_threshold;
+    ptp_servo_reset(servo);
+}
+
+/*!
+    \brief      forget the integral term and start over
+    \param[in]  servo: the servo to reset
+    \param[out] none
+    \retval     none
+*/
+void ptp_servo_reset(ptp_servo_struct *servo)
+{
+    servo->integral = 0.0;
+    servo->first_offset = 0;
+    servo->sample_count = 0U;
+    servo->state = PTP_SERVO_UNLOCKED;
+}
+
+/*!
+    \brief      feed a clock offset to the servo and get the frequency adjustment
+    \param[in]  servo: the servo
+    \param[in]  offset: slave time minus master time, ns
+    \param[in]  interval: time since the previous sample, s
+    \param[out] freq_ppb: frequency adjustment to apply to the slave clock, ppb
+    \retval     PTP_SERVO_UNLOCKED: apply freq_ppb, the frequency is being estimated
+                PTP_SERVO_JUMP: apply freq_ppb and step the clock by -offset
+                PTP_SERVO_LOCKED: apply freq_ppb
+*/
+ptp_servo_state_enum ptp_servo_sample(ptp_servo_struct *servo, int64_t offset, double interval, double *freq_ppb)
+{
+    int64_t magnitude = (offset < 0) ? -offset : offset;
+
+    switch(servo->sample_count) {
+    case 0U:
+        servo->first_offset = offset;
+        servo->sample_count = 1U;
+        servo->state = PTP_SERVO_UNLOCKED;
+        *freq_ppb = servo->integral;
+        break;
+
+    case 1U:
+        /* the drift between the first two samples gives the frequency error, a drift of 1 ns/s is 1 ppb */
+        servo->integral = ptp_servo_clamp(servo->integral - ((double)(offset - servo->first_offset) / interval), servo->max_ppb);
+        servo->sample_count = 2U;
+        servo->state = (magnitude > servo->step_threshold) ? PTP_SERVO_JUMP : PTP_SERVO_LOCKED;
+        *freq_ppb = servo->integral;
+        break;
+
+    default:
+        /* a large offset restarts the estimation, which ends with a step */
+        if(magnitude > servo->step_threshold) {
+            servo->sample_count = 0U;
+            return ptp_servo_sample(servo, offset, interval, freq_ppb);
+        }
+        /* a clock ahead of the master has to run slower, clamping the integral term avoids windup */
+        servo->integral = ptp_servo_clamp(servo->integral - (servo->ki * (double)offset * interval), servo->max_ppb);
+        servo->state = PTP_SERVO_LOCKED;
+        *freq_ppb = ptp_servo_clamp(servo->integral - (servo->kp * (double)offset), servo->max_ppb);
+        break;
+    }
+
+    return servo->state;
+}
+
+/*!
+    \brief      scale the nominal timestamp addend by a frequency adjustment
+    \param[in]  base_addend: the addend which runs the clock at the nominal rate
+    \param[in]  freq_ppb: frequency adjustment, ppb
+    \param[out] none
+    \retval     the adjusted addend
+*/
+uint32_t ptp_servo_addend_calc(uint32_t base_addend, double freq_ppb)
+{
+    double addend = (double)base_addend * (1.0 + (freq_ppb / 1000000000.0));
+
+    if(addend >= 4294967295.0) {
+        return 0xFFFFFFFFU;
+    }
+    if(addend <= 0.0) {
+        return 0U;
+    }
+    return (uint32_t)(addend + 0.5);
+}
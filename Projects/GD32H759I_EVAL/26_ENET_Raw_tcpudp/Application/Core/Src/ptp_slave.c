@@ -0,0 +1,597 @@
+/*!
+    \file    ptp_slave.c
+    \brief   IEEE 1588 (PTPv2) end-to-end slave clock over ethernet and UDP
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+#include "ptp_slave.h"
+#include "lwip/udp.h"
+#include "lwip/prot/ethernet.h"
+#include "gd32h7xx_enet.h"
+#include "ethernetif.h"
+#include <string.h>
+
+/* PTP domain followed by the slave */
+#ifndef PTP_SLAVE_DOMAIN
+#define PTP_SLAVE_DOMAIN                 0U
+#endif
+/* interval of the Delay_Req messages, in ms */
+#ifndef PTP_SLAVE_DELAY_REQ_INTERVAL
+#define PTP_SLAVE_DELAY_REQ_INTERVAL     1000U
+#endif
+/* the master is released when no Sync has come from it for this time, in ms */
+#ifndef PTP_SLAVE_MASTER_TIMEOUT
+#define PTP_SLAVE_MASTER_TIMEOUT         5000U
+#endif
+/* servo constants, offsets beyond PTP_SLAVE_STEP_THRESHOLD ns step the clock */
+#ifndef PTP_SLAVE_SERVO_KP
+#define PTP_SLAVE_SERVO_KP               0.7
+#endif
+#ifndef PTP_SLAVE_SERVO_KI
+#define PTP_SLAVE_SERVO_KI               0.3
+#endif
+#ifndef PTP_SLAVE_SERVO_MAX_PPB
+#define PTP_SLAVE_SERVO_MAX_PPB          500000.0
+#endif
+#ifndef PTP_SLAVE_STEP_THRESHOLD
+#define PTP_SLAVE_STEP_THRESHOLD         20000
+#endif
+
+/* PTP message types */
+#define PTP_MSG_SYNC                     0x0U
+#define PTP_MSG_DELAY_REQ                0x1U
+#define PTP_MSG_FOLLOW_UP                0x8U
+#define PTP_MSG_DELAY_RESP               0x9U
+
+/* PTP message layout */
+#define PTP_VERSION                      2U
+#define PTP_HEADER_LEN                   34U
+#define PTP_EVENT_MSG_LEN                44U                    /* Sync, Delay_Req and Follow_Up */
+#define PTP_DELAY_RESP_LEN               54U
+#define PTP_PORT_IDENTITY_LEN            10U
+#define PTP_FLAG_TWO_STEP                0x02U                  /* in the first octet of the flag field */
+#define PTP_CONTROL_DELAY_REQ            0x01U
+#define PTP_LOG_INTERVAL_UNKNOWN         0x7F
+
+/* PTP transports */
+#define PTP_TRANSPORT_L2                 0U
+#define PTP_TRANSPORT_UDP                1U
+#define PTP_EVENT_PORT                   319U
+#define PTP_GENERAL_PORT                 320U
+#define PTP_ETHTYPE                      0x88F7U
+
+/* PTP slave state */
+typedef struct {
+    struct netif *netif;                                        /*!< interface whose clock is synchronized */
+    uint32_t enet_periph;                                       /*!< ENET with the PTP clock */
+    struct udp_pcb *event_pcb;                                  /*!< UDP port 319 */
+    struct udp_pcb *general_pcb;                                /*!< UDP port 320 */
+    ip_addr_t udp_multicast;                                    /*!< 224.0.1.129 */
+    uint32_t base_addend;                                       /*!< addend of the nominal clock rate */
+    ptp_servo_struct servo;                                     /*!< clock servo */
+    uint8_t port_identity[PTP_PORT_IDENTITY_LEN];               /*!< clock identity and port number of the slave */
+    uint32_t localtime;                                         /*!< last time passed to ptp_slave_timer(), ms */
+
+    uint8_t master_valid;                                       /*!< a master is followed */
+    uint8_t master_transport;                                   /*!< transport the master uses */
+    uint8_t master_identity[PTP_PORT_IDENTITY_LEN];             /*!< port identity of the master */
+    uint32_t master_time;                                       /*!< localtime of the last Sync of the master */
+    double sync_interval;                                       /*!< Sync interval announced by the master, s */
+
+    uint8_t sync_pending;                                       /*!< a two-step Sync waits for its Follow_Up */
+    uint16_t sync_seq;                                          /*!< sequence ID of the pending Sync */
+    int64_t sync_rx_time;                                       /*!< receive timestamp t2 of the pending Sync, ns */
+    int64_t sync_correction;                                    /*!< correction field of the pending Sync, ns */
+
+    uint8_t ms_valid;                                           /*!< ms_delay is valid */
+    int64_t ms_delay;                                           /*!< master to slave delay t2 - t1 of the last Sync, ns */
+
+    uint8_t delay_req_pending;                                  /*!< a Delay_Req waits for its Delay_Resp */
+    uint16_t delay_req_seq;                                     /*!< sequence ID of the last Delay_Req */
+    int64_t delay_req_tx_time;                                  /*!< transmit timestamp t3 of the last Delay_Req, ns */
+    uint32_t delay_req_time;                                    /*!< localtime of the last Delay_Req */
+
+    uint8_t path_delay_valid;                                   /*!< path_delay is valid */
+    int64_t path_delay;                                         /*!< mean path delay, ns */
+
+    ptp_slave_stats_struct stats;                               /*!< offset and path delay statistics */
+} ptp_slave_struct;
+
+static ptp_slave_struct ptp_slave;
+
+/* destination MAC address of the PTP messages sent over ethernet */
+static const uint8_t ptp_l2_multicast[ETH_HWADDR_LEN] = {0x01U, 0x1BU, 0x19U, 0x00U, 0x00U, 0x00U};
+
+static void ptp_message_input(const uint8_t *msg, uint16_t len, int64_t rx_time, uint8_t transport);
+static void ptp_sync_complete(int64_t origin_time, int64_t rx_time, int64_t correction);
+static void ptp_delay_req_send(void);
+static void ptp_master_release(void);
+static void ptp_udp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port);
+
+/*!
+    \brief      read a big endian 16-bit field
+    \param[in]  data: the field
+    \param[out] none
+    \retval     the field value
+*/
+static uint16_t ptp_get16(const uint8_t *data)
+{
+    return (uint16_t)(((uint16_t)data[0] << 8) | data[1]);
+}
+
+/*!
+    \brief      read a PTP timestamp field, 48-bit seconds and 32-bit nanoseconds
+    \param[in]  data: the field
+    \param[out] none
+    \retval     the timestamp in ns
+*/
+static int64_t ptp_timestamp_get(const uint8_t *data)
+{
+    uint64_t second = 0U;
+    uint32_t nanosecond = 0U;
+    uint8_t i;
+
+    for(i = 0U; i < 6U; i++) {
+        second = (second << 8) | data[i];
+    }
+    for(i = 6U; i < 10U; i++) {
+        nanosecond = (nanosecond << 8) | data[i];
+    }
+
+    return (int64_t)(second * 1000000000U) + (int64_t)nanosecond;
+}
+
+/*!
+    \brief      read the correction field of a PTP message
+    \param[in]  msg: the PTP message
+    \param[out] none
+    \retval     the correction in ns
+*/
+static int64_t ptp_correction_get(const uint8_t *msg)
+{
+    uint64_t correction = 0U;
+    uint8_t i;
+
+    /* the field holds ns multiplied by 2^16 */
+    for(i = 8U; i < 16U; i++) {
+        correction = (correction << 8) | msg[i];
+    }
+
+    return (int64_t)correction / 65536;
+}
+
+/*!
+    \brief      get the hardware timestamp the ethernetif port took for a pbuf
+    \param[in]  p: the pbuf
+    \param[out] none
+    \retval     the timestamp in ns, 0 if there is none
+*/
+static int64_t ptp_pbuf_time_get(const struct pbuf *p)
+{
+    uint32_t sec, nsec;
+
+    if(0 == ethernetif_ptp_timestamp_get(p, &sec, &nsec)) {
+        return 0;
+    }
+    return ((int64_t)sec * 1000000000) + (int64_t)nsec;
+}
+
+/*!
+    \brief      convert the logMessageInterval field of a PTP message to seconds
+    \param[in]  log_interval: log2 of the interval
+    \param[out] none
+    \retval     the interval in s
+*/
+static double ptp_log_interval_get(int8_t log_interval)
+{
+    double interval = 1.0;
+
+    if((PTP_LOG_INTERVAL_UNKNOWN == log_interval) || (log_interval > 4) || (log_interval < -7)) {
+        return interval;
+    }
+    for(; log_interval > 0; log_interval--) {
+        interval *= 2.0;
+    }
+    for(; log_interval < 0; log_interval++) {
+        interval /= 2.0;
+    }
+
+    return interval;
+}
+
+/*!
+    \brief      step the PTP clock
+    \param[in]  offset: slave time minus master time, ns
+    \param[out] none
+    \retval     none
+*/
+static void ptp_clock_step(int64_t offset)
+{
+    enet_ptp_systime_struct systime;
+    uint64_t magnitude = (offset < 0) ? (uint64_t)(-offset) : (uint64_t)offset;
+
+    systime.second = (uint32_t)(magnitude / 1000000000U);
+    systime.nanosecond = (uint32_t)(magnitude % 1000000000U);
+    /* a clock ahead of the master is moved back */
+    systime.sign = (offset > 0) ? ENET_PTP_TIME_NEGATIVE : ENET_PTP_TIME_POSITIVE;
+    enet_ptp_coarsecorrection_systime_update(ptp_slave.enet_periph, &systime);
+}
+
+/*!
+    \brief      add an offset to the offset statistics
+    \param[in]  offset: slave time minus master time, ns
+    \param[out] none
+    \retval     none
+*/
+static void ptp_offset_stats_update(int64_t offset)
+{
+    ptp_slave_stats_struct *stats = &ptp_slave.stats;
+
+    if((0U == stats->offset_samples) || (offset < stats->offset_min)) {
+        stats->offset_min = offset;
+    }
+    if((0U == stats->offset_samples) || (offset > stats->offset_max)) {
+        stats->offset_max = offset;
+    }
+    stats->offset_abs_sum += (offset < 0) ? (uint64_t)(-offset) : (uint64_t)offset;
+    stats->offset_samples++;
+}
+
+/*!
+    \brief      run the servo with a Sync whose origin timestamp is known
+    \param[in]  origin_time: origin timestamp t1 of the master, ns
+    \param[in]  rx_time: receive timestamp t2 of the slave, ns
+    \param[in]  correction: correction of the Sync and Follow_Up, ns
+    \param[out] none
+    \retval     none
+*/
+static void ptp_sync_complete(int64_t origin_time, int64_t rx_time, int64_t correction)
+{
+    ptp_servo_state_enum state;
+    int64_t offset;
+    double freq_ppb;
+
+    ptp_slave.ms_delay = rx_time - origin_time - correction;
+    ptp_slave.ms_valid = 1U;
+    ptp_slave.stats.sync_count++;
+
+    /* until the first Delay_Resp the path delay is counted as offset */
+    offset = ptp_slave.ms_delay;
+    if(0U != ptp_slave.path_delay_valid) {
+        offset -= ptp_slave.path_delay;
+    }
+    ptp_slave.stats.offset = offset;
+
+    state = ptp_servo_sample(&ptp_slave.servo, offset, ptp_slave.sync_interval, &freq_ppb);
+    enet_ptp_finecorrection_adjfreq(ptp_slave.enet_periph, (int32_t)ptp_servo_addend_calc(ptp_slave.base_addend, freq_ppb));
+    if(PTP_SERVO_JUMP == state) {
+        ptp_clock_step(offset);
+        ptp_slave.stats.step_count++;
+        ptp_slave.stats.offset_samples = 0U;
+        ptp_slave.stats.offset_abs_sum = 0U;
+        /* the timestamps taken before the step are useless */
+        ptp_slave.ms_valid = 0U;
+        ptp_slave.delay_req_pending = 0U;
+    } else if(PTP_SERVO_LOCKED == state) {
+        ptp_offset_stats_update(offset);
+    }
+    ptp_slave.stats.freq_ppb = freq_ppb;
+    ptp_slave.stats.servo_state = state;
+}
+
+/*!
+    \brief      process a PTP message
+    \param[in]  msg: the PTP message
+    \param[in]  len: length of the message
+    \param[in]  rx_time: hardware receive timestamp of the frame, ns
+    \param[in]  transport: PTP_TRANSPORT_L2 or PTP_TRANSPORT_UDP
+    \param[out] none
+    \retval     none
+*/
+static void ptp_message_input(const uint8_t *msg, uint16_t len, int64_t rx_time, uint8_t transport)
+{
+    uint16_t seq;
+    int64_t delay;
+
+    if((len < PTP_HEADER_LEN) || (PTP_VERSION != (msg[1] & 0x0FU)) || (PTP_SLAVE_DOMAIN != msg[4])) {
+        return;
+    }
+    seq = ptp_get16(&msg[30]);
+
+    switch(msg[0] & 0x0FU) {
+    case PTP_MSG_SYNC:
+        if(len < PTP_EVENT_MSG_LEN) {
+            break;
+        }
+        /* follow the first master heard until it goes silent */
+        if(0U == ptp_slave.master_valid) {
+            memcpy(ptp_slave.master_identity, &msg[20], PTP_PORT_IDENTITY_LEN);
+            ptp_slave.master_transport = transport;
+            ptp_slave.master_valid = 1U;
+            ptp_slave.stats.master_change_count++;
+        } else if((transport != ptp_slave.master_transport) || (0 != memcmp(ptp_slave.master_identity, &msg[20], PTP_PORT_IDENTITY_LEN))) {
+            break;
+        }
+        ptp_slave.master_time = ptp_slave.localtime;
+        ptp_slave.sync_interval = ptp_log_interval_get((int8_t)msg[33]);
+        if(0 == rx_time) {
+            break;
+        }
+
+        if(0U != (msg[6] & PTP_FLAG_TWO_STEP)) {
+            /* the origin timestamp comes with the Follow_Up */
+            ptp_slave.sync_pending = 1U;
+            ptp_slave.sync_seq = seq;
+            ptp_slave.sync_rx_time = rx_time;
+            ptp_slave.sync_correction = ptp_correction_get(msg);
+        } else {
+            ptp_slave.sync_pending = 0U;
+            ptp_sync_complete(ptp_timestamp_get(&msg[34]), rx_time, ptp_correction_get(msg));
+        }
+        break;
+
+    case PTP_MSG_FOLLOW_UP:
+        if((len < PTP_EVENT_MSG_LEN) || (0U == ptp_slave.sync_pending) || (seq != ptp_slave.sync_seq) ||
+                (0 != memcmp(ptp_slave.master_identity, &msg[20], PTP_PORT_IDENTITY_LEN))) {
+            break;
+        }
+        ptp_slave.sync_pending = 0U;
+        ptp_sync_complete(ptp_timestamp_get(&msg[34]), ptp_slave.sync_rx_time, ptp_slave.sync_correction + ptp_correction_get(msg));
+        break;
+
+    case PTP_MSG_DELAY_RESP:
+        if((len < PTP_DELAY_RESP_LEN) || (0U == ptp_slave.delay_req_pending) || (seq != ptp_slave.delay_req_seq) ||
+                (0 != memcmp(ptp_slave.port_identity, &msg[44], PTP_PORT_IDENTITY_LEN))) {
+            break;
+        }
+        ptp_slave.delay_req_pending = 0U;
+        ptp_slave.stats.delay_resp_count++;
+
+        /* mean path delay from t2 - t1 of the last Sync and t4 - t3 of this exchange */
+        if(0U != ptp_slave.ms_valid) {
+            delay = (ptp_slave.ms_delay + (ptp_timestamp_get(&msg[34]) - ptp_slave.delay_req_tx_time - ptp_correction_get(msg))) / 2;
+            if(delay >= 0) {
+                ptp_slave.path_delay = delay;
+                ptp_slave.path_delay_valid = 1U;
+                ptp_slave.stats.path_delay = delay;
+            }
+        }
+        break;
+
+    default:
+        /* the first master heard is followed, so Announce and the other messages are not needed */
+        break;
+    }
+}
+
+/*!
+    \brief      send a Delay_Req to the master and take its transmit timestamp
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void ptp_delay_req_send(void)
+{
+    uint8_t msg[PTP_EVENT_MSG_LEN];
+    struct pbuf *p;
+    uint8_t *frame;
+
+    ptp_slave.delay_req_time = ptp_slave.localtime;
+    ptp_slave.delay_req_pending = 0U;
+    ptp_slave.delay_req_seq++;
+
+    memset(msg, 0, sizeof(msg));
+    msg[0] = PTP_MSG_DELAY_REQ;
+    msg[1] = PTP_VERSION;
+    msg[2] = (uint8_t)(PTP_EVENT_MSG_LEN >> 8);
+    msg[3] = (uint8_t)PTP_EVENT_MSG_LEN;
+    msg[4] = PTP_SLAVE_DOMAIN;
+    memcpy(&msg[20], ptp_slave.port_identity, PTP_PORT_IDENTITY_LEN);
+    msg[30] = (uint8_t)(ptp_slave.delay_req_seq >> 8);
+    msg[31] = (uint8_t)ptp_slave.delay_req_seq;
+    msg[32] = PTP_CONTROL_DELAY_REQ;
+    msg[33] = (uint8_t)PTP_LOG_INTERVAL_UNKNOWN;
+
+    if(PTP_TRANSPORT_L2 == ptp_slave.master_transport) {
+        p = pbuf_alloc(PBUF_RAW, SIZEOF_ETH_HDR + PTP_EVENT_MSG_LEN, PBUF_RAM);
+        if(NULL == p) {
+            return;
+        }
+        frame = (uint8_t *)p->payload;
+        memcpy(&frame[0], ptp_l2_multicast, ETH_HWADDR_LEN);
+        memcpy(&frame[ETH_HWADDR_LEN], ptp_slave.netif->hwaddr, ETH_HWADDR_LEN);
+        frame[12] = (uint8_t)(PTP_ETHTYPE >> 8);
+        frame[13] = (uint8_t)PTP_ETHTYPE;
+        memcpy(&frame[SIZEOF_ETH_HDR], msg, PTP_EVENT_MSG_LEN);
+        ptp_slave.netif->linkoutput(ptp_slave.netif, p);
+    } else {
+        p = pbuf_alloc(PBUF_TRANSPORT, PTP_EVENT_MSG_LEN, PBUF_RAM);
+        if((NULL == p) || (NULL == ptp_slave.event_pcb)) {
+            if(NULL != p) {
+                pbuf_free(p);
+            }
+            return;
+        }
+        memcpy(p->payload, msg, PTP_EVENT_MSG_LEN);
+        udp_sendto(ptp_slave.event_pcb, p, &ptp_slave.udp_multicast, PTP_EVENT_PORT);
+    }
+
+    /* the driver has taken the transmit timestamp t3 of the pbuf */
+    ptp_slave.delay_req_tx_time = ptp_pbuf_time_get(p);
+    ptp_slave.delay_req_pending = (0 != ptp_slave.delay_req_tx_time) ? 1U : 0U;
+    pbuf_free(p);
+}
+
+/*!
+    \brief      stop following the master and start over with the next one
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void ptp_master_release(void)
+{
+    ptp_slave.master_valid = 0U;
+    ptp_slave.sync_pending = 0U;
+    ptp_slave.ms_valid = 0U;
+    ptp_slave.delay_req_pending = 0U;
+    ptp_slave.path_delay_valid = 0U;
+    ptp_slave.stats.master_change_count++;
+    ptp_servo_reset(&ptp_slave.servo);
+    ptp_slave.stats.servo_state = ptp_slave.servo.state;
+}
+
+/*!
+    \brief      called when a PTP message is received on UDP port 319 or 320
+    \param[in]  arg: the user argument
+    \param[in]  pcb: the udp_pcb that has received the data
+    \param[in]  p: the packet buffer
+    \param[in]  addr: pointer on the receive IP address
+    \param[in]  port: receive port number
+    \param[out] none
+    \retval     none
+*/
+static void ptp_udp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+    uint8_t msg[PTP_DELAY_RESP_LEN];
+    uint16_t len;
+
+    if(p != NULL) {
+        len = pbuf_copy_partial(p, msg, sizeof(msg), 0U);
+        ptp_message_input(msg, len, ptp_pbuf_time_get(p), PTP_TRANSPORT_UDP);
+        pbuf_free(p);
+    }
+}
+
+/*!
+    \brief      take the PTP frames sent over ethernet, called by the LwIP unknown ethernet protocol hook
+    \param[in]  p: the received frame, the payload points to the ethernet header
+    \param[in]  netif: the interface which received the frame
+    \param[out] none
+    \retval     ERR_OK if the frame was taken and freed, ERR_VAL if it is not a PTP frame
+*/
+err_t ptp_slave_l2_input(struct pbuf *p, struct netif *netif)
+{
+    uint8_t frame[SIZEOF_ETH_HDR + PTP_DELAY_RESP_LEN];
+    uint16_t len;
+
+    if(netif != ptp_slave.netif) {
+        return ERR_VAL;
+    }
+    len = pbuf_copy_partial(p, frame, sizeof(frame), 0U);
+    if((len < SIZEOF_ETH_HDR) || (PTP_ETHTYPE != ptp_get16(&frame[12]))) {
+        return ERR_VAL;
+    }
+
+    ptp_message_input(&frame[SIZEOF_ETH_HDR], (uint16_t)(len - SIZEOF_ETH_HDR), ptp_pbuf_time_get(p), PTP_TRANSPORT_L2);
+    pbuf_free(p);
+
+    return ERR_OK;
+}
+
+/*!
+    \brief      handle the Delay_Req and master timeouts
+    \param[in]  localtime: the current time, ms
+    \param[out] none
+    \retval     none
+*/
+void ptp_slave_timer(uint32_t localtime)
+{
+    ptp_slave.localtime = localtime;
+
+    if(0U == ptp_slave.master_valid) {
+        return;
+    }
+    if((localtime - ptp_slave.master_time) >= PTP_SLAVE_MASTER_TIMEOUT) {
+        ptp_master_release();
+        return;
+    }
+    /* measure the path delay once a Sync has been taken */
+    if((0U != ptp_slave.ms_valid) && ((localtime - ptp_slave.delay_req_time) >= PTP_SLAVE_DELAY_REQ_INTERVAL)) {
+        ptp_delay_req_send();
+    }
+}
+
+/*!
+    \brief      get the offset and path delay statistics
+    \param[in]  none
+    \param[out] stats: the statistics
+    \retval     none
+*/
+void ptp_slave_stats_get(ptp_slave_stats_struct *stats)
+{
+    *stats = ptp_slave.stats;
+}
+
+/*!
+    \brief      initialize the PTP slave on an interface
+    \param[in]  netif: the interface whose ENET runs the PTP clock
+    \param[in]  enet_periph: ENETx(x=0,1)
+    \param[out] none
+    \retval     none
+*/
+void ptp_slave_init(struct netif *netif, uint32_t enet_periph)
+{
+    memset(&ptp_slave, 0, sizeof(ptp_slave));
+    ptp_slave.netif = netif;
+    ptp_slave.enet_periph = enet_periph;
+    ptp_slave.sync_interval = 1.0;
+
+    /* the driver has programmed the addend of the nominal clock rate */
+    ptp_slave.base_addend = ENET_PTP_TSADDEND(enet_periph);
+    ptp_servo_init(&ptp_slave.servo, PTP_SLAVE_SERVO_KP, PTP_SLAVE_SERVO_KI, PTP_SLAVE_SERVO_MAX_PPB, PTP_SLAVE_STEP_THRESHOLD);
+    ptp_slave.stats.servo_state = ptp_slave.servo.state;
+
+    /* EUI-64 clock identity from the MAC address, port number 1 */
+    ptp_slave.port_identity[0] = netif->hwaddr[0];
+    ptp_slave.port_identity[1] = netif->hwaddr[1];
+    ptp_slave.port_identity[2] = netif->hwaddr[2];
+    ptp_slave.port_identity[3] = 0xFFU;
+    ptp_slave.port_identity[4] = 0xFEU;
+    ptp_slave.port_identity[5] = netif->hwaddr[3];
+    ptp_slave.port_identity[6] = netif->hwaddr[4];
+    ptp_slave.port_identity[7] = netif->hwaddr[5];
+    ptp_slave.port_identity[8] = 0x00U;
+    ptp_slave.port_identity[9] = 0x01U;
+
+    /* the PTP messages over UDP go to 224.0.1.129 */
+    IP_ADDR4(&ptp_slave.udp_multicast, 224, 0, 1, 129);
+    ptp_slave.event_pcb = udp_new();
+    if(NULL != ptp_slave.event_pcb) {
+        udp_bind(ptp_slave.event_pcb, IP_ADDR_ANY, PTP_EVENT_PORT);
+        udp_recv(ptp_slave.event_pcb, ptp_udp_recv, NULL);
+    }
+    ptp_slave.general_pcb = udp_new();
+    if(NULL != ptp_slave.general_pcb) {
+        udp_bind(ptp_slave.general_pcb, IP_ADDR_ANY, PTP_GENERAL_PORT);
+        udp_recv(ptp_slave.general_pcb, ptp_udp_recv, NULL);
+    }
+}
@@ -37,6 +37,10 @@
  */
 
 #include "lwip/mem.h"
+#include "lwip/sys.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/prot/ip.h"
+#include "lwip/prot/ip4.h"
 #include "netif/etharp.h"
 #include "ethernetif.h"
 #include "gd32h7xx_enet.h"
@@ -48,23 +52,265 @@
 #define IFNAME0 'G'
 #define IFNAME1 'D'
 
-/* ENET RxDMA/TxDMA descriptor */
-extern enet_descriptors_struct  rxdesc_tab[ENET_RXBUF_NUM], txdesc_tab[ENET_TXBUF_NUM];
+/** Set this to 1 to chain the pbufs of an outgoing frame across several ENET
+ * Tx descriptors instead of copying them into one tx_buff slot. The pbufs are
+ * referenced until the DMA has sent the frame.
+ */
+#ifndef ETHERNETIF_TX_SCATTER_GATHER
+#define ETHERNETIF_TX_SCATTER_GATHER              0
+#endif
+
+/** Set this to 1 to check in software the IPv4 header and TCP or UDP checksums
+ * of the frames the ENET checksum offload has bypassed, e.g. for IP options.
+ * Frames the ENET found a checksum error in are always dropped.
+ * Only used with CHECKSUM_BY_HARDWARE.
+ */
+#ifndef ETHERNETIF_RX_CHECKSUM_FALLBACK
+#define ETHERNETIF_RX_CHECKSUM_FALLBACK           1
+#endif
 
-/* ENET receive buffer  */
-extern uint8_t rx_buff[ENET_RXBUF_NUM][ENET_RXBUF_SIZE];
+#if ETHERNETIF_TX_SCATTER_GATHER && defined(SELECT_DESCRIPTORS_ENHANCED_MODE)
+#error "ETHERNETIF_TX_SCATTER_GATHER does not support SELECT_DESCRIPTORS_ENHANCED_MODE"
+#endif
 
-/* ENET transmit buffer */
-extern uint8_t tx_buff[ENET_TXBUF_NUM][ENET_TXBUF_SIZE];
+#if LWIP_PTP && !defined(SELECT_DESCRIPTORS_ENHANCED_MODE)
+#error "LWIP_PTP needs the timestamps of SELECT_DESCRIPTORS_ENHANCED_MODE"
+#endif
+
+#if LWIP_PTP
+/** Subsecond increment of the PTP clock, in 2^-31 s units. The addend is
+ * computed from it so that the clock runs at the nominal rate.
+ */
+#ifndef ETHERNETIF_PTP_SUBSECOND_INCREMENT
+#define ETHERNETIF_PTP_SUBSECOND_INCREMENT        43U
+#endif
+
+/* hardware timestamp of a frame, kept here so that struct pbuf stays untouched */
+typedef struct {
+    const struct pbuf *p;                                       /*!< the frame, NULL when the slot is empty */
+    uint32_t sec;                                               /*!< seconds */
+    uint32_t nsec;                                              /*!< nanoseconds */
+} ptp_stamp_struct;
+
+/* the received frame being passed to the stack */
+static ptp_stamp_struct ptp_rx_stamp;
+/* the last PTP event message sent */
+static ptp_stamp_struct ptp_tx_stamp;
+#endif /* LWIP_PTP */
+
+#if defined(USE_ENET0) && defined(USE_ENET1) && (ENET_INSTANCE_NUM < 2U)
+#error "using ENET0 and ENET1 at the same time requires ENET_INSTANCE_NUM to be 2"
+#endif
 
-/*global transmit and receive descriptors pointers */
-extern enet_descriptors_struct  *dma_current_txdesc;
-extern enet_descriptors_struct  *dma_current_rxdesc;
+#ifdef USE_ENET0
+#define ETHERNETIF_ENET                           ENET0
+#else
+#define ETHERNETIF_ENET                           ENET1
+#endif /* USE_ENET0 */
 
 /* preserve another ENET RxDMA/TxDMA ptp descriptor for normal mode */
 enet_descriptors_struct  ptp_txstructure[ENET_TXBUF_NUM];
 enet_descriptors_struct  ptp_rxstructure[ENET_RXBUF_NUM];
 
+#if ETHERNETIF_TX_SCATTER_GATHER
+/* frames with more pbufs than this are sent from a single pbuf copy */
+#define ETHERNETIF_TX_MAX_SEGMENTS                ENET_TXBUF_NUM
+#endif /* ETHERNETIF_TX_SCATTER_GATHER */
+
+/* state of one interface, kept in netif->state */
+typedef struct {
+    enet_handle_struct *handle;                                 /*!< ENET instance of the interface */
+#if ETHERNETIF_TX_SCATTER_GATHER
+    struct pbuf *tx_pbuf[ENET_TXBUF_NUM];                       /*!< pbuf held by the last Tx descriptor of each frame until it is sent */
+    enet_descriptors_struct *tx_reclaim_desc;                   /*!< oldest Tx descriptor handed to the DMA and not reclaimed yet */
+    uint32_t tx_busy_count;                                     /*!< Tx descriptors handed to the DMA and not reclaimed yet */
+#endif /* ETHERNETIF_TX_SCATTER_GATHER */
+#ifdef CHECKSUM_BY_HARDWARE
+    ethernetif_rx_checksum_stats_struct rx_checksum;            /*!< Rx checksum offload counters */
+#endif /* CHECKSUM_BY_HARDWARE */
+    ethernetif_stats_struct stats;                              /*!< drop and stall counters */
+} ethernetif_struct;
+
+/* one interface state for each of ENET0 and ENET1 */
+static ethernetif_struct ethernetif_tab[2];
+
+#if ETHERNETIF_TX_SCATTER_GATHER
+static void tx_buffer_reclaim(ethernetif_struct *ethernetif);
+#endif /* ETHERNETIF_TX_SCATTER_GATHER */
+
+#ifdef CHECKSUM_BY_HARDWARE
+#if ETHERNETIF_RX_CHECKSUM_FALLBACK
+/**
+ * Check in software the IPv4 header and the TCP or UDP checksum of a frame
+ * the ENET checksum offload has bypassed. Fragments are left to the stack,
+ * their payload checksum covers the whole datagram.
+ *
+ * @param p the received frame, starting with the ethernet header
+ * @param stats the counters to update
+ * @return 1 if the checksums are right or cannot be checked here, 0 otherwise
+ */
+static int rx_checksum_software_check(struct pbuf *p, ethernetif_rx_checksum_stats_struct *stats)
+{
+    struct eth_hdr *ethhdr = (struct eth_hdr *)p->payload;
+    struct ip_hdr *iphdr;
+    ip4_addr_t src, dest;
+    u16_t hlen, len;
+    u8_t proto;
+    int reval = 1;
+
+    if((p->len < (SIZEOF_ETH_HDR + IP_HLEN)) || (PP_HTONS(ETHTYPE_IP) != ethhdr->type)) {
+        return 1;
+    }
+
+    iphdr = (struct ip_hdr *)((u8_t *)p->payload + SIZEOF_ETH_HDR);
+    hlen = IPH_HL_BYTES(iphdr);
+    len = lwip_ntohs(IPH_LEN(iphdr));
+    /* malformed headers are dropped by the stack */
+    if((hlen < IP_HLEN) || (p->len < (SIZEOF_ETH_HDR + hlen)) || (len < hlen) || (len > (p->tot_len - SIZEOF_ETH_HDR))) {
+        return 1;
+    }
+
+    stats->software_checked++;
+    if(0U != inet_chksum(iphdr, hlen)) {
+        return 0;
+    }
+
+    proto = IPH_PROTO(iphdr);
+    if((0U != (IPH_OFFSET(iphdr) & PP_HTONS(IP_OFFMASK | IP_MF))) || ((IP_PROTO_TCP != proto) && (IP_PROTO_UDP != proto))) {
+        return 1;
+    }
+
+    /* the pseudo header checksum runs over the transport header and payload, without the ethernet padding */
+    ip4_addr_copy(src, iphdr->src);
+    ip4_addr_copy(dest, iphdr->dest);
+    if(0U == pbuf_remove_header(p, SIZEOF_ETH_HDR + hlen)) {
+        /* a UDP checksum of 0 means the sender did not compute one */
+        if((IP_PROTO_TCP == proto) || (p->len < 8U) || (0U != (((u8_t *)p->payload)[6] | ((u8_t *)p->payload)[7]))) {
+            if(0U != inet_chksum_pseudo_partial(p, proto, (u16_t)(len - hlen), (u16_t)(len - hlen), &src, &dest)) {
+                reval = 0;
+            }
+        }
+        pbuf_add_header(p, SIZEOF_ETH_HDR + hlen);
+    }
+
+    return reval;
+}
+#endif /* ETHERNETIF_RX_CHECKSUM_FALLBACK */
+
+/**
+ * Read the result of the ENET Rx checksum offload for a frame and count it.
+ * The frames the ENET could not verify are checked in software if
+ * ETHERNETIF_RX_CHECKSUM_FALLBACK is set.
+ *
+ * @param desc the Rx descriptor of the frame, still holding its status
+ * @param p the received frame
+ * @param stats the counters to update
+ * @return 1 if the frame may be passed to the stack, 0 if it has to be dropped
+ */
+static int rx_checksum_check(const enet_descriptors_struct *desc, struct pbuf *p, ethernetif_rx_checksum_stats_struct *stats)
+{
+    uint32_t header_error, payload_error, verified;
+
+#ifdef SELECT_DESCRIPTORS_ENHANCED_MODE
+    /* the extended status is only written for IP frames */
+    if((uint32_t)RESET == (desc->status & ENET_RDES0_EXSV)) {
+        return 1;
+    }
+    header_error = desc->extended_status & ENET_RDES4_IPHERR;
+    payload_error = desc->extended_status & ENET_RDES4_IPPLDERR;
+    verified = ((uint32_t)RESET == (desc->extended_status & ENET_RDES4_IPCKSB)) && (0U != GET_RDES4_IPPLDT(desc->extended_status));
+#else
+    /* the frame type, IP header error and payload error bits together give the result */
+    switch(desc->status & (ENET_RDES0_FRMT | ENET_RDES0_IPHERR | ENET_RDES0_PCERR)) {
+    case ENET_RDES0_PCERR:
+        /* IP frame with a right header and a payload the ENET does not check */
+        header_error = 0U;
+        payload_error = 0U;
+        verified = 0U;
+        break;
+    case (ENET_RDES0_FRMT | ENET_RDES0_IPHERR):
+    case (ENET_RDES0_FRMT | ENET_RDES0_PCERR):
+    case (ENET_RDES0_FRMT | ENET_RDES0_IPHERR | ENET_RDES0_PCERR):
+        header_error = desc->status & ENET_RDES0_IPHERR;
+        payload_error = desc->status & ENET_RDES0_PCERR;
+        verified = 1U;
+        break;
+    default:
+        /* IP frame without checksum error, or a frame which is not IP */
+        return 1;
+    }
+#endif /* SELECT_DESCRIPTORS_ENHANCED_MODE */
+
+    if(0U != header_error) {
+        stats->ip_header_errors++;
+    }
+    if(0U != payload_error) {
+        stats->payload_errors++;
+    }
+    if((0U != header_error) || (0U != payload_error)) {
+        LINK_STATS_INC(link.chkerr);
+        return 0;
+    }
+
+    if(0U == verified) {
+        stats->unverified++;
+#if ETHERNETIF_RX_CHECKSUM_FALLBACK
+        if(0 == rx_checksum_software_check(p, stats)) {
+            stats->software_errors++;
+            LINK_STATS_INC(link.chkerr);
+            return 0;
+        }
+#endif /* ETHERNETIF_RX_CHECKSUM_FALLBACK */
+    }
+
+    return 1;
+}
+#endif /* CHECKSUM_BY_HARDWARE */
+
+#if LWIP_PTP
+/**
+ * Store a hardware timestamp of the ENET for a frame.
+ *
+ * @param stamp the slot to fill
+ * @param p the pbuf of the frame
+ * @param timestamp the subseconds and seconds taken from the descriptor
+ */
+static void ptp_timestamp_set(ptp_stamp_struct *stamp, const struct pbuf *p, const uint32_t timestamp[2])
+{
+    stamp->sec = timestamp[1];
+    stamp->nsec = enet_ptp_subsecond_2_nanosecond(timestamp[0] & 0x7FFFFFFFU);
+    stamp->p = p;
+}
+
+/**
+ * Check if a frame is a PTP event message, which needs a transmit timestamp:
+ * an ethernet frame of EtherType 0x88F7 or an IPv4 UDP datagram to port 319.
+ *
+ * @param frame the ethernet frame
+ * @param length length of the frame
+ * @return 1 if the frame is a PTP event message, 0 otherwise
+ */
+static int ptp_event_frame_check(const uint8_t *frame, int length)
+{
+    uint32_t ihl;
+
+    if(length < 15) {
+        return 0;
+    }
+    if((0x88U == frame[12]) && (0xF7U == frame[13])) {
+        /* the event messages are the message types below 8 */
+        return (frame[14] & 0x08U) ? 0 : 1;
+    }
+    if((0x08U == frame[12]) && (0x00U == frame[13]) && (17U == frame[23])) {
+        ihl = (uint32_t)(frame[14] & 0x0FU) * 4U;
+        if(length >= (int)(14U + ihl + 4U)) {
+            return ((0x01U == frame[14U + ihl + 2U]) && (0x3FU == frame[14U + ihl + 3U])) ? 1 : 0;
+        }
+    }
+    return 0;
+}
+#endif /* LWIP_PTP */
+
 /**
  * In this function, the hardware should be initialized.
  * Called from ethernetif_init().
@@ -74,9 +320,10 @@ enet_descriptors_struct  ptp_rxstructure[ENET_RXBUF_NUM];
  */
 static void low_level_init(struct netif *netif)
 {
-#ifdef CHECKSUM_BY_HARDWARE
+    ethernetif_struct *ethernetif = (ethernetif_struct *)netif->state;
+    enet_handle_struct *handle = ethernetif->handle;
     int i;
-#endif /* CHECKSUM_BY_HARDWARE */
+
     /* set MAC hardware address length */
     netif->hwaddr_len = ETHARP_HWADDR_LEN;
 
@@ -87,15 +334,9 @@ static void low_level_init(struct netif *netif)
     netif->hwaddr[3] =  BOARD_MAC_ADDR3;
     netif->hwaddr[4] =  BOARD_MAC_ADDR4;
     netif->hwaddr[5] =  BOARD_MAC_ADDR5;
-#ifdef USE_ENET0
-    /* initialize MAC address in ethernet MAC */
-    enet_mac_address_set(ENET0, ENET_MAC_ADDRESS0, netif->hwaddr);
-#endif /* USE_ENET0 */
-#ifdef USE_ENET1
-    /* initialize MAC address in ethernet MAC */
-    enet_mac_address_set(ENET1, ENET_MAC_ADDRESS0, netif->hwaddr);
-#endif /* USE_ENET1 */
 
+    /* initialize MAC address in ethernet MAC */
+    enet_mac_address_set(handle->periph, ENET_MAC_ADDRESS0, netif->hwaddr);
 
     /* maximum transfer unit */
     netif->mtu = 1500;
@@ -104,61 +345,78 @@ static void low_level_init(struct netif *netif)
     /* don't set NETIF_FLAG_ETHARP if this device is not an ethernet one */
     netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_LINK_UP;
 
-#ifdef USE_ENET0
-    /* initialize descriptors list: chain/ring mode */
-#ifdef SELECT_DESCRIPTORS_ENHANCED_MODE
-    enet_ptp_enhanced_descriptors_chain_init(ENET0, ENET_DMA_TX);
-    enet_ptp_enhanced_descriptors_chain_init(ENET0, ENET_DMA_RX);
-#else
-    enet_descriptors_chain_init(ENET0, ENET_DMA_TX);
-    enet_descriptors_chain_init(ENET0, ENET_DMA_RX);
-
-//    enet_descriptors_ring_init(ENET0, ENET_DMA_TX);
-//    enet_descriptors_ring_init(ENET0, ENET_DMA_RX);
-#endif /* SELECT_DESCRIPTORS_ENHANCED_MODE */
-#endif /* USE_ENET0 */
-
-#ifdef USE_ENET1
     /* initialize descriptors list: chain/ring mode */
 #ifdef SELECT_DESCRIPTORS_ENHANCED_MODE
-    enet_ptp_enhanced_descriptors_chain_init(ENET1, ENET_DMA_TX);
-    enet_ptp_enhanced_descriptors_chain_init(ENET1, ENET_DMA_RX);
+    enet_handle_ptp_enhanced_descriptors_chain_init(handle, ENET_DMA_TX);
+    enet_handle_ptp_enhanced_descriptors_chain_init(handle, ENET_DMA_RX);
 #else
-    enet_descriptors_chain_init(ENET1, ENET_DMA_TX);
-    enet_descriptors_chain_init(ENET1, ENET_DMA_RX);
+    enet_handle_descriptors_chain_init(handle, ENET_DMA_TX);
+    enet_handle_descriptors_chain_init(handle, ENET_DMA_RX);
 
-//    enet_descriptors_ring_init(ENET1, ENET_DMA_TX);
-//    enet_descriptors_ring_init(ENET1, ENET_DMA_RX);
+//    enet_handle_descriptors_ring_init(handle, ENET_DMA_TX);
+//    enet_handle_descriptors_ring_init(handle, ENET_DMA_RX);
 #endif /* SELECT_DESCRIPTORS_ENHANCED_MODE */
-#endif /* USE_ENET1 */
 
     /* enable ethernet Rx interrrupt */
-    {
-        int i;
-        for(i = 0; i < ENET_RXBUF_NUM; i++) {
-            enet_rx_desc_immediate_receive_complete_interrupt(&rxdesc_tab[i]);
-        }
+    for(i = 0; i < ENET_RXBUF_NUM; i++) {
+        enet_rx_desc_immediate_receive_complete_interrupt(&handle->rxdesc_tab[i]);
     }
 
 #ifdef CHECKSUM_BY_HARDWARE
     /* enable the TCP, UDP and ICMP checksum insertion for the Tx frames */
     for(i = 0; i < ENET_TXBUF_NUM; i++) {
-        enet_transmit_checksum_config(&txdesc_tab[i], ENET_CHECKSUM_TCPUDPICMP_FULL);
+        enet_transmit_checksum_config(&handle->txdesc_tab[i], ENET_CHECKSUM_TCPUDPICMP_FULL);
     }
 #endif /* CHECKSUM_BY_HARDWARE */
 
+#if ETHERNETIF_TX_SCATTER_GATHER
+    /* start reclaiming from the first Tx descriptor */
+    ethernetif->tx_reclaim_desc = handle->txdesc_current;
+    ethernetif->tx_busy_count = 0U;
+#endif /* ETHERNETIF_TX_SCATTER_GATHER */
+
+#if LWIP_PTP
+    /* the PTP messages over UDP and ethernet are multicast */
+    enet_fliter_feature_enable(handle->periph, ENET_MULTICAST_FILTER_PASS);
+    /* run the PTP clock at the nominal rate in fine mode, timestamping all frames */
+    enet_ptp_start(handle->periph, ENET_PTP_FINEMODE, 0U, 0U,
+                   (uint32_t)((1ULL << 63) / ((uint64_t)ETHERNETIF_PTP_SUBSECOND_INCREMENT * rcu_clock_freq_get(CK_AHB))),
+                   ETHERNETIF_PTP_SUBSECOND_INCREMENT);
+#endif /* LWIP_PTP */
+
     /* note: TCP, UDP, ICMP checksum checking for received frame are enabled in DMA config */
-#ifdef USE_ENET0
     /* enable MAC and DMA transmission and reception */
-    enet_enable(ENET0);
-#endif /* USE_ENET0 */
+    enet_enable(handle->periph);
+}
 
-#ifdef USE_ENET1
-    /* enable MAC and DMA transmission and reception */
-    enet_enable(ENET1);
-#endif /* USE_ENET1 */
+#if ETHERNETIF_TX_SCATTER_GATHER
+/**
+ * Tell whether a Tx frame must be sent from a copy: its chain is longer than
+ * the Tx ring, or one of its pbufs references volatile data (PBUF_REF) which
+ * the caller may reuse as soon as the output call returns.
+ *
+ * @param p the frame to send
+ * @return 1 if the frame must be copied, 0 if its pbufs can be referenced
+ */
+static int tx_frame_needs_copy(struct pbuf *p)
+{
+    struct pbuf *q;
+
+    if(pbuf_clen(p) > ETHERNETIF_TX_MAX_SEGMENTS) {
+        return 1;
+    }
+
+    for(q = p; q != NULL; q = q->next) {
+        if(PBUF_NEEDS_COPY(q)) {
+            return 1;
+        }
+    }
+
+    return 0;
 }
 
+#endif /* ETHERNETIF_TX_SCATTER_GATHER */
+
 /**
  * This function should do the actual transmission of the packet. The packet is
  * contained in the pbuf that is passed to the function. This pbuf
@@ -173,24 +431,119 @@ static void low_level_init(struct netif *netif)
  *       strange results. You might consider waiting for space in the DMA queue
  *       to become availale since the stack doesn't retry to send a packet
  *       dropped because of memory failure (except for the TCP timers).
+ *       The copy path therefore waits for the Tx descriptor. The scatter-gather
+ *       path never spins: it reclaims the descriptors the DMA has released and
+ *       returns ERR_MEM at once if too few are free, so a bare-metal main loop
+ *       is not stalled; TCP retransmits the segment from its timers, other
+ *       frames are dropped.
  */
 
+#if ETHERNETIF_TX_SCATTER_GATHER
 static err_t low_level_output(struct netif *netif, struct pbuf *p)
 {
+    ethernetif_struct *ethernetif = (ethernetif_struct *)netif->state;
+    enet_frame_segment_struct segment[ETHERNETIF_TX_MAX_SEGMENTS];
+    enet_descriptors_struct *last_desc = NULL;
     struct pbuf *q;
-    int framelength = 0;
-    uint8_t *buffer;
+    uint32_t num = 0U;
+    uint32_t start;
+    err_t errval = ERR_MEM;
+
+    SYS_ARCH_DECL_PROTECT(sr);
+
+    /* a frame which cannot be referenced until the DMA has sent it is sent from a flattened copy */
+    if(tx_frame_needs_copy(p)) {
+        p = pbuf_clone(PBUF_RAW, PBUF_RAM, p);
+        if(NULL == p) {
+            ethernetif->stats.tx_nobuf++;
+            LINK_STATS_INC(link.memerr);
+            return ERR_MEM;
+        }
+    } else {
+        pbuf_ref(p);
+    }
 
-    while((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_DAV)) {
+    /* describe the payload of every pbuf and make it visible to the DMA */
+    for(q = p; q != NULL; q = q->next) {
+        if(0U == q->len) {
+            continue;
+        }
+        segment[num].buffer_addr = (uint32_t)q->payload;
+        segment[num].length = q->len;
+        start = (uint32_t)q->payload & ~31U;
+        SCB_CleanDCache_by_Addr((uint32_t *)start, (int32_t)((uint32_t)q->payload + q->len - start));
+        num++;
     }
 
-#ifdef USE_ENET0
-    buffer = (uint8_t *)(enet_desc_information_get(ENET0, dma_current_txdesc, TXDESC_BUFFER_1_ADDR));
-#endif /* USE_ENET0 */
+    /* note: padding and CRC for transmitted frame
+       are automatically inserted by DMA */
+
+    SYS_ARCH_PROTECT(sr);
+    tx_buffer_reclaim(ethernetif);
+    /* never wait for the DMA, TCP retransmits the segment later if the descriptors are still busy */
+    if((ENET_TXBUF_NUM - ethernetif->tx_busy_count) < num) {
+        ethernetif->stats.tx_desc_full++;
+    }
+    if((ENET_TXBUF_NUM - ethernetif->tx_busy_count) >= num) {
+        if(SUCCESS == enet_handle_frame_segments_transmit(ethernetif->handle, segment, num, &last_desc)) {
+            /* the pbuf is released by tx_buffer_reclaim() once the last descriptor is sent */
+            ethernetif->tx_pbuf[last_desc - ethernetif->handle->txdesc_tab] = p;
+            ethernetif->tx_busy_count += num;
+            errval = ERR_OK;
+        }
+    }
+    SYS_ARCH_UNPROTECT(sr);
 
-#ifdef USE_ENET1
-    buffer = (uint8_t *)(enet_desc_information_get(ENET1, dma_current_txdesc, TXDESC_BUFFER_1_ADDR));
-#endif /* USE_ENET1 */
+    if(ERR_OK != errval) {
+        pbuf_free(p);
+        LINK_STATS_INC(link.memerr);
+    }
+
+    return errval;
+}
+
+/**
+ * Release the pbufs of the frames which the Tx DMA has finished with.
+ *
+ * @param ethernetif the interface state
+ */
+static void tx_buffer_reclaim(ethernetif_struct *ethernetif)
+{
+    enet_descriptors_struct *desc;
+    uint32_t index;
+
+    desc = ethernetif->tx_reclaim_desc;
+    while((0U != ethernetif->tx_busy_count) && ((uint32_t)RESET == (desc->status & ENET_TDES0_DAV))) {
+        index = (uint32_t)(desc - ethernetif->handle->txdesc_tab);
+        if(NULL != ethernetif->tx_pbuf[index]) {
+            pbuf_free(ethernetif->tx_pbuf[index]);
+            ethernetif->tx_pbuf[index] = NULL;
+        }
+        desc = (enet_descriptors_struct *)(desc->buffer2_next_desc_addr);
+        ethernetif->tx_busy_count--;
+    }
+    ethernetif->tx_reclaim_desc = desc;
+}
+#else
+static err_t low_level_output(struct netif *netif, struct pbuf *p)
+{
+    ethernetif_struct *ethernetif = (ethernetif_struct *)netif->state;
+    enet_handle_struct *handle = ethernetif->handle;
+    struct pbuf *q;
+    int framelength = 0;
+    uint8_t *buffer;
+#if LWIP_PTP
+    uint32_t timestamp[2];
+#endif /* LWIP_PTP */
+
+    if((uint32_t)RESET != (handle->txdesc_current->status & ENET_TDES0_DAV)) {
+        /* the frame waits for the DMA to release the descriptor */
+        ethernetif->stats.tx_desc_full++;
+        while((uint32_t)RESET != (handle->txdesc_current->status & ENET_TDES0_DAV)) {
+        }
+    }
+
+    buffer = (uint8_t *)(enet_desc_information_get(handle->periph, handle->txdesc_current, TXDESC_BUFFER_1_ADDR));
 
     /* copy frame from pbufs to driver buffers */
     for(q = p; q != NULL; q = q->next) {
@@ -201,26 +554,26 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
     /* note: padding and CRC for transmitted frame
        are automatically inserted by DMA */
 
-#ifdef USE_ENET0
-    /* transmit descriptors to give to DMA */
-#ifdef SELECT_DESCRIPTORS_ENHANCED_MODE
-    ENET_NOCOPY_PTPFRAME_TRANSMIT_ENHANCED_MODE(ENET0, framelength, NULL);
-#else
-    ENET_NOCOPY_FRAME_TRANSMIT(ENET0, framelength);
-#endif /* SELECT_DESCRIPTORS_ENHANCED_MODE */
-#endif /* USE_ENET0 */
-
-#ifdef USE_ENET1
     /* transmit descriptors to give to DMA */
-#ifdef SELECT_DESCRIPTORS_ENHANCED_MODE
-    ENET_NOCOPY_PTPFRAME_TRANSMIT_ENHANCED_MODE(ENET1, framelength, NULL);
+#if LWIP_PTP
+    /* only the PTP event messages wait for their transmit timestamp */
+    if(ptp_event_frame_check(buffer, framelength)) {
+        ptp_tx_stamp.p = NULL;
+        if(SUCCESS == ENET_HANDLE_NOCOPY_PTPFRAME_TRANSMIT_ENHANCED_MODE(handle, framelength, timestamp)) {
+            ptp_timestamp_set(&ptp_tx_stamp, p, timestamp);
+        }
+    } else {
+        ENET_HANDLE_NOCOPY_PTPFRAME_TRANSMIT_ENHANCED_MODE(handle, framelength, NULL);
+    }
+#elif defined(SELECT_DESCRIPTORS_ENHANCED_MODE)
+    ENET_HANDLE_NOCOPY_PTPFRAME_TRANSMIT_ENHANCED_MODE(handle, framelength, NULL);
 #else
-    ENET_NOCOPY_FRAME_TRANSMIT(ENET1, framelength);
+    ENET_HANDLE_NOCOPY_FRAME_TRANSMIT(handle, framelength);
 #endif /* SELECT_DESCRIPTORS_ENHANCED_MODE */
-#endif /* USE_ENET1 */
 
     return ERR_OK;
 }
+#endif /* ETHERNETIF_TX_SCATTER_GATHER */
 
 /**
  * Should allocate a pbuf and transfer the bytes of the incoming
@@ -232,24 +585,21 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
  */
 static struct pbuf *low_level_input(struct netif *netif)
 {
+    ethernetif_struct *ethernetif = (ethernetif_struct *)netif->state;
+    enet_handle_struct *handle = ethernetif->handle;
     struct pbuf *p, *q;
     u16_t len;
     int l = 0;
     uint8_t *buffer;
+#if LWIP_PTP
+    uint32_t timestamp[2];
+#endif /* LWIP_PTP */
 
     p = NULL;
 
-#ifdef USE_ENET0
     /* obtain the size of the packet and put it into the "len" variable. */
-    len = enet_desc_information_get(ENET0, dma_current_rxdesc, RXDESC_FRAME_LENGTH);
-    buffer = (uint8_t *)(enet_desc_information_get(ENET0, dma_current_rxdesc, RXDESC_BUFFER_1_ADDR));
-#endif /* USE_ENET0 */
-
-#ifdef USE_ENET1
-    /* obtain the size of the packet and put it into the "len" variable. */
-    len = enet_desc_information_get(ENET1, dma_current_rxdesc, RXDESC_FRAME_LENGTH);
-    buffer = (uint8_t *)(enet_desc_information_get(ENET1, dma_current_rxdesc, RXDESC_BUFFER_1_ADDR));
-#endif /* USE_ENET1 */
+    len = enet_desc_information_get(handle->periph, handle->rxdesc_current, RXDESC_FRAME_LENGTH);
+    buffer = (uint8_t *)(enet_desc_information_get(handle->periph, handle->rxdesc_current, RXDESC_BUFFER_1_ADDR));
 
     /* we allocate a pbuf chain of pbufs from the Lwip buffer pool */
     p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
@@ -260,23 +610,33 @@ static struct pbuf *low_level_input(struct netif *netif)
             memcpy((uint8_t *)q->payload, (u8_t *)&buffer[l], q->len);
             l = l + q->len;
         }
+    } else {
+        ethernetif->stats.rx_nobuf++;
     }
 
-#ifdef USE_ENET0
-#ifdef SELECT_DESCRIPTORS_ENHANCED_MODE
-    ENET_NOCOPY_PTPFRAME_RECEIVE_ENHANCED_MODE(ENET0, NULL);
-#else
-    ENET_NOCOPY_FRAME_RECEIVE(ENET0);
-#endif /* SELECT_DESCRIPTORS_ENHANCED_MODE */
-#endif /* USE_ENET0 */
+#ifdef CHECKSUM_BY_HARDWARE
+    /* drop the frames with a checksum error before they reach the stack */
+    if((NULL != p) && (0 == rx_checksum_check(handle->rxdesc_current, p, &ethernetif->rx_checksum))) {
+        LINK_STATS_INC(link.drop);
+        pbuf_free(p);
+        p = NULL;
+    }
+#endif /* CHECKSUM_BY_HARDWARE */
 
-#ifdef USE_ENET1
-#ifdef SELECT_DESCRIPTORS_ENHANCED_MODE
-    ENET_NOCOPY_PTPFRAME_RECEIVE_ENHANCED_MODE(ENET1, NULL);
+#if LWIP_PTP
+    /* the driver waits for the timestamp, so ask for it only when the DMA has written it */
+    if((NULL != p) && ((uint32_t)RESET != (handle->rxdesc_current->status & ENET_RDES0_TSV))) {
+        if(SUCCESS == ENET_HANDLE_NOCOPY_PTPFRAME_RECEIVE_ENHANCED_MODE(handle, timestamp)) {
+            ptp_timestamp_set(&ptp_rx_stamp, p, timestamp);
+        }
+    } else {
+        ENET_HANDLE_NOCOPY_PTPFRAME_RECEIVE_ENHANCED_MODE(handle, NULL);
+    }
+#elif defined(SELECT_DESCRIPTORS_ENHANCED_MODE)
+    ENET_HANDLE_NOCOPY_PTPFRAME_RECEIVE_ENHANCED_MODE(handle, NULL);
 #else
-    ENET_NOCOPY_FRAME_RECEIVE(ENET1);
+    ENET_HANDLE_NOCOPY_FRAME_RECEIVE(handle);
 #endif /* SELECT_DESCRIPTORS_ENHANCED_MODE */
-#endif /* USE_ENET1 */
 
     return p;
 }
@@ -295,6 +655,17 @@ err_t ethernetif_input(struct netif *netif)
     err_t err;
     struct pbuf *p;
 
+#if ETHERNETIF_TX_SCATTER_GATHER
+    {
+        SYS_ARCH_DECL_PROTECT(sr);
+
+        /* release the Tx pbufs sent meanwhile, so they are not held until the next output */
+        SYS_ARCH_PROTECT(sr);
+        tx_buffer_reclaim((ethernetif_struct *)netif->state);
+        SYS_ARCH_UNPROTECT(sr);
+    }
+#endif /* ETHERNETIF_TX_SCATTER_GATHER */
+
     /* move received packet into a new pbuf */
     p = low_level_input(netif);
 
@@ -305,15 +676,46 @@ err_t ethernetif_input(struct netif *netif)
 
     /* entry point to the LwIP stack */
     err = netif->input(p, netif);
+#if LWIP_PTP
+    /* the stack has consumed the frame, its pbuf may be reused from now on */
+    ptp_rx_stamp.p = NULL;
+#endif /* LWIP_PTP */
 
     if(err != ERR_OK) {
         LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: IP input error\n"));
+        ((ethernetif_struct *)netif->state)->stats.rx_input++;
         pbuf_free(p);
         p = NULL;
     }
     return err;
 }
 
+/**
+ * This function copies the Rx checksum offload counters of an interface.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param stats the structure to fill, zeroed without CHECKSUM_BY_HARDWARE
+ */
+void ethernetif_rx_checksum_stats_get(struct netif *netif, ethernetif_rx_checksum_stats_struct *stats)
+{
+#ifdef CHECKSUM_BY_HARDWARE
+    *stats = ((ethernetif_struct *)netif->state)->rx_checksum;
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif /* CHECKSUM_BY_HARDWARE */
+}
+
+/**
+ * This function copies the drop and stall counters of an interface.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param stats the structure to fill
+ */
+void ethernetif_stats_get(struct netif *netif, ethernetif_stats_struct *stats)
+{
+    *stats = ((ethernetif_struct *)netif->state)->stats;
+}
+
 /**
  * Should be called at the beginning of the program to set up the
  * network interface. It calls the function low_level_init() to do the
@@ -328,8 +730,18 @@ err_t ethernetif_input(struct netif *netif)
  */
 err_t ethernetif_init(struct netif *netif)
 {
+    enet_handle_struct *handle;
+
     LWIP_ASSERT("netif != NULL", (netif != NULL));
 
+    /* the ENET instance is given as the netif state, otherwise the configured ENET is used */
+    handle = (enet_handle_struct *)netif->state;
+    if(NULL == handle) {
+        handle = enet_handle_get(ETHERNETIF_ENET);
+    }
+    netif->state = &ethernetif_tab[(ENET1 == handle->periph) ? 1 : 0];
+    ((ethernetif_struct *)netif->state)->handle = handle;
+
 #if LWIP_NETIF_HOSTNAME
     /* Initialize interface hostname */
     netif->hostname = "Gigadevice.COM_lwip";
@@ -350,3 +762,30 @@ err_t ethernetif_init(struct netif *netif)
     return ERR_OK;
 }
 
+#if LWIP_PTP
+/**
+ * This function gets the hardware timestamp of a PTP frame. Only the frame
+ * being passed to the stack and the last PTP event message sent have one.
+ *
+ * @param p the first pbuf of the frame
+ * @param sec where to store the seconds
+ * @param nsec where to store the nanoseconds
+ * @return 1 if the frame has a timestamp, 0 otherwise
+ */
+int ethernetif_ptp_timestamp_get(const struct pbuf *p, uint32_t *sec, uint32_t *nsec)
+{
+    const ptp_stamp_struct *stamp;
+
+    if((NULL != p) && (p == ptp_rx_stamp.p)) {
+        stamp = &ptp_rx_stamp;
+    } else if((NULL != p) && (p == ptp_tx_stamp.p)) {
+        stamp = &ptp_tx_stamp;
+    } else {
+        return 0;
+    }
+
+    *sec = stamp->sec;
+    *nsec = stamp->nsec;
+    return 1;
+}
+#endif /* LWIP_PTP */
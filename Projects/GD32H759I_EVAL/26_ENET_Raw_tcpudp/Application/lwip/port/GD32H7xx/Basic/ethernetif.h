@@ -5,7 +5,35 @@
 #include "lwip/err.h"
 #include "lwip/netif.h"
 
+/* LWIP_PTP==1: the port timestamps the received frames and the sent PTP event messages */
+#ifndef LWIP_PTP
+#define LWIP_PTP                0
+#endif
+
+/* Rx checksum offload counters of the interface */
+typedef struct {
+    uint32_t ip_header_errors;                                  /*!< frames dropped for an IP header checksum error */
+    uint32_t payload_errors;                                    /*!< frames dropped for a TCP, UDP or ICMP checksum error */
+    uint32_t unverified;                                        /*!< IP frames the ENET did not fully check */
+    uint32_t software_checked;                                  /*!< unverified frames checked in software */
+    uint32_t software_errors;                                   /*!< frames dropped by the software check */
+} ethernetif_rx_checksum_stats_struct;
+
+/* drop and stall counters of the interface */
+typedef struct {
+    uint32_t rx_nobuf;                                          /*!< frames dropped because the pbuf pool was empty */
+    uint32_t rx_input;                                          /*!< frames the stack refused */
+    uint32_t tx_nobuf;                                          /*!< frames dropped because no pbuf could flatten them */
+    uint32_t tx_desc_full;                                      /*!< frames which found too few free Tx descriptors */
+} ethernetif_stats_struct;
+
 err_t ethernetif_init(struct netif *netif);
 err_t ethernetif_input(struct netif *netif);
+void ethernetif_rx_checksum_stats_get(struct netif *netif, ethernetif_rx_checksum_stats_struct *stats);
+void ethernetif_stats_get(struct netif *netif, ethernetif_stats_struct *stats);
+
+#if LWIP_PTP
+int ethernetif_ptp_timestamp_get(const struct pbuf *p, uint32_t *sec, uint32_t *nsec);
+#endif /* LWIP_PTP */
 
 #endif
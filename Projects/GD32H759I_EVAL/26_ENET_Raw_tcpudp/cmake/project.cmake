@@ -1,9 +1,33 @@
+# ENET DMA descriptor ring sizes, the rings and their buffers are placed in the .dma_nocache section
+set(ENET_RXBUF_NUM 32 CACHE STRING "Number of ENET Rx DMA descriptors (4 to 128, the rings must fit RAM_NOCACHE in the linker script)")
+set(ENET_TXBUF_NUM 32 CACHE STRING "Number of ENET Tx DMA descriptors (4 to 128, the rings must fit RAM_NOCACHE in the linker script)")
+foreach(ENET_RING ENET_RXBUF_NUM ENET_TXBUF_NUM)
+    if(NOT "${${ENET_RING}}" MATCHES "^[0-9]+$" OR ${${ENET_RING}} LESS 4 OR ${${ENET_RING}} GREATER 128)
+        message(FATAL_ERROR "${ENET_RING} must be a number from 4 to 128, got '${${ENET_RING}}'")
+    endif()
+endforeach()
+
+# IEEE 1588 slave clock, the timestamps are carried by the enhanced DMA descriptors
+option(ENET_PTP "Timestamp the ENET frames and run the PTP slave clock" OFF)
+
+# iperf 2 throughput test: lwiperf TCP server and client, then a UDP run to the remote host
+option(ENET_LWIPERF "Build the iperf TCP server, TCP client and UDP blaster" OFF)
+
+# high-throughput TCP profile: large scaled windows, lwIP heap and pools in the EXMC SDRAM
+option(ENET_HIGH_THROUGHPUT "Use large TCP windows with the lwIP heap and pools in SDRAM" OFF)
+
 function(project_add_target_properties TARGET_NAME)
 
 target_compile_definitions(${TARGET_NAME} PRIVATE
     "$<$<CONFIG:Debug>:DEBUG>"
     "$<$<NOT:$<CONFIG:Debug>>:RELEASE>"
 	GD32H7XX
+	ENET_RXBUF_NUM=${ENET_RXBUF_NUM}U
+	ENET_TXBUF_NUM=${ENET_TXBUF_NUM}U
+	"$<$<BOOL:${ENET_PTP}>:SELECT_DESCRIPTORS_ENHANCED_MODE>"
+	"$<$<BOOL:${ENET_PTP}>:LWIP_PTP=1>"
+	"$<$<BOOL:${ENET_LWIPERF}>:LWIP_IPERF=1>"
+	"$<$<BOOL:${ENET_HIGH_THROUGHPUT}>:LWIP_HIGH_THROUGHPUT=1>"
 	)
 
 target_compile_options(${TARGET_NAME} PRIVATE
@@ -75,9 +75,28 @@
 #define LWIP_HTTPD_FS_ASYNC_READ      0
 #endif
 
+/** Set this to 1 to send the gzip variants of the files made by makefsdata.py
+ * to the clients accepting "Content-Encoding: gzip".
+ */
+#ifndef LWIP_HTTPD_FS_GZIP
+#define LWIP_HTTPD_FS_GZIP            1
+#endif
+
+/** Set this to 1 to answer "304 Not Modified" to the requests holding the
+ * ETag of the file in their If-None-Match header.
+ */
+#ifndef LWIP_HTTPD_FS_ETAG
+#define LWIP_HTTPD_FS_ETAG            1
+#endif
+
 #define FS_READ_EOF     -1
 #define FS_READ_DELAYED -2
 
+/* Bits of fs_file.http_header_included */
+#define FS_FILE_FLAGS_HEADER_INCLUDED     0x01  /* the file data starts with the HTTP header */
+#define FS_FILE_FLAGS_HEADER_PERSISTENT   0x02  /* the header allows a persistent connection
+                                                   (HTTP/1.1 with Content-Length) */
+
 #if HTTPD_PRECALCULATED_CHECKSUM
 struct fsdata_chksum {
   u32_t offset;
@@ -86,6 +105,13 @@ struct fsdata_chksum {
 };
 #endif /* HTTPD_PRECALCULATED_CHECKSUM */
 
+/** Position of an SSI tag "<!--#name-->" in a file, found by makefsdata.py */
+struct fs_ssi_tag {
+  u32_t offset;       /* offset of the tag from the start of the file data */
+  u16_t len;          /* length of the tag */
+  const char *name;   /* tag name */
+};
+
 struct fs_file {
   const char *data;
   int len;
@@ -96,6 +122,8 @@ struct fs_file {
   u16_t chksum_count;
 #endif /* HTTPD_PRECALCULATED_CHECKSUM */
   u8_t http_header_included;
+  u16_t ssi_tag_count;
+  const struct fs_ssi_tag *ssi_tags;
 #if LWIP_HTTPD_CUSTOM_FILES
   u8_t is_custom_file;
 #endif /* LWIP_HTTPD_CUSTOM_FILES */
@@ -104,11 +132,19 @@ struct fs_file {
 #endif /* LWIP_HTTPD_FILE_STATE */
 };
 
+/** The request headers fs_open_ext() chooses the response with */
+struct fs_request {
+  u8_t accept_gzip;             /* the client accepts "Content-Encoding: gzip" */
+  const char *if_none_match;    /* value of the If-None-Match header, not NULL-terminated */
+  u16_t if_none_match_len;
+};
+
 #if LWIP_HTTPD_FS_ASYNC_READ
 typedef void (*fs_wait_cb)(void *arg);
 #endif /* LWIP_HTTPD_FS_ASYNC_READ */
 
 err_t fs_open(struct fs_file *file, const char *name);
+err_t fs_open_ext(struct fs_file *file, const char *name, const struct fs_request *request);
 void fs_close(struct fs_file *file);
 #if LWIP_HTTPD_DYNAMIC_FILE_READ
 #if LWIP_HTTPD_FS_ASYNC_READ
@@ -45,6 +45,10 @@ struct fsdata_file {
   u16_t chksum_count;
   const struct fsdata_chksum *chksum;
 #endif /* HTTPD_PRECALCULATED_CHECKSUM */
+  const struct fsdata_file *gzip;   /* gzip variant of the file or NULL */
+  const char *etag;                 /* quoted ETag of the file or NULL */
+  const struct fs_ssi_tag *ssi_tags; /* SSI tags of the file or NULL */
+  u16_t ssi_tag_count;
 };
 
 #endif /* __FSDATA_H__ */
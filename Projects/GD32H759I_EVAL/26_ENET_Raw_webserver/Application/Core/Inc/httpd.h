@@ -51,6 +51,12 @@
 #define LWIP_HTTPD_SSI            1
 #endif
 
+/** Set this to 1 to support stream handlers taking over a connection
+ * (long-lived responses like Server-Sent Events) */
+#ifndef LWIP_HTTPD_STREAM
+#define LWIP_HTTPD_STREAM         0
+#endif
+
 /** Set this to 1 to support HTTP POST */
 #ifndef LWIP_HTTPD_SUPPORT_POST
 #define LWIP_HTTPD_SUPPORT_POST   0
@@ -111,6 +117,43 @@ void http_set_cgi_handlers(const tCGI *pCGIs, int iNumHandlers);
 
 #endif /* LWIP_HTTPD_CGI */
 
+#if LWIP_HTTPD_STREAM
+
+struct tcp_pcb;
+
+/*
+ * Function pointer for a stream handler.
+ *
+ * This function is called each time the HTTPD server is asked for a URI
+ * which was previously registered as a stream using a call to
+ * http_set_stream_handlers. The iIndex parameter provides the index of the
+ * stream within the array passed to http_set_stream_handlers and pcParams
+ * the part of the URI behind '?' (NULL if there is none, only valid during
+ * the call).
+ *
+ * To take the connection over, the handler sets its own callbacks and
+ * argument on pcb (tcp_arg, tcp_recv, tcp_sent, tcp_poll and tcp_err), sends
+ * the response header itself and returns ERR_OK: the HTTPD server then frees
+ * its state of the connection without touching pcb again. Any other return
+ * value leaves the connection to the HTTPD server, which answers with the
+ * 404 page.
+ */
+typedef err_t (*tStreamHandler)(int iIndex, struct tcp_pcb *pcb, char *pcParams);
+
+/*
+ * Structure defining the URI of a stream and the associated function which
+ * is to be called when that URI is requested.
+ */
+typedef struct
+{
+    const char *pcStreamName;
+    tStreamHandler pfnStreamHandler;
+} tStream;
+
+void http_set_stream_handlers(const tStream *pStreams, int iNumHandlers);
+
+#endif /* LWIP_HTTPD_STREAM */
+
 #if LWIP_HTTPD_SSI
 
 /** LWIP_HTTPD_SSI_MULTIPART==1: SSI handler function is called with 2 more
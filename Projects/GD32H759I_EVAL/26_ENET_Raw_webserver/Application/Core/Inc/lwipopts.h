@@ -52,9 +52,6 @@ OF SUCH DAMAGE.
                                                             send a lot of data that needs to be copied, this should
                                                             be set high */
 
-/* Relocate the LwIP RAM heap pointer */
-#define LWIP_RAM_HEAP_POINTER    (0x30004000)
-
 #define MEMP_NUM_PBUF           10                       /* the number of memp struct pbufs. If the application
                                                             sends a lot of data out of ROM (or other static memory),
                                                             this should be set high */
@@ -76,6 +73,10 @@ OF SUCH DAMAGE.
 #define PBUF_POOL_SIZE          10                       /* the number of buffers in the pbuf pool */
 #define PBUF_POOL_BUFSIZE       1500                     /* the size of each pbuf in the pbuf pool */
 
+/* ethernetif options */
+#define ETHERNETIF_TX_SCATTER_GATHER 1                   /* chain the pbufs of a Tx frame across ENET descriptors
+                                                            instead of copying them into the Tx buffer */
+
 /* TCP options */
 #define LWIP_TCP                1
 #define TCP_TTL                 255
@@ -110,6 +111,13 @@ OF SUCH DAMAGE.
 #define UDP_TTL                 255
 
 
+/* httpd options */
+#define LWIP_HTTPD_SUPPORT_11_KEEPALIVE 1                /* keep HTTP/1.1 connections open between requests instead
+                                                            of a TCP handshake and teardown per page and asset */
+#define LWIP_HTTPD_SSI_MULTIPART        1                /* SSI inserts longer than LWIP_HTTPD_MAX_TAG_INSERT_LEN are
+                                                            handed out by the handler in parts */
+#define LWIP_HTTPD_STREAM               1                /* let a stream handler take a connection over (/adc.sse) */
+
 /* statistics options */
 #define LWIP_STATS              0
 #define LWIP_PROVIDE_ERRNO      1
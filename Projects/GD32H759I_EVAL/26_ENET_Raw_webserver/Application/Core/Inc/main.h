@@ -43,7 +43,7 @@ OF SUCH DAMAGE.
 
 //#define USE_ENET_INTERRUPT
 
-/*The USE_ENET0 and USE_ENET1 macros cannot be opened at the same time*/
+/*The USE_ENET0 and USE_ENET1 macros can be opened at the same time only if ENET_INSTANCE_NUM is defined to 2U for the whole build*/
 #define USE_ENET0
 //#define USE_ENET1
 
@@ -75,6 +75,22 @@ OF SUCH DAMAGE.
 #define BOARD_GW_ADDR2   3
 #define BOARD_GW_ADDR3   1
 
+/* ENET1 address, net mask and gateway when USE_ENET0 and USE_ENET1 are both opened, ENET1 is on its own subnet */
+#define BOARD_ENET1_IP_ADDR0        10
+#define BOARD_ENET1_IP_ADDR1        50
+#define BOARD_ENET1_IP_ADDR2        4
+#define BOARD_ENET1_IP_ADDR3        210
+
+#define BOARD_ENET1_NETMASK_ADDR0   255
+#define BOARD_ENET1_NETMASK_ADDR1   255
+#define BOARD_ENET1_NETMASK_ADDR2   255
+#define BOARD_ENET1_NETMASK_ADDR3   0
+
+#define BOARD_ENET1_GW_ADDR0        10
+#define BOARD_ENET1_GW_ADDR1        50
+#define BOARD_ENET1_GW_ADDR2        4
+#define BOARD_ENET1_GW_ADDR3        1
+
 /* MII and RMII mode selection */
 #define RMII_MODE  // user have to provide the 50 MHz clock by soldering a 50 MHz oscillator
 //#define MII_MODE
@@ -84,7 +100,18 @@ OF SUCH DAMAGE.
 #define PHY_CLOCK_MCO
 #endif
 
+/* ADC telemetry: the VREFINT channel is sampled at ADC_STREAM_SAMPLE_RATE into adc_ring by DMA
+   and pushed to the clients of /adc.sse every ADC_STREAM_PERIOD_MS (or ?period=ms) */
+#define ADC_STREAM_SAMPLE_RATE  1000U               /* samples per second, 16 .. 1000000 */
+#define ADC_STREAM_RING_LEN     1024U               /* samples in adc_ring, a power of two */
+#define ADC_STREAM_PERIOD_MS    100U                /* default push period */
+#define ADC_STREAM_MAX_CLIENTS  2U                  /* concurrent /adc.sse connections */
+
+extern uint16_t adc_ring[ADC_STREAM_RING_LEN];
+
 /* function declarations */
+/* push the ADC samples to the telemetry stream clients */
+void http_adc_stream_check(uint32_t curtime);
 /* updates the system local time */
 void time_update(void);
 /* insert a delay time */
@@ -31,6 +31,7 @@
  */
 #include "lwip/opt.h"
 #include "lwip/def.h"
+#include "lwip/init.h"
 #include "fs.h"
 #include "fsdata.h"
 #include <string.h>
@@ -58,9 +59,83 @@ u8_t fs_wait_read_custom(struct fs_file *file, fs_wait_cb callback_fn, void *cal
 #endif /* LWIP_HTTPD_FS_ASYNC_READ */
 #endif /* LWIP_HTTPD_CUSTOM_FILES */
 
+#if LWIP_HTTPD_FS_ETAG
+/** Sent instead of a file whose ETag the client holds already */
+static const char fs_not_modified[] = "HTTP/1.1 304 Not Modified\r\n"
+                                      "Server: lwIP/" LWIP_VERSION_STRING " (http://savannah.nongnu.org/projects/lwip)\r\n\r\n";
+#endif /* LWIP_HTTPD_FS_ETAG */
+
+/*-----------------------------------------------------------------------------------*/
+#ifdef FS_HASH_SIZE
+/** FNV-1a hash of a file name, makefsdata.py places the files in fs_hash_table
+ * with the same function and FS_HASH_SEED so that no two names share a slot.
+ */
+static u32_t
+fs_name_hash(const char *name)
+{
+    u32_t hash = 0x811C9DC5UL ^ FS_HASH_SEED;
+
+    while(*name != '\0') {
+        hash ^= (u8_t)*name++;
+        hash *= 0x01000193UL;
+    }
+    return hash;
+}
+#endif /* FS_HASH_SIZE */
+
+/*-----------------------------------------------------------------------------------*/
+static const struct fsdata_file *
+fs_find(const char *name)
+{
+    const struct fsdata_file *f;
+
+#ifdef FS_HASH_SIZE
+    /* only the file in the slot of the name can match */
+    f = fs_hash_table[fs_name_hash(name) & (FS_HASH_SIZE - 1U)];
+    if((f != NULL) && !strcmp(name, (const char *)f->name)) {
+        return f;
+    }
+#else /* FS_HASH_SIZE */
+    for(f = FS_ROOT; f != NULL; f = f->next) {
+        if(!strcmp(name, (const char *)f->name)) {
+            return f;
+        }
+    }
+#endif /* FS_HASH_SIZE */
+    return NULL;
+}
+
+/*-----------------------------------------------------------------------------------*/
+#if LWIP_HTTPD_FS_ETAG
+static u8_t
+fs_etag_match(const struct fs_request *request, const char *etag)
+{
+    size_t etag_len = strlen(etag);
+    u16_t i;
+
+    if((request->if_none_match_len == 1U) && (request->if_none_match[0] == '*')) {
+        return 1;
+    }
+    /* the header may hold a list of weak or strong ETags */
+    for(i = 0U; (i + etag_len) <= request->if_none_match_len; i++) {
+        if(!memcmp(&request->if_none_match[i], etag, etag_len)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+#endif /* LWIP_HTTPD_FS_ETAG */
+
 /*-----------------------------------------------------------------------------------*/
 err_t
 fs_open(struct fs_file *file, const char *name)
+{
+    return fs_open_ext(file, name, NULL);
+}
+
+/*-----------------------------------------------------------------------------------*/
+err_t
+fs_open_ext(struct fs_file *file, const char *name, const struct fs_request *request)
 {
     const struct fsdata_file *f;
 
@@ -68,6 +143,9 @@ fs_open(struct fs_file *file, const char *name)
         return ERR_ARG;
     }
 
+    /* custom files have no precompiled SSI tags */
+    file->ssi_tags = NULL;
+    file->ssi_tag_count = 0;
 #if LWIP_HTTPD_CUSTOM_FILES
     if(fs_open_custom(file, name)) {
         file->is_custom_file = 1;
@@ -76,25 +154,49 @@ fs_open(struct fs_file *file, const char *name)
     file->is_custom_file = 0;
 #endif /* LWIP_HTTPD_CUSTOM_FILES */
 
-    for(f = FS_ROOT; f != NULL; f = f->next) {
-        if(!strcmp(name, (char *)f->name)) {
-            file->data = (const char *)f->data;
-            file->len = f->len;
-            file->index = f->len;
-            file->pextension = NULL;
-            file->http_header_included = f->http_header_included;
+    f = fs_find(name);
+    if(f == NULL) {
+        /* file not found */
+        return ERR_VAL;
+    }
+#if LWIP_HTTPD_FS_GZIP
+    if((request != NULL) && request->accept_gzip && (f->gzip != NULL)) {
+        f = f->gzip;
+    }
+#endif /* LWIP_HTTPD_FS_GZIP */
+
+    file->data = (const char *)f->data;
+    file->len = f->len;
+    file->index = f->len;
+    file->pextension = NULL;
+    file->http_header_included = f->http_header_included;
+    file->ssi_tags = f->ssi_tags;
+    file->ssi_tag_count = f->ssi_tag_count;
 #if HTTPD_PRECALCULATED_CHECKSUM
-            file->chksum_count = f->chksum_count;
-            file->chksum = f->chksum;
+    file->chksum_count = f->chksum_count;
+    file->chksum = f->chksum;
 #endif /* HTTPD_PRECALCULATED_CHECKSUM */
+#if LWIP_HTTPD_FS_ETAG
+    if((request != NULL) && (request->if_none_match != NULL) && (f->etag != NULL) &&
+            fs_etag_match(request, f->etag)) {
+        file->data = fs_not_modified;
+        file->len = sizeof(fs_not_modified) - 1;
+        file->index = file->len;
+        file->http_header_included = FS_FILE_FLAGS_HEADER_INCLUDED | FS_FILE_FLAGS_HEADER_PERSISTENT;
+        file->ssi_tags = NULL;
+        file->ssi_tag_count = 0;
+#if HTTPD_PRECALCULATED_CHECKSUM
+        file->chksum_count = 0;
+        file->chksum = NULL;
+#endif /* HTTPD_PRECALCULATED_CHECKSUM */
+    }
+#else /* LWIP_HTTPD_FS_ETAG */
+    LWIP_UNUSED_ARG(request);
+#endif /* LWIP_HTTPD_FS_ETAG */
 #if LWIP_HTTPD_FILE_STATE
-            file->state = fs_state_init(file, name);
+    file->state = fs_state_init(file, name);
 #endif /* #if LWIP_HTTPD_FILE_STATE */
-            return ERR_OK;
-        }
-    }
-    /* file not found */
-    return ERR_VAL;
+    return ERR_OK;
 }
 
 /*-----------------------------------------------------------------------------------*/
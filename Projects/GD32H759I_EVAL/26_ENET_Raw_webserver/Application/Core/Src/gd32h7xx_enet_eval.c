@@ -121,7 +121,8 @@ static void enet_mac_dma_config(void)
     }
 
 #ifdef CHECKSUM_BY_HARDWARE
-    enet_init_status = enet_init(ENET0, ENET_AUTO_NEGOTIATION, ENET_AUTOCHECKSUM_DROP_FAILFRAMES, ENET_BROADCAST_FRAMES_PASS);
+    /* the frames with a checksum error are counted and dropped by ethernetif */
+    enet_init_status = enet_init(ENET0, ENET_AUTO_NEGOTIATION, ENET_AUTOCHECKSUM_ACCEPT_FAILFRAMES, ENET_BROADCAST_FRAMES_PASS);
 #else
     enet_init_status = enet_init(ENET0, ENET_AUTO_NEGOTIATION, ENET_NO_AUTOCHECKSUM, ENET_BROADCAST_FRAMES_PASS);
 #endif /* CHECKSUM_BY_HARDWARE */
@@ -142,7 +143,8 @@ static void enet_mac_dma_config(void)
     }
 
 #ifdef CHECKSUM_BY_HARDWARE
-    enet_init_status = enet_init(ENET1, ENET_AUTO_NEGOTIATION, ENET_AUTOCHECKSUM_DROP_FAILFRAMES, ENET_BROADCAST_FRAMES_PASS);
+    /* the frames with a checksum error are counted and dropped by ethernetif */
+    enet_init_status = enet_init(ENET1, ENET_AUTO_NEGOTIATION, ENET_AUTOCHECKSUM_ACCEPT_FAILFRAMES, ENET_BROADCAST_FRAMES_PASS);
 #else
     enet_init_status = enet_init(ENET1, ENET_AUTO_NEGOTIATION, ENET_NO_AUTOCHECKSUM, ENET_BROADCAST_FRAMES_PASS);
 #endif /* CHECKSUM_BY_HARDWARE */
@@ -57,11 +57,21 @@ const tCGI leds_cgi = {"/leds.cgi", http_led_control};
 /*!
     \brief      ssi handler for ADC monitor
 */
+#if LWIP_HTTPD_SSI_MULTIPART
+u16_t http_adc_monitor(int iIndex, char *pcInsert, int iInsertLen, u16_t current_tag_part, u16_t *next_tag_part)
+#else
 u16_t http_adc_monitor(int iIndex, char *pcInsert, int iInsertLen)
+#endif /* LWIP_HTTPD_SSI_MULTIPART */
 {
     char val_1, val_2, val_3, val_4;
     uint32_t adc_val = 0;
 
+#if LWIP_HTTPD_SSI_MULTIPART
+    /* the value is inserted in one part */
+    LWIP_UNUSED_ARG(current_tag_part);
+    LWIP_UNUSED_ARG(next_tag_part);
+#endif /* LWIP_HTTPD_SSI_MULTIPART */
+
     if(0 == iIndex) {
         /* get ADC conversion value */
         adc_val = adc_inserted_data_read(ADC2, ADC_INSERTED_CHANNEL_0);
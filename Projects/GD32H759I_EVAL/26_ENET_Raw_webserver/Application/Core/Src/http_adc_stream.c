@@ -0,0 +1,361 @@
+/*!
+    \file    http_adc_stream.c
+    \brief   ADC telemetry stream of the webserver demo
+
+    \version 2024-07-31, V2.0.0, demo for GD32H7xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "lwip/init.h"
+#include "lwip/tcp.h"
+#include "httpd.h"
+#include "main.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* the samples of one event must fit into the ring buffer with room left for the DMA */
+#define ADC_STREAM_PERIOD_MIN_MS    10U
+#define ADC_STREAM_PERIOD_MAX_MS    ((ADC_STREAM_RING_LEN / 2U) * 1000U / ADC_STREAM_SAMPLE_RATE)
+/* decimation limit, a power of two */
+#define ADC_STREAM_MAX_DECIMATION   64U
+/* room for an event without its values, and per value ("4095," in mV is at most 5 characters) */
+#define ADC_STREAM_EVENT_HDR_LEN    96U
+#define ADC_STREAM_VALUE_LEN        5U
+#define ADC_STREAM_EVENT_LEN        TCP_MSS
+
+/* state of a /adc.sse connection */
+typedef struct {
+    struct tcp_pcb *pcb;                        /* NULL if the slot is free */
+    uint32_t period;                            /* push period in ms */
+    uint32_t last_push;                         /* time of the last push */
+    uint32_t rd;                                /* number of samples consumed */
+    uint32_t seq;                               /* sequence number of the next event */
+    uint32_t lost;                              /* samples dropped since the last event */
+    uint16_t decimation;                        /* samples averaged into one value */
+} adc_stream_client_struct;
+
+static adc_stream_client_struct adc_stream_clients[ADC_STREAM_MAX_CLIENTS];
+/* number of samples written by the DMA, and its last ring position */
+static uint32_t adc_stream_wr = 0U;
+static uint32_t adc_stream_pos = 0U;
+static uint32_t adc_stream_time = 0U;
+static char adc_stream_event[ADC_STREAM_EVENT_LEN];
+
+static const char adc_stream_header[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Server: lwIP/" LWIP_VERSION_STRING " (http://savannah.nongnu.org/projects/lwip)\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: close\r\n"
+    "\r\n"
+    "retry: 2000\n\n";
+
+static err_t http_adc_stream_start(int iIndex, struct tcp_pcb *pcb, char *pcParams);
+/* html request for "/adc.sse" will start http_adc_stream_start */
+static const tStream adc_stream = {"/adc.sse", http_adc_stream_start};
+
+/*!
+    \brief      free the slot of a stream client and close its connection
+    \param[in]  client: stream client
+    \param[out] none
+    \retval     ERR_OK, or ERR_ABRT if the connection had to be aborted
+*/
+static err_t adc_stream_close(adc_stream_client_struct *client)
+{
+    struct tcp_pcb *pcb = client->pcb;
+
+    client->pcb = NULL;
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_err(pcb, NULL);
+    if(ERR_OK != tcp_close(pcb)) {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+/*!
+    \brief      receive callback of a stream connection, requests are ignored
+    \param[in]  arg: stream client
+    \param[in]  pcb: tcp_pcb of the connection
+    \param[in]  p: received data, NULL if the client closed the connection
+    \param[in]  err: receive status
+    \param[out] none
+    \retval     ERR_OK or ERR_ABRT if the connection was aborted
+*/
+static err_t adc_stream_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+    adc_stream_client_struct *client = (adc_stream_client_struct *)arg;
+
+    if(NULL != p) {
+        tcp_recved(pcb, p->tot_len);
+        pbuf_free(p);
+    }
+    if((NULL == p) || (ERR_OK != err)) {
+        /* lwIP must not touch the pcb again once it has been aborted */
+        return adc_stream_close(client);
+    }
+    return ERR_OK;
+}
+
+/*!
+    \brief      error callback of a stream connection, the pcb is already freed
+    \param[in]  arg: stream client
+    \param[in]  err: error code
+    \param[out] none
+    \retval     none
+*/
+static void adc_stream_err(void *arg, err_t err)
+{
+    adc_stream_client_struct *client = (adc_stream_client_struct *)arg;
+
+    (void)err;
+    if(NULL != client) {
+        client->pcb = NULL;
+    }
+}
+
+/*!
+    \brief      stream handler of "/adc.sse": take the connection over
+    \param[in]  iIndex: index of the stream handler
+    \param[in]  pcb: tcp_pcb of the connection
+    \param[in]  pcParams: URI parameters, "period=<ms>" selects the push period
+    \param[out] none
+    \retval     ERR_OK, ERR_MEM if all the client slots are in use
+*/
+static err_t http_adc_stream_start(int iIndex, struct tcp_pcb *pcb, char *pcParams)
+{
+    adc_stream_client_struct *client = NULL;
+    uint32_t period = ADC_STREAM_PERIOD_MS;
+    u16_t len = sizeof(adc_stream_header) - 1U;
+    uint32_t i;
+    char *param;
+
+    (void)iIndex;
+    for(i = 0U; i < ADC_STREAM_MAX_CLIENTS; i++) {
+        if(NULL == adc_stream_clients[i].pcb) {
+            client = &adc_stream_clients[i];
+            break;
+        }
+    }
+    if((NULL == client) || (tcp_sndbuf(pcb) < len)) {
+        return ERR_MEM;
+    }
+
+    /* check parameter "period" */
+    if(NULL != pcParams) {
+        param = strstr(pcParams, "period=");
+        if(NULL != param) {
+            period = (uint32_t)atoi(param + 7);
+        }
+    }
+    if(period < ADC_STREAM_PERIOD_MIN_MS) {
+        period = ADC_STREAM_PERIOD_MIN_MS;
+    } else if(period > ADC_STREAM_PERIOD_MAX_MS) {
+        period = ADC_STREAM_PERIOD_MAX_MS;
+    }
+
+    if(ERR_OK != tcp_write(pcb, adc_stream_header, len, 0U)) {
+        return ERR_MEM;
+    }
+
+    /* the connection is the stream's from now on */
+    client->pcb = pcb;
+    client->period = period;
+    client->last_push = adc_stream_time;
+    client->rd = adc_stream_wr;
+    client->seq = 0U;
+    client->lost = 0U;
+    client->decimation = 1U;
+    tcp_arg(pcb, client);
+    tcp_recv(pcb, adc_stream_recv);
+    tcp_err(pcb, adc_stream_err);
+    tcp_sent(pcb, NULL);
+    tcp_poll(pcb, NULL, 0U);
+    /* events are small, send them right away */
+    tcp_nagle_disable(pcb);
+    tcp_output(pcb);
+    return ERR_OK;
+}
+
+/*!
+    \brief      write an unsigned number in decimal
+    \param[in]  p: destination
+    \param[in]  value: number to write
+    \param[out] none
+    \retval     number of characters written
+*/
+static uint32_t adc_stream_put_uint(char *p, uint32_t value)
+{
+    char digits[10];
+    uint32_t n = 0U, i;
+
+    do {
+        digits[n++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while(0U != value);
+    for(i = 0U; i < n; i++) {
+        p[i] = digits[n - 1U - i];
+    }
+    return n;
+}
+
+/*!
+    \brief      write a string
+    \param[in]  p: destination
+    \param[in]  s: string to write
+    \param[out] none
+    \retval     number of characters written
+*/
+static uint32_t adc_stream_put_str(char *p, const char *s)
+{
+    uint32_t n = strlen(s);
+
+    memcpy(p, s, n);
+    return n;
+}
+
+/*!
+    \brief      send the samples collected since the last push of a client as one event,
+                decimated as far as needed to fit into the send buffer
+    \param[in]  client: stream client
+    \param[out] none
+    \retval     none
+*/
+static void adc_stream_push(adc_stream_client_struct *client)
+{
+    struct tcp_pcb *pcb = client->pcb;
+    uint32_t avail = adc_stream_wr - client->rd;
+    uint32_t space, count, len, i, j, sum;
+    uint16_t decimation = client->decimation;
+
+    /* samples overwritten by the DMA meanwhile are lost */
+    if(avail > (ADC_STREAM_RING_LEN / 2U)) {
+        client->lost += avail - (ADC_STREAM_RING_LEN / 2U);
+        client->rd = adc_stream_wr - (ADC_STREAM_RING_LEN / 2U);
+        avail = ADC_STREAM_RING_LEN / 2U;
+    }
+
+    /* backpressure: never queue more than the connection can take now */
+    space = tcp_sndbuf(pcb);
+    if(tcp_sndqueuelen(pcb) >= (TCP_SND_QUEUELEN - 1U)) {
+        space = 0U;
+    }
+    if(space > ADC_STREAM_EVENT_LEN) {
+        space = ADC_STREAM_EVENT_LEN;
+    }
+
+    /* a fast client gets the full rate back step by step */
+    if((decimation > 1U) &&
+            ((ADC_STREAM_EVENT_HDR_LEN + (avail / (decimation / 2U)) * ADC_STREAM_VALUE_LEN) * 2U <= space)) {
+        decimation /= 2U;
+    }
+    /* a slow client gets fewer values rather than stalling the stack */
+    while((ADC_STREAM_EVENT_HDR_LEN + (avail / decimation) * ADC_STREAM_VALUE_LEN > space) &&
+            (decimation < ADC_STREAM_MAX_DECIMATION)) {
+        decimation *= 2U;
+    }
+    client->decimation = decimation;
+
+    count = avail / decimation;
+    if(0U == count) {
+        return;
+    }
+    if(ADC_STREAM_EVENT_HDR_LEN + count * ADC_STREAM_VALUE_LEN > space) {
+        /* not even the decimated samples fit, drop them */
+        client->lost += count * decimation;
+        client->rd += count * decimation;
+        return;
+    }
+
+    /* data: {"seq":N,"rate":N,"dec":N,"lost":N,"mv":[N,...]} */
+    len = adc_stream_put_str(adc_stream_event, "data: {\"seq\":");
+    len += adc_stream_put_uint(&adc_stream_event[len], client->seq);
+    len += adc_stream_put_str(&adc_stream_event[len], ",\"rate\":");
+    len += adc_stream_put_uint(&adc_stream_event[len], ADC_STREAM_SAMPLE_RATE);
+    len += adc_stream_put_str(&adc_stream_event[len], ",\"dec\":");
+    len += adc_stream_put_uint(&adc_stream_event[len], decimation);
+    len += adc_stream_put_str(&adc_stream_event[len], ",\"lost\":");
+    len += adc_stream_put_uint(&adc_stream_event[len], client->lost);
+    len += adc_stream_put_str(&adc_stream_event[len], ",\"mv\":[");
+    for(i = 0U; i < count; i++) {
+        /* average the decimated samples */
+        sum = 0U;
+        for(j = 0U; j < decimation; j++) {
+            sum += adc_ring[(client->rd++) & (ADC_STREAM_RING_LEN - 1U)];
+        }
+        if(0U != i) {
+            adc_stream_event[len++] = ',';
+        }
+        len += adc_stream_put_uint(&adc_stream_event[len], (sum / decimation) * 3300U / 4096U);
+    }
+    len += adc_stream_put_str(&adc_stream_event[len], "]}\n\n");
+
+    if(ERR_OK == tcp_write(pcb, adc_stream_event, (u16_t)len, TCP_WRITE_FLAG_COPY)) {
+        client->seq++;
+        client->lost = 0U;
+        tcp_output(pcb);
+    } else {
+        client->lost += count * decimation;
+    }
+}
+
+/*!
+    \brief      push the ADC samples to the stream clients whose period is over
+    \param[in]  curtime: current time in ms
+    \param[out] none
+    \retval     none
+*/
+void http_adc_stream_check(uint32_t curtime)
+{
+    uint32_t pos, i;
+
+    /* follow the DMA through the ring */
+    pos = (ADC_STREAM_RING_LEN - dma_transfer_number_get(DMA0, DMA_CH0)) & (ADC_STREAM_RING_LEN - 1U);
+    adc_stream_wr += (pos - adc_stream_pos) & (ADC_STREAM_RING_LEN - 1U);
+    adc_stream_pos = pos;
+    adc_stream_time = curtime;
+
+    for(i = 0U; i < ADC_STREAM_MAX_CLIENTS; i++) {
+        if((NULL != adc_stream_clients[i].pcb) &&
+                ((curtime - adc_stream_clients[i].last_push) >= adc_stream_clients[i].period)) {
+            adc_stream_clients[i].last_push = curtime;
+            adc_stream_push(&adc_stream_clients[i]);
+        }
+    }
+}
+
+/*!
+    \brief      init stream handler
+*/
+void httpd_stream_init(void)
+{
+    http_set_stream_handlers(&adc_stream, 1);
+}
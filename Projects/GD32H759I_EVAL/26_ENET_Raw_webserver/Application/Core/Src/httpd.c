@@ -42,6 +42,8 @@
  *
  * To enable SSI support, define label LWIP_HTTPD_SSI in lwipopts.h.
  * To enable CGI support, define label LWIP_HTTPD_CGI in lwipopts.h.
+ * A stream handler registered via http_set_stream_handlers() takes over
+ * the connection of a request for its URI (LWIP_HTTPD_STREAM in lwipopts.h).
  *
  * By default, the server assumes that HTTP headers are already present in
  * each file stored in the file system.  By defining LWIP_HTTPD_DYNAMIC_HEADERS in
@@ -63,6 +65,11 @@
  * 2. Whitespace is allowed between the tag leadin "<!--#" and the start of
  *    the tag name and between the tag name and the leadout string "-->".
  * 3. The maximum tag name length is LWIP_HTTPD_MAX_TAG_NAME_LEN, currently 8 characters.
+ * 4. The tags are found by makefsdata.py when the file system image is built
+ *    (struct fs_ssi_tag), the server does not parse the files. The text
+ *    between the tags is sent from the file system without copying it.
+ * 5. An insert longer than LWIP_HTTPD_MAX_TAG_INSERT_LEN is sent in parts,
+ *    see LWIP_HTTPD_SSI_MULTIPART.
  *
  * Notes on CGI usage
  * ------------------
@@ -154,13 +161,31 @@
 #endif
 
 /** Set this to 1 to enable HTTP/1.1 persistent connections.
- * ATTENTION: If the generated file system includes HTTP headers, these must
- * include the "Connection: keep-alive" header (pass argument "-11" to makefsdata).
+ * ATTENTION: Only the files flagged FS_FILE_FLAGS_HEADER_PERSISTENT (HTTP/1.1
+ * header with Content-Length, as made by makefsdata.py) and the SSI files are
+ * sent without closing the connection. Requests pipelined behind the current
+ * one are parsed once its response is enqueued.
  */
 #ifndef LWIP_HTTPD_SUPPORT_11_KEEPALIVE
 #define LWIP_HTTPD_SUPPORT_11_KEEPALIVE     0
 #endif
 
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+/** Number of polls (HTTPD_POLL_INTERVAL) an idle persistent connection is kept
+ * open waiting for the next request, default is 2*2s = 4s */
+#ifndef LWIP_HTTPD_KEEPALIVE_IDLE_POLLS
+#define LWIP_HTTPD_KEEPALIVE_IDLE_POLLS     2
+#endif
+
+/** Size of the buffer per SSI connection keeping the tag inserts rendered
+ * before the file is sent, to send the Content-Length of the response.
+ * If the inserts of a file don't fit, the connection is closed after it.
+ */
+#ifndef LWIP_HTTPD_SSI_PRERENDER_LEN
+#define LWIP_HTTPD_SSI_PRERENDER_LEN        256
+#endif
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+
 /** Set this to 1 to support HTTP request coming in in multiple packets/pbufs */
 #ifndef LWIP_HTTPD_SUPPORT_REQUESTLIST
 #define LWIP_HTTPD_SUPPORT_REQUESTLIST      1
@@ -219,12 +244,25 @@
 #define MIN_REQ_LEN   7
 
 #define CRLF "\r\n"
+#define HTTP11_VERSION             "HTTP/1.1"
 #define HTTP11_CONNECTIONKEEPALIVE "Connection: keep-alive"
+#define HTTP11_CONNECTIONCLOSE     "Connection: close"
+
+/* SSI responses get a Content-Length, and so keep the connection, if their
+ * inserts fit into LWIP_HTTPD_SSI_PRERENDER_LEN */
+#define HTTPD_SSI_CONTENT_LENGTH (LWIP_HTTPD_SSI && LWIP_HTTPD_SUPPORT_11_KEEPALIVE)
+
+#if LWIP_HTTPD_SSI && LWIP_HTTPD_DYNAMIC_FILE_READ
+#error "The SSI tag offsets need the whole file in memory, disable LWIP_HTTPD_DYNAMIC_FILE_READ"
+#endif
 
 #if LWIP_HTTPD_SSI
 #define LWIP_HTTPD_IS_SSI(hs) ((hs)->ssi)
+/* An insert is due at the end of the file */
+#define LWIP_HTTPD_SSI_PENDING(hs) (((hs)->ssi != NULL) && ((hs)->ssi->insert_at != NULL))
 #else /* LWIP_HTTPD_SSI */
 #define LWIP_HTTPD_IS_SSI(hs) 0
+#define LWIP_HTTPD_SSI_PENDING(hs) 0
 #endif /* LWIP_HTTPD_SSI */
 
 /** These defines check whether tcp_write has to copy data or not */
@@ -232,15 +270,11 @@
 /** This was TI's check whether to let TCP copy data or not
 #define HTTP_IS_DATA_VOLATILE(hs) ((hs->file < (char *)0x20000000) ? 0 : TCP_WRITE_FLAG_COPY)*/
 #ifndef HTTP_IS_DATA_VOLATILE
-#if LWIP_HTTPD_SSI
-/* Copy for SSI files, no copy for non-SSI files */
-#define HTTP_IS_DATA_VOLATILE(hs)   ((hs)->ssi ? TCP_WRITE_FLAG_COPY : 0)
-#else /* LWIP_HTTPD_SSI */
-/** Default: don't copy if the data is sent from file-system directly */
+/** Default: don't copy if the data is sent from file-system directly
+ * (SSI files too, only their tag inserts are copied) */
 #define HTTP_IS_DATA_VOLATILE(hs) (((hs->file != NULL) && (hs->handle != NULL) && (hs->file == \
                                    (char*)hs->handle->data + hs->handle->len - hs->left)) \
                                    ? 0 : TCP_WRITE_FLAG_COPY)
-#endif /* LWIP_HTTPD_SSI */
 #endif
 
 /** Default: headers are sent from ROM */
@@ -305,30 +339,26 @@ static char http_post_response_filename[LWIP_HTTPD_POST_MAX_RESPONSE_URI_LEN + 1
 
 #define HTTPD_LAST_TAG_PART 0xFFFF
 
-enum tag_check_state {
-    TAG_NONE,       /* Not processing an SSI tag */
-    TAG_LEADIN,     /* Tag lead in "<!--#" being processed */
-    TAG_FOUND,      /* Tag name being read, looking for lead-out start */
-    TAG_LEADOUT,    /* Tag lead out "-->" being processed */
-    TAG_SENDING     /* Sending tag replacement string */
-};
-
 struct http_ssi_state {
-    const char *parsed;     /* Pointer to the first unparsed byte in buf. */
-#if !LWIP_HTTPD_SSI_INCLUDE_TAG
-    const char *tag_started;/* Pointer to the first opening '<' of the tag. */
-#endif /* !LWIP_HTTPD_SSI_INCLUDE_TAG */
-    const char *tag_end;    /* Pointer to char after the closing '>' of the tag. */
-    u32_t parse_left; /* Number of unparsed bytes in buf. */
-    u16_t tag_index;   /* Counter used by tag parsing state machine */
-    u16_t tag_insert_len; /* Length of insert in string tag_insert */
+    const struct fs_ssi_tag *tag; /* Next tag of the file to insert */
+    u16_t tags_left;        /* Number of tags not inserted yet */
+    const char *insert_at;  /* Position in the file of the next insert, NULL if none */
+    const char *insert;     /* Insert being sent, tag_insert or a prerendered one */
+    u16_t tag_index;        /* Number of bytes of the insert sent */
+    u16_t tag_insert_len;   /* Length of the insert */
 #if LWIP_HTTPD_SSI_MULTIPART
     u16_t tag_part; /* Counter passed to and changed by tag insertion function to insert multiple times */
 #endif /* LWIP_HTTPD_SSI_MULTIPART */
-    u8_t tag_name_len; /* Length of the tag name in string tag_name */
-    char tag_name[LWIP_HTTPD_MAX_TAG_NAME_LEN + 1]; /* Last tag name extracted */
+    u8_t inserting;         /* The insert at insert_at is rendered and being sent */
+#if HTTPD_SSI_CONTENT_LENGTH
+    u8_t hdr_insert;  /* The insert at insert_at is the Content-Length header line */
+    u8_t prerendered; /* The inserts are taken from 'inserts' instead of the handler */
+    u16_t inserts_len; /* Number of bytes used in 'inserts' */
+    u16_t inserts_pos; /* Offset of the next insert in 'inserts' */
+    char inserts[LWIP_HTTPD_SSI_PRERENDER_LEN]; /* u16_t length and text of each insert */
+#endif /* HTTPD_SSI_CONTENT_LENGTH */
+    const char *tag_name; /* Name of the tag being inserted */
     char tag_insert[LWIP_HTTPD_MAX_TAG_INSERT_LEN + 1]; /* Insert string for tag_name */
-    enum tag_check_state tag_state; /* State of the tag processor */
 };
 #endif /* LWIP_HTTPD_SSI */
 
@@ -343,6 +373,10 @@ struct http_state {
     struct tcp_pcb *pcb;
 #if LWIP_HTTPD_SUPPORT_REQUESTLIST
     struct pbuf *req;
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+    u16_t req_len;      /* Length of the parsed request, the bytes behind it are pipelined */
+    u16_t req_unrecved; /* Pipelined bytes received while sending, not yet passed to tcp_recved */
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
 #endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
 
 #if LWIP_HTTPD_DYNAMIC_FILE_READ
@@ -357,6 +391,9 @@ struct http_state {
 #if LWIP_HTTPD_SSI
     struct http_ssi_state *ssi;
 #endif /* LWIP_HTTPD_SSI */
+#if LWIP_HTTPD_STREAM
+    u8_t streaming;   /* The connection has been taken over by a stream handler */
+#endif /* LWIP_HTTPD_STREAM */
 #if LWIP_HTTPD_CGI
     char *params[LWIP_HTTPD_MAX_CGI_PARAMETERS]; /* Params extracted from the request URI */
     char *param_vals[LWIP_HTTPD_MAX_CGI_PARAMETERS]; /* Values for each extracted param */
@@ -388,11 +425,19 @@ extern void httpd_ssi_init(void);
 extern void httpd_cgi_init(void);
 #endif
 
+#if LWIP_HTTPD_STREAM
+extern void httpd_stream_init(void);
+#endif /* LWIP_HTTPD_STREAM */
+
 static err_t http_close_conn(struct tcp_pcb *pcb, struct http_state *hs);
 static err_t http_close_or_abort_conn(struct tcp_pcb *pcb, struct http_state *hs, u8_t abort_conn);
-static err_t http_find_file(struct http_state *hs, const char *uri, int is_09);
+static err_t http_find_file(struct http_state *hs, const char *uri, int is_09, const struct fs_request *request);
 static err_t http_init_file(struct http_state *hs, struct fs_file *file, int is_09, const char *uri, u8_t tag_check);
 static err_t http_poll(void *arg, struct tcp_pcb *pcb);
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE && LWIP_HTTPD_SUPPORT_REQUESTLIST
+static err_t http_parse_request(struct pbuf **inp, struct http_state *hs, struct tcp_pcb *pcb);
+static void http_req_consume(struct tcp_pcb *pcb, struct http_state *hs, err_t parsed);
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE && LWIP_HTTPD_SUPPORT_REQUESTLIST */
 #if LWIP_HTTPD_FS_ASYNC_READ
 static void http_continue(void *connection);
 #endif /* LWIP_HTTPD_FS_ASYNC_READ */
@@ -402,12 +447,6 @@ static void http_continue(void *connection);
 tSSIHandler g_pfnSSIHandler = NULL;
 int g_iNumTags = 0;
 const char **g_ppcTags = NULL;
-
-#define LEN_TAG_LEAD_IN 5
-const char *const g_pcTagLeadIn = "<!--#";
-
-#define LEN_TAG_LEAD_OUT 3
-const char *const g_pcTagLeadOut = "-->";
 #endif /* LWIP_HTTPD_SSI */
 
 #if LWIP_HTTPD_CGI
@@ -416,6 +455,12 @@ const tCGI *g_pCGIs;
 int g_iNumCGIs;
 #endif /* LWIP_HTTPD_CGI */
 
+#if LWIP_HTTPD_STREAM
+/* Stream handler information */
+const tStream *g_pStreams;
+int g_iNumStreams;
+#endif /* LWIP_HTTPD_STREAM */
+
 #if LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED
 /** global list of active HTTP connections, use to kill the oldest when
     running out of memory */
@@ -577,6 +622,13 @@ http_state_free(struct http_state *hs)
 {
     if(hs != NULL) {
         http_state_eof(hs);
+#if LWIP_HTTPD_SUPPORT_REQUESTLIST
+        if(hs->req != NULL) {
+            /* drop a partial or pipelined request */
+            pbuf_free(hs->req);
+            hs->req = NULL;
+        }
+#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
 #if LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED
         /* take the connection off the list */
         if(http_connections) {
@@ -710,22 +762,66 @@ http_close_conn(struct tcp_pcb *pcb, struct http_state *hs)
 }
 
 /** End of file: either close the connection (Connection: close) or
- * close the file (Connection: keep-alive)
+ * close the file (Connection: keep-alive) and go on with the next
+ * pipelined request, if one has been received already.
+ *
+ * @return 1 if the response to a pipelined request is ready to be sent,
+ *         0 otherwise (hs may have been freed)
  */
-static void
+static u8_t
 http_eof(struct tcp_pcb *pcb, struct http_state *hs)
 {
-    /* HTTP/1.1 persistent connection? (Not supported for SSI) */
+    /* HTTP/1.1 persistent connection? (http_init_file() cleared keepalive
+       if the response has no Content-Length) */
 #if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
-    if(hs->keepalive && !LWIP_HTTPD_IS_SSI(hs)) {
+    if(hs->keepalive) {
+#if LWIP_HTTPD_SUPPORT_REQUESTLIST
+        struct pbuf *req = hs->req;
+        u16_t req_unrecved = hs->req_unrecved;
+        err_t parsed;
+#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+#if LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED
+        struct http_state *next = hs->next;
+#endif /* LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED */
+
         http_state_eof(hs);
         http_state_init(hs);
+        /* restore the connection state */
+        hs->pcb = pcb;
         hs->keepalive = 1;
-    } else
-#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
-    {
-        http_close_conn(pcb, hs);
+        /* don't let nagle hold back the small last segment of a response */
+        tcp_nagle_disable(pcb);
+#if LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED
+        hs->next = next;
+#endif /* LWIP_HTTPD_KILL_OLD_ON_CONNECTIONS_EXCEEDED */
+#if LWIP_HTTPD_SUPPORT_REQUESTLIST
+        hs->req = req;
+        hs->req_unrecved = req_unrecved;
+        if(hs->req != NULL) {
+            /* a pipelined request is waiting: parse it now */
+            LWIP_DEBUGF(HTTPD_DEBUG, ("http_eof: pipelined request (%"U16_F" bytes)\n", hs->req->tot_len));
+            parsed = http_parse_request(NULL, hs, pcb);
+            http_req_consume(pcb, hs, parsed);
+#if LWIP_HTTPD_STREAM
+            if((parsed == ERR_OK) && hs->streaming) {
+                /* the pcb belongs to the stream handler now */
+                http_state_free(hs);
+                return 0;
+            }
+#endif /* LWIP_HTTPD_STREAM */
+            if((parsed == ERR_OK) && (hs->handle != NULL)) {
+                return 1;
+            } else if(parsed != ERR_INPROGRESS) {
+                /* error or nothing to send (no 404 page) */
+                http_close_conn(pcb, hs);
+            }
+        }
+#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+        return 0;
     }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+    http_close_conn(pcb, hs);
+    return 0;
 }
 
 #if LWIP_HTTPD_CGI
@@ -799,7 +895,7 @@ extract_uri_parameters(struct http_state *hs, char *params)
 #if LWIP_HTTPD_SSI
 /**
  * Insert a tag (found in an shtml in the form of "<!--#tagname-->" into the file.
- * The tag's name is stored in ssi->tag_name (NULL-terminated), the replacement
+ * The tag's name is pointed to by ssi->tag_name (NULL-terminated), the replacement
  * should be written to hs->tag_insert (up to a length of LWIP_HTTPD_MAX_TAG_INSERT_LEN).
  * The amount of data written is stored to ssi->tag_insert_len.
  *
@@ -858,6 +954,161 @@ get_tag_insert(struct http_state *hs)
     LWIP_ASSERT("len <= 0xffff", len <= 0xffff);
     ssi->tag_insert_len = (u16_t)len;
 }
+
+/** Find the position of the next insert from the tag table of the file */
+static void
+http_ssi_next_insert(struct http_state *hs)
+{
+    struct http_ssi_state *ssi = hs->ssi;
+
+    ssi->inserting = 0;
+    if(ssi->tags_left == 0) {
+        ssi->insert_at = NULL;
+        return;
+    }
+    ssi->insert_at = hs->handle->data + ssi->tag->offset;
+#if LWIP_HTTPD_SSI_INCLUDE_TAG
+    /* the insert goes behind the tag */
+    ssi->insert_at += ssi->tag->len;
+#endif /* LWIP_HTTPD_SSI_INCLUDE_TAG */
+}
+
+/** Get the insert due at ssi->insert_at ready to be sent */
+static void
+http_ssi_render(struct http_state *hs)
+{
+    struct http_ssi_state *ssi = hs->ssi;
+
+    ssi->tag_index = 0;
+    ssi->inserting = 1;
+    ssi->insert = ssi->tag_insert;
+#if LWIP_HTTPD_SSI_MULTIPART
+    ssi->tag_part = HTTPD_LAST_TAG_PART;
+#endif /* LWIP_HTTPD_SSI_MULTIPART */
+#if HTTPD_SSI_CONTENT_LENGTH
+    if(ssi->hdr_insert) {
+        /* the header line is in tag_insert already */
+        return;
+    }
+    if(ssi->prerendered) {
+        /* send the insert rendered by http_ssi_content_length() */
+        u16_t insert_len;
+        MEMCPY(&insert_len, &ssi->inserts[ssi->inserts_pos], sizeof(insert_len));
+        ssi->insert = &ssi->inserts[ssi->inserts_pos + sizeof(insert_len)];
+        ssi->tag_insert_len = insert_len;
+        ssi->inserts_pos += (u16_t)(sizeof(insert_len) + insert_len);
+        return;
+    }
+#endif /* HTTPD_SSI_CONTENT_LENGTH */
+    ssi->tag_name = ssi->tag->name;
+#if LWIP_HTTPD_SSI_MULTIPART
+    ssi->tag_part = 0; /* start with tag part 0 */
+#endif /* LWIP_HTTPD_SSI_MULTIPART */
+    get_tag_insert(hs);
+}
+
+/** The insert at ssi->insert_at is sent, go on with the next one */
+static void
+http_ssi_insert_done(struct http_state *hs)
+{
+    struct http_ssi_state *ssi = hs->ssi;
+
+#if HTTPD_SSI_CONTENT_LENGTH
+    if(ssi->hdr_insert) {
+        ssi->hdr_insert = 0;
+        http_ssi_next_insert(hs);
+        return;
+    }
+#endif /* HTTPD_SSI_CONTENT_LENGTH */
+#if !LWIP_HTTPD_SSI_INCLUDE_TAG
+    /* the insert replaces the tag */
+    hs->file += ssi->tag->len;
+    hs->left -= ssi->tag->len;
+#endif /* !LWIP_HTTPD_SSI_INCLUDE_TAG */
+    ssi->tag++;
+    ssi->tags_left--;
+    http_ssi_next_insert(hs);
+}
+
+#if HTTPD_SSI_CONTENT_LENGTH
+/**
+ * Add the Content-Length to the response header of an SSI file. The inserts
+ * of all the tags are rendered before the file is sent so that the length
+ * is known, http_ssi_render() hands them out again in the same order.
+ * The header line itself is sent as an insert placed at the end of the header.
+ *
+ * @param hs http connection state with hs->ssi, hs->file and hs->left set up
+ * @return 1 if the Content-Length is sent, 0 if the connection has to be
+ *         closed after the response
+ */
+static u8_t
+http_ssi_content_length(struct http_state *hs)
+{
+    struct http_ssi_state *ssi = hs->ssi;
+    const struct fs_ssi_tag *tag;
+    const char *hdr_end;
+    s32_t body_len;
+    u16_t i, start, insert_len;
+    size_t len;
+
+    if(!(hs->handle->http_header_included & FS_FILE_FLAGS_HEADER_INCLUDED)) {
+        return 0;
+    }
+    hdr_end = strnstr(hs->file, CRLF CRLF, hs->left);
+    if(hdr_end == NULL) {
+        return 0;
+    }
+    /* the header line goes before the empty line ending the header */
+    hdr_end += 2;
+    body_len = (s32_t)(hs->left - (u32_t)(hdr_end + 2 - hs->file));
+
+    for(i = 0, tag = ssi->tag; i < ssi->tags_left; i++, tag++) {
+        /* keep the parts of the insert as one, behind its length */
+        start = ssi->inserts_len;
+        if((start + sizeof(insert_len)) > LWIP_HTTPD_SSI_PRERENDER_LEN) {
+            ssi->inserts_len = 0;
+            return 0;
+        }
+        ssi->inserts_len += sizeof(insert_len);
+        ssi->tag_name = tag->name;
+#if LWIP_HTTPD_SSI_MULTIPART
+        ssi->tag_part = 0;
+        do
+#endif /* LWIP_HTTPD_SSI_MULTIPART */
+        {
+            get_tag_insert(hs);
+            if((ssi->inserts_len + ssi->tag_insert_len) > LWIP_HTTPD_SSI_PRERENDER_LEN) {
+                LWIP_DEBUGF(HTTPD_DEBUG, ("http_ssi_content_length: inserts don't fit\n"));
+                ssi->inserts_len = 0;
+                return 0;
+            }
+            MEMCPY(&ssi->inserts[ssi->inserts_len], ssi->tag_insert, ssi->tag_insert_len);
+            ssi->inserts_len += ssi->tag_insert_len;
+        }
+#if LWIP_HTTPD_SSI_MULTIPART
+        while(ssi->tag_part != HTTPD_LAST_TAG_PART);
+#endif /* LWIP_HTTPD_SSI_MULTIPART */
+        insert_len = (u16_t)(ssi->inserts_len - start - sizeof(insert_len));
+        MEMCPY(&ssi->inserts[start], &insert_len, sizeof(insert_len));
+        body_len += insert_len;
+#if !LWIP_HTTPD_SSI_INCLUDE_TAG
+        body_len -= tag->len;
+#endif /* !LWIP_HTTPD_SSI_INCLUDE_TAG */
+    }
+    ssi->prerendered = 1;
+
+    len = sizeof("Content-Length: ") - 1;
+    MEMCPY(ssi->tag_insert, "Content-Length: ", len);
+    lwip_itoa(&ssi->tag_insert[len], LWIP_HTTPD_MAX_TAG_INSERT_LEN + 1 - sizeof(CRLF) + 1 - len, (int)body_len);
+    len = strlen(ssi->tag_insert);
+    MEMCPY(&ssi->tag_insert[len], CRLF, sizeof(CRLF));
+    ssi->tag_insert_len = (u16_t)(len + 2);
+    ssi->hdr_insert = 1;
+    ssi->inserting = 0;
+    ssi->insert_at = hdr_end;
+    return 1;
+}
+#endif /* HTTPD_SSI_CONTENT_LENGTH */
 #endif /* LWIP_HTTPD_SSI */
 
 #if LWIP_HTTPD_DYNAMIC_HEADERS
@@ -1025,7 +1276,8 @@ http_send_headers(struct tcp_pcb *pcb, struct http_state *hs)
  * either close the file or read the next block (if supported).
  *
  * @returns: 0 if the file is finished or no data has been read
- *           1 if the file is not finished and data has been read
+ *           1 if the file is not finished and data has been read or
+ *             the response to a pipelined request is ready to be sent
  */
 static u8_t
 http_check_eof(struct tcp_pcb *pcb, struct http_state *hs)
@@ -1043,8 +1295,7 @@ http_check_eof(struct tcp_pcb *pcb, struct http_state *hs)
     if(fs_bytes_left(hs->handle) <= 0) {
         /* We reached the end of the file so this request is done. */
         LWIP_DEBUGF(HTTPD_DEBUG, ("End of file.\n"));
-        http_eof(pcb, hs);
-        return 0;
+        return http_eof(pcb, hs);
     }
 #if LWIP_HTTPD_DYNAMIC_FILE_READ
     /* Do we already have a send buffer allocated? */
@@ -1083,23 +1334,15 @@ http_check_eof(struct tcp_pcb *pcb, struct http_state *hs)
             /* Delayed read, wait for FS to unblock us */
             return 0;
         }
-        /* We reached the end of the file so this request is done.
-         * @todo: don't close here for HTTP/1.1? */
+        /* We reached the end of the file so this request is done. */
         LWIP_DEBUGF(HTTPD_DEBUG, ("End of file.\n"));
-        http_eof(pcb, hs);
-        return 0;
+        return http_eof(pcb, hs);
     }
 
     /* Set up to send the block of data we just read */
     LWIP_DEBUGF(HTTPD_DEBUG, ("Read %d bytes.\n", count));
     hs->left = count;
     hs->file = hs->buf;
-#if LWIP_HTTPD_SSI
-    if(hs->ssi) {
-        hs->ssi->parse_left = count;
-        hs->ssi->parsed = hs->buf;
-    }
-#endif /* LWIP_HTTPD_SSI */
 #else /* LWIP_HTTPD_DYNAMIC_FILE_READ */
     LWIP_ASSERT("SSI and DYNAMIC_HEADERS turned off but eof not reached", 0);
 #endif /* LWIP_HTTPD_SSI || LWIP_HTTPD_DYNAMIC_HEADERS */
@@ -1146,7 +1389,10 @@ http_send_data_nonssi(struct tcp_pcb *pcb, struct http_state *hs)
 }
 
 #if LWIP_HTTPD_SSI
-/** Sub-function of http_send(): This is the send-routine for ssi files
+/** Sub-function of http_send(): This is the send-routine for ssi files.
+ * The tags are taken from the table makefsdata.py made for the file, so the
+ * text up to the next insert is sent from the file system without copying,
+ * only the inserts are copied into the send buffer.
  *
  * @returns: - 1: data has been written (so call tcp_ouput)
  *           - 0: no data has been written (no need to call tcp_output)
@@ -1154,349 +1400,60 @@ http_send_data_nonssi(struct tcp_pcb *pcb, struct http_state *hs)
 static u8_t
 http_send_data_ssi(struct tcp_pcb *pcb, struct http_state *hs)
 {
-    err_t err = ERR_OK;
+    err_t err;
     u16_t len;
-    u16_t mss;
+    u32_t run;
     u8_t data_to_send = 0;
 
     struct http_ssi_state *ssi = hs->ssi;
     LWIP_ASSERT("ssi != NULL", ssi != NULL);
-    /* We are processing an SHTML file so need to scan for tags and replace
-     * them with insert strings. We need to be careful here since a tag may
-     * straddle the boundary of two blocks read from the file and we may also
-     * have to split the insert string between two tcp_write operations. */
-
-    /* How much data could we send? */
-    len = tcp_sndbuf(pcb);
-
-    /* Do we have remaining data to send before parsing more? */
-    if(ssi->parsed > hs->file) {
-        /* We cannot send more data than space available in the send
-           buffer. */
-        if(tcp_sndbuf(pcb) < (ssi->parsed - hs->file)) {
-            len = tcp_sndbuf(pcb);
-        } else {
-            LWIP_ASSERT("Data size does not fit into u16_t!",
-                        (ssi->parsed - hs->file) <= 0xffff);
-            len = (u16_t)(ssi->parsed - hs->file);
-        }
-        mss = tcp_mss(pcb);
-        if(len > (2 * mss)) {
-            len = 2 * mss;
-        }
-
-        err = http_write(pcb, hs->file, &len, HTTP_IS_DATA_VOLATILE(hs));
-        if(err == ERR_OK) {
-            data_to_send = 1;
-            hs->file += len;
-            hs->left -= len;
-        }
-
-        /* If the send buffer is full, return now. */
-        if(tcp_sndbuf(pcb) == 0) {
-            return data_to_send;
-        }
-    }
-
-    LWIP_DEBUGF(HTTPD_DEBUG, ("State %d, %d left\n", ssi->tag_state, (int)ssi->parse_left));
-
-    /* We have sent all the data that was already parsed so continue parsing
-     * the buffer contents looking for SSI tags. */
-    while((ssi->parse_left) && (err == ERR_OK)) {
-        /* @todo: somewhere in this loop, 'len' should grow again... */
-        if(len == 0) {
-            return data_to_send;
-        }
-        switch(ssi->tag_state) {
-        case TAG_NONE:
-            /* We are not currently processing an SSI tag so scan for the
-             * start of the lead-in marker. */
-            if(*ssi->parsed == g_pcTagLeadIn[0]) {
-                /* We found what could be the lead-in for a new tag so change
-                 * state appropriately. */
-                ssi->tag_state = TAG_LEADIN;
-                ssi->tag_index = 1;
-#if !LWIP_HTTPD_SSI_INCLUDE_TAG
-                ssi->tag_started = ssi->parsed;
-#endif /* !LWIP_HTTPD_SSI_INCLUDE_TAG */
-            }
-
-            /* Move on to the next character in the buffer */
-            ssi->parse_left--;
-            ssi->parsed++;
-            break;
-
-        case TAG_LEADIN:
-            /* We are processing the lead-in marker, looking for the start of
-             * the tag name. */
-
-            /* Have we reached the end of the leadin? */
-            if(ssi->tag_index == LEN_TAG_LEAD_IN) {
-                ssi->tag_index = 0;
-                ssi->tag_state = TAG_FOUND;
-            } else {
-                /* Have we found the next character we expect for the tag leadin? */
-                if(*ssi->parsed == g_pcTagLeadIn[ssi->tag_index]) {
-                    /* Yes - move to the next one unless we have found the complete
-                     * leadin, in which case we start looking for the tag itself */
-                    ssi->tag_index++;
-                } else {
-                    /* We found an unexpected character so this is not a tag. Move
-                     * back to idle state. */
-                    ssi->tag_state = TAG_NONE;
-                }
-
-                /* Move on to the next character in the buffer */
-                ssi->parse_left--;
-                ssi->parsed++;
-            }
-            break;
 
-        case TAG_FOUND:
-            /* We are reading the tag name, looking for the start of the
-             * lead-out marker and removing any whitespace found. */
-
-            /* Remove leading whitespace between the tag leading and the first
-             * tag name character. */
-            if((ssi->tag_index == 0) && ((*ssi->parsed == ' ') ||
-                                         (*ssi->parsed == '\t') || (*ssi->parsed == '\n') ||
-                                         (*ssi->parsed == '\r'))) {
-                /* Move on to the next character in the buffer */
-                ssi->parse_left--;
-                ssi->parsed++;
-                break;
+    for(;;) {
+        if((ssi->insert_at != NULL) && (hs->file == ssi->insert_at)) {
+            /* We are at an insert point, send the insert */
+            if(!ssi->inserting) {
+                http_ssi_render(hs);
             }
-
-            /* Have we found the end of the tag name? This is signalled by
-             * us finding the first leadout character or whitespace */
-            if((*ssi->parsed == g_pcTagLeadOut[0]) ||
-                    (*ssi->parsed == ' ')  || (*ssi->parsed == '\t') ||
-                    (*ssi->parsed == '\n') || (*ssi->parsed == '\r')) {
-
-                if(ssi->tag_index == 0) {
-                    /* We read a zero length tag so ignore it. */
-                    ssi->tag_state = TAG_NONE;
-                } else {
-                    /* We read a non-empty tag so go ahead and look for the
-                     * leadout string. */
-                    ssi->tag_state = TAG_LEADOUT;
-                    LWIP_ASSERT("ssi->tag_index <= 0xff", ssi->tag_index <= 0xff);
-                    ssi->tag_name_len = (u8_t)ssi->tag_index;
-                    ssi->tag_name[ssi->tag_index] = '\0';
-                    if(*ssi->parsed == g_pcTagLeadOut[0]) {
-                        ssi->tag_index = 1;
-                    } else {
-                        ssi->tag_index = 0;
-                    }
+            if(ssi->tag_index < ssi->tag_insert_len) {
+                len = (u16_t)LWIP_MIN(tcp_sndbuf(pcb), ssi->tag_insert_len - ssi->tag_index);
+                if(len == 0) {
+                    break;
                 }
-            } else {
-                /* This character is part of the tag name so save it */
-                if(ssi->tag_index < LWIP_HTTPD_MAX_TAG_NAME_LEN) {
-                    ssi->tag_name[ssi->tag_index++] = *ssi->parsed;
-                } else {
-                    /* The tag was too long so ignore it. */
-                    ssi->tag_state = TAG_NONE;
+                /* Note that we set the copy flag here since we only have a
+                 * single tag insert buffer per connection. */
+                err = http_write(pcb, &ssi->insert[ssi->tag_index], &len, HTTP_IS_TAG_VOLATILE(hs));
+                if(err != ERR_OK) {
+                    break;
                 }
+                data_to_send = 1;
+                ssi->tag_index += len;
+                continue;
             }
-
-            /* Move on to the next character in the buffer */
-            ssi->parse_left--;
-            ssi->parsed++;
-
-            break;
-
-        /* We are looking for the end of the lead-out marker. */
-        case TAG_LEADOUT:
-            /* Remove leading whitespace between the tag leading and the first
-             * tag leadout character. */
-            if((ssi->tag_index == 0) && ((*ssi->parsed == ' ') ||
-                                         (*ssi->parsed == '\t') || (*ssi->parsed == '\n') ||
-                                         (*ssi->parsed == '\r'))) {
-                /* Move on to the next character in the buffer */
-                ssi->parse_left--;
-                ssi->parsed++;
-                break;
-            }
-
-            /* Have we found the next character we expect for the tag leadout? */
-            if(*ssi->parsed == g_pcTagLeadOut[ssi->tag_index]) {
-                /* Yes - move to the next one unless we have found the complete
-                 * leadout, in which case we need to call the client to process
-                 * the tag. */
-
-                /* Move on to the next character in the buffer */
-                ssi->parse_left--;
-                ssi->parsed++;
-
-                if(ssi->tag_index == (LEN_TAG_LEAD_OUT - 1)) {
-                    /* Call the client to ask for the insert string for the
-                     * tag we just found. */
 #if LWIP_HTTPD_SSI_MULTIPART
-                    ssi->tag_part = 0; /* start with tag part 0 */
-#endif /* LWIP_HTTPD_SSI_MULTIPART */
-                    get_tag_insert(hs);
-
-                    /* Next time through, we are going to be sending data
-                     * immediately, either the end of the block we start
-                     * sending here or the insert string. */
-                    ssi->tag_index = 0;
-                    ssi->tag_state = TAG_SENDING;
-                    ssi->tag_end = ssi->parsed;
-#if !LWIP_HTTPD_SSI_INCLUDE_TAG
-                    ssi->parsed = ssi->tag_started;
-#endif /* !LWIP_HTTPD_SSI_INCLUDE_TAG*/
-
-                    /* If there is any unsent data in the buffer prior to the
-                     * tag, we need to send it now. */
-                    if(ssi->tag_end > hs->file) {
-                        /* How much of the data can we send? */
-#if LWIP_HTTPD_SSI_INCLUDE_TAG
-                        if(len > ssi->tag_end - hs->file) {
-                            len = (u16_t)(ssi->tag_end - hs->file);
-                        }
-#else /* LWIP_HTTPD_SSI_INCLUDE_TAG*/
-                        if(len > ssi->tag_started - hs->file) {
-                            /* we would include the tag in sending */
-                            len = (u16_t)(ssi->tag_started - hs->file);
-                        }
-#endif /* LWIP_HTTPD_SSI_INCLUDE_TAG*/
-
-                        err = http_write(pcb, hs->file, &len, HTTP_IS_DATA_VOLATILE(hs));
-                        if(err == ERR_OK) {
-                            data_to_send = 1;
-#if !LWIP_HTTPD_SSI_INCLUDE_TAG
-                            if(ssi->tag_started <= hs->file) {
-                                /* pretend to have sent the tag, too */
-                                len += ssi->tag_end - ssi->tag_started;
-                            }
-#endif /* !LWIP_HTTPD_SSI_INCLUDE_TAG*/
-                            hs->file += len;
-                            hs->left -= len;
-                        }
-                    }
-                } else {
-                    ssi->tag_index++;
-                }
-            } else {
-                /* We found an unexpected character so this is not a tag. Move
-                 * back to idle state. */
-                ssi->parse_left--;
-                ssi->parsed++;
-                ssi->tag_state = TAG_NONE;
+            if(ssi->tag_part != HTTPD_LAST_TAG_PART) {
+                /* The handler has more to insert for this tag */
+                ssi->tag_index = 0;
+                get_tag_insert(hs);
+                continue;
             }
-            break;
-
-        /*
-         * We have found a valid tag and are in the process of sending
-         * data as a result of that discovery. We send either remaining data
-         * from the file prior to the insert point or the insert string itself.
-         */
-        case TAG_SENDING:
-            /* Do we have any remaining file data to send from the buffer prior
-             * to the tag? */
-            if(ssi->tag_end > hs->file) {
-                /* How much of the data can we send? */
-#if LWIP_HTTPD_SSI_INCLUDE_TAG
-                if(len > ssi->tag_end - hs->file) {
-                    len = (u16_t)(ssi->tag_end - hs->file);
-                }
-#else /* LWIP_HTTPD_SSI_INCLUDE_TAG*/
-                LWIP_ASSERT("hs->started >= hs->file", ssi->tag_started >= hs->file);
-                if(len > ssi->tag_started - hs->file) {
-                    /* we would include the tag in sending */
-                    len = (u16_t)(ssi->tag_started - hs->file);
-                }
-#endif /* LWIP_HTTPD_SSI_INCLUDE_TAG*/
-                if(len != 0) {
-                    err = http_write(pcb, hs->file, &len, HTTP_IS_DATA_VOLATILE(hs));
-                } else {
-                    err = ERR_OK;
-                }
-                if(err == ERR_OK) {
-                    data_to_send = 1;
-#if !LWIP_HTTPD_SSI_INCLUDE_TAG
-                    if(ssi->tag_started <= hs->file) {
-                        /* pretend to have sent the tag, too */
-                        len += ssi->tag_end - ssi->tag_started;
-                    }
-#endif /* !LWIP_HTTPD_SSI_INCLUDE_TAG*/
-                    hs->file += len;
-                    hs->left -= len;
-                }
-            } else {
-#if LWIP_HTTPD_SSI_MULTIPART
-                if(ssi->tag_index >= ssi->tag_insert_len) {
-                    /* Did the last SSIHandler have more to send? */
-                    if(ssi->tag_part != HTTPD_LAST_TAG_PART) {
-                        /* If so, call it again */
-                        ssi->tag_index = 0;
-                        get_tag_insert(hs);
-                    }
-                }
-#endif /* LWIP_HTTPD_SSI_MULTIPART */
-
-                /* Do we still have insert data left to send? */
-                if(ssi->tag_index < ssi->tag_insert_len) {
-                    /* We are sending the insert string itself. How much of the
-                     * insert can we send? */
-                    if(len > (ssi->tag_insert_len - ssi->tag_index)) {
-                        len = (ssi->tag_insert_len - ssi->tag_index);
-                    }
-
-                    /* Note that we set the copy flag here since we only have a
-                     * single tag insert buffer per connection. If we don't do
-                     * this, insert corruption can occur if more than one insert
-                     * is processed before we call tcp_output. */
-                    err = http_write(pcb, &(ssi->tag_insert[ssi->tag_index]), &len,
-                                     HTTP_IS_TAG_VOLATILE(hs));
-                    if(err == ERR_OK) {
-                        data_to_send = 1;
-                        ssi->tag_index += len;
-                        /* Don't return here: keep on sending data */
-                    }
-                } else {
-#if LWIP_HTTPD_SSI_MULTIPART
-                    if(ssi->tag_part == HTTPD_LAST_TAG_PART)
 #endif /* LWIP_HTTPD_SSI_MULTIPART */
-                    {
-                        /* We have sent all the insert data so go back to looking for
-                         * a new tag. */
-                        LWIP_DEBUGF(HTTPD_DEBUG, ("Everything sent.\n"));
-                        ssi->tag_index = 0;
-                        ssi->tag_state = TAG_NONE;
-#if !LWIP_HTTPD_SSI_INCLUDE_TAG
-                        ssi->parsed = ssi->tag_end;
-#endif /* !LWIP_HTTPD_SSI_INCLUDE_TAG*/
-                    }
-                }
-                break;
-            }
+            http_ssi_insert_done(hs);
+            continue;
         }
-    }
 
-    /* If we drop out of the end of the for loop, this implies we must have
-     * file data to send so send it now. In TAG_SENDING state, we've already
-     * handled this so skip the send if that's the case. */
-    if((ssi->tag_state != TAG_SENDING) && (ssi->parsed > hs->file)) {
-        /* We cannot send more data than space available in the send
-           buffer. */
-        if(tcp_sndbuf(pcb) < (ssi->parsed - hs->file)) {
-            len = tcp_sndbuf(pcb);
-        } else {
-            LWIP_ASSERT("Data size does not fit into u16_t!",
-                        (ssi->parsed - hs->file) <= 0xffff);
-            len = (u16_t)(ssi->parsed - hs->file);
-        }
-        if(len > (2 * tcp_mss(pcb))) {
-            len = 2 * tcp_mss(pcb);
+        /* Send the file up to the next insert */
+        run = (ssi->insert_at != NULL) ? (u32_t)(ssi->insert_at - hs->file) : hs->left;
+        len = (u16_t)LWIP_MIN(LWIP_MIN(run, tcp_sndbuf(pcb)), 2 * tcp_mss(pcb));
+        if(len == 0) {
+            break;
         }
-
         err = http_write(pcb, hs->file, &len, HTTP_IS_DATA_VOLATILE(hs));
-        if(err == ERR_OK) {
-            data_to_send = 1;
-            hs->file += len;
-            hs->left -= len;
+        if(err != ERR_OK) {
+            break;
         }
+        data_to_send = 1;
+        hs->file += len;
+        hs->left -= len;
     }
     return data_to_send;
 }
@@ -1512,6 +1469,7 @@ static u8_t
 http_send(struct tcp_pcb *pcb, struct http_state *hs)
 {
     u8_t data_to_send = HTTP_NO_DATA_TO_SEND;
+    u8_t next_response;
 
     LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("http_send: pcb=%p hs=%p left=%d\n", (void *)pcb,
                 (void *)hs, hs != NULL ? (int)hs->left : 0));
@@ -1527,48 +1485,56 @@ http_send(struct tcp_pcb *pcb, struct http_state *hs)
         return 0;
     }
 
+    /* Send the responses to pipelined requests in the same go while they
+     * fit into the send buffer. */
+    do {
 #if LWIP_HTTPD_FS_ASYNC_READ
-    /* Check if we are allowed to read from this file.
-       (e.g. SSI might want to delay sending until data is available) */
-    if(!fs_is_file_ready(hs->handle, http_continue, hs)) {
-        return 0;
-    }
+        /* Check if we are allowed to read from this file.
+           (e.g. SSI might want to delay sending until data is available) */
+        if(!fs_is_file_ready(hs->handle, http_continue, hs)) {
+            return 0;
+        }
 #endif /* LWIP_HTTPD_FS_ASYNC_READ */
 
 #if LWIP_HTTPD_DYNAMIC_HEADERS
-    /* Do we have any more header data to send for this file? */
-    if(hs->hdr_index < NUM_FILE_HDR_STRINGS) {
-        data_to_send = http_send_headers(pcb, hs);
-        if(data_to_send != HTTP_DATA_TO_SEND_CONTINUE) {
-            return data_to_send;
+        /* Do we have any more header data to send for this file? */
+        if(hs->hdr_index < NUM_FILE_HDR_STRINGS) {
+            data_to_send = http_send_headers(pcb, hs);
+            if(data_to_send != HTTP_DATA_TO_SEND_CONTINUE) {
+                return data_to_send;
+            }
         }
-    }
 #endif /* LWIP_HTTPD_DYNAMIC_HEADERS */
 
-    /* Have we run out of file data to send? If so, we need to read the next
-     * block from the file. */
-    if(hs->left == 0) {
-        if(!http_check_eof(pcb, hs)) {
-            return 0;
+        /* Have we run out of file data to send? If so, we need to read the next
+         * block from the file. */
+        if((hs->left == 0) && !LWIP_HTTPD_SSI_PENDING(hs)) {
+            if(!http_check_eof(pcb, hs)) {
+                return 0;
+            }
         }
-    }
 
 #if LWIP_HTTPD_SSI
-    if(hs->ssi) {
-        data_to_send = http_send_data_ssi(pcb, hs);
-    } else
+        if(hs->ssi) {
+            data_to_send = http_send_data_ssi(pcb, hs);
+        } else
 #endif /* LWIP_HTTPD_SSI */
-    {
-        data_to_send = http_send_data_nonssi(pcb, hs);
-    }
+        {
+            data_to_send = http_send_data_nonssi(pcb, hs);
+        }
+
+        next_response = 0;
+        if((hs->left == 0) && !LWIP_HTTPD_SSI_PENDING(hs) && (fs_bytes_left(hs->handle) <= 0)) {
+            /* We reached the end of the file so this request is done.
+             * This adds the FIN flag right into the last data segment. */
+            LWIP_DEBUGF(HTTPD_DEBUG, ("End of file.\n"));
+            next_response = http_eof(pcb, hs);
+            if(!next_response) {
+                return 0;
+            }
+        }
+    } while(next_response);
 
-    if((hs->left == 0) && (fs_bytes_left(hs->handle) <= 0)) {
-        /* We reached the end of the file so this request is done.
-         * This adds the FIN flag right into the last data segment. */
-        LWIP_DEBUGF(HTTPD_DEBUG, ("End of file.\n"));
-        http_eof(pcb, hs);
-        return 0;
-    }
     LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("send_data end.\n"));
     return data_to_send;
 }
@@ -1666,7 +1632,7 @@ http_handle_post_finished(struct http_state *hs)
     /* NULL-terminate the buffer */
     http_post_response_filename[0] = 0;
     httpd_post_finished(hs, http_post_response_filename, LWIP_HTTPD_POST_MAX_RESPONSE_URI_LEN);
-    return http_find_file(hs, http_post_response_filename, 0);
+    return http_find_file(hs, http_post_response_filename, 0, NULL);
 }
 
 /** Pass received POST body data to the application and correctly handle
@@ -1782,7 +1748,7 @@ http_post_request(struct pbuf **inp, struct http_state *hs,
                         }
                     } else {
                         /* return file passed from application */
-                        return http_find_file(hs, http_post_response_filename, 0);
+                        return http_find_file(hs, http_post_response_filename, 0, NULL);
                     }
                 } else {
                     LWIP_DEBUGF(HTTPD_DEBUG, ("POST received invalid Content-Length: %s\n",
@@ -1859,11 +1825,75 @@ http_continue(void *connection)
 }
 #endif /* LWIP_HTTPD_FS_ASYNC_READ */
 
+#if LWIP_HTTPD_FS_GZIP || LWIP_HTTPD_FS_ETAG
+/**
+ * Find the value of a request header.
+ *
+ * @param headers the request from the CRLF ending its first line
+ * @param headers_len length of the headers
+ * @param name the header name, starting with CRLF and ending with ':'
+ * @param value_len receives the length of the value
+ * @return the value, not NULL-terminated, or NULL if the header is missing
+ */
+static const char *
+http_header_value(const char *headers, u16_t headers_len, const char *name, u16_t *value_len)
+{
+    const char *value, *end;
+
+    value = strnstr(headers, name, headers_len);
+    if(value == NULL) {
+        return NULL;
+    }
+    value += strlen(name);
+    while((value < (headers + headers_len)) && (*value == ' ')) {
+        value++;
+    }
+    end = strnstr(value, CRLF, headers_len - (value - headers));
+    if(end == NULL) {
+        return NULL;
+    }
+    *value_len = (u16_t)(end - value);
+    return value;
+}
+
+/**
+ * Collect the request headers fs_open_ext() chooses the file variant with.
+ *
+ * @param headers the request from the CRLF ending its first line
+ * @param headers_len length of the headers
+ * @param request the structure to fill
+ */
+static void
+http_parse_fs_request(const char *headers, u16_t headers_len, struct fs_request *request)
+{
+    const char *value;
+    u16_t value_len;
+
+    request->accept_gzip = 0;
+    request->if_none_match = NULL;
+    request->if_none_match_len = 0;
+#if LWIP_HTTPD_FS_GZIP
+    value = http_header_value(headers, headers_len, CRLF "Accept-Encoding:", &value_len);
+    if((value != NULL) && (strnstr(value, "gzip", value_len) != NULL)) {
+        request->accept_gzip = 1;
+    }
+#endif /* LWIP_HTTPD_FS_GZIP */
+#if LWIP_HTTPD_FS_ETAG
+    value = http_header_value(headers, headers_len, CRLF "If-None-Match:", &value_len);
+    if(value != NULL) {
+        request->if_none_match = value;
+        request->if_none_match_len = value_len;
+    }
+#endif /* LWIP_HTTPD_FS_ETAG */
+}
+#endif /* LWIP_HTTPD_FS_GZIP || LWIP_HTTPD_FS_ETAG */
+
 /**
  * When data has been received in the correct state, try to parse it
  * as a HTTP request.
  *
- * @param p the received pbuf
+ * @param inp the received pbuf or NULL to parse the pipelined request
+ *        already enqueued in hs->req
  * @param hs the connection state
  * @param pcb the tcp_pcb which received this packet
  * @return ERR_OK if request was OK and hs has been initialized correctly
@@ -1876,7 +1906,7 @@ http_parse_request(struct pbuf **inp, struct http_state *hs, struct tcp_pcb *pcb
     char *data;
     char *crlf;
     u16_t data_len;
-    struct pbuf *p = *inp;
+    struct pbuf *p = (inp != NULL) ? *inp : NULL;
 #if LWIP_HTTPD_SUPPORT_REQUESTLIST
     u16_t clen;
 #endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
@@ -1885,7 +1915,11 @@ http_parse_request(struct pbuf **inp, struct http_state *hs, struct tcp_pcb *pcb
 #endif /* LWIP_HTTPD_SUPPORT_POST */
 
     LWIP_UNUSED_ARG(pcb); /* only used for post */
+#if LWIP_HTTPD_SUPPORT_REQUESTLIST
+    LWIP_ASSERT("p != NULL", (p != NULL) || (hs->req != NULL));
+#else /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
     LWIP_ASSERT("p != NULL", p != NULL);
+#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
     LWIP_ASSERT("hs != NULL", hs != NULL);
 
     if((hs->handle != NULL) || (hs->file != NULL)) {
@@ -1897,18 +1931,21 @@ http_parse_request(struct pbuf **inp, struct http_state *hs, struct tcp_pcb *pcb
 
 #if LWIP_HTTPD_SUPPORT_REQUESTLIST
 
-    LWIP_DEBUGF(HTTPD_DEBUG, ("Received %"U16_F" bytes\n", p->tot_len));
-
     /* first check allowed characters in this pbuf? */
 
     /* enqueue the pbuf */
-    if(hs->req == NULL) {
+    if(p == NULL) {
+        LWIP_DEBUGF(HTTPD_DEBUG, ("Parsing %"U16_F" pipelined bytes\n", hs->req->tot_len));
+    } else if(hs->req == NULL) {
+        LWIP_DEBUGF(HTTPD_DEBUG, ("Received %"U16_F" bytes\n", p->tot_len));
         LWIP_DEBUGF(HTTPD_DEBUG, ("First pbuf\n"));
         hs->req = p;
     } else {
+        LWIP_DEBUGF(HTTPD_DEBUG, ("Received %"U16_F" bytes\n", p->tot_len));
         LWIP_DEBUGF(HTTPD_DEBUG, ("pbuf enqueued\n"));
         pbuf_cat(hs->req, p);
     }
+    p = hs->req;
 
     if(hs->req->next != NULL) {
         data_len = LWIP_MIN(hs->req->tot_len, LWIP_HTTPD_MAX_REQ_LENGTH);
@@ -1976,12 +2013,32 @@ http_parse_request(struct pbuf **inp, struct http_state *hs, struct tcp_pcb *pcb
             uri_len = sp2 - (sp1 + 1);
             if((sp2 != 0) && (sp2 > sp1)) {
                 /* wait for CRLFCRLF (indicating end of HTTP headers) before parsing anything */
-                if(strnstr(data, CRLF CRLF, data_len) != NULL) {
+                char *crlfcrlf = strnstr(data, CRLF CRLF, data_len);
+                if(crlfcrlf != NULL) {
                     char *uri = sp1 + 1;
+                    struct fs_request request;
+                    /* only look at this request, more may be pipelined behind it */
+                    u16_t req_len = (u16_t)(crlfcrlf + 4 - data);
+#if LWIP_HTTPD_FS_GZIP || LWIP_HTTPD_FS_ETAG
+                    /* read the headers before the request line is NULL-terminated */
+                    http_parse_fs_request(crlf, req_len - (u16_t)(crlf - data), &request);
+#else /* LWIP_HTTPD_FS_GZIP || LWIP_HTTPD_FS_ETAG */
+                    memset(&request, 0, sizeof(request));
+#endif /* LWIP_HTTPD_FS_GZIP || LWIP_HTTPD_FS_ETAG */
 #if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
-                    if(!is_09 && strnstr(data, HTTP11_CONNECTIONKEEPALIVE, data_len)) {
+                    /* HTTP/1.1 connections are persistent unless the client
+                       closes them, HTTP/1.0 ones are closed: the headers of
+                       the files don't hold "Connection: keep-alive" */
+                    hs->keepalive = 0;
+                    if(!is_09 && !strncmp(sp2 + 1, HTTP11_VERSION, sizeof(HTTP11_VERSION) - 1) &&
+                            (strnstr(data, HTTP11_CONNECTIONCLOSE, req_len) == NULL)) {
                         hs->keepalive = 1;
                     }
+#if LWIP_HTTPD_SUPPORT_REQUESTLIST
+                    hs->req_len = req_len;
+#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+#else /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+                    LWIP_UNUSED_ARG(req_len);
 #endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
                     /* null-terminate the METHOD (pbuf is freed anyway wen returning) */
                     *sp1 = 0;
@@ -2009,7 +2066,7 @@ http_parse_request(struct pbuf **inp, struct http_state *hs, struct tcp_pcb *pcb
                     } else
 #endif /* LWIP_HTTPD_SUPPORT_POST */
                     {
-                        return http_find_file(hs, uri, is_09);
+                        return http_find_file(hs, uri, is_09, &request);
                     }
                 }
             } else {
@@ -2042,18 +2099,21 @@ badrequest:
  * @param hs the connection state
  * @param uri the HTTP header URI
  * @param is_09 1 if the request is HTTP/0.9 (no HTTP headers in response)
+ * @param request the request headers selecting the file variant, may be NULL
  * @return ERR_OK if file was found and hs has been initialized correctly
  *         another err_t otherwise
  */
 static err_t
-http_find_file(struct http_state *hs, const char *uri, int is_09)
+http_find_file(struct http_state *hs, const char *uri, int is_09, const struct fs_request *request)
 {
     size_t loop;
     struct fs_file *file = NULL;
     char *params;
     err_t err;
-#if LWIP_HTTPD_CGI
+#if LWIP_HTTPD_CGI || LWIP_HTTPD_STREAM
     int i;
+#endif /* LWIP_HTTPD_CGI || LWIP_HTTPD_STREAM */
+#if LWIP_HTTPD_CGI
     int count;
 #endif /* LWIP_HTTPD_CGI */
 #if !LWIP_HTTPD_SSI
@@ -2068,7 +2128,7 @@ http_find_file(struct http_state *hs, const char *uri, int is_09)
            that exists. */
         for(loop = 0; loop < NUM_DEFAULT_FILENAMES; loop++) {
             LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("Looking for %s...\n", g_psDefaultFilenames[loop].name));
-            err = fs_open(&hs->file_handle, (char *)g_psDefaultFilenames[loop].name);
+            err = fs_open_ext(&hs->file_handle, (char *)g_psDefaultFilenames[loop].name, request);
             uri = (char *)g_psDefaultFilenames[loop].name;
             if(err == ERR_OK) {
                 file = &hs->file_handle;
@@ -2096,6 +2156,20 @@ http_find_file(struct http_state *hs, const char *uri, int is_09)
             params++;
         }
 
+#if LWIP_HTTPD_STREAM
+        /* Does the base URI correspond to a stream handler? */
+        for(i = 0; (g_pStreams != NULL) && (i < g_iNumStreams); i++) {
+            if(strcmp(uri, g_pStreams[i].pcStreamName) == 0) {
+                if(g_pStreams[i].pfnStreamHandler(i, hs->pcb, params) == ERR_OK) {
+                    /* the handler has taken the connection over */
+                    hs->streaming = 1;
+                    return ERR_OK;
+                }
+                break;
+            }
+        }
+#endif /* LWIP_HTTPD_STREAM */
+
 #if LWIP_HTTPD_CGI
         /* Does the base URI we have isolated correspond to a CGI handler? */
         if(g_iNumCGIs && g_pCGIs) {
@@ -2116,7 +2190,7 @@ http_find_file(struct http_state *hs, const char *uri, int is_09)
 
         LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("Opening %s\n", uri));
 
-        err = fs_open(&hs->file_handle, uri);
+        err = fs_open_ext(&hs->file_handle, uri, request);
         if(err == ERR_OK) {
             file = &hs->file_handle;
         } else {
@@ -2159,11 +2233,8 @@ http_init_file(struct http_state *hs, struct fs_file *file, int is_09, const cha
         if(tag_check) {
             struct http_ssi_state *ssi = http_ssi_state_alloc();
             if(ssi != NULL) {
-                ssi->tag_index = 0;
-                ssi->tag_state = TAG_NONE;
-                ssi->parsed = file->data;
-                ssi->parse_left = file->len;
-                ssi->tag_end = file->data;
+                ssi->tag = file->ssi_tags;
+                ssi->tags_left = file->ssi_tag_count;
                 hs->ssi = ssi;
             }
         }
@@ -2193,11 +2264,33 @@ http_init_file(struct http_state *hs, struct fs_file *file, int is_09, const cha
             }
         }
 #endif /* LWIP_HTTPD_SUPPORT_V09*/
+#if LWIP_HTTPD_SSI
+        if(hs->ssi != NULL) {
+            http_ssi_next_insert(hs);
+        }
+#endif /* LWIP_HTTPD_SSI */
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+        /* the connection is only kept if the client can find the end of the response */
+        if(hs->keepalive) {
+#if HTTPD_SSI_CONTENT_LENGTH
+            if(hs->ssi != NULL) {
+                hs->keepalive = http_ssi_content_length(hs);
+            } else
+#endif /* HTTPD_SSI_CONTENT_LENGTH */
+            if(!(hs->handle->http_header_included & FS_FILE_FLAGS_HEADER_PERSISTENT)) {
+                hs->keepalive = 0;
+            }
+        }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
     } else {
         hs->handle = NULL;
         hs->file = NULL;
         hs->left = 0;
         hs->retries = 0;
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+        /* nothing to send, close the connection */
+        hs->keepalive = 0;
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
     }
 #if LWIP_HTTPD_DYNAMIC_HEADERS
     /* Determine the HTTP headers to send based on the file extension of
@@ -2256,6 +2349,8 @@ http_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
  * The poll function is called every 2nd second.
  * If there has been no data sent (which resets the retries) in 8 seconds, close.
  * If the last portion of a file has not been sent in 2 seconds, close.
+ * If a persistent connection has been idle for LWIP_HTTPD_KEEPALIVE_IDLE_POLLS
+ * polls, close it to give the pcb to the next client.
  *
  * This could be increased, but we don't want to waste resources for bad connections.
  */
@@ -2286,6 +2381,13 @@ http_poll(void *arg, struct tcp_pcb *pcb)
             http_close_conn(pcb, hs);
             return ERR_OK;
         }
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+        if(hs->keepalive && (hs->handle == NULL) && (hs->retries >= LWIP_HTTPD_KEEPALIVE_IDLE_POLLS)) {
+            LWIP_DEBUGF(HTTPD_DEBUG, ("http_poll: persistent connection idle, close\n"));
+            http_close_conn(pcb, hs);
+            return ERR_OK;
+        }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
 
         /* If this connection has a file open, try to send some more data. If
          * it has not yet received a GET request, don't do this since it will
@@ -2303,9 +2405,47 @@ http_poll(void *arg, struct tcp_pcb *pcb)
     return ERR_OK;
 }
 
+#if LWIP_HTTPD_SUPPORT_REQUESTLIST
+/**
+ * Drop the request http_parse_request() is done with from hs->req. On a
+ * persistent connection, the requests pipelined behind it are kept and the
+ * receive window held back for them is opened again.
+ *
+ * @param pcb the tcp_pcb of the connection
+ * @param hs the connection state
+ * @param parsed return value of http_parse_request()
+ */
+static void
+http_req_consume(struct tcp_pcb *pcb, struct http_state *hs, err_t parsed)
+{
+    LWIP_UNUSED_ARG(pcb);
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+    if(hs->req_unrecved != 0) {
+        tcp_recved(pcb, hs->req_unrecved);
+        hs->req_unrecved = 0;
+    }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+    if((parsed == ERR_INPROGRESS) || (hs->req == NULL)) {
+        /* request not complete yet */
+        return;
+    }
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+    if((parsed == ERR_OK) && hs->keepalive && (hs->req_len < hs->req->tot_len)) {
+        hs->req = pbuf_free_header(hs->req, hs->req_len);
+        return;
+    }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+    /* request fully parsed or error */
+    pbuf_free(hs->req);
+    hs->req = NULL;
+}
+#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+
 /**
  * Data has been received on this pcb.
  * For HTTP 1.0, this should normally only happen once (if the request fits in one packet).
+ * On a persistent connection, requests received while a response is sent are
+ * enqueued and parsed when it is done (pipelining).
  */
 static err_t
 http_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
@@ -2330,6 +2470,25 @@ http_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
         return ERR_OK;
     }
 
+#if LWIP_HTTPD_SUPPORT_11_KEEPALIVE && LWIP_HTTPD_SUPPORT_REQUESTLIST
+    if((hs->handle != NULL) && hs->keepalive
+#if LWIP_HTTPD_SUPPORT_POST
+            && (hs->post_content_len_left == 0)
+#endif /* LWIP_HTTPD_SUPPORT_POST */
+      ) {
+        /* pipelined request: keep it for when the current response is done,
+           the window stays closed for it until then */
+        LWIP_DEBUGF(HTTPD_DEBUG, ("http_recv: request pipelined\n"));
+        hs->req_unrecved += p->tot_len;
+        if(hs->req == NULL) {
+            hs->req = p;
+        } else {
+            pbuf_cat(hs->req, p);
+        }
+        return ERR_OK;
+    }
+#endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE && LWIP_HTTPD_SUPPORT_REQUESTLIST */
+
 #if LWIP_HTTPD_SUPPORT_POST && LWIP_HTTPD_POST_MANUAL_WND
     if(hs->no_auto_wnd) {
         hs->unrecved_bytes += p->tot_len;
@@ -2361,21 +2520,24 @@ http_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
                         || parsed == ERR_INPROGRESS || parsed == ERR_ARG || parsed == ERR_USE);
         } else {
             LWIP_DEBUGF(HTTPD_DEBUG, ("http_recv: already sending data\n"));
+            pbuf_free(p);
+            p = NULL;
         }
 #if LWIP_HTTPD_SUPPORT_REQUESTLIST
-        if(parsed != ERR_INPROGRESS) {
-            /* request fully parsed or error */
-            if(hs->req != NULL) {
-                pbuf_free(hs->req);
-                hs->req = NULL;
-            }
-        }
+        http_req_consume(pcb, hs, parsed);
 #else /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
         if(p != NULL) {
             /* pbuf not passed to application, free it now */
             pbuf_free(p);
         }
 #endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+#if LWIP_HTTPD_STREAM
+        if((parsed == ERR_OK) && hs->streaming) {
+            /* the pcb belongs to the stream handler now */
+            http_state_free(hs);
+            return ERR_OK;
+        }
+#endif /* LWIP_HTTPD_STREAM */
         if(parsed == ERR_OK) {
 #if LWIP_HTTPD_SUPPORT_POST
             if(hs->post_content_len_left == 0)
@@ -2474,6 +2636,10 @@ httpd_init(void)
     httpd_cgi_init();
 #endif
 
+#if LWIP_HTTPD_STREAM
+    httpd_stream_init();
+#endif /* LWIP_HTTPD_STREAM */
+
     httpd_init_addr(IP_ADDR_ANY);
 }
 
@@ -2518,4 +2684,22 @@ http_set_cgi_handlers(const tCGI *cgis, int num_handlers)
 }
 #endif /* LWIP_HTTPD_CGI */
 
+#if LWIP_HTTPD_STREAM
+/**
+ * Set an array of stream URIs/handler functions
+ *
+ * @param streams an array of stream URIs/handler functions
+ * @param num_handlers number of elements in the 'streams' array
+ */
+void
+http_set_stream_handlers(const tStream *streams, int num_handlers)
+{
+    LWIP_ASSERT("no streams given", streams != NULL);
+    LWIP_ASSERT("invalid number of handlers", num_handlers > 0);
+
+    g_pStreams = streams;
+    g_iNumStreams = num_handlers;
+}
+#endif /* LWIP_HTTPD_STREAM */
+
 #endif /* LWIP_TCP */
@@ -47,9 +47,18 @@ __IO uint32_t g_localtime = 0;
 uint32_t g_timedelay;
 
 void adc_config(void);
+void adc_dma_config(void);
+void adc_timer_config(void);
 void cache_enable(void);
 void mpu_config(void);
 
+/* non-cacheable region holding the .dma_nocache section, defined by the linker script */
+extern uint8_t __dma_nocache_region_start[];
+extern uint8_t __dma_nocache_region_size[];
+
+/* ADC samples written by the DMA, non-cacheable so they are read without cache maintenance */
+__attribute__((section(".dma_nocache"), aligned(32))) uint16_t adc_ring[ADC_STREAM_RING_LEN];
+
 /*!
     \brief      main function
     \param[in]  none
@@ -71,7 +80,9 @@ int main(void)
     /* setup ethernet system(GPIOs, clocks, MAC, DMA, systick) */
     enet_system_setup();
 
+    adc_dma_config();
     adc_config();
+    adc_timer_config();
 
     /* initilaize the LwIP stack */
     lwip_stack_init();
@@ -112,6 +123,9 @@ int main(void)
 #else
         lwip_timeouts_check(g_localtime);
 #endif /* TIMEOUT_CHECK_USE_LWIP */
+
+        /* push the ADC samples to the telemetry stream clients */
+        http_adc_stream_check(g_localtime);
     }
 }
 
@@ -156,8 +170,6 @@ void adc_config(void)
     adc_deinit(ADC2);
     /* ADC clock config */
     adc_clock_config(ADC2, ADC_CLK_SYNC_HCLK_DIV6);
-    /* ADC contineous function enable */
-    adc_special_function_config(ADC2, ADC_CONTINUOUS_MODE, ENABLE);
     /* ADC scan mode enable */
     adc_special_function_config(ADC2, ADC_SCAN_MODE, ENABLE);
     adc_special_function_config(ADC2, ADC_INSERTED_CHANNEL_AUTO, ENABLE);
@@ -167,22 +179,96 @@ void adc_config(void)
     adc_data_alignment_config(ADC2, ADC_DATAALIGN_RIGHT);
 
     /* ADC channel length config */
+    adc_channel_length_config(ADC2, ADC_REGULAR_CHANNEL, 1);
     adc_channel_length_config(ADC2, ADC_INSERTED_CHANNEL, 1);
 
-    /* ADC internal reference voltage channel config */
+    /* ADC internal reference voltage channel config: the regular channel is sampled into adc_ring,
+       the inserted channel converts after it and is read by the SSI handler */
+    adc_regular_channel_config(ADC2, 0, ADC_CHANNEL_19, 480);
     adc_inserted_channel_config(ADC2, 0, ADC_CHANNEL_19, 480);
 
     /* enable internal reference voltage channel */
     adc_internal_channel_config(ADC_CHANNEL_INTERNAL_VREFINT, ENABLE);
 
-    /* ADC trigger config */
+    /* ADC trigger config: TIMER5 starts the regular conversions */
+    trigsel_init(TRIGSEL_OUTPUT_ADC2_REGTRG, TRIGSEL_INPUT_TIMER5_TRGO0);
+    adc_external_trigger_config(ADC2, ADC_REGULAR_CHANNEL, EXTERNAL_TRIGGER_RISING);
     adc_external_trigger_config(ADC2, ADC_INSERTED_CHANNEL, EXTERNAL_TRIGGER_DISABLE);
 
+    /* ADC DMA request for every regular conversion */
+    adc_dma_request_after_last_enable(ADC2);
+    adc_dma_mode_enable(ADC2);
+
     /* enable ADC interface */
     adc_enable(ADC2);
+}
 
-    /* ADC software trigger enable */
-    adc_software_trigger_enable(ADC2, ADC_INSERTED_CHANNEL);
+/*!
+    \brief      configure the DMA filling adc_ring with the ADC samples
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void adc_dma_config(void)
+{
+    dma_single_data_parameter_struct dma_single_data_parameter;
+
+    rcu_periph_clock_enable(RCU_DMA0);
+    rcu_periph_clock_enable(RCU_DMAMUX);
+
+    dma_deinit(DMA0, DMA_CH0);
+
+    /* initialize DMA single data mode, circular over the ring buffer */
+    dma_single_data_para_struct_init(&dma_single_data_parameter);
+    dma_single_data_parameter.request = DMA_REQUEST_ADC2;
+    dma_single_data_parameter.periph_addr = (uint32_t)(&ADC_RDATA(ADC2));
+    dma_single_data_parameter.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_single_data_parameter.memory0_addr = (uint32_t)adc_ring;
+    dma_single_data_parameter.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_single_data_parameter.periph_memory_width = DMA_PERIPH_WIDTH_16BIT;
+    dma_single_data_parameter.circular_mode = DMA_CIRCULAR_MODE_ENABLE;
+    dma_single_data_parameter.direction = DMA_PERIPH_TO_MEMORY;
+    dma_single_data_parameter.number = ADC_STREAM_RING_LEN;
+    dma_single_data_parameter.priority = DMA_PRIORITY_HIGH;
+    dma_single_data_mode_init(DMA0, DMA_CH0, &dma_single_data_parameter);
+
+    /* enable DMA channel */
+    dma_channel_enable(DMA0, DMA_CH0);
+}
+
+/*!
+    \brief      configure TIMER5 to trigger the ADC at ADC_STREAM_SAMPLE_RATE
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void adc_timer_config(void)
+{
+    timer_parameter_struct timer_initpara;
+    uint32_t timer_clk;
+
+    rcu_periph_clock_enable(RCU_TIMER5);
+    rcu_periph_clock_enable(RCU_TRIGSEL);
+
+    /* the TIMER clock is twice CK_APB1 if APB1 is divided from AHB */
+    timer_clk = rcu_clock_freq_get(CK_APB1);
+    if(timer_clk != rcu_clock_freq_get(CK_AHB)) {
+        timer_clk *= 2U;
+    }
+
+    timer_deinit(TIMER5);
+    timer_struct_para_init(&timer_initpara);
+    /* count at 1MHz */
+    timer_initpara.prescaler = (uint16_t)(timer_clk / 1000000U - 1U);
+    timer_initpara.alignedmode = TIMER_COUNTER_EDGE;
+    timer_initpara.counterdirection = TIMER_COUNTER_UP;
+    timer_initpara.period = 1000000U / ADC_STREAM_SAMPLE_RATE - 1U;
+    timer_initpara.clockdivision = TIMER_CKDIV_DIV1;
+    timer_init(TIMER5, &timer_initpara);
+
+    /* the update event starts a conversion */
+    timer_master_output0_trigger_source_select(TIMER5, TIMER_TRI_OUT0_SRC_UPDATE);
+    timer_enable(TIMER5);
 }
 
 /*!
@@ -199,6 +285,25 @@ void cache_enable(void)
     /* Enable D-Cache */
     SCB_EnableDCache();
 }
+/*!
+    \brief      get the MPU region size encoding of a memory size
+    \param[in]  size: memory size in bytes, a power of two from 32 bytes
+    \param[out] none
+    \retval     MPU_REGION_SIZE_32B to MPU_REGION_SIZE_4GB
+*/
+static uint8_t mpu_region_size_get(uint32_t size)
+{
+    uint8_t region_size = MPU_REGION_SIZE_32B;
+    uint32_t region_bytes = 32U;
+
+    while((region_bytes < size) && (region_size < MPU_REGION_SIZE_4GB)) {
+        region_size++;
+        region_bytes <<= 1U;
+    }
+
+    return region_size;
+}
+
 /*!
     \brief      configure the MPU
     \param[in]  none
@@ -213,28 +318,14 @@ void mpu_config(void)
     /* disable the MPU */
     ARM_MPU_SetRegion(0U, 0U);
 
-    /* Configure the DMA descriptors and Rx/Tx buffer*/
-    mpu_init_struct.region_base_address = 0x30000000;
-    mpu_init_struct.region_size = MPU_REGION_SIZE_16KB;
-    mpu_init_struct.access_permission = MPU_AP_FULL_ACCESS;
-    mpu_init_struct.access_bufferable = MPU_ACCESS_BUFFERABLE;
-    mpu_init_struct.access_cacheable = MPU_ACCESS_NON_CACHEABLE;
-    mpu_init_struct.access_shareable = MPU_ACCESS_NON_SHAREABLE;
-    mpu_init_struct.region_number = MPU_REGION_NUMBER0;
-    mpu_init_struct.subregion_disable = MPU_SUBREGION_ENABLE;
-    mpu_init_struct.instruction_exec = MPU_INSTRUCTION_EXEC_PERMIT;
-    mpu_init_struct.tex_type = MPU_TEX_TYPE0;
-    mpu_region_config(&mpu_init_struct);
-    mpu_region_enable();
-
-    /* Configure the LwIP RAM heap */
-    mpu_init_struct.region_base_address = 0x30004000;
-    mpu_init_struct.region_size = MPU_REGION_SIZE_16KB;
+    /* Configure the DMA descriptors and Rx/Tx buffer as normal non-cacheable memory */
+    mpu_init_struct.region_base_address = (uint32_t)__dma_nocache_region_start;
+    mpu_init_struct.region_size = mpu_region_size_get((uint32_t)__dma_nocache_region_size);
     mpu_init_struct.access_permission = MPU_AP_FULL_ACCESS;
     mpu_init_struct.access_bufferable = MPU_ACCESS_NON_BUFFERABLE;
     mpu_init_struct.access_cacheable = MPU_ACCESS_NON_CACHEABLE;
     mpu_init_struct.access_shareable = MPU_ACCESS_SHAREABLE;
-    mpu_init_struct.region_number = MPU_REGION_NUMBER1;
+    mpu_init_struct.region_number = MPU_REGION_NUMBER0;
     mpu_init_struct.subregion_disable = MPU_SUBREGION_ENABLE;
     mpu_init_struct.instruction_exec = MPU_INSTRUCTION_EXEC_PERMIT;
     mpu_init_struct.tex_type = MPU_TEX_TYPE1;
@@ -100,7 +100,7 @@ void lwip_stack_init(void)
 #endif /* USE_DHCP */
 #ifdef USE_ENET0
     /* add a new network interface */
-    netif_add(&g_mynetif0, &gd_ipaddr, &gd_netmask, &gd_gw, NULL, &ethernetif_init, &ethernet_input);
+    netif_add(&g_mynetif0, &gd_ipaddr, &gd_netmask, &gd_gw, enet_handle_get(ENET0), &ethernetif_init, &ethernet_input);
 
     /* set a default network interface */
     netif_set_default(&g_mynetif0);
@@ -113,11 +113,20 @@ void lwip_stack_init(void)
 #endif /* USE_ENET0 */
 
 #ifdef USE_ENET1
+#if defined(USE_ENET0) && !defined(USE_DHCP)
+    /* ENET1 is on its own subnet when both interfaces are used */
+    IP4_ADDR(&gd_ipaddr, BOARD_ENET1_IP_ADDR0, BOARD_ENET1_IP_ADDR1, BOARD_ENET1_IP_ADDR2, BOARD_ENET1_IP_ADDR3);
+    IP4_ADDR(&gd_netmask, BOARD_ENET1_NETMASK_ADDR0, BOARD_ENET1_NETMASK_ADDR1, BOARD_ENET1_NETMASK_ADDR2, BOARD_ENET1_NETMASK_ADDR3);
+    IP4_ADDR(&gd_gw, BOARD_ENET1_GW_ADDR0, BOARD_ENET1_GW_ADDR1, BOARD_ENET1_GW_ADDR2, BOARD_ENET1_GW_ADDR3);
+#endif /* USE_ENET0 && !USE_DHCP */
+
     /* add a new network interface */
-    netif_add(&g_mynetif1, &gd_ipaddr, &gd_netmask, &gd_gw, NULL, &ethernetif_init, &ethernet_input);
+    netif_add(&g_mynetif1, &gd_ipaddr, &gd_netmask, &gd_gw, enet_handle_get(ENET1), &ethernetif_init, &ethernet_input);
 
-    /* set a default network interface */
+#ifndef USE_ENET0
+    /* set a default network interface, ENET0 stays the default when both are used */
     netif_set_default(&g_mynetif1);
+#endif /* USE_ENET0 */
 
     /* set the flag of netif as NETIF_FLAG_LINK_UP */
     netif_set_link_up(&g_mynetif1);
@@ -41,6 +41,9 @@
 #include "lwip/mem.h"
 #include "lwip/pbuf.h"
 #include "lwip/timeouts.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/prot/ip.h"
+#include "lwip/prot/ip4.h"
 #include "netif/etharp.h"
 #include "err.h"
 #include "ethernetif.h"
@@ -61,18 +64,118 @@
 #define IFNAME0 'G'
 #define IFNAME1 'D'
 
-/* ENET RxDMA/TxDMA descriptor */
-extern enet_descriptors_struct  rxdesc_tab[ENET_RXBUF_NUM], txdesc_tab[ENET_TXBUF_NUM];
+/** Set this to 1 to hand the ENET Rx DMA buffers to the stack as custom pbufs
+ * instead of copying every received frame into a PBUF_POOL chain.
+ * Requires LWIP_SUPPORT_CUSTOM_PBUF.
+ */
+#ifndef ETHERNETIF_RX_ZERO_COPY
+#define ETHERNETIF_RX_ZERO_COPY                   0
+#endif
 
-/* ENET receive buffer  */
-extern uint8_t rx_buff[ENET_RXBUF_NUM][ENET_RXBUF_SIZE];
+/** The number of Rx buffers on top of ENET_RXBUF_NUM used to re-arm the Rx
+ * descriptors while the stack still holds received frames.
+ */
+#ifndef ETHERNETIF_RX_SPARE_BUF_NUM
+#define ETHERNETIF_RX_SPARE_BUF_NUM               8
+#endif
 
-/* ENET transmit buffer */
-extern uint8_t tx_buff[ENET_TXBUF_NUM][ENET_TXBUF_SIZE];
+/** Set this to 1 to chain the pbufs of an outgoing frame across several ENET
+ * Tx descriptors instead of copying them into one tx_buff slot. The pbufs are
+ * referenced until the DMA has sent the frame.
+ */
+#ifndef ETHERNETIF_TX_SCATTER_GATHER
+#define ETHERNETIF_TX_SCATTER_GATHER              0
+#endif
 
-/*global transmit and receive descriptors pointers */
-extern enet_descriptors_struct  *dma_current_txdesc;
-extern enet_descriptors_struct  *dma_current_rxdesc;
+/** The maximum number of frames the input task passes to the stack in one
+ * poll round. While the task polls, the Rx interrupt stays masked.
+ */
+#ifndef ETHERNETIF_RX_BUDGET
+#define ETHERNETIF_RX_BUDGET                      16
+#endif
+
+/** The ticks the input task sleeps after a poll round used the whole budget,
+ * so that lower priority tasks can run under Rx load. 0 only yields.
+ */
+#ifndef ETHERNETIF_RX_BUDGET_BACKOFF
+#define ETHERNETIF_RX_BUDGET_BACKOFF              1
+#endif
+
+/** Set this to a value from 1 to 255 to delay the Rx interrupt with the
+ * receive watchdog instead of raising it for every frame. The unit is the
+ * RSWDC count (256 ENET clock cycles). 0 raises the interrupt immediately.
+ */
+#ifndef ETHERNETIF_RX_COALESCE_DELAY
+#define ETHERNETIF_RX_COALESCE_DELAY              0
+#endif
+
+/** Set this to 1 to put the outgoing frames into two priority queues in front
+ * of the Tx DMA ring. The high priority queue is always served first, and the
+ * low priority queue may only fill ETHERNETIF_TX_LOW_PRIO_DESC_LIMIT Tx
+ * descriptors, so a high priority frame never waits behind more than that.
+ * Requires ETHERNETIF_TX_SCATTER_GATHER.
+ */
+#ifndef ETHERNETIF_TX_PRIORITY_QUEUE
+#define ETHERNETIF_TX_PRIORITY_QUEUE              0
+#endif
+
+/** The number of frames each Tx priority queue holds. Frames coming to a full
+ * queue are dropped and counted, TCP sends them again later.
+ */
+#ifndef ETHERNETIF_TX_QUEUE_DEPTH
+#define ETHERNETIF_TX_QUEUE_DEPTH                 16
+#endif
+
+/** The number of Tx descriptors the low priority frames may hold at once. */
+#ifndef ETHERNETIF_TX_LOW_PRIO_DESC_LIMIT
+#define ETHERNETIF_TX_LOW_PRIO_DESC_LIMIT         (ENET_TXBUF_NUM / 2)
+#endif
+
+/** IPv4 frames with a DSCP of at least this (CS4), VLAN frames with a priority
+ * of at least ETHERNETIF_TX_HIGH_PRIO_PCP and ARP frames are high priority.
+ */
+#ifndef ETHERNETIF_TX_HIGH_PRIO_DSCP
+#define ETHERNETIF_TX_HIGH_PRIO_DSCP              32
+#endif
+
+#ifndef ETHERNETIF_TX_HIGH_PRIO_PCP
+#define ETHERNETIF_TX_HIGH_PRIO_PCP               4
+#endif
+
+/** Set this to 1 to check in software the IPv4 header and TCP or UDP checksums
+ * of the frames the ENET checksum offload has bypassed, e.g. for IP options.
+ * Frames the ENET found a checksum error in are always dropped.
+ * Only used with CHECKSUM_BY_HARDWARE.
+ */
+#ifndef ETHERNETIF_RX_CHECKSUM_FALLBACK
+#define ETHERNETIF_RX_CHECKSUM_FALLBACK           1
+#endif
+
+#if ETHERNETIF_RX_ZERO_COPY && !LWIP_SUPPORT_CUSTOM_PBUF
+#error "ETHERNETIF_RX_ZERO_COPY requires LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
+
+#if !ETHERNETIF_RX_ZERO_COPY && (0U != ENET_RX_ZERO_COPY)
+#error "ENET_RX_ZERO_COPY leaves the Rx descriptors without buffers, it requires ETHERNETIF_RX_ZERO_COPY"
+#endif
+
+#if ETHERNETIF_TX_PRIORITY_QUEUE && !ETHERNETIF_TX_SCATTER_GATHER
+#error "ETHERNETIF_TX_PRIORITY_QUEUE requires ETHERNETIF_TX_SCATTER_GATHER"
+#endif
+
+#if ETHERNETIF_TX_SCATTER_GATHER && defined(SELECT_DESCRIPTORS_ENHANCED_MODE)
+#error "ETHERNETIF_TX_SCATTER_GATHER does not support SELECT_DESCRIPTORS_ENHANCED_MODE"
+#endif
+
+#if defined(LWIP_PTP) && LWIP_PTP
+#error "LWIP_PTP is only supported by the Basic ethernetif port"
+#endif
+
+#ifdef USE_ENET0
+#define ETHERNETIF_ENET                           ENET0
+#else
+#define ETHERNETIF_ENET                           ENET1
+#endif /* USE_ENET0 */
 
 /* preserve another ENET RxDMA/TxDMA ptp descriptor for normal mode */
 enet_descriptors_struct  ptp_txstructure[ENET_TXBUF_NUM];
@@ -80,7 +183,76 @@ enet_descriptors_struct  ptp_rxstructure[ENET_RXBUF_NUM];
 
 
 static struct netif *low_netif = NULL;
+/* ENET instance with the RxDMA/TxDMA descriptors and buffers of the interface */
+static enet_handle_struct *low_handle = NULL;
 xSemaphoreHandle g_rx_semaphore = NULL;
+xSemaphoreHandle g_tx_semaphore = NULL;
+/* Rx interrupt and poll counters, read with ethernetif_rx_stats_get() */
+static ethernetif_rx_stats_struct rx_stats;
+#ifdef CHECKSUM_BY_HARDWARE
+/* Rx checksum offload counters, read with ethernetif_rx_checksum_stats_get() */
+static ethernetif_rx_checksum_stats_struct rx_checksum_stats;
+#endif /* CHECKSUM_BY_HARDWARE */
+
+#if ETHERNETIF_RX_ZERO_COPY
+/* size of one zero-copy Rx buffer, rounded up to a whole D-Cache line */
+#define ETHERNETIF_RX_BUFFER_SIZE                 ((ENET_RXBUF_SIZE + 31U) & ~31U)
+/* one buffer per Rx descriptor plus the replenish pool */
+#define ETHERNETIF_RX_BUFFER_NUM                  (ENET_RXBUF_NUM + ETHERNETIF_RX_SPARE_BUF_NUM)
+
+/* custom pbuf which references an ENET Rx DMA buffer */
+typedef struct {
+    struct pbuf_custom pc;                                      /*!< lwIP custom pbuf, must be the first member */
+    uint8_t *buffer;                                            /*!< Rx DMA buffer wrapped by the pbuf */
+} rx_pbuf_struct;
+
+/* zero-copy Rx buffers, aligned to the D-Cache line for cache maintenance */
+static uint8_t rx_zc_buff[ETHERNETIF_RX_BUFFER_NUM][ETHERNETIF_RX_BUFFER_SIZE] __attribute__((aligned(32)));
+static rx_pbuf_struct rx_pbuf[ETHERNETIF_RX_BUFFER_NUM];
+
+/* indexes of the buffers which are neither attached to a descriptor nor held by the stack */
+static uint16_t rx_free_list[ETHERNETIF_RX_BUFFER_NUM];
+static uint32_t rx_free_count = 0U;
+
+/* oldest Rx descriptor taken from the DMA which has not been re-armed yet */
+static enet_descriptors_struct *rx_refill_desc = NULL;
+static uint32_t rx_unarmed_count = 0U;
+
+static void rx_zero_copy_init(void);
+static void rx_buffer_refill(void);
+static void rx_pbuf_free_custom(struct pbuf *p);
+#endif /* ETHERNETIF_RX_ZERO_COPY */
+
+#if ETHERNETIF_TX_SCATTER_GATHER
+/* frames with more pbufs than this are sent from a single pbuf copy */
+#define ETHERNETIF_TX_MAX_SEGMENTS                ENET_TXBUF_NUM
+
+/* pbuf held by the last Tx descriptor of each frame until the DMA has sent it */
+static struct pbuf *tx_pbuf[ENET_TXBUF_NUM];
+
+/* oldest Tx descriptor handed to the DMA which has not been reclaimed yet */
+static enet_descriptors_struct *tx_reclaim_desc = NULL;
+static uint32_t tx_busy_count = 0U;
+
+static void tx_buffer_reclaim(void);
+#endif /* ETHERNETIF_TX_SCATTER_GATHER */
+
+#if ETHERNETIF_TX_PRIORITY_QUEUE
+/* frames waiting for Tx descriptors, in the order they came */
+typedef struct {
+    struct pbuf *frame[ETHERNETIF_TX_QUEUE_DEPTH];              /*!< referenced frames */
+    uint32_t head;                                              /*!< index of the oldest frame */
+    uint32_t count;                                             /*!< number of frames in the queue */
+} tx_queue_struct;
+
+static tx_queue_struct tx_queue[ETHERNETIF_TX_QUEUE_NUM];
+/* per queue counters, read with ethernetif_tx_stats_get() */
+static ethernetif_tx_stats_struct tx_stats;
+/* serializes the Tx queues and the Tx descriptors between the senders and the output task */
+static xSemaphoreHandle tx_lock = NULL;
+
+static void ethernetif_output(void *pvParameters);
+#endif /* ETHERNETIF_TX_PRIORITY_QUEUE */
 
 /**
 * In this function, the hardware should be initialized.
@@ -111,6 +283,7 @@ static void low_level_init(struct netif *netif)
     netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_LINK_UP;
 
     low_netif = netif;
+    low_handle = enet_handle_get(ETHERNETIF_ENET);
 
     /* create binary semaphore used for informing ethernetif of frame reception */
     if(g_rx_semaphore == NULL) {
@@ -118,6 +291,14 @@ static void low_level_init(struct netif *netif)
         xSemaphoreTake(g_rx_semaphore, 0);
     }
 
+#if ETHERNETIF_TX_SCATTER_GATHER
+    /* create binary semaphore used for informing ethernetif of frame transmission */
+    if(g_tx_semaphore == NULL) {
+        vSemaphoreCreateBinary(g_tx_semaphore);
+        xSemaphoreTake(g_tx_semaphore, 0);
+    }
+#endif /* ETHERNETIF_TX_SCATTER_GATHER */
+
 #ifdef USE_ENET0
     /* initialize MAC address in ethernet MAC */
     enet_mac_address_set(ENET0, ENET_MAC_ADDRESS0, netif->hwaddr);
@@ -159,7 +340,11 @@ static void low_level_init(struct netif *netif)
     {
         int i;
         for(i = 0; i < ENET_RXBUF_NUM; i++) {
-            enet_rx_desc_immediate_receive_complete_interrupt(&rxdesc_tab[i]);
+#if ETHERNETIF_RX_COALESCE_DELAY
+            enet_rx_desc_delay_receive_complete_interrupt(ETHERNETIF_ENET, &low_handle->rxdesc_tab[i], ETHERNETIF_RX_COALESCE_DELAY);
+#else
+            enet_rx_desc_immediate_receive_complete_interrupt(&low_handle->rxdesc_tab[i]);
+#endif /* ETHERNETIF_RX_COALESCE_DELAY */
         }
     }
 
@@ -167,10 +352,31 @@ static void low_level_init(struct netif *netif)
 #ifdef CHECKSUM_BY_HARDWARE
     /* enable the TCP, UDP and ICMP checksum insertion for the Tx frames */
     for(i = 0; i < ENET_TXBUF_NUM; i++) {
-        enet_transmit_checksum_config(&txdesc_tab[i], ENET_CHECKSUM_TCPUDPICMP_FULL);
+        enet_transmit_checksum_config(&low_handle->txdesc_tab[i], ENET_CHECKSUM_TCPUDPICMP_FULL);
     }
 #endif /* CHECKSUM_BY_HARDWARE */
 
+#if ETHERNETIF_RX_ZERO_COPY
+    /* attach the zero-copy buffers to the Rx descriptors */
+    rx_zero_copy_init();
+#endif /* ETHERNETIF_RX_ZERO_COPY */
+
+#if ETHERNETIF_TX_SCATTER_GATHER
+    /* start reclaiming from the first Tx descriptor and wake up the sender on Tx complete */
+    tx_reclaim_desc = low_handle->txdesc_current;
+    enet_interrupt_enable(ETHERNETIF_ENET, ENET_DMA_INT_TIE);
+#endif /* ETHERNETIF_TX_SCATTER_GATHER */
+
+#if ETHERNETIF_TX_PRIORITY_QUEUE
+    if(tx_lock == NULL) {
+        vSemaphoreCreateBinary(tx_lock);
+    }
+
+    /* create the task that moves the queued frames to the Tx descriptors released by the DMA */
+    xTaskCreate(ethernetif_output, "ETHERNETIF_OUTPUT", ETHERNETIF_INPUT_TASK_STACK_SIZE, NULL,
+                ETHERNETIF_INPUT_TASK_PRIO, NULL);
+#endif /* ETHERNETIF_TX_PRIORITY_QUEUE */
+
     /* create the task that handles the ETH_MAC */
     xTaskCreate(ethernetif_input, "ETHERNETIF_INPUT", ETHERNETIF_INPUT_TASK_STACK_SIZE, NULL,
                 ETHERNETIF_INPUT_TASK_PRIO, NULL);
@@ -204,6 +410,338 @@ static void low_level_init(struct netif *netif)
 *       dropped because of memory failure (except for the TCP timers).
 */
 
+#if ETHERNETIF_TX_SCATTER_GATHER
+/**
+* Tell whether a Tx frame must be sent from a copy: its chain is longer than
+* the Tx ring, or one of its pbufs references volatile data (PBUF_REF) which
+* the caller may reuse as soon as the output call returns.
+*
+* @param p the frame to send
+* @return 1 if the frame must be copied, 0 if its pbufs can be referenced
+*/
+static int tx_frame_needs_copy(struct pbuf *p)
+{
+    struct pbuf *q;
+
+    if(pbuf_clen(p) > ETHERNETIF_TX_MAX_SEGMENTS) {
+        return 1;
+    }
+
+    for(q = p; q != NULL; q = q->next) {
+        if(PBUF_NEEDS_COPY(q)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+#if ETHERNETIF_TX_PRIORITY_QUEUE
+/**
+* Pick the Tx queue of a frame from its ethernet, VLAN and IPv4 headers.
+*
+* @param p the frame
+* @return ETHERNETIF_TX_QUEUE_HIGH or ETHERNETIF_TX_QUEUE_LOW
+*/
+static uint32_t tx_frame_classify(struct pbuf *p)
+{
+    uint8_t header[SIZEOF_ETH_HDR + 4U + 2U];
+    uint16_t len, type;
+    uint16_t offset = 12U;
+
+    len = pbuf_copy_partial(p, header, sizeof(header), 0U);
+    if(len < SIZEOF_ETH_HDR) {
+        return ETHERNETIF_TX_QUEUE_LOW;
+    }
+
+    type = (uint16_t)((header[offset] << 8) | header[offset + 1U]);
+    if(ETHTYPE_VLAN == type) {
+        /* the priority code point is in the top 3 bits of the tag */
+        if((header[offset + 2U] >> 5) >= ETHERNETIF_TX_HIGH_PRIO_PCP) {
+            return ETHERNETIF_TX_QUEUE_HIGH;
+        }
+        offset += 4U;
+        type = (uint16_t)((header[offset] << 8) | header[offset + 1U]);
+    }
+
+    if(ETHTYPE_ARP == type) {
+        return ETHERNETIF_TX_QUEUE_HIGH;
+    }
+    /* the DSCP is in the top 6 bits of the second byte of the IPv4 header */
+    if((ETHTYPE_IP == type) && (len >= (offset + 4U)) && ((header[offset + 3U] >> 2) >= ETHERNETIF_TX_HIGH_PRIO_DSCP)) {
+        return ETHERNETIF_TX_QUEUE_HIGH;
+    }
+
+    return ETHERNETIF_TX_QUEUE_LOW;
+}
+
+/**
+* Hand a frame to the Tx DMA if there are enough free Tx descriptors for it.
+* Must be called with tx_lock held.
+*
+* @param p the frame
+* @param queue the queue the frame comes from
+* @return SUCCESS if the DMA took the frame, ERROR if it has to wait
+*/
+static ErrStatus tx_frame_send(struct pbuf *p, uint32_t queue)
+{
+    enet_frame_segment_struct segment[ETHERNETIF_TX_MAX_SEGMENTS];
+    enet_descriptors_struct *last_desc = NULL;
+    struct pbuf *q;
+    uint32_t num = 0U;
+    uint32_t i, start;
+    ErrStatus reval = ERROR;
+
+    SYS_ARCH_DECL_PROTECT(sr);
+
+    for(q = p; q != NULL; q = q->next) {
+        if(0U != q->len) {
+            segment[num].buffer_addr = (uint32_t)q->payload;
+            segment[num].length = q->len;
+            num++;
+        }
+    }
+
+    if(0U == num) {
+        /* nothing to send */
+        pbuf_free(p);
+        return SUCCESS;
+    }
+    if((ENET_TXBUF_NUM - tx_busy_count) < num) {
+        return ERROR;
+    }
+    /* a low priority frame may always use an idle ring, even if it is longer than the limit */
+    if((ETHERNETIF_TX_QUEUE_HIGH != queue) && (0U != tx_busy_count) &&
+            ((tx_busy_count + num) > ETHERNETIF_TX_LOW_PRIO_DESC_LIMIT)) {
+        return ERROR;
+    }
+
+    /* make the payload visible to the DMA */
+    for(i = 0U; i < num; i++) {
+        start = segment[i].buffer_addr & ~31U;
+        SCB_CleanDCache_by_Addr((uint32_t *)start, (int32_t)(segment[i].buffer_addr + segment[i].length - start));
+    }
+
+    SYS_ARCH_PROTECT(sr);
+    if(SUCCESS == enet_handle_frame_segments_transmit(low_handle, segment, num, &last_desc)) {
+        /* the pbuf is released by tx_buffer_reclaim() once the last descriptor is sent */
+        tx_pbuf[last_desc - low_handle->txdesc_tab] = p;
+        tx_busy_count += num;
+        reval = SUCCESS;
+    }
+    SYS_ARCH_UNPROTECT(sr);
+
+    return reval;
+}
+
+/**
+* Move the queued frames to the free Tx descriptors, high priority first.
+* Must be called with tx_lock held.
+*/
+static void tx_queue_service(void)
+{
+    tx_queue_struct *queue;
+    uint32_t i;
+
+    tx_buffer_reclaim();
+
+    for(i = 0U; i < ETHERNETIF_TX_QUEUE_NUM; i++) {
+        queue = &tx_queue[i];
+        while(0U != queue->count) {
+            if(SUCCESS != tx_frame_send(queue->frame[queue->head], i)) {
+                /* a lower priority frame never overtakes a waiting higher priority one */
+                return;
+            }
+            queue->frame[queue->head] = NULL;
+            queue->head = (queue->head + 1U) % ETHERNETIF_TX_QUEUE_DEPTH;
+            queue->count--;
+            tx_stats.queue[i].sent++;
+        }
+    }
+}
+
+/**
+* This function is the ethernetif_output task. It is woken up by the Tx
+* complete interrupt and sends the frames which waited for Tx descriptors.
+*
+* @param pvParameters not used
+*/
+static void ethernetif_output(void *pvParameters)
+{
+    for(;;) {
+        /* poll now and then as well, in case an interrupt was missed */
+        xSemaphoreTake(g_tx_semaphore, LOWLEVEL_OUTPUT_WAITING_TIME);
+        if(xSemaphoreTake(tx_lock, portMAX_DELAY)) {
+            tx_queue_service();
+            xSemaphoreGive(tx_lock);
+        }
+    }
+}
+
+/**
+* This function copies the Tx queue counters of the interface.
+*
+* @param stats the structure to fill
+*/
+void ethernetif_tx_stats_get(ethernetif_tx_stats_struct *stats)
+{
+    uint32_t i;
+    SYS_ARCH_DECL_PROTECT(sr);
+
+    SYS_ARCH_PROTECT(sr);
+    *stats = tx_stats;
+    for(i = 0U; i < ETHERNETIF_TX_QUEUE_NUM; i++) {
+        stats->queue[i].depth = tx_queue[i].count;
+    }
+    SYS_ARCH_UNPROTECT(sr);
+}
+
+static err_t low_level_output(struct netif *netif, struct pbuf *p)
+{
+    uint32_t index = tx_frame_classify(p);
+    tx_queue_struct *queue = &tx_queue[index];
+    ethernetif_tx_queue_stats_struct *stats = &tx_stats.queue[index];
+    err_t errval = ERR_OK;
+
+    if(!xSemaphoreTake(tx_lock, LOWLEVEL_OUTPUT_WAITING_TIME)) {
+        LINK_STATS_INC(link.drop);
+        return ERR_TIMEOUT;
+    }
+
+    if(queue->count >= ETHERNETIF_TX_QUEUE_DEPTH) {
+        /* never block the caller, TCP sends the segment again later */
+        stats->dropped++;
+        LINK_STATS_INC(link.drop);
+        errval = ERR_MEM;
+    } else {
+        /* the queue holds only pbufs the driver owns, a frame which cannot be
+           referenced until the DMA has sent it is queued as a flattened copy */
+        if(tx_frame_needs_copy(p)) {
+            p = pbuf_clone(PBUF_RAW, PBUF_RAM, p);
+        } else {
+            pbuf_ref(p);
+        }
+
+        if(NULL == p) {
+            stats->dropped++;
+            LINK_STATS_INC(link.memerr);
+            errval = ERR_MEM;
+        } else {
+            queue->frame[(queue->head + queue->count) % ETHERNETIF_TX_QUEUE_DEPTH] = p;
+            queue->count++;
+            stats->enqueued++;
+            if(queue->count > stats->max_depth) {
+                stats->max_depth = queue->count;
+            }
+        }
+    }
+
+    /* send what the free Tx descriptors can take now, the output task sends the rest */
+    tx_queue_service();
+
+    xSemaphoreGive(tx_lock);
+
+    return errval;
+}
+#else
+static err_t low_level_output(struct netif *netif, struct pbuf *p)
+{
+    static xSemaphoreHandle s_tx_semaphore = NULL;
+    enet_frame_segment_struct segment[ETHERNETIF_TX_MAX_SEGMENTS];
+    enet_descriptors_struct *last_desc = NULL;
+    struct pbuf *q;
+    uint32_t num = 0U;
+    uint32_t start;
+    portTickType wait_start;
+    err_t errval = ERR_MEM;
+
+    SYS_ARCH_DECL_PROTECT(sr);
+
+    if(s_tx_semaphore == NULL) {
+        vSemaphoreCreateBinary(s_tx_semaphore);
+    }
+
+    if(!xSemaphoreTake(s_tx_semaphore, LOWLEVEL_OUTPUT_WAITING_TIME)) {
+        LINK_STATS_INC(link.drop);
+        return ERR_TIMEOUT;
+    }
+
+    /* a frame which cannot be referenced until the DMA has sent it is sent from a flattened copy */
+    if(tx_frame_needs_copy(p)) {
+        p = pbuf_clone(PBUF_RAW, PBUF_RAM, p);
+        if(NULL == p) {
+            xSemaphoreGive(s_tx_semaphore);
+            LINK_STATS_INC(link.memerr);
+            return ERR_MEM;
+        }
+    } else {
+        pbuf_ref(p);
+    }
+
+    /* describe the payload of every pbuf and make it visible to the DMA */
+    for(q = p; q != NULL; q = q->next) {
+        if(0U == q->len) {
+            continue;
+        }
+        segment[num].buffer_addr = (uint32_t)q->payload;
+        segment[num].length = q->len;
+        start = (uint32_t)q->payload & ~31U;
+        SCB_CleanDCache_by_Addr((uint32_t *)start, (int32_t)((uint32_t)q->payload + q->len - start));
+        num++;
+    }
+
+    /* wait for the DMA to release enough Tx descriptors, blocking on the Tx complete interrupt */
+    wait_start = xTaskGetTickCount();
+    tx_buffer_reclaim();
+    while((ENET_TXBUF_NUM - tx_busy_count) < num) {
+        if((xTaskGetTickCount() - wait_start) >= LOWLEVEL_OUTPUT_WAITING_TIME) {
+            break;
+        }
+        xSemaphoreTake(g_tx_semaphore, 1);
+        tx_buffer_reclaim();
+    }
+
+    if((ENET_TXBUF_NUM - tx_busy_count) >= num) {
+        SYS_ARCH_PROTECT(sr);
+        if(SUCCESS == enet_handle_frame_segments_transmit(low_handle, segment, num, &last_desc)) {
+            /* the pbuf is released by tx_buffer_reclaim() once the last descriptor is sent */
+            tx_pbuf[last_desc - low_handle->txdesc_tab] = p;
+            tx_busy_count += num;
+            errval = ERR_OK;
+        }
+        SYS_ARCH_UNPROTECT(sr);
+    }
+
+    if(ERR_OK != errval) {
+        pbuf_free(p);
+        LINK_STATS_INC(link.memerr);
+    }
+
+    /* give semaphore and exit */
+    xSemaphoreGive(s_tx_semaphore);
+
+    return errval;
+}
+#endif /* ETHERNETIF_TX_PRIORITY_QUEUE */
+
+/**
+* Release the pbufs of the frames which the Tx DMA has finished with.
+*/
+static void tx_buffer_reclaim(void)
+{
+    uint32_t index;
+
+    while((0U != tx_busy_count) && ((uint32_t)RESET == (tx_reclaim_desc->status & ENET_TDES0_DAV))) {
+        index = (uint32_t)(tx_reclaim_desc - low_handle->txdesc_tab);
+        if(NULL != tx_pbuf[index]) {
+            pbuf_free(tx_pbuf[index]);
+            tx_pbuf[index] = NULL;
+        }
+        tx_reclaim_desc = (enet_descriptors_struct *)(tx_reclaim_desc->buffer2_next_desc_addr);
+        tx_busy_count--;
+    }
+}
+#else
 static err_t low_level_output(struct netif *netif, struct pbuf *p)
 {
     static xSemaphoreHandle s_tx_semaphore = NULL;
@@ -221,15 +759,15 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
     if(xSemaphoreTake(s_tx_semaphore, LOWLEVEL_OUTPUT_WAITING_TIME)) {
         SYS_ARCH_PROTECT(sr);
 
-        while((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_DAV)) {
+        while((uint32_t)RESET != (low_handle->txdesc_current->status & ENET_TDES0_DAV)) {
         }
 
 #ifdef USE_ENET0
-        buffer = (uint8_t *)(enet_desc_information_get(ENET0, dma_current_txdesc, TXDESC_BUFFER_1_ADDR));
+        buffer = (uint8_t *)(enet_desc_information_get(ENET0, low_handle->txdesc_current, TXDESC_BUFFER_1_ADDR));
 #endif /* USE_ENET0 */
 
 #ifdef USE_ENET1
-        buffer = (uint8_t *)(enet_desc_information_get(ENET1, dma_current_txdesc, TXDESC_BUFFER_1_ADDR));
+        buffer = (uint8_t *)(enet_desc_information_get(ENET1, low_handle->txdesc_current, TXDESC_BUFFER_1_ADDR));
 #endif /* USE_ENET1 */
 
         for(q = p; q != NULL; q = q->next) {
@@ -268,16 +806,289 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
     }
 
 }
+#endif /* ETHERNETIF_TX_SCATTER_GATHER */
+
+#ifdef CHECKSUM_BY_HARDWARE
+#if ETHERNETIF_RX_CHECKSUM_FALLBACK
+/**
+* Check in software the IPv4 header and the TCP or UDP checksum of a frame
+* the ENET checksum offload has bypassed. Fragments are left to the stack,
+* their payload checksum covers the whole datagram.
+*
+* @param p the received frame, starting with the ethernet header
+* @param stats the counters to update
+* @return 1 if the checksums are right or cannot be checked here, 0 otherwise
+*/
+static int rx_checksum_software_check(struct pbuf *p, ethernetif_rx_checksum_stats_struct *stats)
+{
+    struct eth_hdr *ethhdr = (struct eth_hdr *)p->payload;
+    struct ip_hdr *iphdr;
+    ip4_addr_t src, dest;
+    u16_t hlen, len;
+    u8_t proto;
+    int reval = 1;
+
+    if((p->len < (SIZEOF_ETH_HDR + IP_HLEN)) || (PP_HTONS(ETHTYPE_IP) != ethhdr->type)) {
+        return 1;
+    }
+
+    iphdr = (struct ip_hdr *)((u8_t *)p->payload + SIZEOF_ETH_HDR);
+    hlen = IPH_HL_BYTES(iphdr);
+    len = lwip_ntohs(IPH_LEN(iphdr));
+    /* malformed headers are dropped by the stack */
+    if((hlen < IP_HLEN) || (p->len < (SIZEOF_ETH_HDR + hlen)) || (len < hlen) || (len > (p->tot_len - SIZEOF_ETH_HDR))) {
+        return 1;
+    }
+
+    stats->software_checked++;
+    if(0U != inet_chksum(iphdr, hlen)) {
+        return 0;
+    }
+
+    proto = IPH_PROTO(iphdr);
+    if((0U != (IPH_OFFSET(iphdr) & PP_HTONS(IP_OFFMASK | IP_MF))) || ((IP_PROTO_TCP != proto) && (IP_PROTO_UDP != proto))) {
+        return 1;
+    }
+
+    /* the pseudo header checksum runs over the transport header and payload, without the ethernet padding */
+    ip4_addr_copy(src, iphdr->src);
+    ip4_addr_copy(dest, iphdr->dest);
+    if(0U == pbuf_remove_header(p, SIZEOF_ETH_HDR + hlen)) {
+        /* a UDP checksum of 0 means the sender did not compute one */
+        if((IP_PROTO_TCP == proto) || (p->len < 8U) || (0U != (((u8_t *)p->payload)[6] | ((u8_t *)p->payload)[7]))) {
+            if(0U != inet_chksum_pseudo_partial(p, proto, (u16_t)(len - hlen), (u16_t)(len - hlen), &src, &dest)) {
+                reval = 0;
+            }
+        }
+        pbuf_add_header(p, SIZEOF_ETH_HDR + hlen);
+    }
+
+    return reval;
+}
+#endif /* ETHERNETIF_RX_CHECKSUM_FALLBACK */
+
+/**
+* Read the result of the ENET Rx checksum offload for a frame and count it.
+* The frames the ENET could not verify are checked in software if
+* ETHERNETIF_RX_CHECKSUM_FALLBACK is set.
+*
+* @param desc a copy of the Rx descriptor of the frame, taken before it was released
+* @param p the received frame
+* @param stats the counters to update
+* @return 1 if the frame may be passed to the stack, 0 if it has to be dropped
+*/
+static int rx_checksum_check(const enet_descriptors_struct *desc, struct pbuf *p, ethernetif_rx_checksum_stats_struct *stats)
+{
+    uint32_t header_error, payload_error, verified;
+
+#ifdef SELECT_DESCRIPTORS_ENHANCED_MODE
+    /* the extended status is only written for IP frames */
+    if((uint32_t)RESET == (desc->status & ENET_RDES0_EXSV)) {
+        return 1;
+    }
+    header_error = desc->extended_status & ENET_RDES4_IPHERR;
+    payload_error = desc->extended_status & ENET_RDES4_IPPLDERR;
+    verified = ((uint32_t)RESET == (desc->extended_status & ENET_RDES4_IPCKSB)) && (0U != GET_RDES4_IPPLDT(desc->extended_status));
+#else
+    /* the frame type, IP header error and payload error bits together give the result */
+    switch(desc->status & (ENET_RDES0_FRMT | ENET_RDES0_IPHERR | ENET_RDES0_PCERR)) {
+    case ENET_RDES0_PCERR:
+        /* IP frame with a right header and a payload the ENET does not check */
+        header_error = 0U;
+        payload_error = 0U;
+        verified = 0U;
+        break;
+    case (ENET_RDES0_FRMT | ENET_RDES0_IPHERR):
+    case (ENET_RDES0_FRMT | ENET_RDES0_PCERR):
+    case (ENET_RDES0_FRMT | ENET_RDES0_IPHERR | ENET_RDES0_PCERR):
+        header_error = desc->status & ENET_RDES0_IPHERR;
+        payload_error = desc->status & ENET_RDES0_PCERR;
+        verified = 1U;
+        break;
+    default:
+        /* IP frame without checksum error, or a frame which is not IP */
+        return 1;
+    }
+#endif /* SELECT_DESCRIPTORS_ENHANCED_MODE */
+
+    if(0U != header_error) {
+        stats->ip_header_errors++;
+    }
+    if(0U != payload_error) {
+        stats->payload_errors++;
+    }
+    if((0U != header_error) || (0U != payload_error)) {
+        LINK_STATS_INC(link.chkerr);
+        return 0;
+    }
+
+    if(0U == verified) {
+        stats->unverified++;
+#if ETHERNETIF_RX_CHECKSUM_FALLBACK
+        if(0 == rx_checksum_software_check(p, stats)) {
+            stats->software_errors++;
+            LINK_STATS_INC(link.chkerr);
+            return 0;
+        }
+#endif /* ETHERNETIF_RX_CHECKSUM_FALLBACK */
+    }
+
+    return 1;
+}
+#endif /* CHECKSUM_BY_HARDWARE */
+
+#if ETHERNETIF_RX_ZERO_COPY
+/**
+* Point every Rx descriptor at a zero-copy buffer and put the remaining
+* buffers into the replenish pool.
+*/
+static void rx_zero_copy_init(void)
+{
+    uint32_t i;
+
+    rx_free_count = 0U;
+    for(i = 0U; i < ETHERNETIF_RX_BUFFER_NUM; i++) {
+        rx_pbuf[i].pc.custom_free_function = rx_pbuf_free_custom;
+        rx_pbuf[i].buffer = &rx_zc_buff[i][0];
+
+        if(i < ENET_RXBUF_NUM) {
+            low_handle->rxdesc_tab[i].buffer1_addr = (uint32_t)rx_pbuf[i].buffer;
+        } else {
+            rx_free_list[rx_free_count++] = (uint16_t)i;
+        }
+    }
+
+    /* drop stale cache lines before the DMA starts writing the buffers */
+    SCB_InvalidateDCache_by_Addr((uint32_t *)rx_zc_buff, (int32_t)sizeof(rx_zc_buff));
+
+    rx_refill_desc = low_handle->rxdesc_current;
+    rx_unarmed_count = 0U;
+}
+
+/**
+* Give the Rx descriptors taken by low_level_input() back to the DMA, in ring
+* order, as long as there are free buffers to attach to them. The DMA is
+* resumed if it was suspended for lack of descriptors.
+* Must be called with SYS_ARCH_PROTECT held.
+*/
+static void rx_buffer_refill(void)
+{
+    uint32_t index;
+    uint32_t rearmed = 0U;
+
+    while((0U != rx_unarmed_count) && (0U != rx_free_count)) {
+        index = rx_free_list[--rx_free_count];
+
+        /* discard lines the stack may have dirtied so that no eviction overwrites DMA data */
+        SCB_InvalidateDCache_by_Addr((uint32_t *)rx_pbuf[index].buffer, (int32_t)ETHERNETIF_RX_BUFFER_SIZE);
+
+        rx_refill_desc->buffer1_addr = (uint32_t)rx_pbuf[index].buffer;
+        /* the buffer address must be visible before the DMA owns the descriptor */
+        __DMB();
+        rx_refill_desc->status = ENET_RDES0_DAV;
+
+        /* descriptors are initialized in chain mode */
+        rx_refill_desc = (enet_descriptors_struct *)(rx_refill_desc->buffer2_next_desc_addr);
+        rx_unarmed_count--;
+        rearmed++;
+    }
+
+    if((0U != rearmed) && (SET == enet_flag_get(ETHERNETIF_ENET, ENET_DMA_FLAG_RBU))) {
+        /* clear RBU flag and resume DMA reception */
+        enet_flag_clear(ETHERNETIF_ENET, ENET_DMA_FLAG_RBU_CLR);
+        enet_dmaprocess_resume(ETHERNETIF_ENET, ENET_DMA_RX);
+    }
+}
+
+/**
+* Custom pbuf free function: called by pbuf_free() when the stack releases the
+* last reference to a received frame. The buffer goes back to the replenish
+* pool and re-arms a waiting descriptor if there is one.
+*
+* @param p the custom pbuf being freed
+*/
+static void rx_pbuf_free_custom(struct pbuf *p)
+{
+    rx_pbuf_struct *rx_p = (rx_pbuf_struct *)p;
+    SYS_ARCH_DECL_PROTECT(sr);
+
+    SYS_ARCH_PROTECT(sr);
+    rx_free_list[rx_free_count++] = (uint16_t)(rx_p - rx_pbuf);
+    rx_buffer_refill();
+    SYS_ARCH_UNPROTECT(sr);
+}
+
+/**
+* Take the frame held by the current Rx descriptor and wrap its DMA buffer
+* into a custom pbuf without copying. The descriptor is re-armed with a spare
+* buffer right away, or later from rx_pbuf_free_custom() if the pool is empty.
+* Erroneous frames are dropped on the way.
+* Must be called with SYS_ARCH_PROTECT held.
+*
+* @param netif the lwip network interface structure for this ethernetif
+* @param rx_desc where to copy the Rx descriptor of the frame, whose checksum
+*        status is checked once the lock is released
+* @return a pbuf referencing the received packet (including MAC header)
+*         NULL if no valid frame is available
+*/
+static struct pbuf *low_level_input(struct netif *netif, enet_descriptors_struct *rx_desc)
+{
+    struct pbuf *p = NULL;
+    enet_descriptors_struct *desc;
+    uint32_t status, index;
+    u16_t len;
+
+    while(NULL == p) {
+        desc = low_handle->rxdesc_current;
+        status = desc->status;
+
+        /* the descriptor is owned by the DMA, or every descriptor is waiting for a buffer */
+        if(((uint32_t)RESET != (status & ENET_RDES0_DAV)) || (ENET_RXBUF_NUM == rx_unarmed_count)) {
+            break;
+        }
+
+        /* detach the descriptor, rx_buffer_refill() gives it back to the DMA */
+        low_handle->rxdesc_current = (enet_descriptors_struct *)(desc->buffer2_next_desc_addr);
+        rx_unarmed_count++;
+
+        index = (uint32_t)((uint8_t *)desc->buffer1_addr - &rx_zc_buff[0][0]) / ETHERNETIF_RX_BUFFER_SIZE;
+        len = enet_desc_information_get(ETHERNETIF_ENET, desc, RXDESC_FRAME_LENGTH);
+
+        /* only error free frames held in one descriptor are passed to the stack */
+        if(((uint32_t)RESET == (status & ENET_RDES0_ERRS)) &&
+                ((uint32_t)RESET != (status & ENET_RDES0_FDES)) &&
+                ((uint32_t)RESET != (status & ENET_RDES0_LDES)) && (len > 0U)) {
+            /* the CPU may have fetched lines of the buffer while the DMA was writing it */
+            SCB_InvalidateDCache_by_Addr((uint32_t *)rx_pbuf[index].buffer, (int32_t)ETHERNETIF_RX_BUFFER_SIZE);
+            p = pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &rx_pbuf[index].pc,
+                                    rx_pbuf[index].buffer, ETHERNETIF_RX_BUFFER_SIZE);
+            /* the descriptor is rewritten when it is re-armed, keep its status */
+            *rx_desc = *desc;
+        }
+
+        if(NULL == p) {
+            /* the frame is dropped, recycle its buffer and try the next one */
+            rx_free_list[rx_free_count++] = (uint16_t)index;
+        }
 
+        rx_buffer_refill();
+    }
+
+    return p;
+}
+#else
 /**
 * Should allocate a pbuf and transfer the bytes of the incoming
 * packet from the interface into the pbuf.
+* Must be called with SYS_ARCH_PROTECT held.
 *
 * @param netif the lwip network interface structure for this ethernetif
+* @param rx_desc where to copy the Rx descriptor of the frame, whose checksum
+*        status is checked once the lock is released
 * @return a pbuf filled with the received packet (including MAC header)
 *         NULL on memory error
 */
-static struct pbuf *low_level_input(struct netif *netif)
+static struct pbuf *low_level_input(struct netif *netif, enet_descriptors_struct *rx_desc)
 {
     struct pbuf *p = NULL, *q;
     uint32_t l = 0;
@@ -286,14 +1097,14 @@ static struct pbuf *low_level_input(struct netif *netif)
 
 #ifdef USE_ENET0
     /* obtain the size of the packet and put it into the "len" variable. */
-    len = enet_desc_information_get(ENET0, dma_current_rxdesc, RXDESC_FRAME_LENGTH);
-    buffer = (uint8_t *)(enet_desc_information_get(ENET0, dma_current_rxdesc, RXDESC_BUFFER_1_ADDR));
+    len = enet_desc_information_get(ENET0, low_handle->rxdesc_current, RXDESC_FRAME_LENGTH);
+    buffer = (uint8_t *)(enet_desc_information_get(ENET0, low_handle->rxdesc_current, RXDESC_BUFFER_1_ADDR));
 #endif /* USE_ENET0 */
 
 #ifdef USE_ENET1
     /* obtain the size of the packet and put it into the "len" variable. */
-    len = enet_desc_information_get(ENET1, dma_current_rxdesc, RXDESC_FRAME_LENGTH);
-    buffer = (uint8_t *)(enet_desc_information_get(ENET1, dma_current_rxdesc, RXDESC_BUFFER_1_ADDR));
+    len = enet_desc_information_get(ENET1, low_handle->rxdesc_current, RXDESC_FRAME_LENGTH);
+    buffer = (uint8_t *)(enet_desc_information_get(ENET1, low_handle->rxdesc_current, RXDESC_BUFFER_1_ADDR));
 #endif /* USE_ENET1 */
 
     if(len > 0) {
@@ -306,6 +1117,8 @@ static struct pbuf *low_level_input(struct netif *netif)
             memcpy((uint8_t *)q->payload, (u8_t *)&buffer[l], q->len);
             l = l + q->len;
         }
+        /* the descriptor goes back to the DMA below, keep its status */
+        *rx_desc = *low_handle->rxdesc_current;
     }
 #ifdef USE_ENET0
 #ifdef SELECT_DESCRIPTORS_ENHANCED_MODE
@@ -325,7 +1138,55 @@ static struct pbuf *low_level_input(struct netif *netif)
 
     return p;
 }
+#endif /* ETHERNETIF_RX_ZERO_COPY */
+
+
+/**
+* This function is called from the ENET interrupt handler when a frame has been
+* received. It masks the Rx interrupt and wakes up the ethernetif_input task,
+* which unmasks it again once the Rx descriptors are drained.
+*
+* @param task_woken set to pdTRUE if the input task has to run on ISR exit
+*/
+void ethernetif_rx_isr(portBASE_TYPE *task_woken)
+{
+    enet_interrupt_disable(ETHERNETIF_ENET, ENET_DMA_INT_RIE);
+    rx_stats.rx_interrupts++;
+    xSemaphoreGiveFromISR(g_rx_semaphore, task_woken);
+}
+
+/**
+* This function copies the Rx interrupt and poll counters of the interface.
+*
+* @param stats the structure to fill
+*/
+void ethernetif_rx_stats_get(ethernetif_rx_stats_struct *stats)
+{
+    SYS_ARCH_DECL_PROTECT(sr);
+
+    SYS_ARCH_PROTECT(sr);
+    *stats = rx_stats;
+    SYS_ARCH_UNPROTECT(sr);
+}
 
+/**
+* This function copies the Rx checksum offload counters of the interface.
+* All of them read zero without CHECKSUM_BY_HARDWARE.
+*
+* @param stats the structure to fill
+*/
+void ethernetif_rx_checksum_stats_get(ethernetif_rx_checksum_stats_struct *stats)
+{
+#ifdef CHECKSUM_BY_HARDWARE
+    SYS_ARCH_DECL_PROTECT(sr);
+
+    SYS_ARCH_PROTECT(sr);
+    *stats = rx_checksum_stats;
+    SYS_ARCH_UNPROTECT(sr);
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif /* CHECKSUM_BY_HARDWARE */
+}
 
 /**
 * This function is the ethernetif_input task, it is processed when a packet
@@ -334,26 +1195,60 @@ static struct pbuf *low_level_input(struct netif *netif)
 * interface. Then the type of the received packet is determined and
 * the appropriate input function is called.
 *
+* The frames are passed to the stack in rounds of at most ETHERNETIF_RX_BUDGET.
+* The Rx interrupt stays masked until a round ends with the ring drained.
+*
 * @param netif the lwip network interface structure for this ethernetif
 */
 void ethernetif_input(void *pvParameters)
 {
     struct pbuf *p;
+    uint32_t count;
+    enet_descriptors_struct rx_desc;
     SYS_ARCH_DECL_PROTECT(sr);
 
     for(;;) {
         if(pdTRUE == xSemaphoreTake(g_rx_semaphore, LOWLEVEL_INPUT_WAITING_TIME)) {
-TRY_GET_NEXT_FRAME:
-            SYS_ARCH_PROTECT(sr);
-            p = low_level_input(low_netif);
-            SYS_ARCH_UNPROTECT(sr);
-
-            if(p != NULL) {
-                if(ERR_OK != low_netif->input(p, low_netif)) {
-                    pbuf_free(p);
-                } else {
-                    goto TRY_GET_NEXT_FRAME;
+            for(;;) {
+                for(count = 0U; count < ETHERNETIF_RX_BUDGET; count++) {
+                    /* only taking the frame off the Rx ring needs the lock */
+                    SYS_ARCH_PROTECT(sr);
+                    p = low_level_input(low_netif, &rx_desc);
+                    SYS_ARCH_UNPROTECT(sr);
+
+                    if(p == NULL) {
+                        break;
+                    }
+#ifdef CHECKSUM_BY_HARDWARE
+                    /* drop the frames with a checksum error, the next ready one is read */
+                    if(0 == rx_checksum_check(&rx_desc, p, &rx_checksum_stats)) {
+                        LINK_STATS_INC(link.drop);
+                        pbuf_free(p);
+                        continue;
+                    }
+#endif /* CHECKSUM_BY_HARDWARE */
+                    if(ERR_OK != low_netif->input(p, low_netif)) {
+                        pbuf_free(p);
+                    }
                 }
+
+                SYS_ARCH_PROTECT(sr);
+                rx_stats.rx_polls++;
+                rx_stats.rx_frames += count;
+                if(count < ETHERNETIF_RX_BUDGET) {
+                    /* drained, a frame received meanwhile raises the interrupt again */
+                    enet_interrupt_enable(ETHERNETIF_ENET, ENET_DMA_INT_RIE);
+                    SYS_ARCH_UNPROTECT(sr);
+                    break;
+                }
+                rx_stats.rx_budget_exhausted++;
+                SYS_ARCH_UNPROTECT(sr);
+
+#if ETHERNETIF_RX_BUDGET_BACKOFF
+                vTaskDelay(ETHERNETIF_RX_BUDGET_BACKOFF);
+#else
+                taskYIELD();
+#endif /* ETHERNETIF_RX_BUDGET_BACKOFF */
             }
         }
     }
@@ -4,8 +4,49 @@
 
 #include "lwip/err.h"
 #include "lwip/netif.h"
+#include "FreeRTOS.h"
+
+/* Rx interrupt and poll counters of the interface */
+typedef struct {
+    uint32_t rx_interrupts;                                     /*!< Rx interrupts taken */
+    uint32_t rx_frames;                                         /*!< frames passed to the stack */
+    uint32_t rx_polls;                                          /*!< poll rounds of the input task */
+    uint32_t rx_budget_exhausted;                               /*!< poll rounds which used the whole budget */
+} ethernetif_rx_stats_struct;
+
+/* Rx checksum offload counters of the interface */
+typedef struct {
+    uint32_t ip_header_errors;                                  /*!< frames dropped for an IP header checksum error */
+    uint32_t payload_errors;                                    /*!< frames dropped for a TCP, UDP or ICMP checksum error */
+    uint32_t unverified;                                        /*!< IP frames the ENET did not fully check */
+    uint32_t software_checked;                                  /*!< unverified frames checked in software */
+    uint32_t software_errors;                                   /*!< frames dropped by the software check */
+} ethernetif_rx_checksum_stats_struct;
+
+/* Tx priority queues, the high priority queue is always served first */
+#define ETHERNETIF_TX_QUEUE_HIGH        0U
+#define ETHERNETIF_TX_QUEUE_LOW         1U
+#define ETHERNETIF_TX_QUEUE_NUM         2U
+
+/* counters of one Tx priority queue */
+typedef struct {
+    uint32_t depth;                                             /*!< frames in the queue now */
+    uint32_t max_depth;                                         /*!< most frames the queue has held */
+    uint32_t enqueued;                                          /*!< frames put into the queue */
+    uint32_t sent;                                              /*!< frames handed to the Tx DMA */
+    uint32_t dropped;                                           /*!< frames dropped because the queue was full */
+} ethernetif_tx_queue_stats_struct;
+
+/* Tx queue counters of the interface */
+typedef struct {
+    ethernetif_tx_queue_stats_struct queue[ETHERNETIF_TX_QUEUE_NUM];
+} ethernetif_tx_stats_struct;
 
 err_t ethernetif_init(struct netif *netif);
 void ethernetif_input( void * pvParameters );
+void ethernetif_rx_isr(portBASE_TYPE *task_woken);
+void ethernetif_rx_stats_get(ethernetif_rx_stats_struct *stats);
+void ethernetif_tx_stats_get(ethernetif_tx_stats_struct *stats);
+void ethernetif_rx_checksum_stats_get(ethernetif_rx_checksum_stats_struct *stats);
 
 #endif 
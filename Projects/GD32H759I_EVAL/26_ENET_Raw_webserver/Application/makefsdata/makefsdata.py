@@ -0,0 +1,352 @@
+#!/usr/bin/env python3
+#
+# makefsdata.py - build the fsdata.c image of the httpd file system from a directory
+#
+# Every file below the input directory becomes one struct fsdata_file with its
+# HTTP header included. On top of what the lwIP makefsdata tool does, the image has:
+#  - a collision free hash table of the file names, fs_open() looks a file up
+#    with one hash and one strcmp() instead of walking the list,
+#  - an ETag header per static file, fs_open_ext() answers "304 Not Modified"
+#    to a request holding it in If-None-Match,
+#  - optionally a gzip variant of the compressible files, sent with
+#    "Content-Encoding: gzip" to the clients accepting it,
+#  - optionally the checksums of the TCP_MSS sized chunks of each file
+#    (HTTPD_PRECALCULATED_CHECKSUM),
+#  - the offset table of the SSI tags of the SSI files, httpd sends the text
+#    between the tags from flash and only renders the tag inserts.
+#
+# The headers are HTTP/1.1 ones: the static files carry a Content-Length and are
+# flagged FS_FILE_FLAGS_HEADER_PERSISTENT, httpd keeps the connection open after
+# them. httpd adds the Content-Length of the SSI files when it sends them.
+#
+# The output only depends on the file contents, it can be compared between builds.
+#
+# The Server header carries the lwIP version read from lwip/init.h, as
+# LWIP_VERSION_STRING does.
+#
+# usage: makefsdata.py <input dir> <output file> [--gzip] [--chksum-chunk <TCP_MSS>]
+#                      [--lwip-init-h <lwip/init.h>]
+#
+
+import argparse
+import gzip
+import os
+import re
+import sys
+import zlib
+
+# lwip/init.h of the lwIP sources in this tree, used when --lwip-init-h is not given
+LWIP_INIT_H = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "..", "..", "..",
+                           "Middlewares", "Third_Party", "lwip", "src", "include", "lwip", "init.h")
+
+# files parsed for SSI tags by httpd, they are neither compressed nor cached
+SSI_EXTENSIONS = (".shtml", ".shtm", ".ssi")
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".htm": "text/html",
+    ".shtml": "text/html",
+    ".shtm": "text/html",
+    ".ssi": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".json": "application/json",
+    ".xml": "text/xml",
+    ".txt": "text/plain",
+    ".svg": "image/svg+xml",
+    ".gif": "image/gif",
+    ".png": "image/png",
+    ".jpg": "image/jpeg",
+    ".jpeg": "image/jpeg",
+    ".bmp": "image/bmp",
+    ".ico": "image/x-icon",
+}
+
+# SSI tag syntax, must match httpd.c: "<!--#name-->", whitespace allowed
+# around the name, no '-' or whitespace in the name
+TAG_LEAD_IN = b"<!--#"
+TAG_LEAD_OUT = b"-->"
+# LWIP_HTTPD_MAX_TAG_NAME_LEN, longer names are not tags
+MAX_TAG_NAME_LEN = 8
+
+# files worth a gzip variant, the image formats are compressed already
+COMPRESSIBLE = (".html", ".htm", ".css", ".js", ".json", ".xml", ".txt", ".svg")
+
+# the gzip variant is only kept if it saves at least this share of the file
+GZIP_MIN_SAVING = 0.1
+
+FNV_OFFSET_BASIS = 0x811C9DC5
+FNV_PRIME = 0x01000193
+
+
+def name_hash(name, seed):
+    """FNV-1a of the file name, must match fs_name_hash() in fs.c"""
+    h = FNV_OFFSET_BASIS ^ seed
+    for c in name.encode("ascii"):
+        h ^= c
+        h = (h * FNV_PRIME) & 0xFFFFFFFF
+    return h
+
+
+def hash_table_build(names):
+    """find a seed mapping every name to its own slot of a power of two table"""
+    size = 1
+    while size < 2 * len(names):
+        size *= 2
+    while True:
+        for seed in range(0x10000):
+            slots = {}
+            for name in names:
+                slot = name_hash(name, seed) & (size - 1)
+                if slot in slots:
+                    break
+                slots[slot] = name
+            else:
+                return size, seed, slots
+        size *= 2
+
+
+def standard_chksum(data):
+    """lwip_standard_chksum() of a buffer, in network byte order"""
+    if len(data) & 1:
+        data = data + b"\0"
+    acc = 0
+    for i in range(0, len(data), 2):
+        acc += (data[i] << 8) | data[i + 1]
+    while acc >> 16:
+        acc = (acc & 0xFFFF) + (acc >> 16)
+    return acc
+
+
+def ssi_tags_find(data):
+    """(offset, length, name) of each SSI tag of data, found the way httpd did
+    when it parsed the files at runtime"""
+    tags = []
+    pos = 0
+    while True:
+        start = data.find(TAG_LEAD_IN, pos)
+        if start < 0:
+            return tags
+        pos = start + 1
+        i = start + len(TAG_LEAD_IN)
+        while i < len(data) and data[i] in b" \t\r\n":
+            i += 1
+        name_start = i
+        while i < len(data) and data[i] not in b"- \t\r\n":
+            i += 1
+        name = data[name_start:i]
+        if not name or len(name) > MAX_TAG_NAME_LEN:
+            continue
+        while i < len(data) and data[i] in b" \t\r\n":
+            i += 1
+        if data[i:i + len(TAG_LEAD_OUT)] != TAG_LEAD_OUT:
+            continue
+        end = i + len(TAG_LEAD_OUT)
+        tags.append((start, end - start, name.decode("ascii")))
+        pos = end
+
+
+def lwip_version_get(path):
+    """LWIP_VERSION_STRING built from the version macros of lwip/init.h"""
+    with open(path, "r") as fp:
+        text = fp.read()
+    fields = {}
+    for key in ("MAJOR", "MINOR", "REVISION", "RC"):
+        m = re.search(r"^\s*#define\s+LWIP_VERSION_%s\s+(\w+)" % key, text, re.M)
+        if m is None:
+            sys.exit("makefsdata.py: LWIP_VERSION_%s not found in %s" % (key, path))
+        fields[key] = m.group(1)
+    version = "%s.%s.%s" % (fields["MAJOR"], fields["MINOR"], fields["REVISION"])
+    if fields["RC"] == "LWIP_RC_DEVELOPMENT":
+        version += "d"
+    elif fields["RC"] != "LWIP_RC_RELEASE":
+        version += "rc" + fields["RC"]
+    return version
+
+
+def c_ident(name):
+    return re.sub(r"[^A-Za-z0-9_]", "_", name)
+
+
+def header_build(name, body, etag, encoding, vary, server):
+    ext = os.path.splitext(name)[1].lower()
+    lines = ["HTTP/1.1 200 OK", server,
+             "Content-type: " + CONTENT_TYPES.get(ext, "text/plain")]
+    if ext in SSI_EXTENSIONS:
+        # the SSI output changes at runtime, keep it out of the caches
+        lines.append("Cache-Control: no-cache")
+    else:
+        lines += ["Content-Length: %d" % len(body), "ETag: " + etag]
+        if encoding is not None:
+            lines.append("Content-Encoding: " + encoding)
+        if vary:
+            lines.append("Vary: Accept-Encoding")
+    return ("\r\n".join(lines) + "\r\n\r\n").encode("ascii")
+
+
+class FsFile:
+    def __init__(self, name, ident, body, etag, server, encoding=None, gzip_variant=None):
+        self.name = name
+        self.ident = ident
+        self.ssi = os.path.splitext(name)[1].lower() in SSI_EXTENSIONS
+        self.tags = []
+        self.etag = etag
+        self.gzip = gzip_variant
+        self.header = header_build(name, body, etag, encoding,
+                                   (encoding is not None) or (gzip_variant is not None), server)
+        self.name_bytes = name.encode("ascii") + b"\0"
+        # the file data starts word aligned after the NUL terminated name
+        self.name_bytes += b"\0" * (-len(self.name_bytes) % 4)
+        self.body = body
+        if self.ssi:
+            # the offsets count from the start of the file data, header included
+            self.tags = [(len(self.header) + offset, length, tag)
+                         for offset, length, tag in ssi_tags_find(body)]
+
+
+def bytes_write(out, data):
+    for i in range(0, len(data), 16):
+        out.write(",".join("0x%02x" % b for b in data[i:i + 16]) + ",\n")
+
+
+def string_comment(data):
+    return data.decode("ascii").replace("*/", "*\\/")
+
+
+def file_write(out, f, index, chksum_chunk):
+    out.write("static const unsigned int dummy_align_%s = %d;\n" % (f.ident, index))
+    out.write("static const unsigned char data_%s[] = {\n" % f.ident)
+    out.write("/* %s (%d chars) */\n" % (f.name, len(f.name) + 1))
+    bytes_write(out, f.name_bytes)
+    out.write("\n/* HTTP header */\n")
+    for line in f.header.split(b"\r\n")[:-2]:
+        line += b"\r\n"
+        out.write('/* "%s" (%d bytes) */\n' % (string_comment(line.rstrip(b"\r\n")), len(line)))
+        bytes_write(out, line)
+    out.write('/* "" (2 bytes) */\n')
+    bytes_write(out, b"\r\n")
+    out.write("/* raw file data (%d bytes) */\n" % len(f.body))
+    bytes_write(out, f.body)
+    out.write("};\n\n")
+
+    if chksum_chunk:
+        data = f.header + f.body
+        out.write("#if HTTPD_PRECALCULATED_CHECKSUM\n")
+        out.write("static const struct fsdata_chksum chksums_%s[] = {\n" % f.ident)
+        for offset in range(0, len(data), chksum_chunk):
+            chunk = data[offset:offset + chksum_chunk]
+            out.write("{%d, 0x%04x, %d},\n" % (offset, standard_chksum(chunk), len(chunk)))
+        out.write("};\n")
+        out.write("#endif /* HTTPD_PRECALCULATED_CHECKSUM */\n\n")
+
+    if f.tags:
+        out.write("static const struct fs_ssi_tag ssi_tags_%s[] = {\n" % f.ident)
+        for offset, length, tag in f.tags:
+            out.write('{%d, %d, "%s"},\n' % (offset, length, tag))
+        out.write("};\n\n")
+
+
+def struct_write(out, f, next_ident, chksum_chunk):
+    data = f.header + f.body
+    out.write("const struct fsdata_file file_%s[] = { {\n" % f.ident)
+    out.write("%s,\n" % ("file_" + next_ident if next_ident else "file_NULL"))
+    out.write("data_%s,\n" % f.ident)
+    out.write("data_%s + %d,\n" % (f.ident, len(f.name_bytes)))
+    out.write("sizeof(data_%s) - %d,\n" % (f.ident, len(f.name_bytes)))
+    if f.ssi:
+        out.write("FS_FILE_FLAGS_HEADER_INCLUDED,\n")
+    else:
+        out.write("FS_FILE_FLAGS_HEADER_INCLUDED | FS_FILE_FLAGS_HEADER_PERSISTENT,\n")
+    out.write("#if HTTPD_PRECALCULATED_CHECKSUM\n")
+    if chksum_chunk:
+        count = (len(data) + chksum_chunk - 1) // chksum_chunk
+        out.write("%d, chksums_%s,\n" % (count, f.ident))
+    else:
+        out.write("0, NULL,\n")
+    out.write("#endif /* HTTPD_PRECALCULATED_CHECKSUM */\n")
+    out.write("%s,\n" % ("file_" + f.gzip.ident if f.gzip else "file_NULL"))
+    out.write("%s,\n" % ('"%s"' % f.etag.replace('"', '\\"') if f.etag else "NULL"))
+    if f.tags:
+        out.write("ssi_tags_%s, %d,\n" % (f.ident, len(f.tags)))
+    else:
+        out.write("NULL, 0,\n")
+    out.write("}};\n\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="build the httpd fsdata.c image from a directory")
+    parser.add_argument("input", help="directory holding the files to serve")
+    parser.add_argument("output", help="fsdata.c file to write")
+    parser.add_argument("--gzip", action="store_true",
+                        help="add gzip variants of the compressible files")
+    parser.add_argument("--chksum-chunk", type=int, default=0, metavar="TCP_MSS",
+                        help="precalculate the checksums of chunks of this size")
+    parser.add_argument("--lwip-init-h", default=LWIP_INIT_H, metavar="INIT_H",
+                        help="lwip/init.h giving the version of the Server header")
+    args = parser.parse_args()
+
+    server = "Server: lwIP/%s (http://savannah.nongnu.org/projects/lwip)" % lwip_version_get(args.lwip_init_h)
+
+    paths = []
+    for root, dirs, names in os.walk(args.input):
+        dirs.sort()
+        for name in sorted(names):
+            paths.append(os.path.join(root, name))
+    if not paths:
+        sys.exit("makefsdata.py: no file found in " + args.input)
+
+    files = []
+    for path in paths:
+        name = "/" + os.path.relpath(path, args.input).replace(os.sep, "/")
+        with open(path, "rb") as fp:
+            body = fp.read()
+        ext = os.path.splitext(name)[1].lower()
+        ssi = ext in SSI_EXTENSIONS
+        etag = None if ssi else '"%08x"' % zlib.crc32(body)
+        variant = None
+        if args.gzip and not ssi and ext in COMPRESSIBLE:
+            packed = gzip.compress(body, compresslevel=9, mtime=0)
+            if len(packed) <= len(body) * (1 - GZIP_MIN_SAVING):
+                variant = FsFile(name, c_ident(name) + "_gz", packed,
+                                 '"%08x-gz"' % zlib.crc32(body), server, "gzip")
+        files.append(FsFile(name, c_ident(name), body, etag, server, gzip_variant=variant))
+
+    size, seed, slots = hash_table_build([f.name for f in files])
+    by_name = {f.name: f for f in files}
+
+    with open(args.output, "w", newline="\n") as out:
+        out.write("/* generated by makefsdata.py from %s, do not edit */\n"
+                  % os.path.basename(os.path.normpath(args.input)))
+        out.write('#include "fs.h"\n#include "lwip/def.h"\n#include "fsdata.h"\n\n\n')
+        out.write("#define file_NULL (struct fsdata_file *) NULL\n\n\n")
+
+        index = 0
+        for f in files:
+            for v in (f, f.gzip):
+                if v is not None:
+                    file_write(out, v, index, args.chksum_chunk)
+                    index += 1
+
+        out.write("\n\n")
+        next_ident = None
+        for f in files:
+            if f.gzip is not None:
+                # the gzip variants are only reached through their file, not listed
+                struct_write(out, f.gzip, None, args.chksum_chunk)
+            struct_write(out, f, next_ident, args.chksum_chunk)
+            next_ident = f.ident
+
+        out.write("#define FS_ROOT file_%s\n" % files[-1].ident)
+        out.write("#define FS_NUMFILES %d\n\n" % len(files))
+
+        out.write("/* collision free hash table of the file names, see fs_name_hash() */\n")
+        out.write("#define FS_HASH_SIZE %d\n" % size)
+        out.write("#define FS_HASH_SEED 0x%08xUL\n" % seed)
+        out.write("static const struct fsdata_file *const fs_hash_table[FS_HASH_SIZE] = {\n")
+        for slot in range(size):
+            out.write("%s,\n" % ("file_" + by_name[slots[slot]].ident if slot in slots else "file_NULL"))
+        out.write("};\n")
+
+
+if __name__ == "__main__":
+    main()
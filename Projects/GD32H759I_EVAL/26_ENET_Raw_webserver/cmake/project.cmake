@@ -1,9 +1,27 @@
+# ENET DMA descriptor ring sizes, the rings and their buffers are placed in the .dma_nocache section
+set(ENET_RXBUF_NUM 32 CACHE STRING "Number of ENET Rx DMA descriptors (4 to 128, the rings must fit RAM_NOCACHE in the linker script)")
+set(ENET_TXBUF_NUM 32 CACHE STRING "Number of ENET Tx DMA descriptors (4 to 128, the rings must fit RAM_NOCACHE in the linker script)")
+foreach(ENET_RING ENET_RXBUF_NUM ENET_TXBUF_NUM)
+    if(NOT "${${ENET_RING}}" MATCHES "^[0-9]+$" OR ${${ENET_RING}} LESS 4 OR ${${ENET_RING}} GREATER 128)
+        message(FATAL_ERROR "${ENET_RING} must be a number from 4 to 128, got '${${ENET_RING}}'")
+    endif()
+endforeach()
+
+# httpd file system image, Application/makefsdata/makefsdata.py builds fsdata.c from Application/fs
+option(HTTPD_FSDATA_GZIP "Add gzip variants of the compressible web files" ON)
+set(HTTPD_FSDATA_CHKSUM_CHUNK 0 CACHE STRING "Precalculate the checksums of chunks of this size, TCP_MSS (0 to disable)")
+if(NOT "${HTTPD_FSDATA_CHKSUM_CHUNK}" MATCHES "^[0-9]+$")
+    message(FATAL_ERROR "HTTPD_FSDATA_CHKSUM_CHUNK must be a number, got '${HTTPD_FSDATA_CHKSUM_CHUNK}'")
+endif()
+
 function(project_add_target_properties TARGET_NAME)
 
 target_compile_definitions(${TARGET_NAME} PRIVATE
     "$<$<CONFIG:Debug>:DEBUG>"
     "$<$<NOT:$<CONFIG:Debug>>:RELEASE>"
 	GD32H7XX
+	ENET_RXBUF_NUM=${ENET_RXBUF_NUM}U
+	ENET_TXBUF_NUM=${ENET_TXBUF_NUM}U
 	)
 
 target_compile_options(${TARGET_NAME} PRIVATE
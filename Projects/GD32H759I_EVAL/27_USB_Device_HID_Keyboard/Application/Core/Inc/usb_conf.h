@@ -105,19 +105,26 @@ OF SUCH DAMAGE.
     #endif
 #endif /* USE_USB_HS */
 
-/* all variables and data structures during the transaction process should be 4-bytes aligned */
+/* all variables and data structures during the transaction process should be 4-bytes aligned,
+   the internal DMA needs whole D-cache lines for the buffers it receives in place */
+#ifdef USB_INTERNAL_DMA_ENABLED
+    #define USB_ALIGN_SIZE  32
+#else
+    #define USB_ALIGN_SIZE  4
+#endif /* USB_INTERNAL_DMA_ENABLED */
+
 #if defined (__GNUC__)         /* GNU Compiler */
-    #define __ALIGN_END __attribute__ ((aligned (4)))
+    #define __ALIGN_END __attribute__ ((aligned (USB_ALIGN_SIZE)))
     #define __ALIGN_BEGIN
 #else
     #define __ALIGN_END
 
     #if defined (__CC_ARM)     /* ARM Compiler */
-        #define __ALIGN_BEGIN __align(4)  
+        #define __ALIGN_BEGIN __align(USB_ALIGN_SIZE)  
     #elif defined (__ICCARM__) /* IAR Compiler */
         #define __ALIGN_BEGIN 
     #elif defined (__TASKING__)/* TASKING Compiler */
-        #define __ALIGN_BEGIN __align(4) 
+        #define __ALIGN_BEGIN __align(USB_ALIGN_SIZE) 
     #endif /* __CC_ARM */  
 #endif /* __GNUC__ */
 
@@ -43,4 +43,7 @@ OF SUCH DAMAGE.
 #define USBH_DATA_BUF_MAX_LEN                   0x200U
 #define USBH_CFGSET_MAX_LEN                     0x200U
 
+/* sector cache between FatFs and the device, see usbh_msc_cache.h for its size options */
+#define USBH_MSC_CACHE_ENABLED
+
 #endif /* USBH_CONF_H */
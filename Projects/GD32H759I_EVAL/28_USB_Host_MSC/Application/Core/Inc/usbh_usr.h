@@ -109,4 +109,11 @@ void usbh_user_unrecovered_error(void);
 /* demo application for mass storage */
 int usbh_usr_msc_application(void);
 
+#ifdef USBH_MSC_DISKIO_RTOS
+/* wake the application task from the host task */
+int usbh_usr_msc_notify(void);
+/* application task running the mass storage demo */
+void usbh_usr_msc_task(void *pvParameters);
+#endif /* USBH_MSC_DISKIO_RTOS */
+
 #endif /* USBH_USR_H */
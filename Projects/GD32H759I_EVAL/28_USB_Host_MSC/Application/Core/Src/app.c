@@ -36,9 +36,41 @@ OF SUCH DAMAGE.
 #include "usbh_msc_core.h"
 #include "usbh_usr.h"
 
+#ifdef USBH_HUB_ENABLED
+#include "usbh_hub.h"
+#endif /* USBH_HUB_ENABLED */
+
+#ifdef USBH_MSC_DISKIO_RTOS
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define USBH_TASK_PRIO              (tskIDLE_PRIORITY + 1)
+#define MSC_APP_TASK_PRIO           (tskIDLE_PRIORITY + 1)
+#endif /* USBH_MSC_DISKIO_RTOS */
+
 usbh_host usb_host_msc;
 usb_core_driver msc_host_core;
 
+#ifdef USBH_MSC_DISKIO_RTOS
+/*!
+    \brief      host task running the USB host state machine
+    \param[in]  pvParameters: not used
+    \param[out] none
+    \retval     none
+*/
+static void usbh_task(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for(;;) {
+        usbh_core_task(&usb_host_msc);
+
+        /* share the CPU with the application task, it runs at the same priority */
+        taskYIELD();
+    }
+}
+#endif /* USBH_MSC_DISKIO_RTOS */
+
 /*!
     \brief      enable the CPU cache
     \param[in]  none
@@ -50,13 +82,8 @@ void cache_enable(void)
     /* enable i-cache */
     SCB_EnableICache();
 
-    /* enable d-cache */
-    /** note:
-      * if the USB DMA is enabled, the d-cache should be disabled!
-      */
-#ifndef USB_INTERNAL_DMA_ENABLED
+    /* enable d-cache, the USB driver keeps the DMA buffers coherent */
     SCB_EnableDCache();
-#endif /* USB_INTERNAL_DMA_ENABLED */
 }
 
 /*!
@@ -83,6 +110,11 @@ int main(void)
     /* register device class */
     usbh_class_register(&usb_host_msc, &usbh_msc);
 
+#ifdef USBH_HUB_ENABLED
+    /* devices on the hub ports get the other registered classes */
+    usbh_class_register(&usb_host_msc, &usbh_hub);
+#endif /* USBH_HUB_ENABLED */
+
 #ifdef USE_USBHS0
 
 #ifdef USE_USB_FS
@@ -122,6 +154,16 @@ int main(void)
 
     usb_intr_config();
 
+#ifdef USBH_MSC_DISKIO_RTOS
+    /* FatFs blocks in disk_read()/disk_write() until the host task completes the request,
+       so the file system demo runs in its own task */
+    xTaskCreate(usbh_task, "USBH", configMINIMAL_STACK_SIZE * 4, NULL, USBH_TASK_PRIO, NULL);
+    xTaskCreate(usbh_usr_msc_task, "MSC_APP", configMINIMAL_STACK_SIZE * 8, NULL, MSC_APP_TASK_PRIO, NULL);
+
+    /* start scheduler */
+    vTaskStartScheduler();
+#endif /* USBH_MSC_DISKIO_RTOS */
+
     while(1) {
         usbh_core_task(&usb_host_msc);
     }
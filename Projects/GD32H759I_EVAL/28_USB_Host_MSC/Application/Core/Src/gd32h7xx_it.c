@@ -112,6 +112,8 @@ void UsageFault_Handler(void)
     }
 }
 
+#ifndef USBH_MSC_DISKIO_RTOS
+
 /*!
     \brief      this function handles SVC exception
     \param[in]  none
@@ -125,6 +127,8 @@ void SVC_Handler(void)
     }
 }
 
+#endif /* USBH_MSC_DISKIO_RTOS */
+
 /*!
     \brief      this function handles DebugMon exception
     \param[in]  none
@@ -138,6 +142,8 @@ void DebugMon_Handler(void)
     }
 }
 
+#ifndef USBH_MSC_DISKIO_RTOS
+
 /*!
     \brief      this function handles PendSV exception
     \param[in]  none
@@ -151,6 +157,8 @@ void PendSV_Handler(void)
     }
 }
 
+#endif /* USBH_MSC_DISKIO_RTOS */
+
 /*!
     \brief      this function handles FPU exception
     \param[in]  none
@@ -37,6 +37,19 @@ OF SUCH DAMAGE.
 #include "usbh_msc_core.h"
 #include "ff.h"
 
+#ifdef USBH_MSC_CACHE_ENABLED
+#include "usbh_msc_cache.h"
+#endif /* USBH_MSC_CACHE_ENABLED */
+
+#ifdef USBH_MSC_DISKIO_RTOS
+#include "FreeRTOS.h"
+#include "semphr.h"
+#endif /* USBH_MSC_DISKIO_RTOS */
+
+#ifdef USBH_HUB_ENABLED
+#include "usbh_hub.h"
+#endif /* USBH_HUB_ENABLED */
+
 #include <string.h>
 
 extern usb_core_driver msc_host_core;
@@ -53,6 +66,10 @@ uint16_t bytesWritten, bytesToWrite, bytesRead;
 uint8_t line_idx;
 uint8_t usbh_usr_application_state = USBH_USR_FS_INIT;
 
+#ifdef USBH_MSC_DISKIO_RTOS
+static SemaphoreHandle_t msc_app_sem = NULL; /* given by the host task to run the demo */
+#endif /* USBH_MSC_DISKIO_RTOS */
+
 /* points to the usbh_user_cb structure */
 usbh_user_cb usr_cb = {
     usbh_user_init,
@@ -70,7 +87,11 @@ usbh_user_cb usr_cb = {
     usbh_user_serialnum_string,
     usbh_user_enumeration_finish,
     usbh_user_userinput,
+#ifdef USBH_MSC_DISKIO_RTOS
+    usbh_usr_msc_notify,
+#else
     usbh_usr_msc_application,
+#endif /* USBH_MSC_DISKIO_RTOS */
     usbh_user_device_not_supported,
     usbh_user_unrecovered_error
 };
@@ -369,6 +390,10 @@ void usbh_user_over_current_detected(void)
 int usbh_usr_msc_application(void)
 {
     msc_lun info;
+    usbh_host *msc_host = &usb_host_msc;
+#ifdef USBH_MSC_CACHE_ENABLED
+    usbh_msc_cache_stats stats;
+#endif /* USBH_MSC_CACHE_ENABLED */
 
     switch(usbh_usr_application_state) {
     case USBH_USR_FS_INIT:
@@ -381,7 +406,12 @@ int usbh_usr_msc_application(void)
 
         LCD_UsrLog("> File System initialized.\r\n");
 
-        if(USBH_OK == usbh_msc_lun_info_get(&usb_host_msc, 0, &info)) {
+#ifdef USBH_HUB_ENABLED
+        /* the Udisk may sit on a hub port */
+        msc_host = usbh_hub_device_find(&usb_host_msc, USB_CLASS_MSC);
+#endif /* USBH_HUB_ENABLED */
+
+        if((NULL != msc_host) && (USBH_OK == usbh_msc_lun_info_get(msc_host, 0, &info))) {
             LCD_UsrLog("> Disk capacity: %llu Bytes.\r\n", (uint64_t)info.capacity.block_nbr * info.capacity.block_size);
         }
 
@@ -468,6 +498,14 @@ int usbh_usr_msc_application(void)
             LCD_ErrLog("> GD32.TXT CANNOT be opened.\r\n");
         }
 
+#ifdef USBH_MSC_CACHE_ENABLED
+        usbh_msc_cache_stats_get(&stats);
+
+        LCD_UsrLog("> Cache hit rate: %u.%u%%, read %u KB/s, write %u KB/s.\r\n", \
+                   (unsigned int)(stats.hit_rate / 10U), (unsigned int)(stats.hit_rate % 10U), \
+                   (unsigned int)stats.read_kbps, (unsigned int)stats.write_kbps);
+#endif /* USBH_MSC_CACHE_ENABLED */
+
         /* unmount file system */
         f_mount(NULL, "0:/", 1);
 
@@ -485,6 +523,44 @@ int usbh_usr_msc_application(void)
     return(0);
 }
 
+#ifdef USBH_MSC_DISKIO_RTOS
+
+/*!
+    \brief      wake the application task, called from the host task
+    \param[in]  none
+    \param[out] none
+    \retval     status
+*/
+int usbh_usr_msc_notify(void)
+{
+    if(NULL != msc_app_sem) {
+        (void)xSemaphoreGive(msc_app_sem);
+    }
+
+    return(0);
+}
+
+/*!
+    \brief      application task running the mass storage demo
+    \param[in]  pvParameters: not used
+    \param[out] none
+    \retval     none
+*/
+void usbh_usr_msc_task(void *pvParameters)
+{
+    (void)pvParameters;
+
+    msc_app_sem = xSemaphoreCreateBinary();
+
+    for(;;) {
+        (void)xSemaphoreTake(msc_app_sem, portMAX_DELAY);
+
+        (void)usbh_usr_msc_application();
+    }
+}
+
+#endif /* USBH_MSC_DISKIO_RTOS */
+
 /*!
     \brief      displays disk content
     \param[in]  path: pointer to root path
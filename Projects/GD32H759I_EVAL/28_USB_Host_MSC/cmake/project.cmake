@@ -1,3 +1,12 @@
+# FatFs disk I/O on FreeRTOS: the host runs in its own task, disk_read/disk_write wait for queued requests
+option(USBH_MSC_DISKIO_RTOS "Run the demo on FreeRTOS with the queued MSC disk I/O" OFF)
+
+# hub class: the Udisk may be attached to a downstream port of a USB hub
+option(USBH_HUB "Register the USB hub class next to the MSC class" OFF)
+
+# host channel scheduler: class pipes are mapped onto the hardware channels at each SOF
+option(USBH_SCHED "Share the host channels between the pipes of all attached devices" OFF)
+
 function(project_add_target_properties TARGET_NAME)
 
 target_compile_definitions(${TARGET_NAME} PRIVATE
@@ -7,6 +16,9 @@ target_compile_definitions(${TARGET_NAME} PRIVATE
     USE_USBHS0
     GD32H7XX
     USE_LCD
+	"$<$<BOOL:${USBH_MSC_DISKIO_RTOS}>:USBH_MSC_DISKIO_RTOS>"
+	"$<$<BOOL:${USBH_HUB}>:USBH_HUB_ENABLED>"
+	"$<$<BOOL:${USBH_SCHED}>:USBH_SCHED_ENABLED>"
 	)
 
 target_compile_options(${TARGET_NAME} PRIVATE
@@ -34,6 +34,7 @@ OF SUCH DAMAGE.
 
 #include "drv_usb_hw.h"
 #include "usbd_msc_core.h"
+#include "flash_msd.h"
 
 usb_core_driver msc_udisk;
 
@@ -48,13 +49,8 @@ void cache_enable(void)
     /* enable i-cache */
     SCB_EnableICache();
 
-    /* enable d-cache */
-    /** note:
-      * if the USB DMA is enabled, the d-cache should be disabled!
-      */
-#ifndef USB_INTERNAL_DMA_ENABLED
+    /* enable d-cache, the USB driver keeps the DMA buffers coherent */
     SCB_EnableDCache();
-#endif /* USB_INTERNAL_DMA_ENABLED */
 }
 
 /*!
@@ -115,5 +111,8 @@ int main(void)
     usb_intr_config();
 
     while(1) {
+        /* write the flash cache back once the host stops writing */
+        usb_mdelay(10U);
+        flash_cache_idle(10U);
     }
 }